@@ -134,6 +134,7 @@
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSumAgreeingIntensities.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectralContrastAngle.h>
 #include <OpenMS/COMPARISON/SPECTRA/PeakAlignment.h>
+#include <OpenMS/COMPARISON/CLUSTERING/SparseSpectraClustering.h>
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMeanIterative.h>
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
@@ -417,6 +418,7 @@ int main(int argc, char** argv)
   DOCME(SpectrumPrecursorComparator);
   DOCME(SteinScottImproveScore);
   DOCME(SpectraMerger);
+  DOCME(SparseSpectraClustering);
   DOCME(SvmTheoreticalSpectrumGenerator);
   //DOCME(SvmTheoreticalSpectrumGeneratorSet);
   DOCME(SvmTheoreticalSpectrumGeneratorTrainer);
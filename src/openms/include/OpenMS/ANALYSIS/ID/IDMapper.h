@@ -265,7 +265,7 @@ protected:
     void getIDDetails_(const PeptideIdentification& id, double& rt_pep, DoubleList& mz_values, IntList& charges, bool use_avg_mass = false) const;
 
     /// increase a bounding box by the given RT and m/z tolerances
-    void increaseBoundingBox_(DBoundingBox<2>& box);
+    void increaseBoundingBox_(DBoundingBox<2>& box) const;
 
     /// try to determine the type of m/z value reported for features, return
     /// whether average peptide masses should be used for matching
@@ -175,7 +175,16 @@ namespace OpenMS
       std::vector<PeptideHit::PeakAnnotation>& annotations,
       double mz_lower_bound = 0.0);
 
-    /// main method of MetaboliteSpectralMatching
+    /**
+      @brief main method of MetaboliteSpectralMatching
+
+      The library is sorted by precursor m/z and binned once into L2-normalized
+      fragment vectors. For every query precursor, the library candidates
+      within the precursor window are ranked by binned cosine similarity and
+      only the best @p prefilter_top_n of them are scored with the (more
+      expensive) hyperscore. Query spectra are processed in parallel; the
+      order of the reported matches does not depend on the number of threads.
+    */
     void run(PeakMap &, PeakMap &, MzTab &);
 
   protected:
@@ -192,15 +201,33 @@ namespace OpenMS
       double mz_lower_bound = 0.0);
 
   private:
+    /// Binned fragment spectra of the library in compressed row layout (same order as the library)
+    struct LibraryIndex_
+    {
+      /// first peak of spectrum i is at offsets[i], the last one before offsets[i + 1]
+      std::vector<Size> offsets;
+      /// bin indices (ascending within each spectrum)
+      std::vector<UInt> bins;
+      /// L2-normalized bin intensities
+      std::vector<float> weights;
+    };
+
     /// private member functions
     void exportMzTab_(const std::vector<SpectralMatch>&, MzTab&);
 
+    /// bin and normalize all library spectra
+    void buildLibraryIndex_(const PeakMap& spec_db, double bin_width, LibraryIndex_& index) const;
+
+    /// width of the bins used by the cosine prefilter
+    double prefilterBinWidth_() const;
+
     double precursor_mz_error_;
     double fragment_mz_error_;
     String mz_error_unit_;
     String ion_mode_;
 
     String report_mode_;
+    Size prefilter_top_n_;
   };
 
 }
@@ -36,6 +36,7 @@
 
 
 #include <OpenMS/ANALYSIS/ID/AhoCorasickAmbiguous.h>
+#include <OpenMS/ANALYSIS/ID/ProteinDBIndex.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <OpenMS/CONCEPT/LogStream.h>
@@ -56,6 +57,7 @@
 #include <atomic>
 #include <algorithm>
 #include <fstream>
+#include <functional>
 
 
 namespace OpenMS
@@ -191,46 +193,15 @@ public:
       // no decoy string provided? try to deduce from data
       if (decoy_string_.empty())
       {
-        auto r = DecoyHelper::findDecoyString(proteins);
+        setDecoyString_(DecoyHelper::findDecoyString(proteins));
         proteins.reset();
-        if (!r.success)
-        {
-          r.is_prefix = true;
-          r.name = "DECOY_";
-          OPENMS_LOG_WARN << "Unable to determine decoy string automatically (not enough decoys were detected)! Using default " << (r.is_prefix ? "prefix" : "suffix") << " decoy string '" << r.name << "'\n"
-                          << "If you think that this is incorrect, please provide a decoy_string and its position manually!" << std::endl;
-        }
-        prefix_ = r.is_prefix;
-        decoy_string_ = r.name;
-        // decoy string and position was extracted successfully
-        OPENMS_LOG_INFO << "Using " << (prefix_ ? "prefix" : "suffix") << " decoy string '" << decoy_string_ << "'" << std::endl;
       }
 
       //---------------------------------------------------------------
       // parsing parameters, correcting xtandem and MSGFPlus parameters
       //---------------------------------------------------------------
-      ProteaseDigestion enzyme;
-      enzyme.setEnzyme(enzyme_name_);
-      enzyme.setSpecificity(enzyme.getSpecificityByName(enzyme_specificity_));
-
-      bool xtandem_fix_parameters = true;
-      bool msgfplus_fix_parameters = true;
-
-      // determine if search engine is solely xtandem or MSGFPlus
-      for (const auto& prot_id : prot_ids)
-      {
-        String search_engine = prot_id.getSearchEngine();
-        StringUtils::toUpper(search_engine);
-        if (search_engine != "XTANDEM") { xtandem_fix_parameters = false; }
-        if (!(search_engine == "MSGFPLUS" || search_engine == "MS-GF+")) { msgfplus_fix_parameters = false; }
-      }
-
-      // solely MSGFPlus -> Trypsin/P as enzyme
-      if (msgfplus_fix_parameters && enzyme.getEnzymeName() == "Trypsin")
-      {
-        OPENMS_LOG_WARN << "MSGFPlus detected but enzyme cutting rules were set to Trypsin. Correcting to Trypsin/P to copy with special cutting rule in MSGFPlus." << std::endl;
-        enzyme.setEnzyme("Trypsin/P");
-      }
+      bool xtandem_fix_parameters(false);
+      const ProteaseDigestion enzyme = getEnzyme_(prot_ids, xtandem_fix_parameters);
 
       //-------------------------------------------------------------
       // calculations
@@ -275,35 +246,12 @@ public:
         /*
         BUILD Peptide DB
         */
-        bool has_illegal_AAs(false);
+        std::vector<String> pep_sequences;
+        collectPeptideSequences_(pep_ids, pep_sequences);
         AhoCorasickAmbiguous::PeptideDB pep_DB;
-        for (std::vector<PeptideIdentification>::const_iterator it1 = pep_ids.begin(); it1 != pep_ids.end(); ++it1)
-        {
-          //String run_id = it1->getIdentifier();
-          const std::vector<PeptideHit>& hits = it1->getHits();
-          for (std::vector<PeptideHit>::const_iterator it2 = hits.begin(); it2 != hits.end(); ++it2)
-          {
-            //
-            // Warning:
-            // do not skip over peptides here, since the results are iterated in the same way
-            //
-            String seq = it2->getSequence().toUnmodifiedString().remove('*'); // make a copy, i.e. do NOT change the peptide sequence!
-            if (seqan::isAmbiguous(seqan::AAString(seq.c_str())))
-            { // do not quit here, to show the user all sequences .. only quit after loop
-              OPENMS_LOG_ERROR << "Peptide sequence '" << it2->getSequence() << "' contains one or more ambiguous amino acids (B|J|Z|X).\n";
-              has_illegal_AAs = true;
-            }
-            if (IL_equivalent_) // convert L to I;
-            {
-              seq.substitute('L', 'I');
-            }
-            appendValue(pep_DB, seq.c_str());
-          }
-        }
-        if (has_illegal_AAs)
+        for (const String& seq : pep_sequences)
         {
-          OPENMS_LOG_ERROR << "One or more peptides contained illegal amino acids. This is not allowed!"
-                    << "\nPlease either remove the peptide or replace it with one of the unambiguous ones (while allowing for ambiguous AA's to match the protein)." << std::endl;;
+          appendValue(pep_DB, seq.c_str());
         }
 
         OPENMS_LOG_INFO << "Mapping " << length(pep_DB) << " peptides to " << (proteins.size() == PROTEIN_CACHE_SIZE ? "? (unknown number of)" : String(proteins.size()))  << " proteins." << std::endl;
@@ -409,30 +357,7 @@ public:
               // test if protein was a hit
               Size hits_total = func_threads.filter_passed + func_threads.filter_rejected;
 
-              // check if there are stretches of 'X'
-              if (prot.has('X'))
-              {
-                // create chunks of the protein (splitting it at stretches of 'X..X') and feed them to AC one by one
-                size_t offset = -1, start = 0;
-                while ((offset = prot.find(jumpX, offset + 1)) != std::string::npos)
-                {
-                  //std::cout << "found X..X at " << offset << " in protein " << proteins[i].identifier << "\n";
-                  addHits_(fuzzyAC, pattern, pep_DB, prot.substr(start, offset + jumpX.size() - start), prot, prot_idx, (int)start, func_threads);
-                  // skip ahead while we encounter more X...
-                  while (offset + jumpX.size() < prot.size() && prot[offset + jumpX.size()] == 'X') ++offset;
-                  start = offset;
-                  //std::cout << "  new start: " << start << "\n";
-                }
-                // last chunk
-                if (start < prot.size())
-                {
-                  addHits_(fuzzyAC, pattern, pep_DB, prot.substr(start), prot, prot_idx, (int)start, func_threads);
-                }
-              }
-              else
-              {
-                addHits_(fuzzyAC, pattern, pep_DB, prot, prot, prot_idx, 0, func_threads);
-              }
+              searchProtein_(fuzzyAC, pattern, pep_DB, prot, prot_idx, jumpX, func_threads);
               // was protein found?
               if (hits_total < func_threads.filter_passed + func_threads.filter_rejected)
               {
@@ -478,250 +403,30 @@ public:
 
       } // end local scope
 
-      //
-      //   do mapping 
-      //
-      // index existing proteins
-      Map<String, Size> runid_to_runidx; // identifier to index
-      for (Size run_idx = 0; run_idx < prot_ids.size(); ++run_idx)
-      {
-        runid_to_runidx[prot_ids[run_idx].getIdentifier()] = run_idx;
-      }
-      
-      // for peptides --> proteins
-      Size stats_matched_unique(0);
-      Size stats_matched_multi(0);
-      Size stats_unmatched(0);    // no match to DB
-      Size stats_count_m_t(0);    // match to Target DB
-      Size stats_count_m_d(0);    // match to Decoy DB
-      Size stats_count_m_td(0);   // match to T+D DB
-
-      Map<Size, std::set<Size> > runidx_to_protidx; // in which protID do appear which proteins (according to mapped peptides)
-
-      Size pep_idx(0);
-      for (std::vector<PeptideIdentification>::iterator it1 = pep_ids.begin(); it1 != pep_ids.end(); ++it1)
-      {
-        // which ProteinIdentification does the peptide belong to?
-        Size run_idx = runid_to_runidx[it1->getIdentifier()];
-
-        std::vector<PeptideHit>& hits = it1->getHits();
-
-        for (std::vector<PeptideHit>::iterator it2 = hits.begin(); it2 != hits.end(); ++it2)
-        {
-          // clear protein accessions
-          it2->setPeptideEvidences(std::vector<PeptideEvidence>());
-          
-          //
-          // is this a decoy hit?
-          //
-          bool matches_target(false);
-          bool matches_decoy(false);
-
-          std::set<Size> prot_indices; /// protein hits of this peptide
-          // add new protein references
-          for (std::set<PeptideProteinMatchInformation>::const_iterator it_i = func.pep_to_prot[pep_idx].begin();
-            it_i != func.pep_to_prot[pep_idx].end(); ++it_i)
-          {
-            prot_indices.insert(it_i->protein_index);
-            const String& accession = protein_accessions[it_i->protein_index];
-            PeptideEvidence pe(accession, it_i->position, it_i->position + (int)it2->getSequence().size() - 1, it_i->AABefore, it_i->AAAfter);
-            it2->addPeptideEvidence(pe);
-
-            runidx_to_protidx[run_idx].insert(it_i->protein_index); // fill protein hits
-
-            if (protein_is_decoy[it_i->protein_index])
-            {
-              matches_decoy = true;
-            }
-            else
-            {
-              matches_target = true;
-            }
-          }
-
-          if (matches_decoy && matches_target)
-          {
-            it2->setMetaValue("target_decoy", "target+decoy");
-            ++stats_count_m_td;
-          }
-          else if (matches_target)
-          {
-            it2->setMetaValue("target_decoy", "target");
-            ++stats_count_m_t;
-          }
-          else if (matches_decoy)
-          {
-            it2->setMetaValue("target_decoy", "decoy");
-            ++stats_count_m_d;
-          } // else: could match to no protein (i.e. both are false)
-          //else ... // not required (handled below; see stats_unmatched);
-
-          if (prot_indices.size() == 1)
-          {
-            it2->setMetaValue("protein_references", "unique");
-            ++stats_matched_unique;
-          }
-          else if (prot_indices.size() > 1)
-          {
-            it2->setMetaValue("protein_references", "non-unique");
-            ++stats_matched_multi;
-          }
-          else
-          {
-            it2->setMetaValue("protein_references", "unmatched");
-            ++stats_unmatched;
-            if (stats_unmatched < 15) OPENMS_LOG_INFO << "Unmatched peptide: " << it2->getSequence() << "\n";
-            else if (stats_unmatched == 15) OPENMS_LOG_INFO << "Unmatched peptide: ...\n";
-          }
-
-          ++pep_idx; // next hit
-        }
-
-      }
-
-      Size total_peptides = stats_count_m_t + stats_count_m_d + stats_count_m_td + stats_unmatched;
-      OPENMS_LOG_INFO << "-----------------------------------\n";
-      OPENMS_LOG_INFO << "Peptide statistics\n";
-      OPENMS_LOG_INFO << "\n";
-      OPENMS_LOG_INFO << "  unmatched                : " << stats_unmatched << " (" << stats_unmatched * 100 / total_peptides << " %)\n";
-      OPENMS_LOG_INFO << "  target/decoy:\n";
-      OPENMS_LOG_INFO << "    match to target DB only: " << stats_count_m_t << " (" << stats_count_m_t * 100 / total_peptides << " %)\n";
-      OPENMS_LOG_INFO << "    match to decoy DB only : " << stats_count_m_d << " (" << stats_count_m_d * 100 / total_peptides << " %)\n";
-      OPENMS_LOG_INFO << "    match to both          : " << stats_count_m_td << " (" << stats_count_m_td * 100 / total_peptides << " %)\n";
-      OPENMS_LOG_INFO << "\n";
-      OPENMS_LOG_INFO << "  mapping to proteins:\n";
-      OPENMS_LOG_INFO << "    no match (to 0 protein)         : " << stats_unmatched << "\n";
-      OPENMS_LOG_INFO << "    unique match (to 1 protein)     : " << stats_matched_unique << "\n";
-      OPENMS_LOG_INFO << "    non-unique match (to >1 protein): " << stats_matched_multi << std::endl;
-
-      /// for proteins --> peptides
-      Size stats_matched_proteins(0), stats_matched_new_proteins(0), stats_orphaned_proteins(0), stats_proteins_target(0), stats_proteins_decoy(0);
-
-      // all peptides contain the correct protein hit references, now update the protein hits
-      for (Size run_idx = 0; run_idx < prot_ids.size(); ++run_idx)
-      {
-        std::set<Size> masterset = runidx_to_protidx[run_idx]; // all protein matches from above
-
-        std::vector<ProteinHit>& phits = prot_ids[run_idx].getHits();
-        {
-          // go through existing protein hits and count orphaned proteins (with no peptide hits)
-          std::vector<ProteinHit> orphaned_hits;
-          for (std::vector<ProteinHit>::iterator p_hit = phits.begin(); p_hit != phits.end(); ++p_hit)
-          {
-            const String& acc = p_hit->getAccession();
-            if (!acc_to_prot.has(acc)) // acc_to_prot only contains found proteins from current run
-            { // old hit is orphaned
-              ++stats_orphaned_proteins;
-              if (keep_unreferenced_proteins_)
-              {
-                p_hit->setMetaValue("target_decoy", "");
-                orphaned_hits.push_back(*p_hit);
-              }
-            }
-          }
-          // only keep orphaned hits (if any)
-          phits = orphaned_hits;
-        }
-
-        // add new protein hits
-        FASTAFile::FASTAEntry fe;
-        phits.reserve(phits.size() + masterset.size());
-        for (std::set<Size>::const_iterator it = masterset.begin(); it != masterset.end(); ++it)
-        {
-          ProteinHit hit;
-          hit.setAccession(protein_accessions[*it]);
-          
-          if (write_protein_sequence_ || write_protein_description_)
-          {
-            proteins.readAt(fe, *it);
-            if (write_protein_sequence_)
-            {
-              hit.setSequence(fe.sequence);
-            } // no else, since sequence is empty by default
-            if (write_protein_description_)
-            {
-              hit.setDescription(fe.description);
-            } // no else, since description is empty by default
-          }
-          if (protein_is_decoy[*it])
-          {
-            hit.setMetaValue("target_decoy", "decoy");
-            ++stats_proteins_decoy;
-          }
-          else
-          {
-            hit.setMetaValue("target_decoy", "target");
-            ++stats_proteins_target;
-          }
-          phits.push_back(hit);
-          ++stats_matched_new_proteins;
-        }
-        stats_matched_proteins += phits.size();
-      }
-
-
-      OPENMS_LOG_INFO << "-----------------------------------\n";
-      OPENMS_LOG_INFO << "Protein statistics\n";
-      OPENMS_LOG_INFO << "\n";
-      OPENMS_LOG_INFO << "  total proteins searched: " << proteins.size() << "\n";
-      OPENMS_LOG_INFO << "  matched proteins       : " << stats_matched_proteins << " (" << stats_matched_new_proteins << " new)\n";
-      if (stats_matched_proteins)
-      { // prevent Division-by-0 Exception
-        OPENMS_LOG_INFO << "  matched target proteins: " << stats_proteins_target << " (" << stats_proteins_target * 100 / stats_matched_proteins << " %)\n";
-        OPENMS_LOG_INFO << "  matched decoy proteins : " << stats_proteins_decoy << " (" << stats_proteins_decoy * 100 / stats_matched_proteins << " %)\n";
-      }
-      OPENMS_LOG_INFO << "  orphaned proteins      : " << stats_orphaned_proteins << (keep_unreferenced_proteins_ ? " (all kept)" : " (all removed)\n");
-      OPENMS_LOG_INFO << "-----------------------------------" << std::endl;
-
+      return annotate_(func, acc_to_prot, protein_accessions, protein_is_decoy, invalid_protein_sequence, proteins.size(),
+                       [&proteins](Size index, FASTAFile::FASTAEntry& fe) { proteins.readAt(fe, index); },
+                       prot_ids, pep_ids);
+    }
 
-      /// exit if no peptides were matched to decoy
-      bool has_error = false;
+    /**
+    @brief Re-index peptide identifications using a (persistent) protein database index.
 
-      if (invalid_protein_sequence)
-      {
-        OPENMS_LOG_ERROR << "Error: One or more protein sequences contained the characters '[' or '(', which are illegal in protein sequences."
-                 << "\nPeptide hits might be masked by these characters (which usually indicate presence of modifications).\n";
-        has_error = true;
-      }
+    Same as run<T>(), but proteins are taken from a ProteinDBIndex (see ProteinDBIndex::build() and ProteinDBIndex::load()),
+    which avoids parsing the FASTA file and building the search structures on every call.
 
-      if ((stats_count_m_d + stats_count_m_td) == 0)
-      {
-        String msg("No peptides were matched to the decoy portion of the database! Did you provide the correct concatenated database? Are your 'decoy_string' (=" + String(decoy_string_) + ") and 'decoy_string_position' (=" + String(param_.getValue("decoy_string_position")) + ") settings correct?");
-        if (missing_decoy_action_ == "error")
-        {
-          OPENMS_LOG_ERROR << "Error: " << msg << "\nSet 'missing_decoy_action' to 'warn' if you are sure this is ok!\nAborting ..." << std::endl;
-          has_error = true;
-        }
-        else if (missing_decoy_action_ == "warn")
-        {
-          OPENMS_LOG_WARN << "Warn: " << msg << "\nSet 'missing_decoy_action' to 'error' if you want to elevate this to an error!" << std::endl;
-        }
-        else // silent
-        {
-        }
-      }
+    Exact and I/L-equivalent matches are looked up in the suffix array of the index (in parallel over peptides).
+    The Aho-Corasick search is only used where tolerance is required: for all proteins if @p mismatches_max is set,
+    otherwise only for proteins containing ambiguous amino acids (B|Z|X, and J unless @p IL_equivalent is set) if @p aaa_max > 0.
 
-      if ((!allow_unmatched_) && (stats_unmatched > 0))
-      {
-        OPENMS_LOG_ERROR << "PeptideIndexer found unmatched peptides, which could not be associated to a protein.\n"
-                  << "Potential solutions:\n"
-                  << "   - check your FASTA database for completeness\n"
-                  << "   - set 'enzyme:specificity' to match the identification parameters of the search engine\n"
-                  << "   - some engines (e.g. X! Tandem) employ loose cutting rules generating non-tryptic peptides;\n"
-                  << "     if you trust them, disable enzyme specificity\n"
-                  << "   - increase 'aaa_max' to allow more ambiguous amino acids\n"
-                  << "   - as a last resort: use the 'allow_unmatched' option to accept unmatched peptides\n"
-                  << "     (note that unmatched peptides cannot be used for FDR calculation or quantification)\n";
-        has_error = true;
-      }
+    If no decoy string was given, the one found during building of the index is used.
+    Protein sequences written with @p write_protein_sequence do not contain '*' characters.
 
-      if (has_error)
-      {
-        OPENMS_LOG_ERROR << "Result files will be written, but PeptideIndexer will exit with an error code." << std::endl;
-        return UNEXPECTED_RESULT;
-      }
-      return EXECUTION_OK;
-    }
+    @param index The protein database index
+    @param prot_ids Resulting protein identifications associated to pep_ids (will be re-written completely)
+    @param pep_ids Peptide identifications which should be search within @p index and then linked to @p prot_ids
+    @return Exit status codes.
+    */
+    ExitCodes run(const ProteinDBIndex& index, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids);
 
      const String& getDecoyString() const;
 
@@ -825,6 +530,54 @@ public:
       }
     }
 
+    /// searches a protein with the Aho-Corasick automaton, splitting it at stretches of 'X' (which cost a lot of time)
+    inline void searchProtein_(AhoCorasickAmbiguous& fuzzyAC, const AhoCorasickAmbiguous::FuzzyACPattern& pattern, const AhoCorasickAmbiguous::PeptideDB& pep_DB, const String& prot, SignedSize idx_prot, const std::string& jumpX, FoundProteinFunctor& func_threads) const
+    {
+      // check if there are stretches of 'X'
+      if (prot.has('X'))
+      {
+        // create chunks of the protein (splitting it at stretches of 'X..X') and feed them to AC one by one
+        size_t offset = -1, start = 0;
+        while ((offset = prot.find(jumpX, offset + 1)) != std::string::npos)
+        {
+          //std::cout << "found X..X at " << offset << " in protein " << proteins[i].identifier << "\n";
+          addHits_(fuzzyAC, pattern, pep_DB, prot.substr(start, offset + jumpX.size() - start), prot, idx_prot, (int)start, func_threads);
+          // skip ahead while we encounter more X...
+          while (offset + jumpX.size() < prot.size() && prot[offset + jumpX.size()] == 'X') ++offset;
+          start = offset;
+          //std::cout << "  new start: " << start << "\n";
+        }
+        // last chunk
+        if (start < prot.size())
+        {
+          addHits_(fuzzyAC, pattern, pep_DB, prot.substr(start), prot, idx_prot, (int)start, func_threads);
+        }
+      }
+      else
+      {
+        addHits_(fuzzyAC, pattern, pep_DB, prot, prot, idx_prot, 0, func_threads);
+      }
+    }
+
+    /// sets decoy string and position from an automatic detection result (or the default, if detection failed)
+    void setDecoyString_(DecoyHelper::Result r);
+
+    /// the enzyme to check cleavage sites with; corrects the parameters for X! Tandem (@p xtandem_fix_parameters) and MSGF+ results
+    ProteaseDigestion getEnzyme_(const std::vector<ProteinIdentification>& prot_ids, bool& xtandem_fix_parameters) const;
+
+    /// unmodified sequences of all peptide hits (I/L converted if required), in order; reports (but accepts) ambiguous amino acids
+    void collectPeptideSequences_(const std::vector<PeptideIdentification>& pep_ids, std::vector<String>& pep_sequences) const;
+
+    /**
+      @brief Annotates peptide and protein hits with the search results in @p func, and reports statistics
+
+      @param read_protein Callback to retrieve a protein (by index), used for writing sequences and descriptions
+    */
+    ExitCodes annotate_(FoundProteinFunctor& func, const Map<String, Size>& acc_to_prot, const std::vector<std::string>& protein_accessions,
+                        const std::vector<bool>& protein_is_decoy, bool invalid_protein_sequence, Size protein_count,
+                        const std::function<void(Size, FASTAFile::FASTAEntry&)>& read_protein,
+                        std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids) const;
+
     void updateMembers_() override;
 
     String decoy_string_;
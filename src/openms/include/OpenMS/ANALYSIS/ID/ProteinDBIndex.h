@@ -0,0 +1,253 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/FASTAContainer.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace OpenMS
+{
+
+/**
+  @brief A persistent suffix array index over a protein database, for fast exact peptide lookups.
+
+  The index holds the accessions, descriptions and sequences of all proteins of a FASTA database (in file order),
+  and a suffix array over the concatenated sequences. It is built once (build()), stored to disk (store())
+  and memory-mapped on later use (load()), so neither the FASTA file has to be parsed again, nor do the
+  index data have to be copied into memory (pages are read on demand and shared between processes).
+
+  Lookups (findPeptide()) return all positions where a peptide occurs exactly, or with 'I', 'L' and 'J' treated
+  as the same residue (I/L-equivalent matching). The suffix array is sorted with I/L/J-equivalence, so both kinds of
+  lookups are served by the same index. Sequences are stored as in the FASTA file, but without '*' characters
+  (just as PeptideIndexing sees them).
+
+  Ambiguous amino acids (B, Z, X, and J unless I/L-equivalence is used) are not resolved by the index.
+  For each protein, getFlags() tells whether it contains such residues, so a tolerant search can be restricted to those proteins.
+
+  The index also stores the result of DecoyHelper::findDecoyString() for the database and (optionally) information about
+  the source file (setSourceInfo()), which can be used to detect an outdated index.
+
+  Suffixes are sorted up to a depth of getSortDepth() residues; longer peptides are verified residue by residue.
+  The concatenated sequences must not exceed 4 G residues.
+
+  @ingroup Analysis_ID
+*/
+class OPENMS_DLLAPI ProteinDBIndex
+{
+public:
+
+  /// Properties of a protein sequence (bit flags, see getFlags())
+  enum ProteinFlags
+  {
+    HAS_AMBIGUOUS_AA = 1, ///< contains 'B', 'Z' or 'X'
+    HAS_J = 2, ///< contains 'J' (ambiguous, unless I/L-equivalence is used)
+    HAS_MODIFICATION = 4 ///< contains '[' or '(', which indicates modifications (illegal in a protein sequence)
+  };
+
+  /// Default constructor (creates an empty index)
+  ProteinDBIndex();
+
+  /// Destructor
+  ~ProteinDBIndex();
+
+  /// no copies (the index might be memory-mapped)
+  ProteinDBIndex(const ProteinDBIndex&) = delete;
+  ProteinDBIndex& operator=(const ProteinDBIndex&) = delete;
+
+  /**
+    @brief Builds the index from a protein database
+
+    @param proteins The proteins, either read piecewise from a FASTA file or from an existing vector of FASTAEntries.
+  */
+  template<typename T>
+  void build(FASTAContainer<T>& proteins)
+  {
+    clear();
+    decoy_ = DecoyHelper::findDecoyString(proteins);
+    proteins.reset();
+
+    while (true)
+    {
+      proteins.cacheChunk(PROTEIN_CACHE_SIZE);
+      if (!proteins.activateCache()) break;
+      for (Size i = 0; i < proteins.chunkSize(); ++i)
+      {
+        addProtein_(proteins.chunkAt(i));
+      }
+    }
+    proteins.reset();
+    buildSuffixArray_();
+  }
+
+  /// Builds the index from a vector of proteins
+  void build(const std::vector<FASTAFile::FASTAEntry>& proteins);
+
+  /**
+    @brief Stores the index in a binary file, which can be memory-mapped by load()
+
+    The file must not be the one this index is currently mapped from.
+
+    @exception Exception::UnableToCreateFile is thrown if the file cannot be written
+  */
+  void store(const String& filename) const;
+
+  /**
+    @brief Memory-maps an index file created by store()
+
+    @exception Exception::FileNotFound is thrown if the file does not exist
+    @exception Exception::ParseError is thrown if the file is not a valid index (or was created on a platform with different endianness)
+  */
+  void load(const String& filename);
+
+  /// Removes all data (and unmaps a loaded file)
+  void clear();
+
+  /// Is the index memory-mapped from a file?
+  bool isMemoryMapped() const;
+
+  /// Number of proteins
+  Size size() const;
+
+  /// Is the index empty?
+  bool empty() const;
+
+  /// Total number of residues (of all proteins)
+  Size residueCount() const;
+
+  /// The protein accession (identifier) of protein @p index
+  String getAccession(Size index) const;
+
+  /// The protein description of protein @p index
+  String getDescription(Size index) const;
+
+  /// The sequence of protein @p index (without '*'); with 'L' and 'J' replaced by 'I' if @p IL_equivalent is set
+  String getSequence(Size index, bool IL_equivalent = false) const;
+
+  /// The length of the sequence of protein @p index
+  Size getSequenceLength(Size index) const;
+
+  /// The ProteinFlags of protein @p index
+  UInt getFlags(Size index) const;
+
+  /// The number of residues suffixes are sorted by (longer peptides are verified explicitly)
+  Size getSortDepth() const;
+
+  /// The decoy string and position found in the database during build()
+  const DecoyHelper::Result& getDecoyInfo() const;
+
+  /// Set information about the source database file, e.g. size and modification time (stored with the index)
+  void setSourceInfo(UInt64 file_size, Int64 timestamp);
+
+  /// Source file information set with setSourceInfo() (0 if unknown)
+  std::pair<UInt64, Int64> getSourceInfo() const;
+
+  /**
+    @brief Finds all occurrences of @p peptide in the proteins
+
+    @param peptide The peptide sequence (unmodified, one letter code)
+    @param IL_equivalent Treat 'I', 'L' and 'J' as the same residue
+    @param hits Resulting pairs of protein index and position in the protein sequence (appended; unordered)
+  */
+  void findPeptide(const String& peptide, bool IL_equivalent, std::vector<std::pair<Size, Size> >& hits) const;
+
+protected:
+
+  /// number of proteins read at once during build()
+  static const Size PROTEIN_CACHE_SIZE = 400000;
+
+  /// appends a protein to the (not yet indexed) data
+  void addProtein_(const FASTAFile::FASTAEntry& protein);
+
+  /// sorts the suffixes and sets up the views on the owned data
+  void buildSuffixArray_();
+
+  /// points the views to the owned data
+  void setViews_();
+
+  /// finds the range of suffixes starting with @p peptide (I/L/J-equivalent, up to the sort depth)
+  std::pair<Size, Size> findRange_(const String& peptide) const;
+
+  /// the protein containing position @p pos of the concatenated sequences
+  Size proteinOf_(Size pos) const;
+
+  // owned data (empty if memory-mapped)
+  std::vector<UInt64> protein_starts_data_; ///< start of each protein in the concatenated sequences (+ end)
+  std::vector<UInt64> accession_offsets_data_; ///< start of each accession in the accession data (+ end)
+  std::vector<UInt64> description_offsets_data_; ///< start of each description in the description data (+ end)
+  std::vector<std::uint8_t> flags_data_; ///< ProteinFlags of each protein
+  std::string accession_data_; ///< concatenated accessions
+  std::string description_data_; ///< concatenated descriptions
+  std::string text_data_; ///< concatenated sequences, each terminated by '\0'
+  std::vector<UInt32> suffix_array_data_; ///< sorted suffixes (positions in text_data_)
+
+  // views on the data (owned or memory-mapped)
+  Size protein_count_;
+  Size text_length_;
+  Size suffix_count_;
+  const UInt64* protein_starts_;
+  const UInt64* accession_offsets_;
+  const UInt64* description_offsets_;
+  const std::uint8_t* flags_;
+  const char* accessions_;
+  const char* descriptions_;
+  const char* text_;
+  const UInt32* suffix_array_;
+
+  Size sort_depth_; ///< number of residues suffixes are sorted by
+  DecoyHelper::Result decoy_; ///< decoy information of the database
+  UInt64 source_size_; ///< size of the source file (0 if unknown)
+  Int64 source_timestamp_; ///< modification time of the source file (0 if unknown)
+
+  std::unique_ptr<boost::interprocess::mapped_region> region_; ///< the memory-mapped index file (if loaded)
+};
+
+} // namespace OpenMS
+
@@ -36,6 +36,7 @@ PeptideProteinResolution.h
 PrecursorPurity.h
 ProtonDistributionModel.h
 PeptideIndexing.h
+ProteinDBIndex.h
 PercolatorFeatureSetHelper.h
 SimpleSearchEngineAlgorithm.h
 SiriusAdapterAlgorithm.h
@@ -71,6 +71,10 @@ public:
 
     /**
      * @brief normalizes the maps of the consensusMap
+     *
+     * Filtering, the median computation (per map) and the normalization (per consensus feature)
+     * run in parallel if OpenMP is enabled.
+     *
      * @param map ConsensusMap
      * @param method whether to use scaling or shifting to same median
      * @param acc_filter string describing the regular expression for filtering accessions
@@ -61,6 +61,11 @@ public:
 
     /**
      * @brief normalizes the maps of the consensusMap
+     *
+     * The intensities are extracted once per map (column-wise), the maps are sorted and
+     * ranked in parallel (if OpenMP is enabled) and the normalized intensities are written
+     * back to the feature handles in place. The result does not depend on the number of threads.
+     *
      * @param map ConsensusMap
      */
     static void normalizeMaps(ConsensusMap & map);
@@ -86,6 +91,10 @@ public:
      * @param map ConsensusMap the map to be updated
      */
     static void setNormalizedIntensityValues(const std::vector<std::vector<double> > & feature_ints, ConsensusMap & map);
+
+protected:
+    /// returns data point @p i of @p data_in resampled to @p n_resampling_points points (see resample(); @p data_in must not be empty)
+    static double resampledValue_(const std::vector<double> & data_in, UInt n_resampling_points, UInt i);
   };
 
 } // namespace OpenMS
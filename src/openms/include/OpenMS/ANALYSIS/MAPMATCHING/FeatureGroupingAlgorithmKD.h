@@ -171,6 +171,10 @@ private:
       The algorithm takes a number of feature or consensus maps and searches
       for corresponding (consensus) features across different maps.
 
+      The data is split into partitions in m/z (see @p nr_partitions), which are
+      processed in parallel if OpenMP is enabled. The result does not depend on
+      the number of threads.
+
       @htmlinclude OpenMS_FeatureGroupingAlgorithmKD.parameters
 
       @ingroup FeatureGrouping
@@ -231,14 +235,16 @@ private:
     template <typename MapType>
     void group_(const std::vector<MapType>& input_maps, ConsensusMap& out);
 
-    /// Run the actual clustering algorithm
-    void runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out);
+    /// Run the actual clustering algorithm (using the distance functor @p feature_distance, so partitions can be processed concurrently)
+    void runClustering_(const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance, ConsensusMap& out) const;
 
-    /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these
-    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data);
+    /// Update maximum possible sizes of potential consensus features for indices specified in @p update_these (@p neighborhoods: neighbor indices of all points)
+    void updateClusterProxies_(std::set<ClusterProxyKD>& potential_clusters, std::vector<ClusterProxyKD>& cluster_for_idx, const std::set<Size>& update_these, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data,
+                               const std::vector<std::vector<Size> >& neighborhoods, FeatureDistance& feature_distance) const;
 
-    /// Compute the current best cluster with center index @p i (mutates @p proxy and @p cf_indices)
-    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const;
+    /// Compute the current best cluster with center index @p i and neighbor indices @p neighbors (mutates @p proxy and @p cf_indices)
+    ClusterProxyKD computeBestClusterForCenter_(Size i, std::vector<Size>& cf_indices, const std::vector<Int>& assigned, const KDTreeFeatureMaps& kd_data,
+                                                const std::vector<Size>& neighbors, FeatureDistance& feature_distance) const;
 
     /// Construct consensus feature and add to out map
     void addConsensusFeature_(const std::vector<Size>& indices, const KDTreeFeatureMaps& kd_data, ConsensusMap& out) const;
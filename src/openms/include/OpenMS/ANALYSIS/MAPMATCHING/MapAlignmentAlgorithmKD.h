@@ -71,6 +71,12 @@ public:
   /// Compute data points needed for RT transformation in the current @p kd_data, add to fit_data_
   void addRTFitData(const KDTreeFeatureMaps& kd_data);
 
+  /// Compute data points needed for RT transformation in @p kd_data, store them in @p fit_data (one entry per map; fit_data_ is not changed, so this can be called concurrently)
+  void getRTFitData(const KDTreeFeatureMaps& kd_data, std::vector<TransformationModel::DataPoints>& fit_data) const;
+
+  /// Add data points computed by getRTFitData() to fit_data_
+  void addRTFitData(const std::vector<TransformationModel::DataPoints>& fit_data);
+
   /// Fit LOWESS to fit_data_, store final models in transformations_
   void fitLOWESS();
 
@@ -63,6 +63,8 @@ namespace OpenMS
     For each map cubic spline smoothing is used to convert the mapping to a smooth function.
     Retention times of each map are transformed by applying the smoothed function.
 
+    If OpenMP is enabled, the pairwise distances, independent cluster alignments (nodes of the tree that do not depend on each other's result) and the final transformations are computed in parallel. The results do not depend on the number of threads.
+
     @htmlinclude OpenMS_MapAlignmentAlgorithmTreeGuided.parameters
 
     @ingroup MapAlignment
@@ -127,6 +129,16 @@ protected:
     // Update defaults model_type_, model_param_ and align_algorithm_
     void updateMembers_() override;
 
+    /**
+     * @brief Align the two clusters merged by @p node.
+     *
+     * The cluster with the smaller 10/90 percentile RT range is transformed onto the other one, the combined map is stored at the smaller index of both clusters (the map at the larger index is cleared).
+     * Only the entries of @p feature_maps_transformed and @p map_sets of the two clusters are changed, so nodes with disjoint clusters can be aligned concurrently (with separate @p aligner objects).
+    */
+    void alignClusters_(const BinaryTreeNode& node, std::vector<FeatureMap>& feature_maps_transformed,
+                        const std::vector<std::vector<double>>& maps_ranges, std::vector<std::vector<Size>>& map_sets,
+                        MapAlignmentAlgorithmIdentification& aligner) const;
+
     /// Type of transformation model
     String model_type_;
 
@@ -62,6 +62,24 @@ namespace OpenMS
                                         const TransformationDescription& trafo,
                                         bool store_original_rt = false);
 
+    /**
+       @brief Applies the given transformation to a single spectrum
+
+       Can be used to transform spectra on the fly, e.g. in an MSDataTransformingConsumer.
+    */
+    static void transformRetentionTimes(MSSpectrum& spectrum,
+                                        const TransformationDescription& trafo,
+                                        bool store_original_rt = false);
+
+    /**
+       @brief Applies the given transformation to all data points of a single chromatogram
+
+       Can be used to transform chromatograms on the fly, e.g. in an MSDataTransformingConsumer.
+    */
+    static void transformRetentionTimes(MSChromatogram& chromatogram,
+                                        const TransformationDescription& trafo,
+                                        bool store_original_rt = false);
+
     /// Applies the given transformation to a feature map
     static void transformRetentionTimes(
       FeatureMap& fmap, const TransformationDescription& trafo,
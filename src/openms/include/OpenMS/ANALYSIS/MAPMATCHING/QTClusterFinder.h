@@ -44,6 +44,7 @@
 #include <boost/unordered_map.hpp>
 
 #include <list>
+#include <queue>
 #include <vector>
 #include <set>
 #include <utility> // for pair<>
@@ -91,7 +92,12 @@ namespace OpenMS
    This algorithm includes a number of optimizations to reduce run-time:
    @li two-dimensional hashing of features,
    @li a look-up table for feature distances,
-   @li a variant of QT clustering that requires only one round of clustering.
+   @li a variant of QT clustering that requires only one round of clustering,
+   @li a priority queue of cluster qualities to find the best cluster,
+   @li partitioning of the data in m/z (see @p nr_partitions); partitions are
+       processed in parallel if OpenMP is enabled (as is the initial computation
+       of the clusters within a partition). The result does not depend on the
+       number of threads.
 
    @see FeatureGroupingAlgorithmQT
 
@@ -116,6 +122,28 @@ private:
 
     typedef HashGrid<OpenMS::GridFeature*> Grid;
 
+    /// Entry of the cluster queue: quality of a cluster (at the time of insertion) and its index
+    typedef std::pair<double, Size> ClusterQueueEntry;
+
+    /// Orders queue entries by quality; for equal qualities, the cluster with the smaller index comes first
+    struct ClusterQueueCompare
+    {
+      bool operator()(const ClusterQueueEntry& left, const ClusterQueueEntry& right) const
+      {
+        return (left.first < right.first) ||
+               ((left.first == right.first) && (left.second > right.second));
+      }
+    };
+
+    /**
+       @brief Priority queue of clusters (best cluster on top)
+
+       When the quality of a cluster changes, a new entry is added; outdated
+       entries and entries of invalid clusters are skipped when they reach the top.
+    */
+    typedef std::priority_queue<ClusterQueueEntry, std::vector<ClusterQueueEntry>,
+                                ClusterQueueCompare> ClusterQueue;
+
     /// Number of input maps
     Size num_maps_;
 
@@ -140,19 +168,24 @@ private:
     /**
        @brief Calculates the distance between two grid features.
     */
-    double getDistance_(const OpenMS::GridFeature* left, const
-        OpenMS::GridFeature* right);
+    double getDistance_(FeatureDistance& feature_distance,
+        const OpenMS::GridFeature* left, const OpenMS::GridFeature* right);
 
     /// Sets algorithm parameters
     void setParameters_(double max_intensity, double max_mz);
 
-    /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    /**
+       @brief Generates a consensus feature from the best cluster and updates the clustering
+
+       @return False if there are no more valid clusters (@p feature is not set then)
+    */
+    bool makeConsensusFeature_(std::vector<QTCluster>& clustering,
+                               ClusterQueue& cluster_queue,
                                ConsensusFeature& feature,
                                ElementMapping& element_mapping, Grid&);
 
-    /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    /// Computes an initial QT clustering of the points in the hash grid (in parallel, if OpenMP is enabled)
+    void computeClustering_(Grid& grid, std::vector<QTCluster>& clustering);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
@@ -163,9 +196,9 @@ private:
     void run_internal_(const std::vector<MapType>& input_maps,
                        ConsensusMap& result_map, bool do_progress);
 
-    /// Adds elements to the cluster based on the elements hashed in the grid
+    /// Adds elements to the cluster based on the elements hashed in the grid (using the given distance functor)
     void addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-      const OpenMS::GridFeature* center_feature);
+      const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance);
 
 protected:
 
@@ -125,6 +125,15 @@ public:
     */
     double apply(double value) const;
 
+    /**
+      @brief Applies the transformation to @p n values.
+
+      Same as calling apply(double) for each value, but faster for many values
+      (especially if they are sorted), see TransformationModel::evaluate().
+      @p in and @p out may be the same array.
+    */
+    void apply(const double* in, double* out, Size n) const;
+
     /// Gets the type of the fitted model
     const String& getModelType() const;
 
@@ -101,6 +101,18 @@ namespace OpenMS
 
     /// Evaluates the model at the given value
     virtual double evaluate(double value) const;
+
+    /**
+      @brief Evaluates the model at @p n values
+
+      Gives the same results as calling evaluate(double) for each value. Derived models may implement this more
+      efficiently, e.g. as a loop that the compiler can vectorize, or by exploiting that the values are sorted.
+
+      @param in Input values (preferably sorted in increasing order)
+      @param out Output array for @p n results (may be the same as @p in)
+      @param n Number of values
+    */
+    virtual void evaluate(const double* in, double* out, Size n) const;
     
     /**
     @brief Weight the data by the given weight function
@@ -65,6 +65,8 @@ public:
     /// Evaluates the model at the given value
     double evaluate(double value) const override;
 
+    using TransformationModel::evaluate;
+
     using TransformationModel::getParameters;
 
     /// Gets the default parameters
@@ -94,6 +94,14 @@ public:
      */
     double evaluate(double value) const override;
 
+    /**
+     * @brief Evaluate the interpolation model at @p n values
+     *
+     * For sorted input, the enclosing data points are found in a single sweep
+     * instead of a binary search per value.
+     */
+    void evaluate(const double* in, double* out, Size n) const override;
+
     /// Gets the default parameters
     static void getDefaultParameters(Param& params);
 
@@ -125,6 +133,24 @@ public:
        */
       virtual double eval(const double& x) const = 0;
 
+      /**
+       * @brief Evaluate the underlying interpolation at a specific position x,
+       * starting the search for the enclosing data points at index @p segment.
+       *
+       * When evaluating at increasing positions, passing the updated
+       * @p segment to the next call avoids a binary search per position.
+       * The default implementation ignores @p segment.
+       *
+       * @param x The position where the interpolation should be evaluated.
+       * @param segment Index of the data point left of (or at) the previous position; updated for @p x.
+       *
+       * @return The interpolated value.
+       */
+      virtual double evalSequential(const double& x, Size& /* segment */) const
+      {
+        return eval(x);
+      }
+
       /**
        * @brief d'tor.
        */
@@ -72,6 +72,9 @@ public:
     /// Evaluates the model at the given value
     double evaluate(double value) const override;
 
+    /// Evaluates the model at @p n values (vectorizable if no weighting is used)
+    void evaluate(const double* in, double* out, Size n) const override;
+
     using TransformationModel::getParameters;
 
     /// Gets the "real" parameters
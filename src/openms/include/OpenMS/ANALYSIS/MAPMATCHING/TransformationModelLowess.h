@@ -66,6 +66,12 @@ public:
       return model_->evaluate(value);
     }
 
+    /// Evaluates the model at @p n values
+    void evaluate(const double* in, double* out, Size n) const override
+    {
+      model_->evaluate(in, out, n);
+    }
+
     using TransformationModel::getParameters;
 
     /// Gets the default parameters
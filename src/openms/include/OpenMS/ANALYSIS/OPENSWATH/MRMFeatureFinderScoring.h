@@ -188,6 +188,17 @@ public:
                          FeatureMap& output,
                          bool ms1only = false);
 
+    /** @brief Returns the hit and miss counts of the spectrum cache of the scorer
+     *
+     * Spectra fetched from the SWATH and MS1 maps during scoring are cached
+     * across all peak groups scored by this object (see
+     * OpenSwathScoring::setSpectrumCacheSize()).
+    */
+    const OpenSwathScoring::SpectrumCacheStatistics& getSpectrumCacheStatistics() const
+    {
+      return scorer_.getSpectrumCacheStatistics();
+    }
+
     /** @brief Set the flag for strict mapping
     */
     void setStrictFlag(bool f)
@@ -311,6 +322,8 @@ private:
     OpenMS::DIAScoring diascoring_;
     OpenMS::SONARScoring sonarscoring_;
     OpenMS::EmgScoring emgscoring_;
+    /// scorer used for all peak groups (keeps its spectrum cache between transition groups)
+    OpenSwathScoring scorer_;
 
     // data
     OpenSwath::SpectrumAccessPtr ms1_map_;
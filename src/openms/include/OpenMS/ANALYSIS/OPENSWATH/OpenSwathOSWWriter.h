@@ -40,6 +40,7 @@
 #include <OpenMS/CONCEPT/UniqueIdGenerator.h>
 
 #include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/DATASTRUCTURES/DataValue.h>
 
 #include <fstream>
 
@@ -54,6 +55,11 @@ namespace OpenMS
     directly linked to the PQP file format described in the TransitionPQPFile class.
     See also OpenSwathTSVWriter for another output format.
 
+    For large outputs, prepareRows and writeRows should be preferred: they
+    collect the typed values of each table in an OSWRows buffer (e.g. one per
+    thread) and insert them with one prepared statement per table instead of
+    formatting and parsing an SQL statement for every row.
+
     The file format has the following tables:
 
       <table>
@@ -124,6 +130,29 @@ namespace OpenMS
 
   public:
 
+    /**
+      @brief Typed values of the OSW tables for a set of features
+
+      Filled by prepareRows and written by writeRows. The cells of each table
+      are stored row by row in the column order of the corresponding INSERT
+      statement, empty values are written as NULL.
+    */
+    struct OPENMS_DLLAPI OSWRows
+    {
+      std::vector<DataValue> feature; ///< FEATURE table
+      std::vector<DataValue> feature_ms1; ///< FEATURE_MS1 table
+      std::vector<DataValue> feature_precursor; ///< FEATURE_PRECURSOR table
+      std::vector<DataValue> feature_ms2; ///< FEATURE_MS2 table
+      std::vector<DataValue> feature_transition; ///< FEATURE_TRANSITION table (transition-level intensities)
+      std::vector<DataValue> feature_transition_uis; ///< FEATURE_TRANSITION table (including UIS scores)
+
+      /// Remove all rows
+      void clear();
+
+      /// Whether no feature has been added
+      bool empty() const;
+    };
+
     OpenSwathOSWWriter(const String& output_filename,
                        const String& input_filename = "inputfile",
                        bool ms1_scores = false,
@@ -205,6 +234,37 @@ namespace OpenMS
      */
     void writeLines(const std::vector<String>& to_osw_output);
 
+    /**
+     * @brief Prepare the rows of a set of features for output
+     *
+     * Same content as prepareLine, but the values are appended to @p rows
+     * without conversion to SQL text. Scores that are not defined are
+     * written as NULL.
+     *
+     * @param pep The compound (peptide/metabolite) used for extraction
+     * @param transition The transition used for extraction
+     * @param output The feature map containing all features (each feature will generate one entry in the output)
+     * @param id The transition group identifier (peptide/metabolite id)
+     * @param rows The buffer the rows are appended to
+     *
+     */
+    void prepareRows(const OpenSwath::LightCompound& /* pep */,
+        const OpenSwath::LightTransition* /* transition */,
+        FeatureMap& output, String id, OSWRows& rows) const;
+
+    /**
+     * @brief Write buffered rows to disk
+     *
+     * All rows are inserted within a single transaction, using one prepared
+     * statement per table.
+     *
+     * @param rows Rows generated by prepareRows
+     *
+     * @note Only call inside an OpenMP critical section
+     *
+     */
+    void writeRows(const OSWRows& rows);
+
   };
 
 }
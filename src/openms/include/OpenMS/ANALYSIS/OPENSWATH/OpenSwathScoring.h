@@ -70,6 +70,13 @@ namespace OpenMS
 
   public:
 
+    /// Hit and miss counts of the spectrum cache (see setSpectrumCacheSize())
+    struct SpectrumCacheStatistics
+    {
+      Size hits = 0; ///< number of spectra returned from the cache
+      Size misses = 0; ///< number of spectra retrieved (and added up) from the map(s)
+    };
+
     /// Constructor
     OpenSwathScoring();
 
@@ -229,7 +236,7 @@ namespace OpenMS
     */
     void calculateDIAIdScores(OpenSwath::IMRMFeature* imrmfeature,
                               const TransitionType & transition,
-                              const std::vector<OpenSwath::SwathMap> swath_maps,
+                              const std::vector<OpenSwath::SwathMap>& swath_maps,
                               OpenMS::DIAScoring & diascoring,
                               OpenSwath_Scores & scores,
                               double drift_lower,
@@ -262,7 +269,7 @@ namespace OpenMS
      * @return Added up spectrum
      *
     */
-    OpenSwath::SpectrumPtr fetchSpectrumSwath(std::vector<OpenSwath::SwathMap> swath_maps,
+    OpenSwath::SpectrumPtr fetchSpectrumSwath(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                               double RT,
                                               int nr_spectra_to_add,
                                               const double drift_lower,
@@ -283,14 +290,65 @@ namespace OpenMS
      * @return Added up spectrum
      *
     */
-    OpenSwath::SpectrumPtr fetchSpectrumSwath(OpenSwath::SpectrumAccessPtr swath_map,
+    OpenSwath::SpectrumPtr fetchSpectrumSwath(const OpenSwath::SpectrumAccessPtr& swath_map,
                                               double RT,
                                               int nr_spectra_to_add,
                                               const double drift_lower,
                                               const double drift_upper);
 
+    /** @brief Sets the maximal number of added-up spectra kept in the spectrum cache
+     *
+     * The spectrum at the apex of a peak group is fetched several times during
+     * scoring (DIA, ion mobility and MS1 scores). fetchSpectrumSwath() keeps the
+     * most recently used spectra, keyed by the map(s), the indices of the added
+     * spectra and the drift time range, so they are retrieved and added up only
+     * once. A size of 0 disables the cache (default: 32).
+     *
+     * @note The spectra are shared with the cache and must not be modified.
+     * The cache is not synchronized, use one object per thread.
+     *
+    */
+    void setSpectrumCacheSize(Size size);
+
+    /// Returns the maximal number of spectra kept in the spectrum cache
+    Size getSpectrumCacheSize() const;
+
+    /// Returns the hit and miss counts of the spectrum cache
+    const SpectrumCacheStatistics& getSpectrumCacheStatistics() const;
+
+    /// Removes all spectra from the cache (the statistics are kept)
+    void clearSpectrumCache();
+
   protected:
 
+    /// A spectrum in the cache with its key
+    struct SpectrumCacheEntry_
+    {
+      /// the map(s) with the index of the spectrum closest to the retention time (defines the added spectra)
+      std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> > spectra;
+      int nr_spectra_to_add;
+      double drift_lower;
+      double drift_upper;
+      OpenSwath::SpectrumPtr spectrum;
+      Size last_used;
+    };
+
+    /// Returns the index of the spectrum closest to @p RT (-1 for an empty map)
+    static int getClosestSpectrumIndex_(const OpenSwath::SpectrumAccessPtr& swath_map, double RT);
+
+    /// Returns the cached spectrum for the given key (null pointer if not in the cache)
+    OpenSwath::SpectrumPtr lookupSpectrum_(const std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> >& spectra,
+                                           int nr_spectra_to_add,
+                                           double drift_lower,
+                                           double drift_upper);
+
+    /// Adds a spectrum to the cache (replacing the least recently used one if the cache is full)
+    void storeSpectrum_(const std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> >& spectra,
+                        int nr_spectra_to_add,
+                        double drift_lower,
+                        double drift_upper,
+                        const OpenSwath::SpectrumPtr& spectrum);
+
     /** @brief Returns an averaged spectrum
      *
      * This function will sum up (add) the intensities of multiple spectra
@@ -311,6 +369,18 @@ namespace OpenMS
                                             const double drift_lower,
                                             const double drift_upper);
 
+    /// Returns the added spectrum around the spectrum with index @p closest_idx (see getAddedSpectra_())
+    OpenSwath::SpectrumPtr getAddedSpectraByIndex_(const OpenSwath::SpectrumAccessPtr& swath_map,
+                                                   int closest_idx,
+                                                   int nr_spectra_to_add,
+                                                   const double drift_lower,
+                                                   const double drift_upper);
+
+    std::vector<SpectrumCacheEntry_> spectrum_cache_;
+    Size spectrum_cache_size_;
+    Size spectrum_cache_tick_;
+    SpectrumCacheStatistics spectrum_cache_statistics_;
+
   };
 }
 
@@ -42,6 +42,7 @@
 
 namespace OpenMS
 {
+  class SqliteConnector;
 
   /**
       @brief This class supports reading and writing of PQP files. 
@@ -231,6 +232,26 @@ private:
     */
     void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false);
 
+    /** @brief Assemble the SELECT statement returning one row per transition
+     *
+     * The column order is fixed (see readPQPInput_) independent of the
+     * optional columns present in the file. If @p minimal is set, columns
+     * that are not needed for a LightTargetedExperiment (annotation,
+     * peptidoforms) are returned as constants and the corresponding joins are
+     * skipped. For @p nr_windows > 0, a WHERE clause restricting the
+     * precursor m/z to the bound parameters ?1/?2, ?3/?4, ... is added.
+     *
+     * @param conn The open database
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     * @param minimal Only select columns required for the Light structures
+     * @param nr_windows Number of precursor m/z ranges to filter on
+     * @param drift_time_exists Output, whether column 29 contains the drift time
+     * @param gene_exists Output, whether column 30 contains the gene name
+     *
+    */
+    String getTransitionSelectSQL_(SqliteConnector& conn, bool legacy_traml_id, bool minimal, Size nr_windows,
+                                   bool& drift_time_exists, bool& gene_exists) const;
+
     /** @brief Write a TargetedExperiment to a file
      *
      * @param filename Name of the output file
@@ -266,13 +287,26 @@ public:
     void convertPQPToTargetedExperiment(const char* filename, OpenMS::TargetedExperiment& targeted_exp, bool legacy_traml_id = false);
 
     /** @brief Read in a PQP file and construct a targeted experiment (Light transition structure)
+     *
+     * The rows are converted directly into the Light structures while they
+     * are read from the database, without materializing the full transition
+     * table in memory first. Each compound and protein is only constructed
+     * once, at its first occurrence.
+     *
+     * Optionally, only transitions whose precursor m/z lies within one of the
+     * provided (lower, upper) m/z ranges (inclusive) are loaded, e.g. the
+     * SWATH isolation windows of the data that will be analyzed. Compounds
+     * and proteins are only added if at least one of their transitions is
+     * loaded. An empty list loads all transitions.
      *
      * @param filename The input file
      * @param targeted_exp The output targeted experiment
      * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     * @param swath_windows Precursor m/z ranges (lower, upper) to load
      *
     */
-    void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
+    void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false,
+                                        const std::vector<std::pair<double, double> >& swath_windows = std::vector<std::pair<double, double> >());
 
   };
 }
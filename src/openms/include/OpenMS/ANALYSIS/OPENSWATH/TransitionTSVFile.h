@@ -221,6 +221,23 @@ protected:
     */
     void TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp);
 
+    /** @brief Create a LightCompound (peptide or metabolite) from a single TSVTransition
+     *
+     * Uses all compound-level fields of the transition (sequence,
+     * modifications, charge, retention time, drift time, protein references).
+     *
+    */
+    void createLightCompound_(std::vector<TSVTransition>::const_iterator tr_it, OpenSwath::LightCompound& compound);
+
+    /** @brief Check the peptide group label of a single transition against previously seen transitions
+     *
+     * Streaming counterpart of resolveMixedSequenceGroups_: @p label_sequence_map
+     * stores the first peptide sequence seen for each peptide group label and
+     * transitions must be presented in input order.
+     *
+    */
+    void resolveMixedSequenceGroup_(TSVTransition& transition, std::map<String, String>& label_sequence_map) const;
+
     /// Convert an OpenMS transition to a TSVTransition for output writing
     TransitionTSVFile::TSVTransition convertTransition_(const ReactionMonitoringTransition* it, OpenMS::TargetedExperiment& targeted_exp);
     //@}
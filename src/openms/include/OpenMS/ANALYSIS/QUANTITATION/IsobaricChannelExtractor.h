@@ -62,6 +62,15 @@ namespace OpenMS
     for improvement of protein identification and accuracy of isobaric mass tag quantification on Orbitrap-type mass
     spectrometers. Analytical chemistry 83: 8959-67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
 
+    Purity computation and reporter ion search are performed in parallel (OpenMP) over all
+    spectra used for quantification. The order of the features in the output map follows the
+    order of the spectra in the input, independent of the number of threads.
+
+    To quantify large files with low memory, use the extractChannels() overload which takes an
+    mzML file name: the spectra are streamed from disk and only the peaks required for the
+    channel extraction (reporter ion region of MSn spectra, isolation windows in MS1 spectra)
+    are kept in memory.
+
     @note Centroided MS and MS/MS data is required.
 
     @htmlinclude OpenMS_IsobaricChannelExtractor.parameters
@@ -91,6 +100,21 @@ public:
     */
     void extractChannels(const PeakMap& ms_exp_data, ConsensusMap& consensus_map);
 
+    /**
+      @brief Extracts the isobaric channels from an mzML file while streaming it from disk.
+
+      While reading, MSn spectra are reduced to the reporter ion region and MS1 spectra to the
+      isolation windows of the MSn spectra surrounding them. Chromatograms are skipped.
+      The result is identical to loading the full file and calling extractChannels(const PeakMap&, ConsensusMap&).
+
+      @param mzml_file Raw data (mzML) to search for isobaric quantitation channels.
+      @param consensus_map Output map containing the identified channels and the corresponding intensities.
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void extractChannels(const String& mzml_file, ConsensusMap& consensus_map);
+
 private:
     /**
       @brief Small struct to capture the current state of the purity computation.
@@ -200,6 +224,16 @@ private:
     */
     double computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
 
+    /**
+      @brief Searches the reporter ions of all channels in the MSn spectrum @p spec.
+
+      @param spec The spectrum used for quantification.
+      @param intensities Intensity of the closest non-zero peak within the allowed reporter mass shift for each channel (0 if none or below the minimum reporter intensity).
+      @param mz_deltas Deviation of the closest non-zero peak within 0.5 Th of each channel (NaN if there is none), used for calibration statistics.
+      @param not_unique Flags channels where more than one peak was found within the allowed reporter mass shift.
+    */
+    void extractReporterIons_(const PeakMap::SpectrumType& spec, std::vector<Peak2D::IntensityType>& intensities, std::vector<double>& mz_deltas, std::vector<bool>& not_unique) const;
+
     /**
       @brief Get the first (of potentially many) activation methods (HCD,CID,...) of this spectrum.
 
@@ -39,21 +39,25 @@
 #include <OpenMS/KERNEL/Feature.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/TransformationModelLowess.h>
-#include <OpenMS/DATASTRUCTURES/KDTree.h>
-#include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureNode.h>
 
 namespace OpenMS
 {
 
-/// Stores a set of features, together with a 2D tree for fast search
+/**
+  @brief Stores a set of features, together with a 2D tree for fast search
+
+  The 2D tree (on RT and m/z) is static: it is stored implicitly as a permutation of the feature
+  indices and built in O(n log n) by optimizeTree() (which is called by addMaps() and
+  applyTransformations()). Features added with addFeature() afterwards are still found by
+  queries, but by a linear search until optimizeTree() is called again.
+
+  Queries do not change the object, so they can be run concurrently.
+*/
 class OPENMS_DLLAPI KDTreeFeatureMaps : public DefaultParamHandler
 {
 
 public:
 
-  /// 2D tree on features
-  typedef KDTree::KDTree<2,KDTreeFeatureNode> FeatureKDTree;
-
   /// Default constructor
   KDTreeFeatureMaps() :
     DefaultParamHandler("KDTreeFeatureMaps")
@@ -117,7 +121,7 @@ public:
   /// Number of features stored
   Size size() const;
 
-  /// Number of points in the tree
+  /// Number of points that can be found by queries (all features)
   Size treeSize() const;
 
   /// Number of maps
@@ -126,22 +130,34 @@ public:
   /// Clear all data
   void clear();
 
-  /// Optimize the kD tree
+  /// (Re-)build the 2D tree on all features (if features were added since the last call)
   void optimizeTree();
 
-  /// Fill @p result with indices of all features compatible (wrt. RT, m/z, map index) to the feature with @p index
+  /// Fill @p result with indices of all features compatible (wrt. RT, m/z, map index) to the feature with @p index (in increasing order)
   void getNeighborhood(Size index, std::vector<Size>& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map = false, double max_pairwise_log_fc = -1.0) const;
 
-  /// Fill @p result with indices of all features within the specified boundaries
+  /// Fill @p result with indices of all features within the specified boundaries (in increasing order)
   void queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, std::vector<Size>& result_indices, Size ignored_map_index = std::numeric_limits<Size>::max()) const;
 
-  /// Apply RT transformations
+  /// Apply RT transformations (and rebuild the 2D tree)
   void applyTransformations(const std::vector<TransformationModelLowess*>& trafos);
 
 protected:
 
   void updateMembers_() override;
 
+  /// Builds the subtree on tree_[@p begin, @p end), split in dimension @p dim (0: RT, 1: m/z)
+  void buildTree_(Size begin, Size end, Size dim);
+
+  /// Adds the features of subtree tree_[@p begin, @p end) (split in dimension @p dim) that lie within the region to @p result_indices
+  void queryTree_(Size begin, Size end, Size dim, const double (&low)[2], const double (&high)[2], std::vector<Size>& result_indices) const;
+
+  /// Coordinate of feature @p i in dimension @p dim (0: RT, 1: m/z)
+  double coordinate_(Size i, Size dim) const
+  {
+    return dim == 0 ? rt_[i] : mz_[i];
+  }
+
   /// Feature data
   std::vector<const BaseFeature*> features_;
 
@@ -151,11 +167,20 @@ protected:
   /// (Potentially transformed) retention times
   std::vector<double> rt_;
 
+  /// m/z values (copied from the features for faster access)
+  std::vector<double> mz_;
+
   /// Number of maps
   Size num_maps_;
 
-  /// 2D tree on features from all input maps.
-  FeatureKDTree kd_tree_;
+  /**
+    @brief 2D tree on features from all input maps, stored implicitly as a permutation of feature indices
+
+    The median of every range tree_[begin, end) (at position (begin + end) / 2) splits the range in RT or m/z
+    (alternating, starting with RT). Small ranges are not split. Features with indices not contained in tree_
+    (added after the last build) are searched linearly.
+  */
+  std::vector<Size> tree_;
 
 };
 }
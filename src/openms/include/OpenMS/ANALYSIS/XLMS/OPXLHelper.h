@@ -98,6 +98,11 @@ namespace OpenMS
           Assumes the list of peptides and the list of spectrum precursor masses are sorted by mass in ascending order,
           and the list of mono-link masses is sorted in descending order.
 
+          Peptide pairs are found with a two-pointer sweep over the sorted peptide masses, so only the pairs fitting
+          the given precursor masses are generated, in linear time per precursor mass.
+          The candidates are enumerated in a deterministic order (by precursor mass, then loop-links, mono-links and cross-links
+          ordered by peptide indices). The function does not start parallel regions itself and can be called for different spectra in parallel.
+
        * @param peptides The peptides with precomputed masses from the digestDatabase function
        * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
        * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
@@ -243,6 +248,7 @@ namespace OpenMS
 
           This function uses enumerateCrossLinksAndMasses and buildCandidates to search for peptide pairs fitting to the given precursor mass_light
           and all considered precursor corrections.
+          It only depends on its arguments and can be called for several spectra in parallel.
 
        * @param precursor_correction_steps An IntList of integers as indices of isotopic peaks around the experimental precursor
        * @param precursor_mass The decharged precursor mass
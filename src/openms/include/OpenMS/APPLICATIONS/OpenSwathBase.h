@@ -305,11 +305,13 @@ protected:
    * @param tr_type Input file type
    * @param tr_file Input file name
    * @param tsv_reader_param Parameters on how to interpret spectral data
+   * @param swath_windows Precursor m/z ranges to load (PQP only, empty loads all transitions)
    *
    */
   OpenSwath::LightTargetedExperiment loadTransitionList(const FileTypes::Type& tr_type,
                                                         const String& tr_file,
-                                                        const Param& tsv_reader_param)
+                                                        const Param& tsv_reader_param,
+                                                        const std::vector<std::pair<double, double> >& swath_windows = std::vector<std::pair<double, double> >())
   {
     OpenSwath::LightTargetedExperiment transition_exp;
     ProgressLogger progresslogger;
@@ -325,7 +327,7 @@ protected:
     else if (tr_type == FileTypes::PQP)
     {
       progresslogger.startProgress(0, 1, "Load PQP file");
-      TransitionPQPFile().convertPQPToTargetedExperiment(tr_file.c_str(), transition_exp);
+      TransitionPQPFile().convertPQPToTargetedExperiment(tr_file.c_str(), transition_exp, false, swath_windows);
       progresslogger.endProgress();
     }
     else if (tr_type == FileTypes::TSV)
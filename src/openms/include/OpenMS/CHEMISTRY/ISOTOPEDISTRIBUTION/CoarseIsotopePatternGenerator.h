@@ -41,6 +41,8 @@
 
 namespace OpenMS
 {
+  class Element;
+
   /**
     * @ingroup Chemistry
     * @brief Isotope pattern generator for coarse isotope distributions.
@@ -90,6 +92,13 @@ namespace OpenMS
     * @note If you need fine isotope distributions, consider using the
     * FineIsotopePatternGenerator.
     *
+    * Since most formulas share the same elements with similar counts, the
+    * distribution of each element raised to its count (for a given max
+    * isotope) is memoized in a process-wide table which is shared between all
+    * instances and threads (see clearElementPowerCache()). Convolutions of
+    * long distributions (i.e. when many isotopes are requested) are computed
+    * via FFT instead of the quadratic direct sum.
+    *
     * See also method run()
     **/
 
@@ -126,6 +135,15 @@ namespace OpenMS
     bool getRoundMasses() const;
     //@}
 
+    /// @name Element power cache
+    //@{
+    /// removes all memoized element distributions (shared by all instances)
+    static void clearElementPowerCache();
+
+    /// returns the number of memoized element distributions (shared by all instances)
+    static Size getElementPowerCacheSize();
+    //@}
+
     /**
       * @brief Creates an isotope distribution from an empirical sum formula
       *
@@ -315,6 +333,16 @@ namespace OpenMS
     /// convolves the distribution @p input with itself and stores the result in @p result
     IsotopeDistribution::ContainerType convolveSquare_(const IsotopeDistribution::ContainerType & input) const;
 
+    /**
+      @brief convolves the gapless distributions @p left and @p right via FFT and returns the first @p r_max isotopes
+
+      Used by convolve_() and convolveSquare_() for long distributions, where the direct sum is quadratic in the number of isotopes.
+    */
+    IsotopeDistribution::ContainerType convolveFFT_(const IsotopeDistribution::ContainerType & left, const IsotopeDistribution::ContainerType & right, Size r_max) const;
+
+    /// returns the distribution of @p element convolved @p count times with itself (memoized for the current max isotope)
+    IsotopeDistribution::ContainerType elementPow_(const Element * element, Size count) const;
+
     /// converts the masses of distribution @p input from atomic numbers to accurate masses
     IsotopeDistribution::ContainerType correctMass_(const IsotopeDistribution::ContainerType & input, const double mono_weight) const;
 
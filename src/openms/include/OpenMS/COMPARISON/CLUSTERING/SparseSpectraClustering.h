@@ -0,0 +1,145 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+#pragma once
+
+#include <OpenMS/COMPARISON/CLUSTERING/ClusterFunctor.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumMatrix.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+      @brief Hierarchical clustering of spectra with memory linear in the number of spectra
+
+      ClusterHierarchical needs the full DistanceMatrix of all spectra, which limits it
+      to roughly 100k spectra. This class only compares likely similar spectra:
+
+      1. All spectra are binned (see BinnedSpectrum) and packed into a BinnedSpectrumMatrix.
+      2. Candidate pairs are generated by locality-sensitive hashing: each spectrum gets a
+         signature of random hyperplane bits (SimHash, approximating the cosine similarity),
+         split into @p lsh:bands bands of @p lsh:bits_per_band bits. Two spectra are
+         candidates if they agree in at least one band and their precursor m/z are within
+         @p precursor_mz_tolerance.
+      3. The candidate pairs are scored with the chosen binned similarity measure; pairs with
+         a distance (1 - similarity) of at least @p distance_threshold are discarded.
+      4. Agglomerative clustering with the chosen linkage is performed on the sparse distances.
+         Pairs that were not scored have a distance of 1.
+
+      Binning, hashing and scoring run in parallel. The resulting tree has the same format as
+      the one produced by the ClusterFunctor implementations (nodes sorted by distance,
+      unconnected clusters joined by dummy nodes with distance -1), so it can be analyzed with
+      ClusterAnalyzer, e.g. ClusterAnalyzer::cut.
+
+      @htmlinclude OpenMS_SparseSpectraClustering.parameters
+
+      @see ClusterHierarchical, BinnedSpectrumMatrix, ClusterAnalyzer
+
+      @ingroup SpectraClustering
+  */
+  class OPENMS_DLLAPI SparseSpectraClustering :
+    public DefaultParamHandler,
+    public ProgressLogger
+  {
+public:
+
+    /// a scored candidate pair (i < j) with its distance
+    struct CandidatePair
+    {
+      Size first;
+      Size second;
+      float distance;
+    };
+
+    /// default constructor
+    SparseSpectraClustering();
+
+    /// destructor
+    ~SparseSpectraClustering() override;
+
+    /**
+        @brief Clusters the given spectra
+
+        @param data the spectra to cluster (sorted by m/z)
+        @param cluster_tree the clustering (data.size() - 1 nodes, see ClusterFunctor)
+        @throw ClusterFunctor::InsufficientInput if less than two spectra are given
+    */
+    void cluster(const std::vector<PeakSpectrum>& data, std::vector<BinaryTreeNode>& cluster_tree);
+
+    /**
+        @brief Generates and scores the candidate pairs (steps 1 to 3 of the clustering)
+
+        @param data the spectra to cluster (sorted by m/z)
+        @param pairs scored candidate pairs below the distance threshold, sorted by (first, second)
+    */
+    void computeCandidatePairs(const std::vector<PeakSpectrum>& data, std::vector<CandidatePair>& pairs);
+
+    /**
+        @brief Agglomerative clustering on sparse distances (step 4 of the clustering)
+
+        @param size number of elements
+        @param pairs distances of element pairs; missing pairs have distance 1
+        @param cluster_tree the clustering (@p size - 1 nodes, see ClusterFunctor)
+    */
+    void clusterSparse(Size size, const std::vector<CandidatePair>& pairs, std::vector<BinaryTreeNode>& cluster_tree) const;
+
+protected:
+
+    void updateMembers_() override;
+
+    /// SimHash band keys of all rows of @p matrix (row-major, bands_ keys per row)
+    void computeBandKeys_(const BinnedSpectrumMatrix& matrix, std::vector<UInt64>& keys) const;
+
+    /// precursor m/z of a spectrum (0 if it has no precursor)
+    static double precursorMZ_(const PeakSpectrum& spec);
+
+    double precursor_tolerance_;
+    bool precursor_tolerance_ppm_;
+    float bin_size_;
+    UInt bin_spread_;
+    float bin_offset_;
+    BinnedSpectrumMatrix::SimilarityMeasure measure_;
+    String linkage_;
+    double distance_threshold_;
+    UInt bands_;
+    UInt bits_per_band_;
+  };
+
+}
@@ -0,0 +1,204 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#pragma once
+
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+#include <OpenMS/DATASTRUCTURES/DistanceMatrix.h>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Batch comparison of many binned spectra
+
+    Packs a set of compatible BinnedSpectrum objects into a single matrix in
+    compressed sparse row (CSR) layout: the (sorted) bin indices and intensities
+    of all spectra are stored in two contiguous arrays. Per-row statistics
+    (number of filled bins, intensity sum, squared norm) are precomputed once.
+
+    All supported similarity measures only depend on the bins filled in both
+    spectra, which are found with a linear merge of the sorted index arrays.
+    One-vs-many and all-vs-all comparisons are parallelized with OpenMP.
+    The scores are identical to the ones of the pairwise compare functors:
+    - CONTRAST_ANGLE: BinnedSpectralContrastAngle
+    - SHARED_PEAK_COUNT: BinnedSharedPeakCount
+    - SUM_AGREEING_INTENSITIES: BinnedSumAgreeingIntensities
+
+    @see BinnedSpectrum
+    @see BinnedSpectrumCompareFunctor
+
+    @ingroup SpectraComparison
+  */
+  class OPENMS_DLLAPI BinnedSpectrumMatrix
+  {
+public:
+
+    /// similarity measures supported by the batch comparison
+    enum SimilarityMeasure
+    {
+      CONTRAST_ANGLE,
+      SHARED_PEAK_COUNT,
+      SUM_AGREEING_INTENSITIES,
+      SIZE_OF_SIMILARITYMEASURE
+    };
+
+    /// names of the similarity measures (same as the product names of the compare functors)
+    static const std::string NamesOfSimilarityMeasure[SIZE_OF_SIMILARITYMEASURE];
+
+    /// a scored hit: (row index, similarity)
+    typedef std::pair<Size, double> Hit;
+
+    /// default constructor
+    BinnedSpectrumMatrix();
+
+    /**
+      @brief Constructor packing the given spectra
+
+      @throw Exception::IllegalArgument if the spectra have incompatible binning
+    */
+    explicit BinnedSpectrumMatrix(const std::vector<BinnedSpectrum>& spectra);
+
+    /// destructor
+    virtual ~BinnedSpectrumMatrix();
+
+    /**
+      @brief Appends a spectrum as a new row
+
+      @throw Exception::IllegalArgument if @p spec is not compatible to the spectra already stored
+    */
+    void addSpectrum(const BinnedSpectrum& spec);
+
+    /// removes all spectra
+    void clear();
+
+    /// number of stored spectra (rows)
+    Size size() const;
+
+    /// total number of filled bins
+    Size nonZeros() const;
+
+    /// first entry of each row in getBinIndices() and getBinValues() (size() + 1 entries)
+    const std::vector<Size>& getRowOffsets() const;
+
+    /// bin indices of all rows (ascending within each row)
+    const std::vector<UInt>& getBinIndices() const;
+
+    /// bin intensities of all rows
+    const std::vector<float>& getBinValues() const;
+
+    /// similarity between rows @p i and @p j
+    double compare(Size i, Size j, SimilarityMeasure measure) const;
+
+    /**
+      @brief Compares @p query against all rows
+
+      @param scores Similarity of @p query to every row (resized to size())
+      @throw Exception::IllegalArgument if @p query is not compatible to the stored spectra
+    */
+    void compareOneVsMany(const BinnedSpectrum& query, SimilarityMeasure measure, std::vector<double>& scores) const;
+
+    /**
+      @brief Compares @p query against all rows and returns the @p top_k best hits
+
+      Hits are sorted by decreasing similarity (ties by increasing row index).
+      Rows with similarity zero are not reported.
+
+      @throw Exception::IllegalArgument if @p query is not compatible to the stored spectra
+    */
+    void compareOneVsMany(const BinnedSpectrum& query, SimilarityMeasure measure, Size top_k, std::vector<Hit>& hits) const;
+
+    /// Compares all rows against each other and stores the similarities in @p similarities (resized to size())
+    void compareAllVsAll(SimilarityMeasure measure, DistanceMatrix<float>& similarities) const;
+
+    /**
+      @brief Compares all rows against each other, keeping the @p top_k best hits per row
+
+      @p hits[i] holds the hits of row i (excluding i itself), sorted as in compareOneVsMany().
+      Memory usage is linear in the number of rows.
+    */
+    void compareAllVsAll(SimilarityMeasure measure, Size top_k, std::vector<std::vector<Hit> >& hits) const;
+
+protected:
+
+    /// sums over the bins filled in two rows
+    struct MergeResult_
+    {
+      double dot;
+      double agreeing;
+      Size shared;
+    };
+
+    /// merge of two sorted index arrays
+    static MergeResult_ merge_(const UInt* idx_a, const float* val_a, Size size_a,
+                               const UInt* idx_b, const float* val_b, Size size_b);
+
+    /// score from the merge result and the row statistics
+    static double score_(const MergeResult_& m, SimilarityMeasure measure,
+                         Size nnz_a, double sum_a, double sqsum_a,
+                         Size nnz_b, double sum_b, double sqsum_b);
+
+    /// throws if @p spec cannot be compared with the stored spectra
+    void checkCompatible_(const BinnedSpectrum& spec) const;
+
+    /// keeps the @p top_k best entries in @p hits and sorts them
+    static void selectTopK_(std::vector<Hit>& hits, Size top_k);
+
+    /// first entry of each row in the index/value arrays (size() + 1 entries)
+    std::vector<Size> row_offsets_;
+
+    /// bin indices of all rows
+    std::vector<UInt> bin_indices_;
+
+    /// bin intensities of all rows
+    std::vector<float> bin_values_;
+
+    /// intensity sum of each row
+    std::vector<double> row_sums_;
+
+    /// sum of squared intensities of each row
+    std::vector<double> row_sqsums_;
+
+    /// binning of the stored spectra (bins are not stored)
+    BinnedSpectrum layout_;
+
+    /// whether layout_ was set
+    bool has_layout_;
+  };
+
+}
@@ -7,6 +7,7 @@ BinnedSharedPeakCount.h
 BinnedSpectralContrastAngle.h
 BinnedSpectrum.h
 BinnedSpectrumCompareFunctor.h
+BinnedSpectrumMatrix.h
 BinnedSumAgreeingIntensities.h
 PeakAlignment.h
 PeakSpectrumCompareFunctor.h
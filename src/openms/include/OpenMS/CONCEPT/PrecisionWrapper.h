@@ -107,5 +107,8 @@ private:
     os << s;
     return os;
   }
+
+  /// Output operator for a PrecisionWrapper of double: writes the shortest representation that reads back to the same value (see StringConversions::formatShortest())
+  OPENMS_DLLAPI std::ostream & operator<<(std::ostream & os, const PrecisionWrapper<double> & rhs);
 } // namespace OpenMS
 
@@ -0,0 +1,342 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief An ordered set of unique elements, stored contiguously in a sorted std::vector.
+
+    FlatSet offers the subset of the std::set interface which is commonly used (iteration, insert, find, erase, ...),
+    with the same semantics: elements are kept sorted w.r.t. @p Compare, equivalent elements are
+    rejected on insertion (the element already present wins) and only const access to the elements is provided,
+    since modifying an element could break the ordering.
+
+    In contrast to std::set, all elements live in a single memory block. This reduces the memory footprint
+    (no per-node allocation and tree pointers), makes copying cheap and iteration cache-friendly.
+    The price is O(n) insertion in the middle of the set. Appending an element which is larger than all current
+    elements (the common case when filling a set in order) is amortized O(1) and inserting a whole range
+    is O(n + k log k).
+
+    Note that, unlike for std::set, any insertion or erasure invalidates iterators and references.
+
+    @ingroup Datastructures
+  */
+  template <typename Key, typename Compare = std::less<Key> >
+  class FlatSet
+  {
+    typedef std::vector<Key> ContainerType;
+
+public:
+    ///@name Type definitions (compatible with std::set)
+    //@{
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+    typedef typename ContainerType::size_type size_type;
+    typedef typename ContainerType::difference_type difference_type;
+    typedef typename ContainerType::const_reference reference;
+    typedef typename ContainerType::const_reference const_reference;
+    typedef typename ContainerType::const_pointer pointer;
+    typedef typename ContainerType::const_pointer const_pointer;
+    /// like for std::set, iterator and const_iterator are the same (constant) iterator type
+    typedef typename ContainerType::const_iterator iterator;
+    typedef typename ContainerType::const_iterator const_iterator;
+    typedef typename ContainerType::const_reverse_iterator reverse_iterator;
+    typedef typename ContainerType::const_reverse_iterator const_reverse_iterator;
+    //@}
+
+    /// Default constructor
+    FlatSet() = default;
+
+    /// Constructor with a comparator
+    explicit FlatSet(const Compare& comp) :
+      comp_(comp)
+    {
+    }
+
+    /// Constructor from a range of (not necessarily sorted or unique) elements
+    template <typename InputIterator>
+    FlatSet(InputIterator first, InputIterator last, const Compare& comp = Compare()) :
+      comp_(comp)
+    {
+      insert(first, last);
+    }
+
+    /// Constructor from an initializer list
+    FlatSet(std::initializer_list<value_type> init, const Compare& comp = Compare()) :
+      comp_(comp)
+    {
+      insert(init.begin(), init.end());
+    }
+
+    /// Copy constructor
+    FlatSet(const FlatSet&) = default;
+
+    /// Move constructor
+    FlatSet(FlatSet&&) = default;
+
+    /// Assignment operator
+    FlatSet& operator=(const FlatSet&) = default;
+
+    /// Move assignment operator
+    FlatSet& operator=(FlatSet&&) = default;
+
+    ///@name Iterators
+    //@{
+    const_iterator begin() const { return data_.begin(); }
+    const_iterator end() const { return data_.end(); }
+    const_iterator cbegin() const { return data_.cbegin(); }
+    const_iterator cend() const { return data_.cend(); }
+    const_reverse_iterator rbegin() const { return data_.rbegin(); }
+    const_reverse_iterator rend() const { return data_.rend(); }
+    const_reverse_iterator crbegin() const { return data_.crbegin(); }
+    const_reverse_iterator crend() const { return data_.crend(); }
+    //@}
+
+    ///@name Capacity
+    //@{
+    bool empty() const { return data_.empty(); }
+    size_type size() const { return data_.size(); }
+    size_type max_size() const { return data_.max_size(); }
+    size_type capacity() const { return data_.capacity(); }
+    /// Reserve memory for @p n elements (not available for std::set)
+    void reserve(size_type n) { data_.reserve(n); }
+    /// Release unused memory (not available for std::set)
+    void shrink_to_fit() { data_.shrink_to_fit(); }
+    //@}
+
+    ///@name Modifiers
+    //@{
+    /// Removes all elements
+    void clear() { data_.clear(); }
+
+    /**
+      @brief Inserts @p value, if no equivalent element is contained yet.
+
+      @return Iterator to the inserted (or the already present, equivalent) element and a flag whether the insertion took place.
+    */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+      // fast path: appending in sorted order
+      if (data_.empty() || comp_(data_.back(), value))
+      {
+        data_.push_back(value);
+        return std::make_pair(iterator(data_.end() - 1), true);
+      }
+      typename ContainerType::iterator pos = std::lower_bound(data_.begin(), data_.end(), value, comp_);
+      if (pos != data_.end() && !comp_(value, *pos))
+      {
+        return std::make_pair(iterator(pos), false);
+      }
+      return std::make_pair(iterator(data_.insert(pos, value)), true);
+    }
+
+    /// Inserts @p value (move version)
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+      if (data_.empty() || comp_(data_.back(), value))
+      {
+        data_.push_back(std::move(value));
+        return std::make_pair(iterator(data_.end() - 1), true);
+      }
+      typename ContainerType::iterator pos = std::lower_bound(data_.begin(), data_.end(), value, comp_);
+      if (pos != data_.end() && !comp_(value, *pos))
+      {
+        return std::make_pair(iterator(pos), false);
+      }
+      return std::make_pair(iterator(data_.insert(pos, std::move(value))), true);
+    }
+
+    /// Inserts @p value, using @p hint as a suggestion where it should go (enables std::inserter)
+    iterator insert(const_iterator hint, const value_type& value)
+    {
+      // the hint is correct if value belongs directly before it
+      if ((hint == end() || comp_(value, *hint)) && (hint == begin() || comp_(*(hint - 1), value)))
+      {
+        return data_.insert(data_.begin() + (hint - begin()), value);
+      }
+      return insert(value).first;
+    }
+
+    /**
+      @brief Inserts all elements of the range [first, last).
+
+      Elements equivalent to an already contained element (or to an earlier element of the range) are skipped,
+      just as with std::set::insert.
+    */
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+      const size_type old_size = data_.size();
+      data_.insert(data_.end(), first, last);
+      typename ContainerType::iterator middle = data_.begin() + old_size;
+      // stable sort/merge keeps the present (or first) element of a run of equivalent elements in front
+      std::stable_sort(middle, data_.end(), comp_);
+      if (old_size != 0 && middle != data_.end() && !comp_(*(middle - 1), *middle))
+      {
+        std::inplace_merge(data_.begin(), middle, data_.end(), comp_);
+      }
+      const Compare& comp = comp_;
+      data_.erase(std::unique(data_.begin(), data_.end(),
+                              [&comp](const value_type& a, const value_type& b) { return !comp(a, b); }),
+                  data_.end());
+    }
+
+    /// Inserts all elements of the initializer list
+    void insert(std::initializer_list<value_type> init)
+    {
+      insert(init.begin(), init.end());
+    }
+
+    /// Constructs an element in-place (if no equivalent element is contained yet)
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+      return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    /// Removes the element at @p pos, returns an iterator to the following element
+    iterator erase(const_iterator pos)
+    {
+      return data_.erase(pos);
+    }
+
+    /// Removes the elements in [first, last), returns an iterator to the following element
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      return data_.erase(first, last);
+    }
+
+    /// Removes the element equivalent to @p key (if any), returns the number of removed elements
+    size_type erase(const key_type& key)
+    {
+      const_iterator it = find(key);
+      if (it == end()) return 0;
+      data_.erase(it);
+      return 1;
+    }
+
+    /// Swaps the content of two sets
+    void swap(FlatSet& other)
+    {
+      using std::swap;
+      swap(data_, other.data_);
+      swap(comp_, other.comp_);
+    }
+    //@}
+
+    ///@name Lookup
+    //@{
+    /// Returns the number of elements equivalent to @p key (0 or 1)
+    size_type count(const key_type& key) const
+    {
+      return find(key) != end() ? 1 : 0;
+    }
+
+    /// Returns an iterator to the element equivalent to @p key, or end()
+    const_iterator find(const key_type& key) const
+    {
+      const_iterator it = lower_bound(key);
+      if (it != end() && !comp_(key, *it)) return it;
+      return end();
+    }
+
+    /// Returns an iterator to the first element not less than @p key
+    const_iterator lower_bound(const key_type& key) const
+    {
+      return std::lower_bound(data_.begin(), data_.end(), key, comp_);
+    }
+
+    /// Returns an iterator to the first element greater than @p key
+    const_iterator upper_bound(const key_type& key) const
+    {
+      return std::upper_bound(data_.begin(), data_.end(), key, comp_);
+    }
+
+    /// Returns the range of elements equivalent to @p key
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+    {
+      return std::equal_range(data_.begin(), data_.end(), key, comp_);
+    }
+    //@}
+
+    ///@name Observers
+    //@{
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return comp_; }
+    //@}
+
+    /// Equality (element-wise, like std::set)
+    bool operator==(const FlatSet& rhs) const
+    {
+      return data_ == rhs.data_;
+    }
+
+    /// Inequality
+    bool operator!=(const FlatSet& rhs) const
+    {
+      return !(data_ == rhs.data_);
+    }
+
+    /// Lexicographical comparison (like std::set)
+    bool operator<(const FlatSet& rhs) const
+    {
+      return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end(), comp_);
+    }
+
+private:
+    /// sorted, unique elements
+    ContainerType data_;
+    /// the ordering
+    Compare comp_;
+  };
+
+  /// Swaps the content of two FlatSets
+  template <typename Key, typename Compare>
+  inline void swap(FlatSet<Key, Compare>& lhs, FlatSet<Key, Compare>& rhs)
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace OpenMS
+
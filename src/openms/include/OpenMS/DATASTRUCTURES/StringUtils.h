@@ -228,7 +228,39 @@ namespace OpenMS
       return str;
     }
 
-    
+
+    /**
+      @brief Writes a short decimal representation of @p d to @p buffer, which reads back to exactly @p d (Grisu2 algorithm)
+
+      In almost all cases, the representation is the shortest one that round-trips. Numbers with an absolute
+      value in [1e-2, 1e4) (and zero) are written in fixed notation, all others in scientific notation with an
+      exponent of at least two digits, as with append(double). At least one fractional digit is written,
+      e.g. "1.0", "0.30000000000000004", "1.5e-07" or "1.2e04".
+      Non-finite values are written as "nan", "inf" and "-inf".
+
+      The conversion is locale-independent and much faster than append(double) or stream output.
+
+      @param d The number
+      @param buffer Output buffer, which must have room for at least 32 characters (no terminating zero is written)
+      @return Pointer behind the last written character
+    */
+    OPENMS_DLLAPI char* formatShortest(double d, char* buffer);
+
+    /// round-trip conversion to String (see formatShortest())
+    /// does NOT clear the input string @p target, so appending is as efficient as possible
+    inline void appendShortest(double d, String& target)
+    {
+      char buffer[32];
+      target.append(buffer, formatShortest(d, buffer));
+    }
+    /// round-trip conversion to String (see formatShortest())
+    inline String toStringShortest(double d)
+    {
+      String str;
+      appendShortest(d, str);
+      return str;
+    }
+
     inline void append(const DataValue& d, bool full_precision, String& target)
     {
       target += d.toString(full_precision);
@@ -831,6 +863,17 @@ public:
       return ret;
     }
 
+    /**
+      @brief Fast, locale-independent parsing of a double in decimal notation, e.g. "-12.5", "1.5e-7" or ".5"
+
+      Parsing succeeds for numbers with at most 19 significant digits, whose conversion to double can be computed
+      exactly (the usual case for numbers in data files). In this case, @p begin is advanced behind the number and
+      the correctly rounded result is stored in @p target. Otherwise (e.g. for "nan", "inf", more digits or very large
+      exponents), false is returned and @p begin is not modified, so a general parser can be used instead.
+      Whitespace is not skipped.
+    */
+    static bool parseDoubleFast(const char*& begin, const char* end, double& target);
+
     /**
       @brief convert String (leading and trailing whitespace allowed) to double
 
@@ -841,6 +884,15 @@ public:
     static double toDouble(const String& s)
     {
       double ret;
+      // fast path for plain decimal numbers (most numbers written by OpenMS and other tools)
+      const char* begin = s.c_str();
+      const char* end = begin + s.size();
+      const char* pos = skipSpace_(begin, end);
+      if (parseDoubleFast(pos, end, ret) && skipSpace_(pos, end) == end)
+      {
+        return ret;
+      }
+
       // boost::spirit::qi was found to be vastly superior to boost::lexical_cast or stringstream extraction (especially for VisualStudio),
       // so don't change this unless you have benchmarks for all platforms!
       String::ConstIterator it = s.begin();
@@ -994,6 +1046,16 @@ public:
     }
   };
   
+  /// skips whitespace (as boost::spirit::ascii::space)
+  static const char* skipSpace_(const char* it, const char* end)
+  {
+    while (it != end && (*it == ' ' || (*it >= '\t' && *it <= '\r')))
+    {
+      ++it;
+    }
+    return it;
+  }
+
   // Qi parsers using the 'real_policies_NANfixed_' template which allows for 'nan'
   // (the original Boost implementation has a bug, see https://svn.boost.org/trac/boost/ticket/6955)
   static boost::spirit::qi::real_parser<double, real_policies_NANfixed_<double> > parse_double_;
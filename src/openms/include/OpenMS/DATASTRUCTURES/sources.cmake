@@ -24,6 +24,7 @@ DateTime.h
 DefaultParamHandler.h
 DistanceMatrix.h
 FASTAContainer.h
+FlatSet.h
 GridFeature.h
 IsotopeCluster.h
 KDTree.h
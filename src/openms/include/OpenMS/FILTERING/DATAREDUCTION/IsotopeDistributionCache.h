@@ -37,10 +37,19 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 
+#include <map>
+
 namespace OpenMS
 {
+  class EmpiricalFormula;
+  class IsotopeDistribution;
+
   /**
    * @brief Pre-calculate isotope distributions for interesting mass ranges
+   *
+   * Averagine distributions are pre-calculated for all mass windows up to the
+   * maximum mass. Distributions of exact sum formulas are calculated on first
+   * request and cached (thread-safe) for subsequent lookups.
    */
   class OPENMS_DLLAPI IsotopeDistributionCache
   {
@@ -52,11 +61,36 @@ public:
     /// Returns the isotope distribution for a certain mass window
     const TheoreticalIsotopePattern & getIsotopeDistribution(double mass) const;
 
+    /**
+     * @brief Returns the isotope distribution for the sum formula @p formula
+     *
+     * The distribution is calculated (trimmed and scaled like the averagine
+     * distributions) on first request and cached afterwards. References stay
+     * valid until clearFormulaCache() is called.
+     */
+    const TheoreticalIsotopePattern & getIsotopeDistribution(const EmpiricalFormula & formula) const;
+
+    /// Returns the number of cached sum formula distributions
+    Size getFormulaCacheSize() const;
+
+    /// Removes all cached sum formula distributions (invalidates references to them)
+    void clearFormulaCache();
+
 private:
+    /// Trims, annotates and scales the distribution @p d into @p pattern
+    void fillPattern_(IsotopeDistribution & d, TheoreticalIsotopePattern & pattern) const;
+
     /// Vector of pre-calculated isotope distributions for several mass windows
     std::vector<TheoreticalIsotopePattern> isotope_distributions_;
 
+    /// Isotope distributions of sum formulas calculated on demand (key: formula string)
+    mutable std::map<String, TheoreticalIsotopePattern> formula_distributions_;
+
     double mass_window_width_;
+
+    double intensity_percentage_;
+
+    double intensity_percentage_optional_;
   };
 }
 
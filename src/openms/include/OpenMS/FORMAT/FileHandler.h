@@ -39,12 +39,16 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/FORMAT/OPTIONS/PeakFileOptions.h>
 
+#include <vector>
+
 namespace OpenMS
 {
   class PeakFileOptions;
   class MSSpectrum;
   class MSExperiment;
   class FeatureMap;
+  class ProteinIdentification;
+  class PeptideIdentification;
 
   /**
     @brief Facilitates file handling by file type recognition.
@@ -166,6 +170,37 @@ public:
     */
     bool loadFeatures(const String& filename, FeatureMap& map, FileTypes::Type force_type = FileTypes::UNKNOWN);
 
+    /**
+      @brief Loads a file into protein and peptide identifications
+
+      Supported formats are idXML, mzIdentML and idBin.
+
+      @param filename the file name of the file to load.
+      @param protein_ids The protein identifications to load the data into.
+      @param peptide_ids The peptide identifications to load the data into.
+      @param force_type Forces to load the file with that file type. If no type is forced, it is determined from the extension (or from the content if that fails).
+
+      @return true if the file could be loaded, false otherwise
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    bool loadIdentifications(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type = FileTypes::UNKNOWN);
+
+    /**
+      @brief Stores protein and peptide identifications to a file
+
+      The file type to store the data in is determined by the file name. Supported formats for storing are idXML, mzIdentML and idBin.
+      If the file format cannot be determined from the file name, the idXML format is used.
+
+      @param filename The name of the file to store the data in.
+      @param protein_ids The protein identifications to store.
+      @param peptide_ids The peptide identifications to store.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be written
+    */
+    void storeIdentifications(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids);
+
     /**
       @brief Computes a SHA-1 hash value for the content of the given file.
 
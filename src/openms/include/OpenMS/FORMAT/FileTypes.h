@@ -114,6 +114,7 @@ namespace OpenMS
       JSON,               ///< JavaScript Object Notation file (.json)
       RAW,                ///< Thermo Raw File (.raw)
       EXE,                ///< Executable (.exe)
+      IDBIN,              ///< OpenMS binary column-oriented identification format, see IdBinaryFile (.idBin)
       SIZE_OF_TYPE        ///< No file type. Simply stores the number of types
     };
 
@@ -48,6 +48,7 @@
 #include <xercesc/sax2/Attributes.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <iosfwd>
 #include <string>
 
@@ -288,6 +289,19 @@ protected:
 
       //@}
 
+      /**
+        @brief Writes @p count elements (e.g. features) to @p os, formatting chunks of consecutive elements in parallel
+
+        @p write_element is called once per element index, with a buffer stream that has the precision and flags of @p os.
+        It may be called concurrently (if OpenMP is enabled), so it must not modify shared state.
+        The buffered chunks of @p chunk_size elements are written to @p os in element order, i.e. the output is identical
+        to calling @p write_element for all elements in a sequential loop.
+        Only a few chunks per thread are buffered at a time. After writing them, @p written is called (sequentially)
+        with the number of elements written so far, e.g. to report progress.
+      */
+      static void writeElementsChunked_(std::ostream & os, Size count, const std::function<void(std::ostream &, Size)> & write_element,
+                                        const std::function<void(Size)> & written, Size chunk_size = 1000);
+
       ///@name controlled vocabulary handling methods
       //@{
 
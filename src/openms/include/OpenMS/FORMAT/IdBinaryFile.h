@@ -0,0 +1,122 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Used to load and store identifications in a binary, column-oriented format (idBin)
+
+    Peptide identifications and their hits are stored column by column: every attribute
+    (e.g. "hit.score", "peptide_id.rt") and every meta value key (e.g. "hit.meta:target_decoy")
+    forms a separate, zlib-compressed block. Strings (sequences, accessions, meta keys and values)
+    are stored once per block in a dictionary and referenced by index, so repeated peptide
+    sequences are also parsed only once when loading.
+
+    A directory at the end of the file lists all blocks, which allows to
+    - load only some of the columns (see setColumnFilter()), without reading the others from disk, and
+    - decompress and decode the selected columns in parallel (if OpenMP is enabled).
+
+    Protein identifications (search parameters, protein hits, groups) are stored in a single block named "proteins".
+
+    Available column names of a file can be listed with getColumnNames(). The
+    "peptide_id.hit_count" column is always loaded, as it defines the structure of the data.
+
+    @note The file is written in the byte order of the machine. Loading a file created on a machine with different endianness fails.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI IdBinaryFile :
+    public ProgressLogger
+  {
+public:
+    /// Constructor
+    IdBinaryFile();
+
+    /**
+      @brief Loads the identifications of an idBin file
+
+      Only the columns allowed by the column filter are loaded, all other attributes keep their default values.
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a valid idBin file
+    */
+    void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids);
+
+    /**
+      @brief Stores the identifications in an idBin file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids);
+
+    /**
+      @brief Restricts loading to the given columns
+
+      Names ending in '*' are prefixes (e.g. "hit.meta:*" selects all meta values of peptide hits).
+      An empty list (the default) loads all columns.
+    */
+    void setColumnFilter(const StringList& columns);
+
+    /// Returns the column filter (empty if all columns are loaded)
+    const StringList& getColumnFilter() const;
+
+    /**
+      @brief Returns the names of all columns stored in an idBin file
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a valid idBin file
+    */
+    static StringList getColumnNames(const String& filename);
+
+    /// Checks whether the file starts with the idBin magic number (false if it cannot be read)
+    static bool isIdBinaryFile(const String& filename);
+
+protected:
+    /// Returns whether column @p name passes the column filter
+    bool isSelected_(const String& name) const;
+
+    /// Columns to load (empty: all)
+    StringList column_filter_;
+  };
+
+} // namespace OpenMS
@@ -45,6 +45,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <iosfwd>
 
 namespace OpenMS
 {
@@ -164,6 +166,22 @@ namespace OpenMS
       }
     }
 
+    /**
+      @brief Writes the rows of one section to @p os, pulling them from @p next_row until it returns false
+
+      Rows are pulled in batches (e.g. from MzTab::CMMzTabStream) and the rows of a batch are formatted in parallel,
+      so only a single batch is kept in memory. @p write_header is called with the first row before any row is written
+      (and not at all if the section is empty).
+
+      @return The number of rows written
+    */
+    template <typename SectionRow>
+    Size writeMzTabSectionStreamed_(std::ostream& os,
+                                    const std::function<bool(SectionRow&)>& next_row,
+                                    const std::function<void(const SectionRow&)>& write_header,
+                                    const std::vector<String>& optional_columns,
+                                    const MzTabMetaData& meta) const;
+
     // auxiliary functions
 
     /// Helper function for "generateMzTabSectionRow_" functions
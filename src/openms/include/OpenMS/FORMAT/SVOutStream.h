@@ -131,6 +131,9 @@ public:
     */
     SVOutStream& operator<<(enum Newline);
 
+    /// doubles are written in the shortest representation that reads back to the same value (see StringConversions::formatShortest())
+    SVOutStream& operator<<(double value);
+
     /// numeric types should be converted to String first to make use
     /// of StringConversion
     template<typename T>
@@ -38,6 +38,8 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <functional>
+
 namespace OpenMS
 {
   namespace Internal
@@ -91,6 +93,30 @@ protected:
       */
       void parseBuffer_(const std::string & buffer, XMLHandler * handler);
 
+      /**
+        @brief Parses the XML file given by @p filename, with the @p element_tag elements of its @p list_tag element in parallel.
+
+        The file is read into memory and parsed in two steps:
+        - The document without the content of the list element (e.g. the header and identification runs of a
+          featureXML file) is parsed using @p handler.
+        - The content of the list is split into chunks of @p elements_per_chunk top-level @p element_tag elements.
+          Each chunk is wrapped into a document with the root element @p chunk_root_tag (without attributes) and
+          parsed with the handler returned by @p chunk_handler for the chunk index. If OpenMP is enabled, the chunks
+          are parsed concurrently.
+
+        @p chunk_handler is called sequentially for the chunk indices 0, 1, 2, ... after the first step, so the chunk
+        handlers can take over state from @p handler (e.g. references to identification runs).
+        Finally, @p merge_chunk is called sequentially for all chunks in the order of the file.
+
+        @return false, without parsing anything, if the file is compressed. Use parse_() in this case.
+
+        @exception Exception::FileNotFound is thrown if the file is not found
+        @exception Exception::ParseError is thrown if an error occurred during the parsing
+      */
+      bool parseChunked_(const String & filename, XMLHandler * handler, const String & list_tag, const String & element_tag,
+                         const String & chunk_root_tag, Size elements_per_chunk,
+                         const std::function<XMLHandler * (Size)> & chunk_handler, const std::function<void(Size)> & merge_chunk);
+
       /**
         @brief Stores the contents of the XML handler given by @p handler in the file given by @p filename.
 
@@ -40,6 +40,7 @@ GzipIfstream.h
 GzipInputStream.h
 HDF5Connector.h
 IBSpectraFile.h
+IdBinaryFile.h
 IdXMLFile.h
 IndexedMzMLFileLoader.h
 InspectInfile.h
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/DATASTRUCTURES/DRange.h>
+#include <OpenMS/DATASTRUCTURES/FlatSet.h>
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/KERNEL/FeatureHandle.h>
 
@@ -72,7 +73,8 @@ namespace OpenMS
 public:
     ///Type definitions
     //@{
-    typedef std::set<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
+    /// Sorted set of handles (ordered by map index, then unique id), stored contiguously
+    typedef FlatSet<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
     typedef HandleSetType::const_iterator const_iterator;
     typedef HandleSetType::iterator iterator;
     typedef HandleSetType::const_reverse_iterator const_reverse_iterator;
@@ -87,6 +87,19 @@ public:
      */
     double eval(double x) const;
 
+    /**
+     * @brief evaluates the spline at position x, starting the search for the
+     * enclosing knot interval at @p index
+     *
+     * Gives the same result as eval(double), but avoids a binary search if
+     * the spline is evaluated at increasing positions and @p index is passed
+     * on from one call to the next.
+     *
+     * @param x x-position
+     * @param index index of the knot interval of the previous position (updated)
+     */
+    double eval(double x, unsigned& index) const;
+
     /**
      * @brief evaluates derivative of spline at position x
      *
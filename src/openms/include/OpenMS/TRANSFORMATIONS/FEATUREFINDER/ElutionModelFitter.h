@@ -67,6 +67,10 @@ namespace OpenMS
        - each subordinate has one convex hull
        - all convex hulls in one feature contain the same number (> 0) of points
        - the y coordinates of the hull points store the intensities
+
+       Features are fitted in parallel (if OpenMP is enabled), using one trace fitter per thread.
+
+       @exception Exception::MissingInformation is thrown if a feature has no subordinates or the first subordinate has no convex hull
     */
     void fitElutionModels(FeatureMap& features);
 
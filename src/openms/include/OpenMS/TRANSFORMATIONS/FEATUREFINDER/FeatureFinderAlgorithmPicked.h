@@ -95,8 +95,6 @@ public:
     static const String getProductName();
 
 protected:
-    /// editable copy of the map
-    MapType map_;
     /// Output stream for log/debug info
     mutable std::ofstream log_;
     /// debug flag
@@ -138,6 +136,27 @@ protected:
     std::vector<std::vector<std::vector<double> > > intensity_thresholds_;
     //@}
 
+    /**
+      @name Precalculated peak scores
+
+      The scores of all peaks of the input map are stored in flat arrays (instead of meta data arrays of a copy of the map).
+      Use peakIndex_() to look up the entry of a peak.
+    */
+    //@{
+    /// Index of the first peak of each spectrum in the score arrays (with an additional entry for the total number of peaks)
+    std::vector<Size> spectrum_offsets_;
+    /// Mass trace score of each peak
+    std::vector<float> trace_scores_;
+    /// Intensity significance score of each peak
+    std::vector<float> intensity_scores_;
+    /// Flag whether a peak is the local maximum of its mass trace
+    std::vector<char> local_max_;
+    /// Isotope pattern score of each peak (for the charge currently processed)
+    std::vector<float> pattern_scores_;
+    /// Overall score of each peak (for the charge currently processed)
+    std::vector<float> overall_scores_;
+    //@}
+
     ///Vector of precalculated isotope distributions for several mass windows
     std::vector<TheoreticalIsotopePattern> isotope_distributions_;
 
@@ -170,9 +189,8 @@ protected:
 
       @param pattern The IsotopePattern that should be extended.
       @param traces The MassTraces datastructure where the extended mass traces will be stored in.
-      @param meta_index_overall The index of the data array where the quality scores for the given charge are stored.
     */
-    void extendMassTraces_(const IsotopePattern& pattern, MassTraces& traces, Size meta_index_overall) const;
+    void extendMassTraces_(const IsotopePattern& pattern, MassTraces& traces) const;
 
     /**
       @brief Extends a single mass trace in one RT direction
@@ -185,14 +203,22 @@ protected:
       @param spectrum_index The index of the spectrum from which on the mass trace should be extended
       @param mz The mz location (center) of the trace
       @param increase_rt Indicator whether the extension is done in forward or backward direction (with respect to the current spectrum)
-      @param meta_index_overall The index of the overall score
       @param min_rt The rt minimum up to which the trace will be extended.
       @param max_rt The rt maximum up to which the trace will be extended.
 
       @note This method assumes that it extends from a local maximum.
       @note If @c min_rt or @c max_rt are set to 0.0 no boundary is assumed in the respective direction.
     */
-    void extendMassTrace_(MassTrace& trace, SignedSize spectrum_index, double mz, bool increase_rt, Size meta_index_overall, double min_rt = 0.0, double max_rt = 0.0) const;
+    void extendMassTrace_(MassTrace& trace, SignedSize spectrum_index, double mz, bool increase_rt, double min_rt = 0.0, double max_rt = 0.0) const;
+
+    /// Returns the index of peak @p peak of spectrum @p spectrum in the score arrays
+    inline Size peakIndex_(Size spectrum, Size peak) const
+    {
+      return spectrum_offsets_[spectrum] + peak;
+    }
+
+    /// Appends the scores of all peaks as meta data array @p name to the spectra of @p map (a copy of the input map, used for debug output)
+    void addScoreArray_(MapType& map, const String& name, const std::vector<float>& scores) const;
 
     /// Returns the index of the peak nearest to m/z @p pos in spectrum @p spec (linear search starting from index @p start)
     Size nearest_(double pos, const MSSpectrum& spec, Size start) const;
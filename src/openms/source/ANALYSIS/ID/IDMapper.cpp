@@ -35,10 +35,82 @@
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <cmath>
+
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// a matching consensus feature: (index in the map, map index of the matching sub-element)
+    typedef pair<Size, UInt64> SubelementMatch;
+
+    /**
+      @brief Index of (consensus) feature positions for RT/m/z window queries
+
+      Positions are bucketed by m/z (1 Th per bucket) and sorted by RT within
+      each bucket, so a query only looks at the positions of the few buckets
+      overlapping the m/z window and within those only at the RT window.
+    */
+    class PositionIndex
+    {
+    public:
+      /// add a position belonging to the element with index @p index
+      void add(double rt, double mz, Size index)
+      {
+        Entry e = {bucket_(mz), rt, mz, index};
+        entries_.push_back(e);
+      }
+
+      /// sort the positions (call after adding all positions and before querying)
+      void build()
+      {
+        sort(entries_.begin(), entries_.end());
+      }
+
+      /// append the indices of all positions within the given window to @p result (may contain duplicates)
+      void query(double rt, double rt_tolerance, double mz, double mz_tolerance, vector<Size>& result) const
+      {
+        // slightly enlarged window; the caller checks the exact tolerances
+        rt_tolerance += 1e-6;
+        mz_tolerance = mz_tolerance * (1.0 + 1e-6) + 1e-9;
+        for (SignedSize b = bucket_(mz - mz_tolerance); b <= bucket_(mz + mz_tolerance); ++b)
+        {
+          Entry lower = {b, rt - rt_tolerance, -numeric_limits<double>::max(), 0};
+          for (vector<Entry>::const_iterator it = lower_bound(entries_.begin(), entries_.end(), lower);
+               it != entries_.end() && it->bucket == b && it->rt <= rt + rt_tolerance; ++it)
+          {
+            if (fabs(it->mz - mz) <= mz_tolerance) result.push_back(it->index);
+          }
+        }
+      }
+
+    private:
+      struct Entry
+      {
+        SignedSize bucket;
+        double rt;
+        double mz;
+        Size index;
+
+        bool operator<(const Entry& rhs) const
+        {
+          if (bucket != rhs.bucket) return bucket < rhs.bucket;
+          if (rt != rhs.rt) return rt < rhs.rt;
+          if (mz != rhs.mz) return mz < rhs.mz;
+          return index < rhs.index;
+        }
+      };
+
+      static SignedSize bucket_(double mz)
+      {
+        return SignedSize(floor(mz));
+      }
+
+      vector<Entry> entries_;
+    };
+  }
 
   IDMapper::IDMapper() :
     DefaultParamHandler("IDMapper"),
@@ -237,39 +309,57 @@ namespace OpenMS
     // append protein identifications to Map
     map.getProteinIdentifications().insert(map.getProteinIdentifications().end(), protein_ids.begin(), protein_ids.end());
 
-    // keep track of assigned/unassigned peptide identifications.
-    // maps Pep.Id. index to number of assignments to a feature
-    std::map<Size, Size> assigned_ids;
-
-    // keep track of assigned/unassigned precursors
-    std::map<Size, Size> assigned_precursors;
-
-    // store which peptides fit which feature (and avoid double entries)
-    // consensusMap -> {peptide_index}
-    vector<set<size_t>> mapping(map.size());
-
-    DoubleList mz_values;
-    double rt_pep;
-    IntList charges;
+    // index the positions of the consensus features (or of their sub-elements)
+    PositionIndex index;
+    for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+    {
+      if (!measure_from_subelements)
+      {
+        index.add(map[cm_index].getRT(), map[cm_index].getMZ(), cm_index);
+      }
+      else
+      {
+        for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
+             it_handle != map[cm_index].getFeatures().end();
+             ++it_handle)
+        {
+          index.add(it_handle->getRT(), it_handle->getMZ(), cm_index);
+        }
+      }
+    }
+    index.build();
 
     // for statistics
     Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
 
-    // iterate over the peptide IDs
-    for (Size i = 0; i < ids.size(); ++i)
+    // find the matching consensus features of all peptide IDs in parallel,
+    // then assign the IDs sequentially to keep the order deterministic
+    vector<vector<SubelementMatch> > id_matches(ids.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
     {
       if (ids[i].getHits().empty()) continue;
 
+      DoubleList mz_values;
+      double rt_pep;
+      IntList charges;
       getIDDetails_(ids[i], rt_pep, mz_values, charges);
 
-      bool id_mapped(false);
-
-      // iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      // only consensus features close to one of the m/z values can match
+      vector<Size> candidates;
+      for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
       {
-        // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
-        bool was_added = false; // was current pep-m/z matched?!
+        index.query(rt_pep, rt_tolerance_, mz_values[i_mz], getAbsoluteMZTolerance_(mz_values[i_mz]), candidates);
+      }
+      sort(candidates.begin(), candidates.end());
+      candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
 
+      // iterate over the candidate features
+      for (Size cm_index : candidates)
+      {
         // iterate over m/z values of pepIds
         for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
         {
@@ -292,15 +382,15 @@ namespace OpenMS
             current_charges.push_back(0); // "not specified" always matches
           }
 
+          bool was_added = false; // was current pep-m/z matched?!
+
           //check if we compare distance from centroid or subelements
           if (!measure_from_subelements)
           {
             if (isMatch_(rt_pep - map[cm_index].getRT(), mz_pep, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
             {
-              id_mapped = true;
               was_added = true;
-              map[cm_index].getPeptideIdentifications().push_back(ids[i]);
-              ++assigned_ids[i];
+              id_matches[i].push_back(SubelementMatch(cm_index, 0));
             }
           }
           else
@@ -311,54 +401,55 @@ namespace OpenMS
             {
               if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
               {
-                id_mapped = true;
                 was_added = true;
-                if (mapping[cm_index].count(i) == 0)
-                {
-                  // Store the map index of the peptide feature in the id the feature was mapped to.
-                  PeptideIdentification id_pep = ids[i];
-                  if (annotate_ids_with_subelements)
-                  {
-                    id_pep.setMetaValue("map_index", it_handle->getMapIndex());
-                  }
-
-                  map[cm_index].getPeptideIdentifications().push_back(id_pep);
-                  ++assigned_ids[i];
-                  mapping[cm_index].insert(i);
-                }
+                id_matches[i].push_back(SubelementMatch(cm_index, it_handle->getMapIndex()));
                 break; // we added this peptide already.. no need to check other handles
               }
             }
-            // continue to here
           }
 
+          // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
           if (was_added) break;
 
         } // m/z values to check
+      } // features
+    }
 
-        // break to here
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
 
-      } // features
+      for (const SubelementMatch& match : id_matches[i])
+      {
+        if (measure_from_subelements && annotate_ids_with_subelements)
+        {
+          // Store the map index of the peptide feature in the id the feature was mapped to.
+          PeptideIdentification id_pep = ids[i];
+          id_pep.setMetaValue("map_index", match.second);
+          map[match.first].getPeptideIdentifications().push_back(id_pep);
+        }
+        else
+        {
+          map[match.first].getPeptideIdentifications().push_back(ids[i]);
+        }
+      }
 
       // the id has not been mapped to any consensus feature
-      if (!id_mapped)
+      if (id_matches[i].empty())
       {
         map.getUnassignedPeptideIdentifications().push_back(ids[i]);
         ++id_matches_none;
       }
-    } // Identifications
-
-    for (std::map<Size, Size>::const_iterator it = assigned_ids.begin(); it != assigned_ids.end(); ++it)
-    {
-      if (it->second == 1)
+      else if (id_matches[i].size() == 1)
       {
         ++id_matches_single;
       }
-      else if (it->second > 1)
+      else
       {
         ++id_matches_multiple;
       }
-    }
+    } // Identifications
+    vector<vector<SubelementMatch> >().swap(id_matches);
 
     vector<Size> unidentified = mapPrecursorsToIdentifications(spectra, ids).unidentified;
 
@@ -400,15 +491,18 @@ namespace OpenMS
     Size spectrum_matches_none(0), spectrum_matches_single(0), spectrum_matches_multiple(0);
 
     // are there any mapped but unidentified precursors?
-    for (Size ui = 0; ui != unidentified.size(); ++ui)
+    // (matches per spectrum and precursor are again searched in parallel)
+    vector<vector<vector<SubelementMatch> > > precursor_matches(unidentified.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize ui = 0; ui < (SignedSize)unidentified.size(); ++ui)
     {
-      Size spectrum_index = unidentified[ui];
-      const MSSpectrum& spectrum = spectra[spectrum_index];
+      const MSSpectrum& spectrum = spectra[unidentified[ui]];
       const vector<Precursor>& precursors = spectrum.getPrecursors();
+      precursor_matches[ui].resize(precursors.size());
 
-      bool precursor_mapped(false);
-
-      // check if precursor has been identified
       for (Size i_p = 0; i_p < precursors.size(); ++i_p)
       {
         // check by precursor mass and spectrum RT
@@ -416,35 +510,28 @@ namespace OpenMS
         int z_p = precursors[i_p].getCharge();
         double rt_value = spectrum.getRT();
 
-        PeptideIdentification precursor_empty_id;
-        precursor_empty_id.setRT(rt_value);
-        precursor_empty_id.setMZ(mz_p);
-        precursor_empty_id.setMetaValue("spectrum_index", spectrum_index);
-        if (!spectra[spectrum_index].getNativeID().empty())
+        // charge states to use for checking:
+        IntList current_charges;
+        if (!ignore_charge_)
         {
-          precursor_empty_id.setMetaValue("spectrum_reference",  spectra[spectrum_index].getNativeID());
+          current_charges.push_back(z_p);
+          current_charges.push_back(0); // "not specified" always matches
         }
-        precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
 
-        // iterate over the consensus features
-        for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
-        {
-          // charge states to use for checking:
-          IntList current_charges;
-          if (!ignore_charge_)
-          {
-            current_charges.push_back(z_p);
-            current_charges.push_back(0); // "not specified" always matches
-          }
+        vector<Size> candidates;
+        index.query(rt_value, rt_tolerance_, mz_p, getAbsoluteMZTolerance_(mz_p), candidates);
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
 
+        // iterate over the candidate consensus features
+        for (Size cm_index : candidates)
+        {
           // check if we compare distance from centroid or subelements
           if (!measure_from_subelements) // measure from centroid
           {
             if (isMatch_(rt_value - map[cm_index].getRT(), mz_p, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
             {
-              map[cm_index].getPeptideIdentifications().push_back(precursor_empty_id);
-              ++assigned_precursors[spectrum_index];
-              precursor_mapped = true;
+              precursor_matches[ui][i_p].push_back(SubelementMatch(cm_index, 0));
             }
           }
           else // measure from subelements
@@ -455,32 +542,59 @@ namespace OpenMS
             {
               if (isMatch_(rt_value - it_handle->getRT(), mz_p, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
               {
-                if (annotate_ids_with_subelements)
-                {
-                  // store the map index the precursor was mapped to
-                  Size map_index = it_handle->getMapIndex();
-
-                  // we use no undesrscore here to be compatible with linkers
-                  precursor_empty_id.setMetaValue("map_index", map_index);
-                }
-                map[cm_index].getPeptideIdentifications().push_back(precursor_empty_id);
-                ++assigned_precursors[spectrum_index];
-                precursor_mapped = true;
+                precursor_matches[ui][i_p].push_back(SubelementMatch(cm_index, it_handle->getMapIndex()));
               }
             }
           }
-        } // m/z values to check
+        }
       }
-      if (!precursor_mapped) ++spectrum_matches_none;
     }
 
-    for (std::map<Size, Size>::const_iterator it = assigned_precursors.begin(); it != assigned_precursors.end(); ++it)
+    for (Size ui = 0; ui != unidentified.size(); ++ui)
     {
-      if (it->second == 1)
+      Size spectrum_index = unidentified[ui];
+      const MSSpectrum& spectrum = spectra[spectrum_index];
+      const vector<Precursor>& precursors = spectrum.getPrecursors();
+
+      Size assigned_precursors(0);
+
+      // check if precursor has been identified
+      for (Size i_p = 0; i_p < precursors.size(); ++i_p)
+      {
+        PeptideIdentification precursor_empty_id;
+        precursor_empty_id.setRT(spectrum.getRT());
+        precursor_empty_id.setMZ(precursors[i_p].getMZ());
+        precursor_empty_id.setMetaValue("spectrum_index", spectrum_index);
+        if (!spectra[spectrum_index].getNativeID().empty())
+        {
+          precursor_empty_id.setMetaValue("spectrum_reference",  spectra[spectrum_index].getNativeID());
+        }
+        precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
+
+        for (const SubelementMatch& match : precursor_matches[ui][i_p])
+        {
+          if (measure_from_subelements && annotate_ids_with_subelements)
+          {
+            // store the map index the precursor was mapped to
+            Size map_index = match.second;
+
+            // we use no undesrscore here to be compatible with linkers
+            precursor_empty_id.setMetaValue("map_index", map_index);
+          }
+          map[match.first].getPeptideIdentifications().push_back(precursor_empty_id);
+          ++assigned_precursors;
+        }
+      }
+
+      if (assigned_precursors == 0)
+      {
+        ++spectrum_matches_none;
+      }
+      else if (assigned_precursors == 1)
       {
         ++spectrum_matches_single;
       }
-      else if (it->second > 1)
+      else
       {
         ++spectrum_matches_multiple;
       }
@@ -535,35 +649,55 @@ namespace OpenMS
       use_avg_mass = checkMassType_(map.getDataProcessing());
     }
 
-    // calculate feature bounding boxes only once:
-    vector<DBoundingBox<2> > boxes;
-    double min_rt = numeric_limits<double>::max();
-    double max_rt = -numeric_limits<double>::max();
-    // cout << "Precomputing bounding boxes..." << endl;
-    boxes.reserve(map.size());
-    for (FeatureMap::Iterator f_it = map.begin();
-         f_it != map.end(); ++f_it)
+    // calculate feature bounding boxes (and those of the mass traces) only once:
+    vector<DBoundingBox<2> > boxes(map.size());
+    vector<vector<DBoundingBox<2> > > hull_boxes(use_centroid_mz ? 0 : map.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (SignedSize index = 0; index < (SignedSize)map.size(); ++index)
     {
+      const Feature& feat = map[index];
       DBoundingBox<2> box;
       if (!(use_centroid_rt && use_centroid_mz))
       {
-        box = f_it->getConvexHull().getBoundingBox();
+        box = feat.getConvexHull().getBoundingBox();
       }
       if (use_centroid_rt)
       {
-        box.setMinX(f_it->getRT());
-        box.setMaxX(f_it->getRT());
+        box.setMinX(feat.getRT());
+        box.setMaxX(feat.getRT());
       }
       if (use_centroid_mz)
       {
-        box.setMinY(f_it->getMZ());
-        box.setMaxY(f_it->getMZ());
+        box.setMinY(feat.getMZ());
+        box.setMaxY(feat.getMZ());
+      }
+      else
+      {
+        for (vector<ConvexHull2D>::const_iterator ch_it = feat.getConvexHulls().begin();
+             ch_it != feat.getConvexHulls().end(); ++ch_it)
+        {
+          DBoundingBox<2> hull_box = ch_it->getBoundingBox();
+          if (use_centroid_rt)
+          {
+            hull_box.setMinX(feat.getRT());
+            hull_box.setMaxX(feat.getRT());
+          }
+          increaseBoundingBox_(hull_box);
+          hull_boxes[index].push_back(hull_box);
+        }
       }
       increaseBoundingBox_(box);
-      boxes.push_back(box);
+      boxes[index] = box;
+    }
 
-      min_rt = min(min_rt, box.minPosition().getX());
-      max_rt = max(max_rt, box.maxPosition().getX());
+    double min_rt = numeric_limits<double>::max();
+    double max_rt = -numeric_limits<double>::max();
+    for (Size index = 0; index < boxes.size(); ++index)
+    {
+      min_rt = min(min_rt, boxes[index].minPosition().getX());
+      max_rt = max(max_rt, boxes[index].maxPosition().getX());
     }
 
     // hash bounding boxes of features by RT:
@@ -576,7 +710,6 @@ namespace OpenMS
 
     if (map.size() > 0)
     {
-      // cout << "Setting up hash table..." << endl;
       offset = SignedSize(floor(min_rt));
       // this only works if features were found
       hash_table.resize(SignedSize(floor(max_rt)) - offset + 1);
@@ -595,38 +728,50 @@ namespace OpenMS
       OPENMS_LOG_WARN << "IDMapper received an empty FeatureMap! All peptides are mapped as 'unassigned'!" << endl;
     }
 
+    // returns whether the position matches the feature (or one of its mass traces)
+    auto featureMatches = [&](Size feature_index, const DPosition<2>& pos)
+    {
+      if (!boxes[feature_index].encloses(pos)) return false;
+      // only one m/z value to check, which was already incorporated
+      // into the overall bounding box -> success!
+      if (use_centroid_mz) return true;
+      // else: check all the mass traces
+      for (const DBoundingBox<2>& hull_box : hull_boxes[feature_index])
+      {
+        if (hull_box.encloses(pos)) return true;
+      }
+      return false;
+    };
+
     // for statistics:
     Size matches_none = 0, matches_single = 0, matches_multi = 0;
 
-    // cout << "Finding matches..." << endl;
-    // iterate over peptide IDs:
-    for (vector<PeptideIdentification>::const_iterator id_it =
-         ids.begin(); id_it != ids.end(); ++id_it)
-    {
-      // cout << "Peptide ID: " << id_it - ids.begin() << endl;
+    // find the matching features of all peptide IDs in parallel,
+    // then assign the IDs sequentially to keep the order deterministic
+    vector<vector<Size> > id_matches(ids.size());
 
-      if (id_it->getHits().empty()) continue;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize id_index = 0; id_index < (SignedSize)ids.size(); ++id_index)
+    {
+      const PeptideIdentification& id = ids[id_index];
+      if (id.getHits().empty()) continue;
 
       DoubleList mz_values;
       double rt_value;
       IntList charges;
-      getIDDetails_(*id_it, rt_value, mz_values, charges, use_avg_mass);
+      getIDDetails_(id, rt_value, mz_values, charges, use_avg_mass);
 
-      if ((rt_value < min_rt) || (rt_value > max_rt)) // RT out of bounds
-      {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
-        ++matches_none;
-        continue;
-      }
+      if ((rt_value < min_rt) || (rt_value > max_rt)) continue; // RT out of bounds
 
       // iterate over candidate features:
       Size index = SignedSize(floor(rt_value)) - offset;
-      Size matching_features = 0;
-      for (vector<SignedSize>::iterator hash_it =
+      for (vector<SignedSize>::const_iterator hash_it =
            hash_table[index].begin(); hash_it != hash_table[index].end();
            ++hash_it)
       {
-        Feature & feat = map[*hash_it];
+        const Feature & feat = map[*hash_it];
 
         // need to check the charge state?
         bool check_charge = !ignore_charge_;
@@ -646,45 +791,28 @@ namespace OpenMS
             continue;                   // charge states need to match
           }
 
-          DPosition<2> id_pos(rt_value, *mz_it);
-          if (boxes[*hash_it].encloses(id_pos))                 // potential match
+          if (featureMatches(*hash_it, DPosition<2>(rt_value, *mz_it))) // success!
           {
-            if (use_centroid_mz)
-            {
-              // only one m/z value to check, which was already incorporated
-              // into the overall bounding box -> success!
-              feat.getPeptideIdentifications().push_back(*id_it);
-              ++matching_features;
-              break;                     // "mz_it" loop
-            }
-            // else: check all the mass traces
-            bool found_match = false;
-            for (vector<ConvexHull2D>::iterator ch_it =
-                 feat.getConvexHulls().begin(); ch_it !=
-                 feat.getConvexHulls().end(); ++ch_it)
-            {
-              DBoundingBox<2> box = ch_it->getBoundingBox();
-              if (use_centroid_rt)
-              {
-                box.setMinX(feat.getRT());
-                box.setMaxX(feat.getRT());
-              }
-              increaseBoundingBox_(box);
-              if (box.encloses(id_pos)) // success!
-              {
-                feat.getPeptideIdentifications().push_back(*id_it);
-                ++matching_features;
-                found_match = true;
-                break; // "ch_it" loop
-              }
-            }
-            if (found_match) break; // "mz_it" loop
+            id_matches[id_index].push_back(*hash_it);
+            break; // "mz_it" loop
           }
         }
       }
+    }
+
+    for (Size id_index = 0; id_index < ids.size(); ++id_index)
+    {
+      if (ids[id_index].getHits().empty()) continue;
+
+      for (Size feature_index : id_matches[id_index])
+      {
+        map[feature_index].getPeptideIdentifications().push_back(ids[id_index]);
+      }
+
+      Size matching_features = id_matches[id_index].size();
       if (matching_features == 0)
       {
-        map.getUnassignedPeptideIdentifications().push_back(*id_it);
+        map.getUnassignedPeptideIdentifications().push_back(ids[id_index]);
         ++matches_none;
       }
       else if (matching_features == 1)
@@ -696,12 +824,12 @@ namespace OpenMS
         ++matches_multi;
       }
     }
+    vector<vector<Size> >().swap(id_matches);
 
     vector<Size> unidentified = mapPrecursorsToIdentifications(spectra, ids).unidentified;
 
     // map all unidentified precursor to features
     Size spectrum_matches_none(0);
-    Size spectrum_matches(0);
     Size spectrum_matches_single(0);
     Size spectrum_matches_multi(0);
 
@@ -729,11 +857,17 @@ namespace OpenMS
     }
 
     // are there any mapped but unidentified precursors?
-    for (Size i = 0; i != unidentified.size(); ++i)
+    // (each precursor is assigned to the first matching feature, or -1 if none)
+    vector<vector<SignedSize> > precursor_matches(unidentified.size());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)unidentified.size(); ++i)
     {
-      Size spectrum_index = unidentified[i];
-      const MSSpectrum& spectrum = spectra[spectrum_index];
+      const MSSpectrum& spectrum = spectra[unidentified[i]];
       const vector<Precursor>& precursors = spectrum.getPrecursors();
+      precursor_matches[i].assign(precursors.size(), -1);
 
       // check if precursor has been identified
       for (Size i_p = 0; i_p < precursors.size(); ++i_p)
@@ -743,89 +877,55 @@ namespace OpenMS
         double rt_value = spectrum.getRT();
         int z_p = precursors[i_p].getCharge();
 
-        if ((rt_value < min_rt) || (rt_value > max_rt)) // RT out of bounds
-        {
-          ++spectrum_matches_none;
-          continue;
-        }
+        if ((rt_value < min_rt) || (rt_value > max_rt)) continue; // RT out of bounds
 
         // iterate over candidate features:
         Size index = SignedSize(floor(rt_value)) - offset;
-        Size matching_features = 0;
-
-        PeptideIdentification precursor_empty_id;
-        precursor_empty_id.setRT(rt_value);
-        precursor_empty_id.setMZ(mz_p);
-        precursor_empty_id.setMetaValue("spectrum_index", spectrum_index);
-        if (!spectra[spectrum_index].getNativeID().empty())
-        {
-          precursor_empty_id.setMetaValue("spectrum_reference",  spectra[spectrum_index].getNativeID());
-        }
-        precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
-        //precursor_empty_id.setCharge(z_p);
-
-        for (vector<SignedSize>::iterator hash_it =
+        for (vector<SignedSize>::const_iterator hash_it =
            hash_table[index].begin(); hash_it != hash_table[index].end();
            ++hash_it)
         {
-          Feature & feat = map[*hash_it];
-
           // (optinally) check charge state
           if (!ignore_charge_)
           {
-            if (z_p != feat.getCharge()) continue;
+            if (z_p != map[*hash_it].getCharge()) continue;
           }
 
-          DPosition<2> id_pos(rt_value, mz_p);
-
-          if (boxes[*hash_it].encloses(id_pos)) // potential match
+          if (featureMatches(*hash_it, DPosition<2>(rt_value, mz_p))) // success!
           {
-            if (use_centroid_mz)
-            {
-              // only one m/z value to check, which was already incorporated
-              // into the overall bounding box -> success!
-              feat.getPeptideIdentifications().push_back(precursor_empty_id);
-              ++spectrum_matches;
-              break; // "mz_it" loop
-            }
-            // else: check all the mass traces
-            bool found_match = false;
-            for (vector<ConvexHull2D>::iterator ch_it =
-                  feat.getConvexHulls().begin(); ch_it !=
-                  feat.getConvexHulls().end(); ++ch_it)
-            {
-              DBoundingBox<2> box = ch_it->getBoundingBox();
-              if (use_centroid_rt)
-              {
-                box.setMinX(feat.getRT());
-                box.setMaxX(feat.getRT());
-              }
-              increaseBoundingBox_(box);
-              if (box.encloses(id_pos)) // success!
-              {
-                feat.getPeptideIdentifications().push_back(precursor_empty_id);
-                ++matching_features;
-                found_match = true;
-                break; // "ch_it" loop
-              }
-            }
-
-            if (found_match) break; // "mz_it" loop
+            precursor_matches[i][i_p] = *hash_it;
+            break;
           }
         }
+      }
+    }
 
-        if (matching_features == 0)
+    for (Size i = 0; i != unidentified.size(); ++i)
+    {
+      Size spectrum_index = unidentified[i];
+      const MSSpectrum& spectrum = spectra[spectrum_index];
+      const vector<Precursor>& precursors = spectrum.getPrecursors();
+
+      for (Size i_p = 0; i_p < precursors.size(); ++i_p)
+      {
+        if (precursor_matches[i][i_p] < 0)
         {
           ++spectrum_matches_none;
+          continue;
         }
-        else if (matching_features == 1)
-        {
-          ++spectrum_matches_single;
-        }
-        else
+
+        PeptideIdentification precursor_empty_id;
+        precursor_empty_id.setRT(spectrum.getRT());
+        precursor_empty_id.setMZ(precursors[i_p].getMZ());
+        precursor_empty_id.setMetaValue("spectrum_index", spectrum_index);
+        if (!spectra[spectrum_index].getNativeID().empty())
         {
-          ++spectrum_matches_multi;
+          precursor_empty_id.setMetaValue("spectrum_reference",  spectra[spectrum_index].getNativeID());
         }
+        precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
+
+        map[precursor_matches[i][i_p]].getPeptideIdentifications().push_back(precursor_empty_id);
+        ++spectrum_matches_single;
       }
     }
 
@@ -912,7 +1012,7 @@ namespace OpenMS
     }
   }
 
-  void IDMapper::increaseBoundingBox_(DBoundingBox<2>& box)
+  void IDMapper::increaseBoundingBox_(DBoundingBox<2>& box) const
   {
     DPosition<2> sub_min(rt_tolerance_,
                          getAbsoluteMZTolerance_(box.minPosition().getY())),
@@ -35,6 +35,7 @@
 #include <OpenMS/ANALYSIS/ID/MetaboliteSpectralMatching.h>
 
 
+#include <cmath>
 #include <numeric>
 #include <boost/math/special_functions/factorials.hpp>
 
@@ -297,6 +298,9 @@ namespace OpenMS
     defaults_.setValue("ionization_mode", "positive", "Positive or negative ionization mode?");
     defaults_.setValidStrings("ionization_mode", ListUtils::create<String>(("positive,negative")));
 
+    defaults_.setValue("prefilter_top_n", 50, "Number of library candidates per precursor (ranked by binned cosine similarity) for which the hyperscore is computed. Set to 0 to score all candidates within the precursor window.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("prefilter_top_n", 0);
+
     defaultsToParam_();
 
     this->setLogType(CMD);
@@ -449,6 +453,14 @@ namespace OpenMS
       mz_keys.push_back(spec_db[spec_idx].getPrecursors()[0].getMZ());
     }
 
+    // bin and normalize the library once (it is searched by every query)
+    const double bin_width = prefilterBinWidth_();
+    LibraryIndex_ lib_index;
+    if (prefilter_top_n_ > 0)
+    {
+      buildLibraryIndex_(spec_db, bin_width, lib_index);
+    }
+
     // remove potential noise peaks by selecting the ten most intense peak per 100 Da window
     WindowMower wm;
     Param wm_param;
@@ -465,120 +477,178 @@ namespace OpenMS
     spme.mergeSpectraPrecursors(msexp);
     wm.filterPeakMap(msexp);
 
-
-    // container storing results
-    vector<SpectralMatch> matching_results;
-
     bool fragment_error_unit_ppm(true);
     if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
 
-    for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+    // results per query spectrum, concatenated in input order afterwards
+    vector<vector<SpectralMatch> > results_per_spectrum(msexp.size());
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-      // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
+      // dense binned query spectrum (reused between queries of the same thread)
+      vector<float> query_bins;
 
-      // iterate over all precursor masses
-      for (Size prec_idx = 0; prec_idx < msexp[spec_idx].getPrecursors().size(); ++prec_idx)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize spec_idx = 0; spec_idx < (SignedSize)msexp.size(); ++spec_idx)
       {
-        // get precursor m/z
-        double precursor_mz(msexp[spec_idx].getPrecursors()[prec_idx].getMZ());
-
-        // cout << "precursor no. " << prec_idx << ": mz " << precursor_mz << " ";
+        const MSSpectrum& query = msexp[spec_idx];
+        vector<SpectralMatch>& matching_results = results_per_spectrum[spec_idx];
 
-        double prec_mz_lowerbound, prec_mz_upperbound;
-
-        if (!fragment_error_unit_ppm) // Da
-        {
-          prec_mz_lowerbound = precursor_mz - precursor_mz_error_;
-          prec_mz_upperbound = precursor_mz + precursor_mz_error_;
-        }
-        else // ppm
+        // the query spectrum is binned once for all its precursors; every peak
+        // also contributes to the neighboring bins so that matches within the
+        // fragment tolerance are not lost at bin borders
+        if (prefilter_top_n_ > 0)
         {
-          double ppm_offset(precursor_mz * 1e-6 * precursor_mz_error_);
-          prec_mz_lowerbound = precursor_mz - ppm_offset;
-          prec_mz_upperbound = precursor_mz + ppm_offset;
+          query_bins.assign(query.empty() ? 0 : UInt(query.back().getMZ() / bin_width) + 2, 0.0f);
+          for (MSSpectrum::ConstIterator it = query.begin(); it != query.end(); ++it)
+          {
+            UInt bin = UInt(it->getMZ() / bin_width);
+            for (UInt b = (bin > 0 ? bin - 1 : 0); b <= bin + 1; ++b)
+            {
+              query_bins[b] = max(query_bins[b], float(it->getIntensity()));
+            }
+          }
+          float norm = sqrt(inner_product(query_bins.begin(), query_bins.end(), query_bins.begin(), 0.0f));
+          if (norm > 0)
+          {
+            for (float& q : query_bins) q /= norm;
+          }
         }
 
-        // cout << "lower mz: " << prec_mz_lowerbound << " ";
-        // cout << "upper mz: " << prec_mz_upperbound << endl;
+        // iterate over all precursor masses
+        for (Size prec_idx = 0; prec_idx < query.getPrecursors().size(); ++prec_idx)
+        {
+          // get precursor m/z
+          double precursor_mz(query.getPrecursors()[prec_idx].getMZ());
 
-        vector<double>::const_iterator lower_it = lower_bound(mz_keys.begin(), mz_keys.end(), prec_mz_lowerbound);
-        vector<double>::const_iterator upper_it = upper_bound(mz_keys.begin(), mz_keys.end(), prec_mz_upperbound);
+          double prec_mz_lowerbound, prec_mz_upperbound;
 
-        Size start_idx(lower_it - mz_keys.begin());
-        Size end_idx(upper_it - mz_keys.begin());
+          if (!fragment_error_unit_ppm) // Da
+          {
+            prec_mz_lowerbound = precursor_mz - precursor_mz_error_;
+            prec_mz_upperbound = precursor_mz + precursor_mz_error_;
+          }
+          else // ppm
+          {
+            double ppm_offset(precursor_mz * 1e-6 * precursor_mz_error_);
+            prec_mz_lowerbound = precursor_mz - ppm_offset;
+            prec_mz_upperbound = precursor_mz + ppm_offset;
+          }
 
-        //cout << "identifying " << msexp[spec_idx].getMetaValue("Massbank_Accession_ID") << endl;
+          vector<double>::const_iterator lower_it = lower_bound(mz_keys.begin(), mz_keys.end(), prec_mz_lowerbound);
+          vector<double>::const_iterator upper_it = upper_bound(mz_keys.begin(), mz_keys.end(), prec_mz_upperbound);
 
-        vector<SpectralMatch> partial_results;
+          Size start_idx(lower_it - mz_keys.begin());
+          Size end_idx(upper_it - mz_keys.begin());
 
-        for (Size search_idx = start_idx; search_idx < end_idx; ++search_idx)
-        {
-          // do spectral matching
-          // cout << "scanning " << spec_db[search_idx].getPrecursors()[0].getMZ() << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << endl;
+          // collect candidates with matching charge state of precursor ions
+          vector<Size> candidates;
+          for (Size search_idx = start_idx; search_idx < end_idx; ++search_idx)
+          {
+            if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
+            {
+              continue;
+            }
+            candidates.push_back(search_idx);
+          }
 
-          // check for charge state of precursor ions: do they match?
-          if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
+          // cosine prefilter: keep only the most similar candidates for the hyperscore
+          if (prefilter_top_n_ > 0 && candidates.size() > prefilter_top_n_)
           {
-            continue;
+            vector<pair<float, Size> > ranked;
+            ranked.reserve(candidates.size());
+            for (Size search_idx : candidates)
+            {
+              float cosine = 0.0f;
+              for (Size k = lib_index.offsets[search_idx]; k < lib_index.offsets[search_idx + 1]; ++k)
+              {
+                if (lib_index.bins[k] >= query_bins.size()) break; // bins are sorted
+                cosine += query_bins[lib_index.bins[k]] * lib_index.weights[k];
+              }
+              // negate the score, so ties are resolved by library index
+              ranked.push_back(make_pair(-cosine, search_idx));
+            }
+            partial_sort(ranked.begin(), ranked.begin() + prefilter_top_n_, ranked.end());
+            ranked.resize(prefilter_top_n_);
+
+            candidates.clear();
+            for (const pair<float, Size>& r : ranked)
+            {
+              candidates.push_back(r.second);
+            }
+            sort(candidates.begin(), candidates.end());
           }
 
-          double hyperscore(computeHyperScore(fragment_mz_error_, fragment_error_unit_ppm, msexp[spec_idx], spec_db[search_idx], 0.0));
+          vector<SpectralMatch> partial_results;
 
-          // cout << " scored with " << hyperScore << endl;
-          if (hyperscore > 0)
+          for (Size search_idx : candidates)
           {
-            // cout << "  ** detected " << spec_db[search_idx].getMetaValue("Massbank_Accession_ID") << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << " scored with " << hyperscore << endl;
-
-            // score result temporarily
-            SpectralMatch tmp_match;
-            tmp_match.setObservedPrecursorMass(precursor_mz);
-            tmp_match.setFoundPrecursorMass(spec_db[search_idx].getPrecursors()[0].getMZ());
-            double obs_rt = floor(msexp[spec_idx].getRT() * 10)/10.0;
-            tmp_match.setObservedPrecursorRT(obs_rt);
-            tmp_match.setFoundPrecursorCharge(spec_db[search_idx].getPrecursors()[0].getCharge());
-            tmp_match.setMatchingScore(hyperscore);
-            tmp_match.setObservedSpectrumIndex(spec_idx);
-            tmp_match.setMatchingSpectrumIndex(search_idx);
-
-            tmp_match.setPrimaryIdentifier(spec_db[search_idx].getMetaValue("Massbank_Accession_ID"));
-            tmp_match.setSecondaryIdentifier(spec_db[search_idx].getMetaValue("HMDB_ID"));
-            tmp_match.setSumFormula(spec_db[search_idx].getMetaValue("Sum_Formula"));
-            tmp_match.setCommonName(spec_db[search_idx].getMetaValue("Metabolite_Name"));
-            tmp_match.setInchiString(spec_db[search_idx].getMetaValue("Inchi_String"));
-            tmp_match.setSMILESString(spec_db[search_idx].getMetaValue("SMILES_String"));
-            tmp_match.setPrecursorAdduct(spec_db[search_idx].getMetaValue("Precursor_Ion"));
-
-            partial_results.push_back(tmp_match);
+            // do spectral matching
+            double hyperscore(computeHyperScore(fragment_mz_error_, fragment_error_unit_ppm, query, spec_db[search_idx], 0.0));
+
+            if (hyperscore > 0)
+            {
+              // score result temporarily
+              SpectralMatch tmp_match;
+              tmp_match.setObservedPrecursorMass(precursor_mz);
+              tmp_match.setFoundPrecursorMass(spec_db[search_idx].getPrecursors()[0].getMZ());
+              double obs_rt = floor(query.getRT() * 10)/10.0;
+              tmp_match.setObservedPrecursorRT(obs_rt);
+              tmp_match.setFoundPrecursorCharge(spec_db[search_idx].getPrecursors()[0].getCharge());
+              tmp_match.setMatchingScore(hyperscore);
+              tmp_match.setObservedSpectrumIndex(spec_idx);
+              tmp_match.setMatchingSpectrumIndex(search_idx);
+
+              tmp_match.setPrimaryIdentifier(spec_db[search_idx].getMetaValue("Massbank_Accession_ID"));
+              tmp_match.setSecondaryIdentifier(spec_db[search_idx].getMetaValue("HMDB_ID"));
+              tmp_match.setSumFormula(spec_db[search_idx].getMetaValue("Sum_Formula"));
+              tmp_match.setCommonName(spec_db[search_idx].getMetaValue("Metabolite_Name"));
+              tmp_match.setInchiString(spec_db[search_idx].getMetaValue("Inchi_String"));
+              tmp_match.setSMILESString(spec_db[search_idx].getMetaValue("SMILES_String"));
+              tmp_match.setPrecursorAdduct(spec_db[search_idx].getMetaValue("Precursor_Ion"));
+
+              partial_results.push_back(tmp_match);
+            }
           }
-        }
 
-        // sort results by decreasing store
-        sort(partial_results.begin(), partial_results.end(), SpectralMatchScoreGreater);
+          // sort results by decreasing store
+          stable_sort(partial_results.begin(), partial_results.end(), SpectralMatchScoreGreater);
 
-        // report mode: top3 or best?
-        if (report_mode_ == "top3")
-        {
-          Size num_results(partial_results.size());
+          // report mode: top3 or best?
+          if (report_mode_ == "top3")
+          {
+            Size num_results(partial_results.size());
 
-          Size last_result_idx = (num_results >= 3) ? 3 : num_results;
+            Size last_result_idx = (num_results >= 3) ? 3 : num_results;
 
-          for (Size result_idx = 0; result_idx < last_result_idx; ++result_idx)
-          {
-            // cout << "score: " << partial_results[result_idx].getMatchingScore() << " " << partial_results[result_idx].getMatchingSpectrumIndex() << endl;
-            matching_results.push_back(partial_results[result_idx]);
+            for (Size result_idx = 0; result_idx < last_result_idx; ++result_idx)
+            {
+              matching_results.push_back(partial_results[result_idx]);
+            }
           }
-        }
 
-        if (report_mode_ == "best")
-        {
-          if (partial_results.size() > 0)
+          if (report_mode_ == "best")
           {
-            matching_results.push_back(partial_results[0]);
+            if (partial_results.size() > 0)
+            {
+              matching_results.push_back(partial_results[0]);
+            }
           }
-        }
 
-      } // end precursor loop
-    } // end spectra loop
+        } // end precursor loop
+      } // end spectra loop
+    }
+
+    // container storing results
+    vector<SpectralMatch> matching_results;
+    for (Size spec_idx = 0; spec_idx < results_per_spectrum.size(); ++spec_idx)
+    {
+      matching_results.insert(matching_results.end(), results_per_spectrum[spec_idx].begin(), results_per_spectrum[spec_idx].end());
+    }
 
     // write final results to MzTab
     exportMzTab_(matching_results, mztab_out);
@@ -595,11 +665,65 @@ namespace OpenMS
 
     mz_error_unit_ = (String)param_.getValue("mass_error_unit");
     report_mode_ = (String)param_.getValue("report_mode");
+    prefilter_top_n_ = (Int)param_.getValue("prefilter_top_n");
   }
 
 
   /// private methods
 
+  double MetaboliteSpectralMatching::prefilterBinWidth_() const
+  {
+    // bins span twice the fragment tolerance; for ppm, the tolerance at m/z 1000 is used
+    double tolerance = fragment_mz_error_;
+    if (mz_error_unit_ != "Da")
+    {
+      tolerance = fragment_mz_error_ * 1e-6 * 1000.0;
+    }
+    return max(2.0 * tolerance, 0.01);
+  }
+
+
+  void MetaboliteSpectralMatching::buildLibraryIndex_(const PeakMap& spec_db, double bin_width, LibraryIndex_& index) const
+  {
+    index.offsets.assign(1, 0);
+    index.bins.clear();
+    index.weights.clear();
+
+    vector<pair<UInt, float> > binned;
+    for (Size spec_idx = 0; spec_idx < spec_db.size(); ++spec_idx)
+    {
+      binned.clear();
+      for (MSSpectrum::ConstIterator it = spec_db[spec_idx].begin(); it != spec_db[spec_idx].end(); ++it)
+      {
+        binned.push_back(make_pair(UInt(it->getMZ() / bin_width), float(it->getIntensity())));
+      }
+      sort(binned.begin(), binned.end());
+
+      // sum up peaks falling into the same bin
+      Size first = index.bins.size();
+      for (const pair<UInt, float>& b : binned)
+      {
+        if (index.bins.size() > first && index.bins.back() == b.first)
+        {
+          index.weights.back() += b.second;
+        }
+        else
+        {
+          index.bins.push_back(b.first);
+          index.weights.push_back(b.second);
+        }
+      }
+
+      float norm = sqrt(inner_product(index.weights.begin() + first, index.weights.end(), index.weights.begin() + first, 0.0f));
+      if (norm > 0)
+      {
+        for (Size k = first; k < index.weights.size(); ++k) index.weights[k] /= norm;
+      }
+      index.offsets.push_back(index.bins.size());
+    }
+  }
+
+
   void MetaboliteSpectralMatching::exportMzTab_(const vector<SpectralMatch>& overall_results, MzTab& mztab_out)
   {
     // iterate the overall results table
@@ -34,6 +34,10 @@
 
 #include <OpenMS/ANALYSIS/ID/PeptideIndexing.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace OpenMS;
 using namespace std;
@@ -127,5 +131,560 @@ bool PeptideIndexing::isPrefix() const
 }
 
 
+void PeptideIndexing::setDecoyString_(DecoyHelper::Result r)
+{
+  if (!r.success)
+  {
+    r.is_prefix = true;
+    r.name = "DECOY_";
+    OPENMS_LOG_WARN << "Unable to determine decoy string automatically (not enough decoys were detected)! Using default " << (r.is_prefix ? "prefix" : "suffix") << " decoy string '" << r.name << "'\n"
+                    << "If you think that this is incorrect, please provide a decoy_string and its position manually!" << std::endl;
+  }
+  prefix_ = r.is_prefix;
+  decoy_string_ = r.name;
+  // decoy string and position was extracted successfully
+  OPENMS_LOG_INFO << "Using " << (prefix_ ? "prefix" : "suffix") << " decoy string '" << decoy_string_ << "'" << std::endl;
+}
+
+ProteaseDigestion PeptideIndexing::getEnzyme_(const std::vector<ProteinIdentification>& prot_ids, bool& xtandem_fix_parameters) const
+{
+  ProteaseDigestion enzyme;
+  enzyme.setEnzyme(enzyme_name_);
+  enzyme.setSpecificity(enzyme.getSpecificityByName(enzyme_specificity_));
+
+  xtandem_fix_parameters = true;
+  bool msgfplus_fix_parameters = true;
+
+  // determine if search engine is solely xtandem or MSGFPlus
+  for (const auto& prot_id : prot_ids)
+  {
+    String search_engine = prot_id.getSearchEngine();
+    StringUtils::toUpper(search_engine);
+    if (search_engine != "XTANDEM") { xtandem_fix_parameters = false; }
+    if (!(search_engine == "MSGFPLUS" || search_engine == "MS-GF+")) { msgfplus_fix_parameters = false; }
+  }
+
+  // solely MSGFPlus -> Trypsin/P as enzyme
+  if (msgfplus_fix_parameters && enzyme.getEnzymeName() == "Trypsin")
+  {
+    OPENMS_LOG_WARN << "MSGFPlus detected but enzyme cutting rules were set to Trypsin. Correcting to Trypsin/P to copy with special cutting rule in MSGFPlus." << std::endl;
+    enzyme.setEnzyme("Trypsin/P");
+  }
+  return enzyme;
+}
+
+void PeptideIndexing::collectPeptideSequences_(const std::vector<PeptideIdentification>& pep_ids, std::vector<String>& pep_sequences) const
+{
+  bool has_illegal_AAs(false);
+  pep_sequences.clear();
+  for (std::vector<PeptideIdentification>::const_iterator it1 = pep_ids.begin(); it1 != pep_ids.end(); ++it1)
+  {
+    //String run_id = it1->getIdentifier();
+    const std::vector<PeptideHit>& hits = it1->getHits();
+    for (std::vector<PeptideHit>::const_iterator it2 = hits.begin(); it2 != hits.end(); ++it2)
+    {
+      //
+      // Warning:
+      // do not skip over peptides here, since the results are iterated in the same way
+      //
+      String seq = it2->getSequence().toUnmodifiedString().remove('*'); // make a copy, i.e. do NOT change the peptide sequence!
+      if (seqan::isAmbiguous(seqan::AAString(seq.c_str())))
+      { // do not quit here, to show the user all sequences .. only quit after loop
+        OPENMS_LOG_ERROR << "Peptide sequence '" << it2->getSequence() << "' contains one or more ambiguous amino acids (B|J|Z|X).\n";
+        has_illegal_AAs = true;
+      }
+      if (IL_equivalent_) // convert L to I;
+      {
+        seq.substitute('L', 'I');
+      }
+      pep_sequences.push_back(seq);
+    }
+  }
+  if (has_illegal_AAs)
+  {
+    OPENMS_LOG_ERROR << "One or more peptides contained illegal amino acids. This is not allowed!"
+              << "\nPlease either remove the peptide or replace it with one of the unambiguous ones (while allowing for ambiguous AA's to match the protein)." << std::endl;;
+  }
+}
+
+PeptideIndexing::ExitCodes PeptideIndexing::run(const ProteinDBIndex& index, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids)
+{
+  // no decoy string provided? use the one detected when building the index
+  if (decoy_string_.empty())
+  {
+    setDecoyString_(index.getDecoyInfo());
+  }
+
+  bool xtandem_fix_parameters(false);
+  const ProteaseDigestion enzyme = getEnzyme_(prot_ids, xtandem_fix_parameters);
+
+  if (index.empty()) // we do not allow an empty database
+  {
+    OPENMS_LOG_ERROR << "Error: An empty database was provided. Mapping makes no sense. Aborting..." << std::endl;
+    return DATABASE_EMPTY;
+  }
+
+  if (pep_ids.empty()) // we allow this case, since the TOPP tool should not crash when encountering a bad raw file (with no PSMs)
+  {
+    OPENMS_LOG_WARN << "Warning: An empty set of peptide identifications was provided. Output will be empty as well." << std::endl;
+    if (!keep_unreferenced_proteins_)
+    {
+      // delete only protein hits, not whole ID runs incl. meta data:
+      for (ProteinIdentification& prot_id : prot_ids)
+      {
+        prot_id.getHits().clear();
+      }
+    }
+    return PEPTIDE_IDS_EMPTY;
+  }
+
+  const Size protein_count = index.size();
+  FoundProteinFunctor func(enzyme, xtandem_fix_parameters); // store the matches
+  Map<String, Size> acc_to_prot; // map: accessions --> FASTA protein index
+  std::vector<bool> protein_is_decoy(protein_count); // protein index -> is decoy?
+  std::vector<std::string> protein_accessions(protein_count); // protein index -> accession
+
+  bool invalid_protein_sequence = false; // check for proteins with modifications, i.e. '[' or '(', and throw an exception
+  Size count_j_proteins(0);
+
+  // proteins which require tolerant search (Aho-Corasick); all others are looked up in the index
+  std::vector<Size> ac_proteins;
+  std::vector<bool> is_ac_protein(protein_count, mm_max_ > 0);
+  for (Size i = 0; i < protein_count; ++i)
+  {
+    const String acc = index.getAccession(i);
+    protein_is_decoy[i] = (prefix_ ? acc.hasPrefix(decoy_string_) : acc.hasSuffix(decoy_string_));
+
+    const UInt flags = index.getFlags(i);
+    if (flags & ProteinDBIndex::HAS_MODIFICATION) invalid_protein_sequence = true;
+    if (!IL_equivalent_ && (flags & ProteinDBIndex::HAS_J)) ++count_j_proteins;
+
+    const bool ambiguous = (flags & ProteinDBIndex::HAS_AMBIGUOUS_AA) || (!IL_equivalent_ && (flags & ProteinDBIndex::HAS_J));
+    if (aaa_max_ > 0 && ambiguous) is_ac_protein[i] = true;
+    if (is_ac_protein[i]) ac_proteins.push_back(i);
+  }
+
+  { // new scope - forget data after search
+    std::vector<String> pep_sequences;
+    collectPeptideSequences_(pep_ids, pep_sequences);
+
+    OPENMS_LOG_INFO << "Mapping " << pep_sequences.size() << " peptides to " << protein_count << " proteins." << std::endl;
+
+    if (pep_sequences.empty())
+    {
+      OPENMS_LOG_WARN << "Warning: Peptide identifications have no hits inside! Output will be empty as well." << std::endl;
+      return PEPTIDE_IDS_EMPTY;
+    }
+
+    SysInfo::MemUsage mu;
+
+    /*
+       Index lookup (exact and I/L-equivalent matches)
+    */
+    if (ac_proteins.size() < protein_count)
+    {
+      this->startProgress(0, pep_sequences.size(), "Index lookup");
+      std::atomic<int> progress_peps(0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        FoundProteinFunctor func_threads(enzyme, xtandem_fix_parameters);
+        std::vector<Size> found_proteins_thread; // indices of proteins with hits
+        std::vector<std::pair<Size, Size> > hits; // protein index, position
+        String prot;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100) nowait
+#endif
+        for (SignedSize p = 0; p < (SignedSize)pep_sequences.size(); ++p)
+        {
+          ++progress_peps; // atomic
+#ifdef _OPENMP
+          if (omp_get_thread_num() == 0)
+#endif
+          {
+            this->setProgress(progress_peps);
+          }
+
+          hits.clear();
+          index.findPeptide(pep_sequences[p], IL_equivalent_, hits);
+          std::sort(hits.begin(), hits.end()); // fetch each protein sequence only once
+          Size prot_idx = protein_count;
+          for (const std::pair<Size, Size>& hit : hits)
+          {
+            if (is_ac_protein[hit.first]) continue; // searched by Aho-Corasick below
+            if (hit.first != prot_idx)
+            {
+              prot_idx = hit.first;
+              prot = index.getSequence(prot_idx, IL_equivalent_);
+              found_proteins_thread.push_back(prot_idx);
+            }
+            func_threads.addHit(p, prot_idx, pep_sequences[p].size(), prot, (Int)hit.second);
+          }
+        }
+
+        // join results again
+#ifdef _OPENMP
+#pragma omp critical(PeptideIndexer_joinIndex)
+#endif
+        {
+          func.merge(func_threads);
+          for (Size prot_idx : found_proteins_thread)
+          {
+            protein_accessions[prot_idx] = index.getAccession(prot_idx);
+            acc_to_prot[protein_accessions[prot_idx]] = prot_idx;
+          }
+        }
+      } // OMP end parallel
+      this->endProgress();
+    }
+
+    /*
+       Aho Corasick (tolerant search, only where required)
+    */
+    if (!ac_proteins.empty())
+    {
+      OPENMS_LOG_INFO << "Searching " << ac_proteins.size() << " protein(s) with up to " << aaa_max_ << " ambiguous amino acid(s) and " << mm_max_ << " mismatch(es)!" << std::endl;
+      AhoCorasickAmbiguous::PeptideDB pep_DB;
+      for (const String& seq : pep_sequences)
+      {
+        appendValue(pep_DB, seq.c_str());
+      }
+      AhoCorasickAmbiguous::FuzzyACPattern pattern;
+      AhoCorasickAmbiguous::initPattern(pep_DB, aaa_max_, mm_max_, pattern);
+
+      const std::string jumpX(aaa_max_ + mm_max_ + 1, 'X'); // jump over stretches of 'X' which cost a lot of time; +1 because  AXXA is a valid hit for aaa_max == 2 (cannot split it)
+      this->startProgress(0, ac_proteins.size(), "Aho-Corasick");
+      std::atomic<int> progress_prots(0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        FoundProteinFunctor func_threads(enzyme, xtandem_fix_parameters);
+        std::vector<Size> found_proteins_thread; // indices of proteins with hits
+        AhoCorasickAmbiguous fuzzyAC;
+        String prot;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100) nowait
+#endif
+        for (SignedSize i = 0; i < (SignedSize)ac_proteins.size(); ++i)
+        {
+          ++progress_prots; // atomic
+#ifdef _OPENMP
+          if (omp_get_thread_num() == 0)
+#endif
+          {
+            this->setProgress(progress_prots);
+          }
+
+          const Size prot_idx = ac_proteins[i];
+          prot = index.getSequence(prot_idx, IL_equivalent_);
+
+          // test if protein was a hit
+          Size hits_total = func_threads.filter_passed + func_threads.filter_rejected;
+          searchProtein_(fuzzyAC, pattern, pep_DB, prot, prot_idx, jumpX, func_threads);
+          // was protein found?
+          if (hits_total < func_threads.filter_passed + func_threads.filter_rejected)
+          {
+            found_proteins_thread.push_back(prot_idx);
+          }
+        }
+
+        // join results again
+#ifdef _OPENMP
+#pragma omp critical(PeptideIndexer_joinAC)
+#endif
+        {
+          func.merge(func_threads);
+          for (Size prot_idx : found_proteins_thread)
+          {
+            protein_accessions[prot_idx] = index.getAccession(prot_idx);
+            acc_to_prot[protein_accessions[prot_idx]] = prot_idx;
+          }
+        }
+      } // OMP end parallel
+      this->endProgress();
+    }
+    mu.after();
+    OPENMS_LOG_DEBUG << mu.delta("Index lookup") << std::endl;
+
+    OPENMS_LOG_INFO << "\nSearch done:\n  found " << func.filter_passed << " hits for " << func.pep_to_prot.size() << " of " << pep_sequences.size() << " peptides.\n";
+
+    // write some stats
+    OPENMS_LOG_INFO << "Peptide hits passing enzyme filter: " << func.filter_passed << "\n"
+             << "     ... rejected by enzyme filter: " << func.filter_rejected << std::endl;
+
+    if (count_j_proteins)
+    {
+      OPENMS_LOG_WARN << "PeptideIndexer found " << count_j_proteins << " protein sequences in your database containing the amino acid 'J'."
+        << "To match 'J' in a protein, an ambiguous amino acid placeholder for I/L will be used.\n"
+        << "This costs runtime and eats into the 'aaa_max' limit, leaving less opportunity for B/Z/X matches.\n"
+        << "If you want 'J' to be treated as unambiguous, enable '-IL_equivalent'!" << std::endl;
+    }
+  } // end local scope
+
+  return annotate_(func, acc_to_prot, protein_accessions, protein_is_decoy, invalid_protein_sequence, protein_count,
+                   [&index](Size i, FASTAFile::FASTAEntry& fe)
+                   {
+                     fe.identifier = index.getAccession(i);
+                     fe.description = index.getDescription(i);
+                     fe.sequence = index.getSequence(i);
+                   },
+                   prot_ids, pep_ids);
+}
+
+PeptideIndexing::ExitCodes PeptideIndexing::annotate_(FoundProteinFunctor& func, const Map<String, Size>& acc_to_prot, const std::vector<std::string>& protein_accessions,
+                                                      const std::vector<bool>& protein_is_decoy, bool invalid_protein_sequence, Size protein_count,
+                                                      const std::function<void(Size, FASTAFile::FASTAEntry&)>& read_protein,
+                                                      std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids) const
+{
+  //
+  //   do mapping 
+  //
+  // index existing proteins
+  Map<String, Size> runid_to_runidx; // identifier to index
+  for (Size run_idx = 0; run_idx < prot_ids.size(); ++run_idx)
+  {
+    runid_to_runidx[prot_ids[run_idx].getIdentifier()] = run_idx;
+  }
+  
+  // for peptides --> proteins
+  Size stats_matched_unique(0);
+  Size stats_matched_multi(0);
+  Size stats_unmatched(0);    // no match to DB
+  Size stats_count_m_t(0);    // match to Target DB
+  Size stats_count_m_d(0);    // match to Decoy DB
+  Size stats_count_m_td(0);   // match to T+D DB
+
+  Map<Size, std::set<Size> > runidx_to_protidx; // in which protID do appear which proteins (according to mapped peptides)
+
+  Size pep_idx(0);
+  for (std::vector<PeptideIdentification>::iterator it1 = pep_ids.begin(); it1 != pep_ids.end(); ++it1)
+  {
+    // which ProteinIdentification does the peptide belong to?
+    Size run_idx = runid_to_runidx[it1->getIdentifier()];
+
+    std::vector<PeptideHit>& hits = it1->getHits();
+
+    for (std::vector<PeptideHit>::iterator it2 = hits.begin(); it2 != hits.end(); ++it2)
+    {
+      // clear protein accessions
+      it2->setPeptideEvidences(std::vector<PeptideEvidence>());
+      
+      //
+      // is this a decoy hit?
+      //
+      bool matches_target(false);
+      bool matches_decoy(false);
+
+      std::set<Size> prot_indices; /// protein hits of this peptide
+      // add new protein references
+      for (std::set<PeptideProteinMatchInformation>::const_iterator it_i = func.pep_to_prot[pep_idx].begin();
+        it_i != func.pep_to_prot[pep_idx].end(); ++it_i)
+      {
+        prot_indices.insert(it_i->protein_index);
+        const String& accession = protein_accessions[it_i->protein_index];
+        PeptideEvidence pe(accession, it_i->position, it_i->position + (int)it2->getSequence().size() - 1, it_i->AABefore, it_i->AAAfter);
+        it2->addPeptideEvidence(pe);
+
+        runidx_to_protidx[run_idx].insert(it_i->protein_index); // fill protein hits
+
+        if (protein_is_decoy[it_i->protein_index])
+        {
+          matches_decoy = true;
+        }
+        else
+        {
+          matches_target = true;
+        }
+      }
+
+      if (matches_decoy && matches_target)
+      {
+        it2->setMetaValue("target_decoy", "target+decoy");
+        ++stats_count_m_td;
+      }
+      else if (matches_target)
+      {
+        it2->setMetaValue("target_decoy", "target");
+        ++stats_count_m_t;
+      }
+      else if (matches_decoy)
+      {
+        it2->setMetaValue("target_decoy", "decoy");
+        ++stats_count_m_d;
+      } // else: could match to no protein (i.e. both are false)
+      //else ... // not required (handled below; see stats_unmatched);
+
+      if (prot_indices.size() == 1)
+      {
+        it2->setMetaValue("protein_references", "unique");
+        ++stats_matched_unique;
+      }
+      else if (prot_indices.size() > 1)
+      {
+        it2->setMetaValue("protein_references", "non-unique");
+        ++stats_matched_multi;
+      }
+      else
+      {
+        it2->setMetaValue("protein_references", "unmatched");
+        ++stats_unmatched;
+        if (stats_unmatched < 15) OPENMS_LOG_INFO << "Unmatched peptide: " << it2->getSequence() << "\n";
+        else if (stats_unmatched == 15) OPENMS_LOG_INFO << "Unmatched peptide: ...\n";
+      }
+
+      ++pep_idx; // next hit
+    }
+
+  }
+
+  Size total_peptides = stats_count_m_t + stats_count_m_d + stats_count_m_td + stats_unmatched;
+  OPENMS_LOG_INFO << "-----------------------------------\n";
+  OPENMS_LOG_INFO << "Peptide statistics\n";
+  OPENMS_LOG_INFO << "\n";
+  OPENMS_LOG_INFO << "  unmatched                : " << stats_unmatched << " (" << stats_unmatched * 100 / total_peptides << " %)\n";
+  OPENMS_LOG_INFO << "  target/decoy:\n";
+  OPENMS_LOG_INFO << "    match to target DB only: " << stats_count_m_t << " (" << stats_count_m_t * 100 / total_peptides << " %)\n";
+  OPENMS_LOG_INFO << "    match to decoy DB only : " << stats_count_m_d << " (" << stats_count_m_d * 100 / total_peptides << " %)\n";
+  OPENMS_LOG_INFO << "    match to both          : " << stats_count_m_td << " (" << stats_count_m_td * 100 / total_peptides << " %)\n";
+  OPENMS_LOG_INFO << "\n";
+  OPENMS_LOG_INFO << "  mapping to proteins:\n";
+  OPENMS_LOG_INFO << "    no match (to 0 protein)         : " << stats_unmatched << "\n";
+  OPENMS_LOG_INFO << "    unique match (to 1 protein)     : " << stats_matched_unique << "\n";
+  OPENMS_LOG_INFO << "    non-unique match (to >1 protein): " << stats_matched_multi << std::endl;
+
+  /// for proteins --> peptides
+  Size stats_matched_proteins(0), stats_matched_new_proteins(0), stats_orphaned_proteins(0), stats_proteins_target(0), stats_proteins_decoy(0);
+
+  // all peptides contain the correct protein hit references, now update the protein hits
+  for (Size run_idx = 0; run_idx < prot_ids.size(); ++run_idx)
+  {
+    std::set<Size> masterset = runidx_to_protidx[run_idx]; // all protein matches from above
+
+    std::vector<ProteinHit>& phits = prot_ids[run_idx].getHits();
+    {
+      // go through existing protein hits and count orphaned proteins (with no peptide hits)
+      std::vector<ProteinHit> orphaned_hits;
+      for (std::vector<ProteinHit>::iterator p_hit = phits.begin(); p_hit != phits.end(); ++p_hit)
+      {
+        const String& acc = p_hit->getAccession();
+        if (!acc_to_prot.has(acc)) // acc_to_prot only contains found proteins from current run
+        { // old hit is orphaned
+          ++stats_orphaned_proteins;
+          if (keep_unreferenced_proteins_)
+          {
+            p_hit->setMetaValue("target_decoy", "");
+            orphaned_hits.push_back(*p_hit);
+          }
+        }
+      }
+      // only keep orphaned hits (if any)
+      phits = orphaned_hits;
+    }
+
+    // add new protein hits
+    FASTAFile::FASTAEntry fe;
+    phits.reserve(phits.size() + masterset.size());
+    for (std::set<Size>::const_iterator it = masterset.begin(); it != masterset.end(); ++it)
+    {
+      ProteinHit hit;
+      hit.setAccession(protein_accessions[*it]);
+      
+      if (write_protein_sequence_ || write_protein_description_)
+      {
+        read_protein(*it, fe);
+        if (write_protein_sequence_)
+        {
+          hit.setSequence(fe.sequence);
+        } // no else, since sequence is empty by default
+        if (write_protein_description_)
+        {
+          hit.setDescription(fe.description);
+        } // no else, since description is empty by default
+      }
+      if (protein_is_decoy[*it])
+      {
+        hit.setMetaValue("target_decoy", "decoy");
+        ++stats_proteins_decoy;
+      }
+      else
+      {
+        hit.setMetaValue("target_decoy", "target");
+        ++stats_proteins_target;
+      }
+      phits.push_back(hit);
+      ++stats_matched_new_proteins;
+    }
+    stats_matched_proteins += phits.size();
+  }
+
+
+  OPENMS_LOG_INFO << "-----------------------------------\n";
+  OPENMS_LOG_INFO << "Protein statistics\n";
+  OPENMS_LOG_INFO << "\n";
+  OPENMS_LOG_INFO << "  total proteins searched: " << protein_count << "\n";
+  OPENMS_LOG_INFO << "  matched proteins       : " << stats_matched_proteins << " (" << stats_matched_new_proteins << " new)\n";
+  if (stats_matched_proteins)
+  { // prevent Division-by-0 Exception
+    OPENMS_LOG_INFO << "  matched target proteins: " << stats_proteins_target << " (" << stats_proteins_target * 100 / stats_matched_proteins << " %)\n";
+    OPENMS_LOG_INFO << "  matched decoy proteins : " << stats_proteins_decoy << " (" << stats_proteins_decoy * 100 / stats_matched_proteins << " %)\n";
+  }
+  OPENMS_LOG_INFO << "  orphaned proteins      : " << stats_orphaned_proteins << (keep_unreferenced_proteins_ ? " (all kept)" : " (all removed)\n");
+  OPENMS_LOG_INFO << "-----------------------------------" << std::endl;
+
+
+  /// exit if no peptides were matched to decoy
+  bool has_error = false;
+
+  if (invalid_protein_sequence)
+  {
+    OPENMS_LOG_ERROR << "Error: One or more protein sequences contained the characters '[' or '(', which are illegal in protein sequences."
+             << "\nPeptide hits might be masked by these characters (which usually indicate presence of modifications).\n";
+    has_error = true;
+  }
+
+  if ((stats_count_m_d + stats_count_m_td) == 0)
+  {
+    String msg("No peptides were matched to the decoy portion of the database! Did you provide the correct concatenated database? Are your 'decoy_string' (=" + String(decoy_string_) + ") and 'decoy_string_position' (=" + String(param_.getValue("decoy_string_position")) + ") settings correct?");
+    if (missing_decoy_action_ == "error")
+    {
+      OPENMS_LOG_ERROR << "Error: " << msg << "\nSet 'missing_decoy_action' to 'warn' if you are sure this is ok!\nAborting ..." << std::endl;
+      has_error = true;
+    }
+    else if (missing_decoy_action_ == "warn")
+    {
+      OPENMS_LOG_WARN << "Warn: " << msg << "\nSet 'missing_decoy_action' to 'error' if you want to elevate this to an error!" << std::endl;
+    }
+    else // silent
+    {
+    }
+  }
+
+  if ((!allow_unmatched_) && (stats_unmatched > 0))
+  {
+    OPENMS_LOG_ERROR << "PeptideIndexer found unmatched peptides, which could not be associated to a protein.\n"
+              << "Potential solutions:\n"
+              << "   - check your FASTA database for completeness\n"
+              << "   - set 'enzyme:specificity' to match the identification parameters of the search engine\n"
+              << "   - some engines (e.g. X! Tandem) employ loose cutting rules generating non-tryptic peptides;\n"
+              << "     if you trust them, disable enzyme specificity\n"
+              << "   - increase 'aaa_max' to allow more ambiguous amino acids\n"
+              << "   - as a last resort: use the 'allow_unmatched' option to accept unmatched peptides\n"
+              << "     (note that unmatched peptides cannot be used for FDR calculation or quantification)\n";
+    has_error = true;
+  }
+
+  if (has_error)
+  {
+    OPENMS_LOG_ERROR << "Result files will be written, but PeptideIndexer will exit with an error code." << std::endl;
+    return UNEXPECTED_RESULT;
+  }
+  return EXECUTION_OK;
+}
+
+
 /// @endcond
 
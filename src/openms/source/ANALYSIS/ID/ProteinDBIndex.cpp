@@ -0,0 +1,526 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/ProteinDBIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    const char INDEX_MAGIC[8] = {'O', 'M', 'S', 'P', 'D', 'B', 'I', 'X'};
+    const UInt32 INDEX_VERSION = 1;
+    const UInt32 BYTE_ORDER_MARK = 0x01020304;
+
+    /// number of residues suffixes are sorted by
+    const Size DEFAULT_SORT_DEPTH = 64;
+
+    /// number of buckets for the initial sort (by the first two residues)
+    const Size BUCKET_COUNT = 1 << 16;
+
+    /// Fixed-size header of an index file. The sections follow in the order of the fields, each aligned to 8 bytes.
+    struct IndexFileHeader
+    {
+      char magic[8];
+      UInt32 version;
+      UInt32 byte_order;
+      UInt64 protein_count;
+      UInt64 text_length;
+      UInt64 suffix_count;
+      UInt64 accession_length;
+      UInt64 description_length;
+      UInt64 decoy_length;
+      UInt64 sort_depth;
+      UInt64 source_size;
+      Int64 source_timestamp;
+      std::uint8_t decoy_success;
+      std::uint8_t decoy_is_prefix;
+      std::uint8_t padding[6];
+    };
+
+    /// byte offsets of the sections of an index file
+    struct IndexFileSections
+    {
+      explicit IndexFileSections(const IndexFileHeader& h)
+      {
+        Size pos = aligned(sizeof(IndexFileHeader));
+        protein_starts = pos;       pos += aligned((h.protein_count + 1) * sizeof(UInt64));
+        accession_offsets = pos;    pos += aligned((h.protein_count + 1) * sizeof(UInt64));
+        description_offsets = pos;  pos += aligned((h.protein_count + 1) * sizeof(UInt64));
+        flags = pos;                pos += aligned(h.protein_count * sizeof(std::uint8_t));
+        accessions = pos;           pos += aligned(h.accession_length);
+        descriptions = pos;         pos += aligned(h.description_length);
+        decoy = pos;                pos += aligned(h.decoy_length);
+        text = pos;                 pos += aligned(h.text_length);
+        suffix_array = pos;         pos += aligned(h.suffix_count * sizeof(UInt32));
+        total = pos;
+      }
+
+      static Size aligned(Size bytes)
+      {
+        return (bytes + 7) & ~Size(7);
+      }
+
+      Size protein_starts, accession_offsets, description_offsets, flags, accessions, descriptions, decoy, text, suffix_array, total;
+    };
+
+    /// I/L/J-equivalence: 'L' and 'J' are mapped to 'I'
+    inline unsigned char normalize(char c)
+    {
+      return (c == 'L' || c == 'J') ? 'I' : static_cast<unsigned char>(c);
+    }
+  }
+
+  ProteinDBIndex::ProteinDBIndex() :
+    sort_depth_(DEFAULT_SORT_DEPTH),
+    decoy_{false, "", true},
+    source_size_(0),
+    source_timestamp_(0)
+  {
+    clear();
+  }
+
+  ProteinDBIndex::~ProteinDBIndex()
+  {
+  }
+
+  void ProteinDBIndex::build(const std::vector<FASTAFile::FASTAEntry>& proteins)
+  {
+    FASTAContainer<TFI_Vector> container(proteins);
+    build(container);
+  }
+
+  void ProteinDBIndex::clear()
+  {
+    region_.reset();
+    protein_starts_data_.assign(1, 0);
+    accession_offsets_data_.assign(1, 0);
+    description_offsets_data_.assign(1, 0);
+    flags_data_.clear();
+    accession_data_.clear();
+    description_data_.clear();
+    text_data_.clear();
+    suffix_array_data_.clear();
+    sort_depth_ = DEFAULT_SORT_DEPTH;
+    decoy_ = {false, "", true};
+    source_size_ = 0;
+    source_timestamp_ = 0;
+    setViews_();
+  }
+
+  void ProteinDBIndex::setViews_()
+  {
+    protein_count_ = flags_data_.size();
+    text_length_ = text_data_.size();
+    suffix_count_ = suffix_array_data_.size();
+    protein_starts_ = protein_starts_data_.data();
+    accession_offsets_ = accession_offsets_data_.data();
+    description_offsets_ = description_offsets_data_.data();
+    flags_ = flags_data_.data();
+    accessions_ = accession_data_.data();
+    descriptions_ = description_data_.data();
+    text_ = text_data_.data();
+    suffix_array_ = suffix_array_data_.data();
+  }
+
+  void ProteinDBIndex::addProtein_(const FASTAFile::FASTAEntry& protein)
+  {
+    accession_data_ += protein.identifier;
+    accession_offsets_data_.push_back(accession_data_.size());
+    description_data_ += protein.description;
+    description_offsets_data_.push_back(description_data_.size());
+
+    std::uint8_t flags(0);
+    for (const char c : protein.sequence)
+    {
+      switch (c)
+      {
+        case '*':
+          continue; // not part of the searched sequence
+        case 'B':
+        case 'Z':
+        case 'X':
+          flags |= HAS_AMBIGUOUS_AA;
+          break;
+        case 'J':
+          flags |= HAS_J;
+          break;
+        case '[':
+        case '(':
+          flags |= HAS_MODIFICATION;
+          break;
+        default:
+          break;
+      }
+      text_data_.push_back(c);
+    }
+    text_data_.push_back('\0'); // terminator; lookups never match across proteins
+    protein_starts_data_.push_back(text_data_.size());
+    flags_data_.push_back(flags);
+  }
+
+  void ProteinDBIndex::buildSuffixArray_()
+  {
+    if (text_data_.size() > std::numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, text_data_.size());
+    }
+    sort_depth_ = DEFAULT_SORT_DEPTH;
+
+    const char* text = text_data_.data();
+    const Size text_length = text_data_.size();
+    // bucket of a suffix: its first two residues (the second might be the terminator)
+    auto bucketOf = [text](Size pos)
+    {
+      return (Size(normalize(text[pos])) << 8) | Size(normalize(text[pos + 1]));
+    };
+
+    // counting sort into buckets ...
+    std::vector<UInt64> bucket_start(BUCKET_COUNT + 1, 0);
+    for (Size pos = 0; pos < text_length; ++pos)
+    {
+      if (text[pos] != '\0') ++bucket_start[bucketOf(pos) + 1];
+    }
+    std::partial_sum(bucket_start.begin(), bucket_start.end(), bucket_start.begin());
+    suffix_array_data_.resize(bucket_start.back());
+    std::vector<UInt64> bucket_fill(bucket_start.begin(), bucket_start.end() - 1);
+    for (Size pos = 0; pos < text_length; ++pos)
+    {
+      if (text[pos] != '\0') suffix_array_data_[bucket_fill[bucketOf(pos)]++] = static_cast<UInt32>(pos);
+    }
+
+    // ... then sort each bucket (by the first sort_depth_ residues, ties by position)
+    const Size depth = sort_depth_;
+    auto suffixLess = [text, depth](UInt32 a, UInt32 b)
+    {
+      for (Size k = 0; k < depth; ++k)
+      {
+        const unsigned char ca = normalize(text[a + k]);
+        const unsigned char cb = normalize(text[b + k]);
+        if (ca != cb) return ca < cb;
+        if (ca == '\0') break; // both suffixes end here
+      }
+      return a < b;
+    };
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize b = 0; b < (SignedSize)BUCKET_COUNT; ++b)
+    {
+      std::sort(suffix_array_data_.begin() + bucket_start[b], suffix_array_data_.begin() + bucket_start[b + 1], suffixLess);
+    }
+
+    setViews_();
+  }
+
+  void ProteinDBIndex::store(const String& filename) const
+  {
+    std::ofstream os(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    IndexFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, INDEX_MAGIC, sizeof(h.magic));
+    h.version = INDEX_VERSION;
+    h.byte_order = BYTE_ORDER_MARK;
+    h.protein_count = protein_count_;
+    h.text_length = text_length_;
+    h.suffix_count = suffix_count_;
+    h.accession_length = accession_offsets_[protein_count_];
+    h.description_length = description_offsets_[protein_count_];
+    h.decoy_length = decoy_.name.size();
+    h.sort_depth = sort_depth_;
+    h.source_size = source_size_;
+    h.source_timestamp = source_timestamp_;
+    h.decoy_success = decoy_.success;
+    h.decoy_is_prefix = decoy_.is_prefix;
+
+    // write a section and pad it to 8 bytes
+    const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    auto writeSection = [&os, &padding](const void* data, Size bytes)
+    {
+      if (bytes > 0) os.write(static_cast<const char*>(data), bytes);
+      os.write(padding, IndexFileSections::aligned(bytes) - bytes);
+    };
+    writeSection(&h, sizeof(h));
+    writeSection(protein_starts_, (protein_count_ + 1) * sizeof(UInt64));
+    writeSection(accession_offsets_, (protein_count_ + 1) * sizeof(UInt64));
+    writeSection(description_offsets_, (protein_count_ + 1) * sizeof(UInt64));
+    writeSection(flags_, protein_count_ * sizeof(std::uint8_t));
+    writeSection(accessions_, h.accession_length);
+    writeSection(descriptions_, h.description_length);
+    writeSection(decoy_.name.c_str(), h.decoy_length);
+    writeSection(text_, text_length_);
+    writeSection(suffix_array_, suffix_count_ * sizeof(UInt32));
+
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void ProteinDBIndex::load(const String& filename)
+  {
+    {
+      std::ifstream probe(filename.c_str(), std::ios::binary);
+      if (!probe)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+    }
+    clear();
+    flags_data_.clear();
+    protein_starts_data_.clear();
+    accession_offsets_data_.clear();
+    description_offsets_data_.clear();
+
+    try
+    {
+      boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+      region_.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception&)
+    {
+      clear();
+      throw Exception::FileNotReadable(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    const char* base = static_cast<const char*>(region_->get_address());
+    const Size file_size = region_->get_size();
+
+    IndexFileHeader h;
+    if (file_size < sizeof(h))
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "File is too small to be a protein database index.");
+    }
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, INDEX_MAGIC, sizeof(h.magic)) != 0)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Not a protein database index.");
+    }
+    if (h.byte_order != BYTE_ORDER_MARK)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Protein database index was created on a platform with different endianness.");
+    }
+    if (h.version != INDEX_VERSION)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Unsupported protein database index version " + String(h.version) + " (expected " + String(INDEX_VERSION) + ").");
+    }
+    const IndexFileSections sections(h);
+    if (sections.total > file_size)
+    {
+      clear();
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Protein database index is truncated.");
+    }
+
+    protein_count_ = h.protein_count;
+    text_length_ = h.text_length;
+    suffix_count_ = h.suffix_count;
+    protein_starts_ = reinterpret_cast<const UInt64*>(base + sections.protein_starts);
+    accession_offsets_ = reinterpret_cast<const UInt64*>(base + sections.accession_offsets);
+    description_offsets_ = reinterpret_cast<const UInt64*>(base + sections.description_offsets);
+    flags_ = reinterpret_cast<const std::uint8_t*>(base + sections.flags);
+    accessions_ = base + sections.accessions;
+    descriptions_ = base + sections.descriptions;
+    text_ = base + sections.text;
+    suffix_array_ = reinterpret_cast<const UInt32*>(base + sections.suffix_array);
+
+    sort_depth_ = h.sort_depth;
+    decoy_.success = h.decoy_success != 0;
+    decoy_.is_prefix = h.decoy_is_prefix != 0;
+    decoy_.name = String(base + sections.decoy, h.decoy_length);
+    source_size_ = h.source_size;
+    source_timestamp_ = h.source_timestamp;
+  }
+
+  bool ProteinDBIndex::isMemoryMapped() const
+  {
+    return region_ != nullptr;
+  }
+
+  Size ProteinDBIndex::size() const
+  {
+    return protein_count_;
+  }
+
+  bool ProteinDBIndex::empty() const
+  {
+    return protein_count_ == 0;
+  }
+
+  Size ProteinDBIndex::residueCount() const
+  {
+    return suffix_count_;
+  }
+
+  String ProteinDBIndex::getAccession(Size index) const
+  {
+    return String(accessions_ + accession_offsets_[index], accession_offsets_[index + 1] - accession_offsets_[index]);
+  }
+
+  String ProteinDBIndex::getDescription(Size index) const
+  {
+    return String(descriptions_ + description_offsets_[index], description_offsets_[index + 1] - description_offsets_[index]);
+  }
+
+  String ProteinDBIndex::getSequence(Size index, bool IL_equivalent) const
+  {
+    String seq(text_ + protein_starts_[index], getSequenceLength(index));
+    if (IL_equivalent)
+    {
+      seq.substitute('L', 'I');
+      seq.substitute('J', 'I');
+    }
+    return seq;
+  }
+
+  Size ProteinDBIndex::getSequenceLength(Size index) const
+  {
+    return protein_starts_[index + 1] - protein_starts_[index] - 1; // without terminator
+  }
+
+  UInt ProteinDBIndex::getFlags(Size index) const
+  {
+    return flags_[index];
+  }
+
+  Size ProteinDBIndex::getSortDepth() const
+  {
+    return sort_depth_;
+  }
+
+  const DecoyHelper::Result& ProteinDBIndex::getDecoyInfo() const
+  {
+    return decoy_;
+  }
+
+  void ProteinDBIndex::setSourceInfo(UInt64 file_size, Int64 timestamp)
+  {
+    source_size_ = file_size;
+    source_timestamp_ = timestamp;
+  }
+
+  std::pair<UInt64, Int64> ProteinDBIndex::getSourceInfo() const
+  {
+    return std::make_pair(source_size_, source_timestamp_);
+  }
+
+  std::pair<Size, Size> ProteinDBIndex::findRange_(const String& peptide) const
+  {
+    const Size len = std::min(peptide.size(), sort_depth_);
+    const char* text = text_;
+    // compares the first len residues of a suffix to the peptide (I/L/J-equivalent)
+    auto suffixLessThanPeptide = [text, len, &peptide](UInt32 pos)
+    {
+      for (Size k = 0; k < len; ++k)
+      {
+        const unsigned char ct = normalize(text[pos + k]);
+        const unsigned char cp = normalize(peptide[k]);
+        if (ct != cp) return ct < cp; // a terminator is smaller than any residue
+      }
+      return false;
+    };
+    auto suffixNotGreaterThanPeptide = [text, len, &peptide](UInt32 pos)
+    {
+      for (Size k = 0; k < len; ++k)
+      {
+        const unsigned char ct = normalize(text[pos + k]);
+        const unsigned char cp = normalize(peptide[k]);
+        if (ct != cp) return ct < cp;
+      }
+      return true;
+    };
+    const UInt32* first = std::partition_point(suffix_array_, suffix_array_ + suffix_count_, suffixLessThanPeptide);
+    const UInt32* last = std::partition_point(first, suffix_array_ + suffix_count_, suffixNotGreaterThanPeptide);
+    return std::make_pair(Size(first - suffix_array_), Size(last - suffix_array_));
+  }
+
+  Size ProteinDBIndex::proteinOf_(Size pos) const
+  {
+    return std::upper_bound(protein_starts_, protein_starts_ + protein_count_ + 1, UInt64(pos)) - protein_starts_ - 1;
+  }
+
+  void ProteinDBIndex::findPeptide(const String& peptide, bool IL_equivalent, std::vector<std::pair<Size, Size> >& hits) const
+  {
+    if (peptide.empty() || suffix_count_ == 0) return;
+
+    const std::pair<Size, Size> range = findRange_(peptide);
+    const Size len = peptide.size();
+    for (Size i = range.first; i < range.second; ++i)
+    {
+      const Size pos = suffix_array_[i];
+      // the range only guarantees an I/L/J-equivalent match of the first sort_depth_ residues
+      bool match = true;
+      for (Size k = (IL_equivalent ? sort_depth_ : 0); k < len; ++k)
+      {
+        const bool same = IL_equivalent ? (normalize(text_[pos + k]) == normalize(peptide[k])) : (text_[pos + k] == peptide[k]);
+        if (!same) // also stops at the protein terminator
+        {
+          match = false;
+          break;
+        }
+      }
+      if (match)
+      {
+        const Size protein = proteinOf_(pos);
+        hits.push_back(std::make_pair(protein, pos - protein_starts_[protein]));
+      }
+    }
+  }
+
+} // namespace OpenMS
@@ -36,6 +36,7 @@ PeptideProteinResolution.cpp
 PrecursorPurity.cpp
 ProtonDistributionModel.cpp
 PeptideIndexing.cpp
+ProteinDBIndex.cpp
 PercolatorFeatureSetHelper.cpp
 SimpleSearchEngineAlgorithm.cpp
 SiriusAdapterAlgorithm.cpp
@@ -83,12 +83,25 @@ namespace OpenMS
       }
     }
 
+    // apply the filters (independent per consensus feature)
+    vector<char> passes(map.size(), 1);
+    if (!acc_filter.empty() || !desc_filter.empty())
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+      for (SignedSize i = 0; i < SignedSize(map.size()); ++i)
+      {
+        passes[i] = passesFilters_(map.begin() + i, map, acc_filter, desc_filter);
+      }
+    }
+
     // fill feature_int with intensities
     Size pass_counter = 0;
     ConsensusMap::ConstIterator cf_it;
     for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
     {
-      if (!passesFilters_(cf_it, map, acc_filter, desc_filter))
+      if (!passes[cf_it - map.begin()])
       {
         continue;
       }
@@ -124,8 +137,11 @@ namespace OpenMS
     }
     else
     {
-      //compute medians
-      for (UInt j = 0; j < number_of_maps; j++)
+      //compute medians (sorts the intensities of every map)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize j = 0; j < SignedSize(number_of_maps); j++)
       {
         vector<double>& ints_j = feature_int[j];
         medians[j] = Math::median(ints_j.begin(), ints_j.end());
@@ -142,7 +158,6 @@ namespace OpenMS
       OPENMS_LOG_WARN << endl << "WARNING: normalization using median shifting is not recommended for regular log-normal MS data. Use this only if you know exactly what you're doing!" << endl << endl;
     }
 
-    ConsensusMap::Iterator cf_it;
     ProgressLogger progresslogger;
     progresslogger.setLogType(ProgressLogger::CMD);
     progresslogger.startProgress(0, map.size(), "normalizing maps");
@@ -150,9 +165,26 @@ namespace OpenMS
     vector<double> medians;
     Size index_of_largest_map = computeMedians(map, medians, acc_filter, desc_filter);
 
-    for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    // shift to median of map with largest median in order to avoid negative intensities
+    double max_median(numeric_limits<double>::min());
+    Size max_median_index(0);
+    for (Size i = 0; i < medians.size(); ++i)
     {
-      progresslogger.setProgress(cf_it - map.begin());
+      if (medians[i] > max_median)
+      {
+        max_median = medians[i];
+        max_median_index = i;
+      }
+    }
+
+    // consensus features are independent -> normalize them in parallel
+    Size progress = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize i = 0; i < SignedSize(map.size()); ++i)
+    {
+      ConsensusMap::ConstIterator cf_it = map.begin() + i;
       ConsensusFeature::HandleSetType::const_iterator f_it;
       for (f_it = cf_it->getFeatures().begin(); f_it != cf_it->getFeatures().end(); ++f_it)
       {
@@ -164,20 +196,13 @@ namespace OpenMS
         }
         else // method == NM_SHIFT
         {
-          // shift to median of map with largest median in order to avoid negative intensities
-          double max_median(numeric_limits<double>::min());
-          Size max_median_index(0);
-          for (Size i = 0; i < medians.size(); ++i)
-          {
-            if (medians[i] > max_median)
-            {
-              max_median = medians[i];
-              max_median_index = i;
-            }
-          }
           f_it->asMutable().setIntensity(f_it->getIntensity() + medians[max_median_index] - medians[map_index]);
         }
       }
+#ifdef _OPENMP
+#pragma omp critical (ConsensusMapNormalizerAlgorithmMedian_progress)
+#endif
+      progresslogger.setProgress(progress++);
     }
     progresslogger.endProgress();
   }
@@ -36,6 +36,8 @@
 
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace OpenMS
@@ -66,62 +68,65 @@ namespace OpenMS
       }
     }
 
-    //resample n data points from each sorted intensity distribution (from the different maps), n = maximum number of features in any map
-    vector<vector<double> > resampled_sorted_data;
-    for (Size i = 0; i < number_of_maps; ++i)
+    //sort the intensities of every map (in place), remembering the original position
+    //of every value in sort_indices (equal values keep their original order)
+    vector<vector<UInt> > sort_indices(number_of_maps);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(number_of_maps); ++i)
     {
-      vector<double> sorted = feature_ints[i];
-      std::sort(sorted.begin(), sorted.end());
-      vector<double> resampled(largest_number_of_features);
-      resample(sorted, resampled, static_cast<UInt>(largest_number_of_features));
-      resampled_sorted_data.push_back(resampled);
+      vector<double>& ints = feature_ints[i];
+      vector<UInt>& indices = sort_indices[i];
+      indices.resize(ints.size());
+      for (Size j = 0; j < ints.size(); ++j)
+      {
+        indices[j] = static_cast<UInt>(j);
+      }
+      std::stable_sort(indices.begin(), indices.end(), [&ints](UInt a, UInt b) { return ints[a] < ints[b]; });
+      vector<double> sorted(ints.size());
+      for (Size j = 0; j < indices.size(); ++j)
+      {
+        sorted[j] = ints[indices[j]];
+      }
+      ints.swap(sorted);
     }
 
-    //compute reference distribution from all resampled distributions
+    //compute reference distribution: mean of the sorted intensity distributions of all maps,
+    //each resampled to n data points (n = maximum number of features in any map)
     vector<double> reference_distribution(largest_number_of_features);
-    for (Size i = 0; i < number_of_maps; ++i)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (SignedSize j = 0; j < SignedSize(largest_number_of_features); ++j)
     {
-      for (Size j = 0; j < largest_number_of_features; ++j)
+      double value = 0.0;
+      for (Size i = 0; i < number_of_maps; ++i)
       {
-        reference_distribution[j] += (resampled_sorted_data[i][j] / (double)number_of_maps);
+        if (feature_ints[i].empty())
+        {
+          continue;
+        }
+        value += resampledValue_(feature_ints[i], static_cast<UInt>(largest_number_of_features), static_cast<UInt>(j)) / (double)number_of_maps;
       }
+      reference_distribution[j] = value;
     }
 
     //for each map: resample from the reference distribution down to the respective original size again
-    vector<vector<double> > normalized_sorted_ints(number_of_maps);
-    for (Size i = 0; i < number_of_maps; ++i)
-    {
-      vector<double> ints;
-      resample(reference_distribution, ints, static_cast<UInt>(feature_ints[i].size()));
-      normalized_sorted_ints[i] = ints;
-    }
-
-    //set the intensities of feature_ints to the normalized intensities
-    for (Size i = 0; i < number_of_maps; ++i)
+    //and move the normalized values to the original positions of the corresponding ranks
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(number_of_maps); ++i)
     {
-      // We do not want to change the order in feature_ints[i] but normalized_sorted_ints
-      // comes sorted, so we transfer the values in feature_ints[i] into pairs that store
-      // the value and the index in feature_ints[i]. Then we sort the vector of pair and as
-      // a result store the indexes of feature_ints[i] in a sorted order in sort_indices.
-      std::vector<std::pair<double, UInt> > sort_pairs;
-      sort_pairs.reserve(feature_ints[i].size());
-      for (Size j = 0; j < feature_ints[i].size(); ++j)
-      {
-        sort_pairs.push_back(std::make_pair(feature_ints[i][j], j));
-      }
-      std::sort(sort_pairs.begin(), sort_pairs.end());
-      vector<Size> sort_indices;
-      sort_indices.reserve(sort_pairs.size());
-      for (Size j = 0; j < sort_pairs.size(); ++j)
-      {
-        sort_indices.push_back(sort_pairs.at(j).second);
-      }
-      Size k = 0;
-      for (Size j = 0; j < sort_indices.size(); ++j)
+      vector<UInt>& indices = sort_indices[i];
+      vector<double> normalized(indices.size());
+      for (Size k = 0; k < indices.size(); ++k)
       {
-        Size idx = sort_indices[j];
-        feature_ints[i][idx] = normalized_sorted_ints[i][k++];
+        normalized[indices[k]] = resampledValue_(reference_distribution, static_cast<UInt>(indices.size()), static_cast<UInt>(k));
       }
+      feature_ints[i].swap(normalized);
+      vector<UInt>().swap(indices);
     }
 
     //write new feature intensities to the consensus map
@@ -133,30 +138,33 @@ namespace OpenMS
     data_out.clear();
     data_out.resize(n_resampling_points);
 
-    if (n_resampling_points == 0)
+    for (UInt i = 0; i < n_resampling_points; ++i)
     {
-      return;
+      data_out[i] = resampledValue_(data_in, n_resampling_points, i);
     }
+  }
 
-    data_out[0] = data_in.front();
-    data_out[n_resampling_points - 1] = data_in.back();
+  double ConsensusMapNormalizerAlgorithmQuantile::resampledValue_(const vector<double>& data_in, UInt n_resampling_points, UInt i)
+  {
+    if (i == n_resampling_points - 1)
+    {
+      return data_in.back();
+    }
+    if (i == 0)
+    {
+      return data_in.front();
+    }
     double delta = (double)(data_in.size() - 1) / (double)(n_resampling_points - 1);
-    for (UInt i = 1; i < n_resampling_points - 1; ++i)
+    double pseudo_index = (double)i * delta;
+    double left_index = (UInt)floor(pseudo_index);
+    double right_index = (UInt)ceil(pseudo_index);
+    if (left_index == right_index)
     {
-      double pseudo_index = (double)i * delta;
-      double left_index = (UInt)floor(pseudo_index);
-      double right_index = (UInt)ceil(pseudo_index);
-      if (left_index == right_index)
-      {
-        data_out[i] = data_in[left_index];
-      }
-      else
-      {
-        double weight_left = 1.0 - (pseudo_index - (double)left_index);
-        double weight_right = 1.0 - ((double)right_index - pseudo_index);
-        data_out[i] = weight_left * data_in[left_index] + weight_right * data_in[right_index];
-      }
+      return data_in[left_index];
     }
+    double weight_left = 1.0 - (pseudo_index - (double)left_index);
+    double weight_right = 1.0 - ((double)right_index - pseudo_index);
+    return weight_left * data_in[left_index] + weight_right * data_in[right_index];
   }
 
   void ConsensusMapNormalizerAlgorithmQuantile::extractIntensityVectors(const ConsensusMap& map, vector<vector<double> >& out_intensities)
@@ -184,41 +184,69 @@ namespace OpenMS
     // add last partition (a bit more since we use "smaller than" below)
     partition_boundaries.push_back(massrange.back() + 1.0);
 
+    // assign the features of all input maps to their partitions (feature
+    // indices per partition and map, in the original order)
+    const Size nr_partitions = partition_boundaries.size() - 1;
+    vector<vector<vector<Size> > > partition_features(nr_partitions, vector<vector<Size> >(input_maps.size()));
+    for (size_t k = 0; k < input_maps.size(); k++)
+    {
+      for (size_t m = 0; m < input_maps[k].size(); m++)
+      {
+        // partition j contains the m/z range [partition_boundaries[j], partition_boundaries[j+1])
+        Size j = upper_bound(partition_boundaries.begin(), partition_boundaries.end(),
+                             input_maps[k][m].getMZ()) - partition_boundaries.begin() - 1;
+        partition_features[j][k].push_back(m);
+      }
+    }
+
+    // copies the features of partition j into temporary maps
+    auto getPartitionMaps = [&](Size j, vector<MapType>& tmp_input_maps)
+    {
+      tmp_input_maps.resize(input_maps.size());
+      for (size_t k = 0; k < input_maps.size(); k++)
+      {
+        for (Size m : partition_features[j][k])
+        {
+          tmp_input_maps[k].push_back(input_maps[k][m]);
+        }
+        tmp_input_maps[k].updateRanges();
+      }
+    };
+
+    // Partitions are independent and processed in parallel. Results are
+    // collected per partition and combined in partition order, so they do not
+    // depend on the number of threads.
+
     // ------------ compute RT transformation models ------------
 
     MapAlignmentAlgorithmKD aligner(input_maps.size(), param_);
     bool align = param_.getValue("warp:enabled").toString() == "true";
     if (align)
     {
+      vector<vector<TransformationModel::DataPoints> > partition_fit_data(nr_partitions);
       Size progress = 0;
-      startProgress(0, partition_boundaries.size(), "computing RT transformations");
-      for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+      startProgress(0, nr_partitions, "computing RT transformations");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize j = 0; j < SignedSize(nr_partitions); j++)
       {
-        double partition_start = partition_boundaries[j];
-        double partition_end = partition_boundaries[j+1];
-
-        std::vector<MapType> tmp_input_maps(input_maps.size());
-        for (size_t k = 0; k < input_maps.size(); k++)
-        {
-          // iterate over all features in the current input map and append
-          // matching features (within the current partition) to the temporary
-          // map
-          for (size_t m = 0; m < input_maps[k].size(); m++)
-          {
-            if (input_maps[k][m].getMZ() >= partition_start &&
-                input_maps[k][m].getMZ() < partition_end)
-            {
-              tmp_input_maps[k].push_back(input_maps[k][m]);
-            }
-          }
-          tmp_input_maps[k].updateRanges();
-        }
+        vector<MapType> tmp_input_maps;
+        getPartitionMaps(j, tmp_input_maps);
 
         // set up kd-tree
         KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
-        aligner.addRTFitData(kd_data);
+        aligner.getRTFitData(kd_data, partition_fit_data[j]);
+#ifdef _OPENMP
+#pragma omp critical (FeatureGroupingAlgorithmKD_progress)
+#endif
         setProgress(progress++);
       }
+      for (Size j = 0; j < nr_partitions; j++)
+      {
+        aligner.addRTFitData(partition_fit_data[j]);
+      }
+      partition_fit_data.clear();
 
       // fit LOWESS on RT fit data collected across all partitions
       try
@@ -235,44 +263,51 @@ namespace OpenMS
     }
 
     // ------------ run alignment + feature linking on individual partitions ------------
+    vector<ConsensusMap> partition_results(nr_partitions);
     Size progress = 0;
-    startProgress(0, partition_boundaries.size(), "linking features");
-    for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+    startProgress(0, nr_partitions, "linking features");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-      double partition_start = partition_boundaries[j];
-      double partition_end = partition_boundaries[j+1];
-
-      std::vector<MapType> tmp_input_maps(input_maps.size());
-      for (size_t k = 0; k < input_maps.size(); k++)
+      // the distance functor keeps state, so every thread needs its own copy
+      FeatureDistance feature_distance;
+      feature_distance = feature_distance_;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize j = 0; j < SignedSize(nr_partitions); j++)
       {
-        // iterate over all features in the current input map and append
-        // matching features (within the current partition) to the temporary
-        // map
-        for (size_t m = 0; m < input_maps[k].size(); m++)
+        vector<MapType> tmp_input_maps;
+        getPartitionMaps(j, tmp_input_maps);
+
+        // set up kd-tree
+        KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
+
+        // alignment
+        if (align)
         {
-          if (input_maps[k][m].getMZ() >= partition_start &&
-              input_maps[k][m].getMZ() < partition_end)
-          {
-            tmp_input_maps[k].push_back(input_maps[k][m]);
-          }
+          aligner.transform(kd_data);
         }
-        tmp_input_maps[k].updateRanges();
-      }
 
-      // set up kd-tree
-      KDTreeFeatureMaps kd_data(tmp_input_maps, param_);
+        // link features
+        runClustering_(kd_data, feature_distance, partition_results[j]);
+#ifdef _OPENMP
+#pragma omp critical (FeatureGroupingAlgorithmKD_progress)
+#endif
+        setProgress(progress++);
+      }
+    }
+    endProgress();
 
-      // alignment
-      if (align)
+    for (ConsensusMap& partition_result : partition_results)
+    {
+      for (const ConsensusFeature& cf : partition_result)
       {
-        aligner.transform(kd_data);
+        out.push_back(cf);
       }
-
-      // link features
-      runClustering_(kd_data, out);
-      setProgress(progress++);
+      partition_result.clear();
     }
-    endProgress();
 
     postprocess_(input_maps, out);
   }
@@ -289,10 +324,17 @@ namespace OpenMS
     group_(maps, out);
   }
 
-  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, ConsensusMap& out)
+  void FeatureGroupingAlgorithmKD::runClustering_(const KDTreeFeatureMaps& kd_data, FeatureDistance& feature_distance, ConsensusMap& out) const
   {
     Size n = kd_data.size();
 
+    // neighborhoods are needed repeatedly (whenever a neighbor was assigned) -> query all of them once
+    vector<vector<Size> > neighborhoods(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      kd_data.getNeighborhood(i, neighborhoods[i], rt_tol_secs_, mz_tol_, mz_ppm_, true);
+    }
+
     // pass 1: initialize best potential clusters for all possible cluster centers
     set<Size> update_these;
     for (Size i = 0; i < kd_data.size(); ++i)
@@ -302,7 +344,7 @@ namespace OpenMS
     set<ClusterProxyKD> potential_clusters;
     vector<ClusterProxyKD> cluster_for_idx(n);
     vector<Int> assigned(n, false);
-    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+    updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, neighborhoods, feature_distance);
 
     // pass 2: construct consensus features until all points assigned.
     while (!potential_clusters.empty())
@@ -312,7 +354,7 @@ namespace OpenMS
 
       // compile the actual list of sub feature indices for cluster with center i
       vector<Size> cf_indices;
-      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data);
+      computeBestClusterForCenter_(i, cf_indices, assigned, kd_data, neighborhoods[i], feature_distance);
 
       // add consensus feature
       addConsensusFeature_(cf_indices, kd_data, out);
@@ -328,8 +370,7 @@ namespace OpenMS
       update_these = set<Size>();
       for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
       {
-        vector<Size> f_neighbors;
-        kd_data.getNeighborhood(*f_it, f_neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, true);
+        const vector<Size>& f_neighbors = neighborhoods[*f_it];
         for (vector<Size>::const_iterator it = f_neighbors.begin(); it != f_neighbors.end(); ++it)
         {
           if (!assigned[*it])
@@ -340,7 +381,7 @@ namespace OpenMS
       }
 
       // now that the points are marked assigned, update the neighborhoods of their neighbors
-      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data);
+      updateClusterProxies_(potential_clusters, cluster_for_idx, update_these, assigned, kd_data, neighborhoods, feature_distance);
     }
   }
 
@@ -350,14 +391,16 @@ namespace OpenMS
                                                          vector<ClusterProxyKD>& cluster_for_idx,
                                                          const set<Size>& update_these,
                                                          const vector<Int>& assigned,
-                                                         const KDTreeFeatureMaps& kd_data)
+                                                         const KDTreeFeatureMaps& kd_data,
+                                                         const vector<vector<Size> >& neighborhoods,
+                                                         FeatureDistance& feature_distance) const
   {
     for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
     {
       Size i = *it;
       const ClusterProxyKD& old_proxy = cluster_for_idx[i];
       vector<Size> unused;
-      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data);
+      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data, neighborhoods[i], feature_distance);
 
       // only need to update if size and/or average distance have changed
       if (new_proxy != old_proxy)
@@ -369,17 +412,16 @@ namespace OpenMS
     }
   }
 
-  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data) const
+  ClusterProxyKD FeatureGroupingAlgorithmKD::computeBestClusterForCenter_(Size i, vector<Size>& cf_indices, const vector<Int>& assigned, const KDTreeFeatureMaps& kd_data,
+                                                                         const vector<Size>& neighbors, FeatureDistance& feature_distance) const
   {
     //Parameters how to use charge/adduct information
     String merge_charge(param_.getValue("link:charge_merging").toString());
     String merge_adduct(param_.getValue("link:adduct_merging").toString());
 
-    // compute i's neighborhood, together with a look-up table
+    // look-up table for i's neighborhood:
     // map index -> corresponding points
     map<Size, vector<Size> > points_for_map_index;
-    vector<Size> neighbors;
-    kd_data.getNeighborhood(i, neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, true);
     Int charge_i = kd_data.charge(i);
     const BaseFeature* f_i = kd_data.feature(i);
     for (vector<Size>::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it)
@@ -471,8 +513,7 @@ namespace OpenMS
       Size best_index = numeric_limits<Size>::max();
       for (vector<Size>::const_iterator c_it = candidates.begin(); c_it != candidates.end(); ++c_it)
       {
-        double dist = const_cast<FeatureDistance&>(feature_distance_)(*(kd_data.feature(*c_it)),
-                                                                      *(kd_data.feature(i))).second;
+        double dist = feature_distance(*(kd_data.feature(*c_it)), *(kd_data.feature(i))).second;
 
         if (dist < min_dist)
         {
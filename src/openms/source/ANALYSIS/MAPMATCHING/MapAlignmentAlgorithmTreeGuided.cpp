@@ -145,7 +145,10 @@ namespace OpenMS
   void MapAlignmentAlgorithmTreeGuided::extractSeqAndRt_(const vector<FeatureMap>& feature_maps,
           vector<SeqAndRTList>& maps_seq_and_rt, vector<vector<double>>& maps_ranges)
   {
-    for (Size i = 0; i < feature_maps.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(feature_maps.size()); ++i)
     {
       for (const BaseFeature& bf : feature_maps[i])
       {
@@ -167,12 +170,90 @@ namespace OpenMS
     extractSeqAndRt_(feature_maps, maps_seq_and_rt, maps_ranges);
     PeptideIdentificationsPearsonDistance_ pep_dist;
     AverageLinkage al;
-    DistanceMatrix<float> dist_matrix; // will be filled
     ClusterHierarchical ch;
 
+    // compute the pairwise distances here (in parallel) instead of in ClusterHierarchical::cluster(),
+    // which only fills the matrix if it does not have the right size yet
+    const SignedSize n_maps = maps_seq_and_rt.size();
+    DistanceMatrix<float> dist_matrix;
+    dist_matrix.resize(n_maps, 1);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = n_maps - 1; i >= 0; --i) // longest rows first
+    {
+      for (SignedSize j = 0; j < i; ++j)
+      {
+        // distance value is 1-similarity value, since similarity is in range of [0,1]
+        dist_matrix.setValueQuick(i, j, 1 - pep_dist(maps_seq_and_rt[i], maps_seq_and_rt[j]));
+      }
+    }
+
     ch.cluster<SeqAndRTList, PeptideIdentificationsPearsonDistance_>(maps_seq_and_rt, pep_dist, al, tree, dist_matrix);
   }
 
+  // Align the two clusters merged by node using a given aligner; the result is stored at the smaller index of both clusters.
+  void MapAlignmentAlgorithmTreeGuided::alignClusters_(const BinaryTreeNode& node,
+                                                       std::vector<FeatureMap>& feature_maps_transformed,
+                                                       const std::vector<std::vector<double>>& maps_ranges,
+                                                       std::vector<std::vector<Size>>& map_sets,
+                                                       MapAlignmentAlgorithmIdentification& aligner) const
+  {
+    Size ref;
+    Size to_transform;
+
+    // ----------------
+    // prepare alignment
+    // ----------------
+    //  determine the map with larger RT range for 10/90 percentile (->reference)
+    double left_range = maps_ranges[node.left_child][maps_ranges[node.left_child].size()*0.9] - maps_ranges[node.left_child][maps_ranges[node.left_child].size()*0.1];
+    double right_range = maps_ranges[node.right_child][maps_ranges[node.right_child].size()*0.9] - maps_ranges[node.right_child][maps_ranges[node.right_child].size()*0.1];
+
+    if (left_range > right_range)
+    {
+      ref = node.left_child;
+      to_transform = node.right_child;
+    }
+    else
+    {
+      ref = node.right_child;
+      to_transform = node.left_child;
+    }
+
+    vector<FeatureMap> to_align;
+    to_align.push_back(feature_maps_transformed[to_transform]);
+    to_align.push_back(feature_maps_transformed[ref]);
+
+    // ----------------
+    // perform alignment
+    // ----------------
+    vector<TransformationDescription> transformations_align;  // temporary for aligner output
+    aligner.align(to_align, transformations_align, 1);
+
+    // transform retention times of non-identity for next iteration
+    transformations_align[0].fitModel(model_type_, model_param_);
+    MapAlignmentTransformer::transformRetentionTimes(feature_maps_transformed[to_transform],
+            transformations_align[0], true);
+
+    // combine aligned maps, store at smaller index, because tree always calls smaller number
+    // clear feature map at larger index to save memory
+    feature_maps_transformed[ref] += feature_maps_transformed[to_transform];
+    feature_maps_transformed[ref].updateRanges();
+    if (ref < to_transform)
+    {
+      feature_maps_transformed[to_transform].clear(true);
+    }
+    else
+    {
+      feature_maps_transformed[to_transform] = feature_maps_transformed[ref];
+      feature_maps_transformed[ref].clear(true);
+    }
+
+    // update order of alignment for both aligned maps
+    map_sets[ref].insert(map_sets[ref].end(), map_sets[to_transform].begin(), map_sets[to_transform].end());
+    map_sets[to_transform] = map_sets[ref];
+  }
+
   // Align feature maps tree guided using align() of MapAlignmentAlgorithmIdentification and use TreeNode with larger 10/90 percentile range as reference.
   void MapAlignmentAlgorithmTreeGuided::treeGuidedAlignment(const std::vector<BinaryTreeNode>& tree,
                                                             std::vector<FeatureMap>& feature_maps_transformed,
@@ -180,10 +261,6 @@ namespace OpenMS
                                                             FeatureMap& map_transformed,
                                                             std::vector<Size>& trafo_order)
   {
-    Size last_trafo = 0;  // to get final transformation order from map_sets
-    vector<TransformationDescription> transformations_align;  // temporary for aligner output
-    vector<FeatureMap> to_align;
-
     // helper to memorize rt transformation order
     vector<vector<Size>> map_sets(feature_maps_transformed.size());
     for (Size i = 0; i < feature_maps_transformed.size(); ++i)
@@ -191,9 +268,6 @@ namespace OpenMS
       map_sets[i].push_back(i);
     }
 
-    Size ref;
-    Size to_transform;
-
     // check RT ranges of IDs
     for (size_t i = 0; i < maps_ranges.size(); ++i)
     {
@@ -202,65 +276,60 @@ namespace OpenMS
       if (maps_ranges[i].empty()) throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "FeatureMap originating from '" + ListUtils::concatenate(p, "', '") + "' contains no Peptide Identifications. Cannot align!");
     }
 
-    for (const auto& node : tree)
+    // Nodes that merge clusters created in earlier rounds only can be aligned concurrently: every node is
+    // scheduled in the round after the last node that changed one of its two clusters. Nodes of the same
+    // round work on disjoint clusters, so the result does not depend on the number of threads.
+    vector<Size> cluster_round(feature_maps_transformed.size(), 0);
+    vector<vector<Size>> rounds;
+    for (Size n = 0; n < tree.size(); ++n)
     {
-      // ----------------
-      // prepare alignment
-      // ----------------
-      //  determine the map with larger RT range for 10/90 percentile (->reference)
-      double left_range = maps_ranges[node.left_child][maps_ranges[node.left_child].size()*0.9] - maps_ranges[node.left_child][maps_ranges[node.left_child].size()*0.1];
-      double right_range = maps_ranges[node.right_child][maps_ranges[node.right_child].size()*0.9] - maps_ranges[node.right_child][maps_ranges[node.right_child].size()*0.1];
-
-      if (left_range > right_range)
-      {
-        ref = node.left_child;
-        to_transform = node.right_child;
-      }
-      else
-      {
-        ref = node.right_child;
-        to_transform = node.left_child;
-      }
-
-      vector<double> tmp;
-      std::merge(maps_ranges[node.right_child].begin(), maps_ranges[node.right_child].end(), maps_ranges[node.left_child].begin(), maps_ranges[node.left_child].end(), std::back_inserter(tmp));
-
-      to_align.push_back(feature_maps_transformed[to_transform]);
-      to_align.push_back(feature_maps_transformed[ref]);
-
-      // ----------------
-      // perform alignment
-      // ----------------
-      align_algorithm_.align(to_align, transformations_align, 1);
-
-      // transform retention times of non-identity for next iteration
-      transformations_align[0].fitModel(model_type_, model_param_);
-      MapAlignmentTransformer::transformRetentionTimes(feature_maps_transformed[to_transform],
-              transformations_align[0], true);
+      const Size round = max(cluster_round[tree[n].left_child], cluster_round[tree[n].right_child]);
+      if (round == rounds.size()) rounds.emplace_back();
+      rounds[round].push_back(n);
+      cluster_round[tree[n].left_child] = cluster_round[tree[n].right_child] = round + 1;
+    }
 
-      // combine aligned maps, store at smaller index, because tree always calls smaller number
-      // clear feature map at larger index to save memory
-      feature_maps_transformed[ref] += feature_maps_transformed[to_transform];
-      feature_maps_transformed[ref].updateRanges();
-      if (ref < to_transform)
+    for (const vector<Size>& round : rounds)
+    {
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
       {
-        feature_maps_transformed[to_transform].clear(true);
-        last_trafo = ref;
+        // the aligner keeps state during align(), so every thread needs its own
+        MapAlignmentAlgorithmIdentification aligner;
+        aligner.setParameters(align_algorithm_.getParameters());
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (SignedSize i = 0; i < SignedSize(round.size()); ++i)
+        {
+          try
+          {
+            alignClusters_(tree[round[i]], feature_maps_transformed, maps_ranges, map_sets, aligner);
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (MapAlignmentAlgorithmTreeGuided_treeGuidedAlignment)
+#endif
+            if (!error) error = std::current_exception();
+          }
+        }
       }
-      else
+      if (error)
       {
-        feature_maps_transformed[to_transform] = feature_maps_transformed[ref];
-        feature_maps_transformed[ref].clear(true);
-        last_trafo = to_transform;
+        std::rethrow_exception(error);
       }
+    }
 
-      // update order of alignment for both aligned maps
-      map_sets[ref].insert(map_sets[ref].end(), map_sets[to_transform].begin(), map_sets[to_transform].end());
-      map_sets[to_transform] = map_sets[ref];
-
-      transformations_align.clear();
-      to_align.clear();
+    // the last node merged all maps (stored at the smaller index)
+    Size last_trafo = 0;
+    if (!tree.empty())
+    {
+      last_trafo = min(tree.back().left_child, tree.back().right_child);
     }
+
     // copy last transformed FeatureMap for reference return
     map_transformed = feature_maps_transformed[last_trafo];
     trafo_order = map_sets[last_trafo];
@@ -272,11 +341,25 @@ namespace OpenMS
                                                                   std::vector<TransformationDescription>& transformations,
                                                                   const std::vector<Size>& trafo_order)
   {
-    FeatureMap::const_iterator fit = map_transformed.begin();
-    TransformationDescription::DataPoints trafo_data_tmp;
+    // features of the maps are stored consecutively in order of alignment
+    vector<Size> offsets(1, 0);
     for (auto& map_idx : trafo_order)
     {
-      for (Size i = 0; i < feature_maps[map_idx].size(); ++i)
+      offsets.push_back(offsets.back() + feature_maps[map_idx].size());
+    }
+
+    // fit the models of the maps in parallel
+    std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize k = 0; k < SignedSize(trafo_order.size()); ++k)
+    {
+      const Size map_idx = trafo_order[k];
+      TransformationDescription::DataPoints trafo_data_tmp;
+      trafo_data_tmp.reserve(offsets[k + 1] - offsets[k]);
+      for (FeatureMap::const_iterator fit = map_transformed.begin() + offsets[k];
+           fit != map_transformed.begin() + offsets[k + 1]; ++fit)
       {
         TransformationDescription::DataPoint point;
         if (fit->metaValueExists("original_RT"))
@@ -290,17 +373,32 @@ namespace OpenMS
         point.second = fit->getRT();
         point.note = fit->getUniqueId();
         trafo_data_tmp.push_back(point);
-        ++fit;
       }
       transformations[map_idx] = TransformationDescription(trafo_data_tmp);
-      transformations[map_idx].fitModel(model_type_, model_param_);
-      trafo_data_tmp.clear();
+      try
+      {
+        transformations[map_idx].fitModel(model_type_, model_param_);
+      }
+      catch (...)
+      {
+#ifdef _OPENMP
+#pragma omp critical (MapAlignmentAlgorithmTreeGuided_computeTrafosByOriginalRT)
+#endif
+        if (!error) error = std::current_exception();
+      }
+    }
+    if (error)
+    {
+      std::rethrow_exception(error);
     }
   }
 
   void MapAlignmentAlgorithmTreeGuided::computeTransformedFeatureMaps(vector<FeatureMap>& feature_maps, const vector<TransformationDescription>& transformations)
   {
-    for (Size i = 0; i < feature_maps.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(feature_maps.size()); ++i)
     {
       MapAlignmentTransformer::transformRetentionTimes(feature_maps[i], transformations[i], true);
     }
@@ -151,37 +151,80 @@ namespace OpenMS
       // add last partition (a bit more since we use "smaller than" below)
       partition_boundaries.push_back(massrange.back() + 1.0);
 
+      // assign the features of all input maps to their partitions (feature
+      // indices per partition and map, in the original order)
+      const Size nr_partitions = partition_boundaries.size() - 1;
+      std::vector<std::vector<std::vector<Size> > > partition_features(nr_partitions,
+        std::vector<std::vector<Size> >(input_maps.size()));
+      for (size_t k = 0; k < input_maps.size(); k++)
+      {
+        for (size_t m = 0; m < input_maps[k].size(); m++)
+        {
+          // partition j contains the m/z range [partition_boundaries[j], partition_boundaries[j+1])
+          Size j = std::upper_bound(partition_boundaries.begin(), partition_boundaries.end(),
+                                    input_maps[k][m].getMZ()) - partition_boundaries.begin() - 1;
+          partition_features[j][k].push_back(m);
+        }
+      }
+
+      // Partitions are independent, so they are processed in parallel (each
+      // by its own instance, as the algorithm keeps state). Results are
+      // collected per partition and appended in order, so the output does not
+      // depend on the number of threads.
+      std::vector<ConsensusMap> partition_results(nr_partitions);
+      std::exception_ptr error;
       ProgressLogger logger;
       Size progress = 0;
       logger.setLogType(ProgressLogger::CMD);
-      logger.startProgress(0, partition_boundaries.size(), "linking features");
-      for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+      logger.startProgress(0, nr_partitions, "linking features");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize j = 0; j < SignedSize(nr_partitions); j++)
       {
-        double partition_start = partition_boundaries[j];
-        double partition_end = partition_boundaries[j+1];
-
-        std::vector<MapType> tmp_input_maps(input_maps.size());
-        for (size_t k = 0; k < input_maps.size(); k++)
+        try
         {
-          // iterate over all features in the current input map and append
-          // matching features (within the current partition) to the temporary
-          // map
-          for (size_t m = 0; m < input_maps[k].size(); m++)
+          std::vector<MapType> tmp_input_maps(input_maps.size());
+          for (size_t k = 0; k < input_maps.size(); k++)
           {
-            if (input_maps[k][m].getMZ() >= partition_start && 
-                input_maps[k][m].getMZ() < partition_end)
+            for (Size m : partition_features[j][k])
             {
               tmp_input_maps[k].push_back(input_maps[k][m]);
             }
+            tmp_input_maps[k].updateRanges();
           }
-          tmp_input_maps[k].updateRanges();
-        }
 
-        // run algo on current partition
-        run_internal_(tmp_input_maps, result_map, false);
+          // run algo on current partition
+          QTClusterFinder partition_finder;
+          partition_finder.setParameters(param_);
+          partition_finder.run_internal_(tmp_input_maps, partition_results[j], false);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (QTClusterFinder_run_error)
+#endif
+          if (!error) error = std::current_exception();
+        }
+#ifdef _OPENMP
+#pragma omp critical (QTClusterFinder_run_progress)
+#endif
         logger.setProgress(progress++);
       }
       logger.endProgress();
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+
+      for (ConsensusMap& partition_result : partition_results)
+      {
+        for (const ConsensusFeature& feature : partition_result)
+        {
+          result_map.push_back(feature);
+        }
+        partition_result.clear();
+      }
     }
   }
 
@@ -239,7 +282,7 @@ namespace OpenMS
 
     // compute QT clustering:
     // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
+    vector<QTCluster> clustering;
     computeClustering_(grid, clustering);
     // number of clusters == number of data points:
     Size size = clustering.size();
@@ -247,7 +290,7 @@ namespace OpenMS
     // create a temp. map storing which grid features are next to which clusters
     typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
     ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       NeighborList neigh = it->getAllNeighbors();
@@ -264,13 +307,20 @@ namespace OpenMS
     }
 
     // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       OpenMS::GridFeature* center_feature = it->getCenterPoint();
       element_mapping[center_feature].push_back(&(*it));
     }
 
+    // priority queue of the cluster qualities
+    ClusterQueue cluster_queue;
+    for (Size i = 0; i < clustering.size(); ++i)
+    {
+      cluster_queue.push(ClusterQueueEntry(clustering[i].getQuality(), i));
+    }
+
     ProgressLogger logger;
     Size progress = 0;
     if (do_progress)
@@ -279,50 +329,46 @@ namespace OpenMS
       logger.startProgress(0, size, "linking features");
     }
 
-    while (!clustering.empty())
+    while (true)
     {
-      // std::cout << "Clusters: " << clustering.size() << std::endl;
       ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
-      if (!clustering.empty())
+      if (!makeConsensusFeature_(clustering, cluster_queue, consensus_feature, element_mapping, grid))
       {
-        result_map.push_back(consensus_feature);
+        break; // no more clusters to process
       }
+      result_map.push_back(consensus_feature);
       if (do_progress) logger.setProgress(progress++);
     }
 
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  bool QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
+                                              ClusterQueue& cluster_queue,
                                               ConsensusFeature& feature,
                                               ElementMapping& element_mapping,
                                               Grid& grid)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
+    // find the best cluster (a valid cluster with the highest score; the
+    // first one in case of ties): entries of invalid clusters and outdated
+    // entries (the quality of the cluster has changed since) are skipped
+    QTCluster* best = nullptr;
+    while (!cluster_queue.empty())
     {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
+      const ClusterQueueEntry top = cluster_queue.top();
+      cluster_queue.pop();
+      QTCluster& cluster = clustering[top.second];
+      if (!cluster.isInvalid() && cluster.getQuality() == top.first)
       {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
+        best = &cluster;
+        break;
       }
     }
 
-    // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
+    // no more clusters to process
+    if (best == nullptr)
     {
-      clustering.clear();
-      return;
+      return false;
     }
 
     OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
@@ -400,7 +446,11 @@ namespace OpenMS
             // add elements to the current cluster to replace the ones we just
             // removed
             const OpenMS::GridFeature* center_feature = (*cluster)->getCenterPoint();
-            addClusterElements_(x, y, grid, (**cluster), center_feature);
+            addClusterElements_(x, y, grid, (**cluster), center_feature, feature_distance_);
+
+            // the quality may have changed -> add a new queue entry (the old
+            // one becomes outdated)
+            cluster_queue.push(ClusterQueueEntry((*cluster)->getQuality(), *cluster - &clustering[0]));
 
             ////////////////////////////////////////
             // Step 2: update element_mapping as the best feature for each
@@ -432,10 +482,11 @@ namespace OpenMS
         }
       }
     }
+    return true;
   }
 
   void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
-    const OpenMS::GridFeature* center_feature)
+    const OpenMS::GridFeature* center_feature, FeatureDistance& feature_distance)
   {
     cluster.initializeCluster();
 
@@ -478,7 +529,7 @@ namespace OpenMS
             if (center_feature != neighbor_feature)
             {
               // NOTE: this actually caches the distance -> memory problem
-              double dist = getDistance_(center_feature, neighbor_feature);
+              double dist = getDistance_(feature_distance, center_feature, neighbor_feature);
 
               if (dist == FeatureDistance::infinity)
               {
@@ -528,7 +579,7 @@ namespace OpenMS
   }
 
   void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+                                           vector<QTCluster>& clustering)
   {
     clustering.clear();
     already_used_.clear();
@@ -536,25 +587,42 @@ namespace OpenMS
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
+    // create a cluster for every point in the grid:
     for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
-
-      addClusterElements_(x, y, grid, cluster, center_feature);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance, use_IDs_, x, y));
+    }
 
-      clustering.push_back(cluster);
+    // add the neighbors and compute the cluster qualities in parallel (the
+    // clusters are independent; the distance functor keeps state, so every
+    // thread needs its own copy):
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      FeatureDistance feature_distance;
+      feature_distance = feature_distance_;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < SignedSize(clustering.size()); ++i)
+      {
+        QTCluster& cluster = clustering[i];
+        addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid, cluster,
+                            cluster.getCenterPoint(), feature_distance);
+      }
     }
   }
 
-  double QTClusterFinder::getDistance_(const OpenMS::GridFeature* left,
+  double QTClusterFinder::getDistance_(FeatureDistance& feature_distance,
+                                       const OpenMS::GridFeature* left,
                                        const OpenMS::GridFeature* right)
   {
-    return feature_distance_(left->getFeature(), right->getFeature()).second;
+    return feature_distance(left->getFeature(), right->getFeature()).second;
   }
   
 
@@ -133,6 +133,11 @@ namespace OpenMS
     return model_->evaluate(value);
   }
 
+  void TransformationDescription::apply(const double* in, double* out, Size n) const
+  {
+    model_->evaluate(in, out, n);
+  }
+
   const String& TransformationDescription::getModelType() const
   {
     return model_type_;
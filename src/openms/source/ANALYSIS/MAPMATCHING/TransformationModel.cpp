@@ -88,6 +88,14 @@ namespace OpenMS
     return value;
   }
 
+  void TransformationModel::evaluate(const double* in, double* out, Size n) const
+  {
+    for (Size i = 0; i < n; ++i)
+    {
+      out[i] = evaluate(in[i]);
+    }
+  }
+
   const Param& TransformationModel::getParameters() const
   {
     return params_;
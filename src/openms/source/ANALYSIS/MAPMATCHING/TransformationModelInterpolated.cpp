@@ -71,6 +71,14 @@ public:
       return spline_->eval(x);
     }
 
+    double evalSequential(const double& x, Size& segment) const override
+    {
+      unsigned index = static_cast<unsigned>(segment);
+      const double result = spline_->eval(x, index);
+      segment = index;
+      return result;
+    }
+
     ~Spline2dInterpolator() override
     {
       delete spline_;
@@ -163,6 +171,34 @@ public:
       }
     }
 
+    double evalSequential(const double& x, Size& segment) const override
+    {
+      if (segment >= x_.size() || x_[segment] > x)
+      {
+        // no usable start index (e.g. positions not sorted)
+        segment = std::upper_bound(x_.begin(), x_.end(), x) - x_.begin() - 1;
+      }
+      else
+      {
+        while (segment + 1 < x_.size() && x_[segment + 1] <= x)
+        {
+          ++segment;
+        }
+      }
+
+      // same invariants as in eval(): x_[segment] <= x < x_[segment + 1], or x is the last point
+      if (segment + 1 == x_.size())
+      {
+        return y_.back();
+      }
+      const double x_0 = x_[segment];
+      const double x_1 = x_[segment + 1];
+      const double y_0 = y_[segment];
+      const double y_1 = y_[segment + 1];
+
+      return y_0 + (y_1 - y_0) * (x - x_0) / (x_1 - x_0);
+    }
+
     ~LinearInterpolator() override
     {
     }
@@ -418,6 +454,28 @@ private:
     return interp_->eval(value);
   }
 
+  void TransformationModelInterpolated::evaluate(const double* in, double* out, Size n) const
+  {
+    // carried over between values, so sorted input is interpolated in one sweep over the data points
+    Size segment = 0;
+    for (Size i = 0; i < n; ++i)
+    {
+      const double value = in[i];
+      if (value < x_.front()) // extrapolate front
+      {
+        out[i] = lm_front_->evaluate(value);
+      }
+      else if (value > x_.back()) // extrapolate back
+      {
+        out[i] = lm_back_->evaluate(value);
+      }
+      else
+      {
+        out[i] = interp_->evalSequential(value, segment);
+      }
+    }
+  }
+
   void TransformationModelInterpolated::getDefaultParameters(Param& params)
   {
     params.clear();
@@ -110,6 +110,21 @@ namespace OpenMS
     return eval;
   }
 
+  void TransformationModelLinear::evaluate(const double* in, double* out, Size n) const
+  {
+    if (weighting_)
+    {
+      TransformationModel::evaluate(in, out, n);
+      return;
+    }
+    // no branches or virtual calls in the loop, so the compiler can vectorize it
+    const double slope = slope_, intercept = intercept_;
+    for (Size i = 0; i < n; ++i)
+    {
+      out[i] = slope * in[i] + intercept;
+    }
+  }
+
   void TransformationModelLinear::invert()
   {
     if (slope_ == 0)
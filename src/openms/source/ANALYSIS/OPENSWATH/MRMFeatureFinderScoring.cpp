@@ -254,6 +254,11 @@ namespace OpenMS
     }
     endProgress();
 
+    const OpenSwathScoring::SpectrumCacheStatistics& cache_stats = scorer_.getSpectrumCacheStatistics();
+    OPENMS_LOG_DEBUG << "Spectrum cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses" << std::endl;
+    // the cached spectra keep the maps of this call alive
+    scorer_.clearSpectrumCache();
+
     //output.sortByPosition(); // if the exact same order is needed
     return;
   }
@@ -538,7 +543,7 @@ namespace OpenMS
     newtr.invert();
     expected_rt = newtr.apply(expected_rt);
 
-    OpenSwathScoring scorer;
+    OpenSwathScoring& scorer = scorer_;
     scorer.initialize(rt_normalization_factor_, add_up_spectra_,
                       spacing_for_spectra_resampling_,
                       im_extra_drift_,
@@ -35,12 +35,196 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
 
 #include <OpenMS/FORMAT/SqliteConnector.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
 
 #include <sqlite3.h>
 
+#include <cmath>
+#include <iostream>
+
 namespace OpenMS
 {
 
+  namespace
+  {
+    // column / meta value pairs of FEATURE_MS2 following FEATURE_ID and AREA_INTENSITY
+    const char* const FEATURE_MS2_SCORES[][2] =
+    {
+      {"TOTAL_AREA_INTENSITY", "total_xic"},
+      {"APEX_INTENSITY", "peak_apices_sum"},
+      {"TOTAL_MI", "total_mi"},
+      {"VAR_BSERIES_SCORE", "var_bseries_score"},
+      {"VAR_DOTPROD_SCORE", "var_dotprod_score"},
+      {"VAR_INTENSITY_SCORE", "var_intensity_score"},
+      {"VAR_ISOTOPE_CORRELATION_SCORE", "var_isotope_correlation_score"},
+      {"VAR_ISOTOPE_OVERLAP_SCORE", "var_isotope_overlap_score"},
+      {"VAR_LIBRARY_CORR", "var_library_corr"},
+      {"VAR_LIBRARY_DOTPROD", "var_library_dotprod"},
+      {"VAR_LIBRARY_MANHATTAN", "var_library_manhattan"},
+      {"VAR_LIBRARY_RMSD", "var_library_rmsd"},
+      {"VAR_LIBRARY_ROOTMEANSQUARE", "var_library_rootmeansquare"},
+      {"VAR_LIBRARY_SANGLE", "var_library_sangle"},
+      {"VAR_LOG_SN_SCORE", "var_log_sn_score"},
+      {"VAR_MANHATTAN_SCORE", "var_manhatt_score"},
+      {"VAR_MASSDEV_SCORE", "var_massdev_score"},
+      {"VAR_MASSDEV_SCORE_WEIGHTED", "var_massdev_score_weighted"},
+      {"VAR_MI_SCORE", "var_mi_score"},
+      {"VAR_MI_WEIGHTED_SCORE", "var_mi_weighted_score"},
+      {"VAR_MI_RATIO_SCORE", "var_mi_ratio_score"},
+      {"VAR_NORM_RT_SCORE", "var_norm_rt_score"},
+      {"VAR_XCORR_COELUTION", "var_xcorr_coelution"},
+      {"VAR_XCORR_COELUTION_WEIGHTED", "var_xcorr_coelution_weighted"},
+      {"VAR_XCORR_SHAPE", "var_xcorr_shape"},
+      {"VAR_XCORR_SHAPE_WEIGHTED", "var_xcorr_shape_weighted"},
+      {"VAR_YSERIES_SCORE", "var_yseries_score"},
+      {"VAR_ELUTION_MODEL_FIT_SCORE", "var_elution_model_fit_score"},
+      {"VAR_IM_XCORR_SHAPE", "var_im_xcorr_shape"},
+      {"VAR_IM_XCORR_COELUTION", "var_im_xcorr_coelution"},
+      {"VAR_IM_DELTA_SCORE", "var_im_delta_score"},
+      {"VAR_SONAR_LAG", "var_sonar_lag"},
+      {"VAR_SONAR_SHAPE", "var_sonar_shape"},
+      {"VAR_SONAR_LOG_SN", "var_sonar_log_sn"},
+      {"VAR_SONAR_LOG_DIFF", "var_sonar_log_diff"},
+      {"VAR_SONAR_LOG_TREND", "var_sonar_log_trend"},
+      {"VAR_SONAR_RSQ", "var_sonar_rsq"}
+    };
+
+    // column / meta value pairs of FEATURE_MS1 following FEATURE_ID
+    const char* const FEATURE_MS1_SCORES[][2] =
+    {
+      {"AREA_INTENSITY", "ms1_area_intensity"},
+      {"APEX_INTENSITY", "ms1_apex_intensity"},
+      {"VAR_MASSDEV_SCORE", "var_ms1_ppm_diff"},
+      {"VAR_IM_MS1_DELTA_SCORE", "var_im_ms1_delta_score"},
+      {"VAR_MI_SCORE", "var_ms1_mi_score"},
+      {"VAR_MI_CONTRAST_SCORE", "var_ms1_mi_contrast_score"},
+      {"VAR_MI_COMBINED_SCORE", "var_ms1_mi_combined_score"},
+      {"VAR_ISOTOPE_CORRELATION_SCORE", "var_ms1_isotope_correlation"},
+      {"VAR_ISOTOPE_OVERLAP_SCORE", "var_ms1_isotope_overlap"},
+      {"VAR_XCORR_COELUTION", "var_ms1_xcorr_coelution"},
+      {"VAR_XCORR_COELUTION_CONTRAST", "var_ms1_xcorr_coelution_contrast"},
+      {"VAR_XCORR_COELUTION_COMBINED", "var_ms1_xcorr_coelution_combined"},
+      {"VAR_XCORR_SHAPE", "var_ms1_xcorr_shape"},
+      {"VAR_XCORR_SHAPE_CONTRAST", "var_ms1_xcorr_shape_contrast"},
+      {"VAR_XCORR_SHAPE_COMBINED", "var_ms1_xcorr_shape_combined"}
+    };
+
+    // column / meta value suffix pairs of the UIS transition scores following
+    // FEATURE_ID, the meta values are prefixed by "id_target_" or "id_decoy_"
+    const char* const FEATURE_TRANSITION_UIS_SCORES[][2] =
+    {
+      {"TRANSITION_ID", "transition_names"},
+      {"AREA_INTENSITY", "area_intensity"},
+      {"TOTAL_AREA_INTENSITY", "total_area_intensity"},
+      {"APEX_INTENSITY", "apex_intensity"},
+      {"TOTAL_MI", "total_mi"},
+      {"VAR_INTENSITY_SCORE", "intensity_score"},
+      {"VAR_INTENSITY_RATIO_SCORE", "intensity_ratio_score"},
+      {"VAR_LOG_INTENSITY", "ind_log_intensity"},
+      {"VAR_XCORR_COELUTION", "ind_xcorr_coelution"},
+      {"VAR_XCORR_SHAPE", "ind_xcorr_shape"},
+      {"VAR_LOG_SN_SCORE", "ind_log_sn_score"},
+      {"VAR_MASSDEV_SCORE", "ind_massdev_score"},
+      {"VAR_MI_SCORE", "ind_mi_score"},
+      {"VAR_MI_RATIO_SCORE", "ind_mi_ratio_score"},
+      {"VAR_ISOTOPE_CORRELATION_SCORE", "ind_isotope_correlation"},
+      {"VAR_ISOTOPE_OVERLAP_SCORE", "ind_isotope_overlap"}
+    };
+
+    const Size NR_FEATURE_MS2_SCORES = sizeof(FEATURE_MS2_SCORES) / sizeof(FEATURE_MS2_SCORES[0]);
+    const Size NR_FEATURE_MS1_SCORES = sizeof(FEATURE_MS1_SCORES) / sizeof(FEATURE_MS1_SCORES[0]);
+    const Size NR_FEATURE_TRANSITION_UIS_SCORES = sizeof(FEATURE_TRANSITION_UIS_SCORES) / sizeof(FEATURE_TRANSITION_UIS_SCORES[0]);
+
+    // builds "INSERT INTO table (FEATURE_ID, <first columns>, <score columns>) VALUES (?, ..., ?)"
+    String insertStatement(const String& table, const std::vector<String>& first_columns,
+                           const char* const scores[][2], Size nr_scores, Size& nr_columns)
+    {
+      std::vector<String> columns(first_columns);
+      for (Size i = 0; i < nr_scores; ++i)
+      {
+        columns.push_back(scores[i][0]);
+      }
+      nr_columns = columns.size();
+      std::vector<String> placeholders(nr_columns, "?");
+      return "INSERT INTO " + table + " (" + ListUtils::concatenate(columns, ", ") +
+        ") VALUES (" + ListUtils::concatenate(placeholders, ", ") + ");";
+    }
+
+    // bind a single value, empty values and NaN are stored as NULL
+    int bindValue(sqlite3_stmt* stmt, int pos, const DataValue& value)
+    {
+      switch (value.valueType())
+      {
+        case DataValue::EMPTY_VALUE:
+          return sqlite3_bind_null(stmt, pos);
+
+        case DataValue::INT_VALUE:
+          return sqlite3_bind_int64(stmt, pos, static_cast<sqlite3_int64>(static_cast<long long>(value)));
+
+        case DataValue::DOUBLE_VALUE:
+        {
+          double d = value;
+          if (std::isnan(d)) return sqlite3_bind_null(stmt, pos);
+          return sqlite3_bind_double(stmt, pos, d);
+        }
+
+        default:
+        {
+          // numeric strings are converted by the column affinity, same as the
+          // literal in a textual INSERT statement
+          String str = value.toString();
+          String lower = str;
+          lower.toLower();
+          if (str.empty() || lower == "nan" || lower == "-nan" || lower == "null") return sqlite3_bind_null(stmt, pos);
+          return sqlite3_bind_text(stmt, pos, str.c_str(), (int)str.size(), SQLITE_TRANSIENT);
+        }
+      }
+    }
+
+    // insert all rows of a table buffer using one prepared statement
+    void insertRows(sqlite3* db, const String& statement, Size nr_columns, const std::vector<DataValue>& cells)
+    {
+      if (cells.empty()) return;
+
+      sqlite3_stmt* stmt = nullptr;
+      SqliteConnector::prepareStatement(db, &stmt, statement);
+      for (Size row = 0; row < cells.size(); row += nr_columns)
+      {
+        int rc = SQLITE_OK;
+        for (Size col = 0; col < nr_columns && rc == SQLITE_OK; ++col)
+        {
+          rc = bindValue(stmt, (int)(col + 1), cells[row + col]);
+        }
+        if (rc == SQLITE_OK) rc = sqlite3_step(stmt);
+        if (rc != SQLITE_DONE)
+        {
+          String error(sqlite3_errmsg(db));
+          std::cerr << "SQL error while inserting OSW row" << std::endl;
+          std::cerr << "Prepared statement " << statement << std::endl;
+          sqlite3_finalize(stmt);
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error);
+        }
+        sqlite3_reset(stmt);
+      }
+      sqlite3_finalize(stmt);
+    }
+  }
+
+  void OpenSwathOSWWriter::OSWRows::clear()
+  {
+    feature.clear();
+    feature_ms1.clear();
+    feature_precursor.clear();
+    feature_ms2.clear();
+    feature_transition.clear();
+    feature_transition_uis.clear();
+  }
+
+  bool OpenSwathOSWWriter::OSWRows::empty() const
+  {
+    return feature.empty();
+  }
+
   bool OpenSwathOSWWriter::isActive() const
   {
     return doWrite_;
@@ -468,6 +652,149 @@ namespace OpenMS
     return sql.str();
   }
 
+  void OpenSwathOSWWriter::prepareRows(const OpenSwath::LightCompound& /* pep */,
+                                        const OpenSwath::LightTransition* /* transition */,
+                                        FeatureMap& output,
+                                        String id,
+                                        OSWRows& rows) const
+  {
+    // Conversion from UInt64 to int64_t to support SQLite (and conversion to 63 bits)
+    const DataValue run_id(static_cast<long long>(run_id_ & ~(1ULL << 63)));
+    const DataValue precursor_id(id);
+
+    // transition rows of this feature map, only one of both is kept (see prepareLine)
+    std::vector<DataValue> ms2_transition, uis_transition;
+
+    for (const auto& feature_it : output)
+    {
+      UInt64 uint64_feature_id = feature_it.getUniqueId();
+      const DataValue feature_id(static_cast<long long>(uint64_feature_id & ~(1ULL << 63))); // clear sign bit
+
+      for (const auto& sub_it : feature_it.getSubordinates())
+      {
+        if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS2")
+        {
+          ms2_transition.push_back(feature_id);
+          ms2_transition.push_back(sub_it.getMetaValue("native_id"));
+          ms2_transition.push_back(sub_it.getIntensity());
+          ms2_transition.push_back(sub_it.getMetaValue("total_xic"));
+          ms2_transition.push_back(sub_it.getMetaValue("peak_apex_int"));
+          ms2_transition.push_back(sub_it.getMetaValue("total_mi"));
+        }
+        else if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS1" && sub_it.getIntensity() > 0.0)
+        {
+          std::vector<String> isotope;
+          OpenMS::String(sub_it.getMetaValue("native_id")).split(OpenMS::String("Precursor_i"), isotope);
+          rows.feature_precursor.push_back(feature_id);
+          rows.feature_precursor.push_back(isotope[1]);
+          rows.feature_precursor.push_back(sub_it.getIntensity());
+          rows.feature_precursor.push_back(sub_it.getMetaValue("peak_apex_int"));
+        }
+      }
+
+      // these will be missing if RT scoring is disabled
+      double norm_rt = -1, delta_rt = -1;
+      if (feature_it.metaValueExists("norm_RT") ) norm_rt = feature_it.getMetaValue("norm_RT");
+      if (feature_it.metaValueExists("delta_rt") ) delta_rt = feature_it.getMetaValue("delta_rt");
+
+      rows.feature.push_back(feature_id);
+      rows.feature.push_back(run_id);
+      rows.feature.push_back(precursor_id);
+      rows.feature.push_back(feature_it.getRT());
+      rows.feature.push_back(feature_it.getMetaValue("im_drift"));
+      rows.feature.push_back(norm_rt);
+      rows.feature.push_back(delta_rt);
+      rows.feature.push_back(feature_it.getMetaValue("leftWidth"));
+      rows.feature.push_back(feature_it.getMetaValue("rightWidth"));
+
+      rows.feature_ms2.push_back(feature_id);
+      rows.feature_ms2.push_back(feature_it.getIntensity());
+      for (Size i = 0; i < NR_FEATURE_MS2_SCORES; ++i)
+      {
+        rows.feature_ms2.push_back(feature_it.getMetaValue(FEATURE_MS2_SCORES[i][1]));
+      }
+
+      if (use_ms1_traces_)
+      {
+        rows.feature_ms1.push_back(feature_id);
+        for (Size i = 0; i < NR_FEATURE_MS1_SCORES; ++i)
+        {
+          rows.feature_ms1.push_back(feature_it.getMetaValue(FEATURE_MS1_SCORES[i][1]));
+        }
+      }
+
+      if (enable_uis_scoring_)
+      {
+        const char* const prefixes[] = {"id_target_", "id_decoy_"};
+        for (const char* prefix : prefixes)
+        {
+          String num_transitions = String(prefix) + "num_transitions";
+          if (!feature_it.metaValueExists(num_transitions)) continue;
+
+          std::vector<std::vector<String> > scores(NR_FEATURE_TRANSITION_UIS_SCORES);
+          for (Size k = 0; k < NR_FEATURE_TRANSITION_UIS_SCORES; ++k)
+          {
+            String score_name = String(prefix) + FEATURE_TRANSITION_UIS_SCORES[k][1];
+            // prepareLine reports the apex intensity as total MI for targets, keep the same output
+            if (score_name == "id_target_total_mi") score_name = "id_target_apex_intensity";
+            scores[k] = getSeparateScore(feature_it, score_name);
+          }
+
+          int nr_transitions = feature_it.getMetaValue(num_transitions);
+          for (int i = 0; i < nr_transitions; ++i)
+          {
+            uis_transition.push_back(feature_id);
+            for (Size k = 0; k < NR_FEATURE_TRANSITION_UIS_SCORES; ++k)
+            {
+              uis_transition.push_back(scores[k][i]);
+            }
+          }
+        }
+      }
+    }
+
+    if (enable_uis_scoring_ && !uis_transition.empty())
+    {
+      rows.feature_transition_uis.insert(rows.feature_transition_uis.end(), uis_transition.begin(), uis_transition.end());
+    }
+    else
+    {
+      rows.feature_transition.insert(rows.feature_transition.end(), ms2_transition.begin(), ms2_transition.end());
+    }
+  }
+
+  void OpenSwathOSWWriter::writeRows(const OSWRows& rows)
+  {
+    if (rows.empty()) return;
+
+    Size nr_columns_feature, nr_columns_precursor, nr_columns_ms1, nr_columns_ms2, nr_columns_transition, nr_columns_uis;
+    const String insert_feature = insertStatement("FEATURE",
+        ListUtils::create<String>("ID,RUN_ID,PRECURSOR_ID,EXP_RT,EXP_IM,NORM_RT,DELTA_RT,LEFT_WIDTH,RIGHT_WIDTH"),
+        nullptr, 0, nr_columns_feature);
+    const String insert_precursor = insertStatement("FEATURE_PRECURSOR",
+        ListUtils::create<String>("FEATURE_ID,ISOTOPE,AREA_INTENSITY,APEX_INTENSITY"),
+        nullptr, 0, nr_columns_precursor);
+    const String insert_ms1 = insertStatement("FEATURE_MS1", ListUtils::create<String>("FEATURE_ID"),
+        FEATURE_MS1_SCORES, NR_FEATURE_MS1_SCORES, nr_columns_ms1);
+    const String insert_ms2 = insertStatement("FEATURE_MS2", ListUtils::create<String>("FEATURE_ID,AREA_INTENSITY"),
+        FEATURE_MS2_SCORES, NR_FEATURE_MS2_SCORES, nr_columns_ms2);
+    const String insert_transition = insertStatement("FEATURE_TRANSITION",
+        ListUtils::create<String>("FEATURE_ID,TRANSITION_ID,AREA_INTENSITY,TOTAL_AREA_INTENSITY,APEX_INTENSITY,TOTAL_MI"),
+        nullptr, 0, nr_columns_transition);
+    const String insert_uis = insertStatement("FEATURE_TRANSITION", ListUtils::create<String>("FEATURE_ID"),
+        FEATURE_TRANSITION_UIS_SCORES, NR_FEATURE_TRANSITION_UIS_SCORES, nr_columns_uis);
+
+    SqliteConnector conn(output_filename_);
+    conn.executeStatement("BEGIN TRANSACTION");
+    insertRows(conn.getDB(), insert_feature, nr_columns_feature, rows.feature);
+    insertRows(conn.getDB(), insert_ms1, nr_columns_ms1, rows.feature_ms1);
+    insertRows(conn.getDB(), insert_precursor, nr_columns_precursor, rows.feature_precursor);
+    insertRows(conn.getDB(), insert_ms2, nr_columns_ms2, rows.feature_ms2);
+    insertRows(conn.getDB(), insert_transition, nr_columns_transition, rows.feature_transition);
+    insertRows(conn.getDB(), insert_uis, nr_columns_uis, rows.feature_transition_uis);
+    conn.executeStatement("END TRANSACTION");
+  }
+
   void OpenSwathOSWWriter::writeLines(const std::vector<String>& to_osw_output)
   {
     SqliteConnector conn(output_filename_);
@@ -102,7 +102,9 @@ namespace OpenMS
     spacing_for_spectra_resampling_(0.005),
     add_up_spectra_(1),
     spectra_addition_method_("simple"),
-    im_drift_extra_pcnt_(0.0)
+    im_drift_extra_pcnt_(0.0),
+    spectrum_cache_size_(32),
+    spectrum_cache_tick_(0)
   {
   }
 
@@ -118,6 +120,13 @@ namespace OpenMS
                                     const OpenSwath_Scores_Usage & su,
                                     const std::string& spectrum_addition_method)
   {
+    // cached spectra depend on the way spectra are added up
+    if (spectrum_addition_method != spectra_addition_method_ ||
+        spacing_for_spectra_resampling != spacing_for_spectra_resampling_)
+    {
+      clearSpectrumCache();
+    }
+
     this->rt_normalization_factor_ = rt_normalization_factor;
     this->add_up_spectra_ = add_up_spectra;
     this->spectra_addition_method_ = spectrum_addition_method;
@@ -271,7 +280,7 @@ namespace OpenMS
 
   void OpenSwathScoring::calculateDIAIdScores(OpenSwath::IMRMFeature* imrmfeature,
                                               const TransitionType & transition,
-                                              const std::vector<OpenSwath::SwathMap> swath_maps,
+                                              const std::vector<OpenSwath::SwathMap>& swath_maps,
                                               OpenMS::DIAScoring & diascoring,
                                               OpenSwath_Scores & scores,
                                               double drift_lower, double drift_upper)
@@ -496,31 +505,115 @@ namespace OpenMS
     OpenSwath::Scoring::normalize_sum(&normalized_library_intensity[0], boost::numeric_cast<int>(normalized_library_intensity.size()));
   }
 
-  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(OpenSwath::SpectrumAccessPtr swath_map,
+  void OpenSwathScoring::setSpectrumCacheSize(Size size)
+  {
+    spectrum_cache_size_ = size;
+    if (spectrum_cache_.size() > size)
+    {
+      clearSpectrumCache();
+    }
+  }
+
+  Size OpenSwathScoring::getSpectrumCacheSize() const
+  {
+    return spectrum_cache_size_;
+  }
+
+  const OpenSwathScoring::SpectrumCacheStatistics& OpenSwathScoring::getSpectrumCacheStatistics() const
+  {
+    return spectrum_cache_statistics_;
+  }
+
+  void OpenSwathScoring::clearSpectrumCache()
+  {
+    spectrum_cache_.clear();
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::lookupSpectrum_(const std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> >& spectra,
+                                                           int nr_spectra_to_add, double drift_lower, double drift_upper)
+  {
+    // the cache is small, a linear search is cheap compared to adding up spectra
+    for (SpectrumCacheEntry_& entry : spectrum_cache_)
+    {
+      if (entry.nr_spectra_to_add == nr_spectra_to_add &&
+          entry.drift_lower == drift_lower &&
+          entry.drift_upper == drift_upper &&
+          entry.spectra == spectra)
+      {
+        entry.last_used = ++spectrum_cache_tick_;
+        ++spectrum_cache_statistics_.hits;
+        return entry.spectrum;
+      }
+    }
+    ++spectrum_cache_statistics_.misses;
+    return OpenSwath::SpectrumPtr();
+  }
+
+  void OpenSwathScoring::storeSpectrum_(const std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> >& spectra,
+                                        int nr_spectra_to_add, double drift_lower, double drift_upper,
+                                        const OpenSwath::SpectrumPtr& spectrum)
+  {
+    if (spectrum_cache_size_ == 0) return;
+
+    SpectrumCacheEntry_* entry;
+    if (spectrum_cache_.size() < spectrum_cache_size_)
+    {
+      spectrum_cache_.push_back(SpectrumCacheEntry_());
+      entry = &spectrum_cache_.back();
+    }
+    else // replace the least recently used spectrum
+    {
+      entry = &*std::min_element(spectrum_cache_.begin(), spectrum_cache_.end(),
+        [](const SpectrumCacheEntry_& a, const SpectrumCacheEntry_& b) { return a.last_used < b.last_used; });
+    }
+    entry->spectra = spectra;
+    entry->nr_spectra_to_add = nr_spectra_to_add;
+    entry->drift_lower = drift_lower;
+    entry->drift_upper = drift_upper;
+    entry->spectrum = spectrum;
+    entry->last_used = ++spectrum_cache_tick_;
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(const OpenSwath::SpectrumAccessPtr& swath_map,
                                                               double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
   {
-    return getAddedSpectra_(swath_map, RT, nr_spectra_to_add, drift_lower, drift_upper);
+    std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> > spectra(1, std::make_pair(swath_map, getClosestSpectrumIndex_(swath_map, RT)));
+    OpenSwath::SpectrumPtr spectrum = lookupSpectrum_(spectra, nr_spectra_to_add, drift_lower, drift_upper);
+    if (!spectrum)
+    {
+      spectrum = getAddedSpectraByIndex_(swath_map, spectra[0].second, nr_spectra_to_add, drift_lower, drift_upper);
+      storeSpectrum_(spectra, nr_spectra_to_add, drift_lower, drift_upper, spectrum);
+    }
+    return spectrum;
   }
 
-  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::vector<OpenSwath::SwathMap> swath_maps,
+  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                                               double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
   {
     if (swath_maps.size() == 1)
     {
-      return getAddedSpectra_(swath_maps[0].sptr, RT, nr_spectra_to_add, drift_lower, drift_upper);
+      return fetchSpectrumSwath(swath_maps[0].sptr, RT, nr_spectra_to_add, drift_lower, drift_upper);
     }
-    else
+
+    std::vector<std::pair<OpenSwath::SpectrumAccessPtr, int> > spectra;
+    spectra.reserve(swath_maps.size());
+    for (const OpenSwath::SwathMap& swath_map : swath_maps)
+    {
+      spectra.emplace_back(swath_map.sptr, getClosestSpectrumIndex_(swath_map.sptr, RT));
+    }
+    OpenSwath::SpectrumPtr spectrum = lookupSpectrum_(spectra, nr_spectra_to_add, drift_lower, drift_upper);
+    if (!spectrum)
     {
       // multiple SWATH maps for a single precursor -> this is SONAR data
       std::vector<OpenSwath::SpectrumPtr> all_spectra;
-      for (size_t i = 0; i < swath_maps.size(); ++i)
+      for (const auto& map_spectrum : spectra)
       {
-        OpenSwath::SpectrumPtr spec = getAddedSpectra_(swath_maps[i].sptr, RT, nr_spectra_to_add, drift_lower, drift_upper);
-        all_spectra.push_back(spec);
+        all_spectra.push_back(getAddedSpectraByIndex_(map_spectrum.first, map_spectrum.second, nr_spectra_to_add, drift_lower, drift_upper));
       }
-      OpenSwath::SpectrumPtr spectrum_ = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
-      return spectrum_;
+      spectrum = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
+      storeSpectrum_(spectra, nr_spectra_to_add, drift_lower, drift_upper, spectrum);
     }
+    return spectrum;
   }
 
   OpenSwath::SpectrumPtr filterByDrift(const OpenSwath::SpectrumPtr input, const double drift_lower, const double drift_upper)
@@ -571,17 +664,12 @@ namespace OpenMS
   }
 
 
-  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(OpenSwath::SpectrumAccessPtr swath_map,
-                                                            double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  int OpenSwathScoring::getClosestSpectrumIndex_(const OpenSwath::SpectrumAccessPtr& swath_map, double RT)
   {
     std::vector<std::size_t> indices = swath_map->getSpectraByRT(RT, 0.0);
-    OpenSwath::SpectrumPtr added_spec(new OpenSwath::Spectrum);
-    added_spec->getDataArrays().push_back( OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray) );
-    added_spec->getDataArrays().back()->description = "Ion Mobility";
-
-    if (indices.empty() )
+    if (indices.empty())
     {
-      return added_spec;
+      return -1;
     }
     int closest_idx = boost::numeric_cast<int>(indices[0]);
     if (indices[0] != 0 &&
@@ -590,6 +678,26 @@ namespace OpenMS
     {
       closest_idx--;
     }
+    return closest_idx;
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(OpenSwath::SpectrumAccessPtr swath_map,
+                                                            double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  {
+    return getAddedSpectraByIndex_(swath_map, getClosestSpectrumIndex_(swath_map, RT), nr_spectra_to_add, drift_lower, drift_upper);
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectraByIndex_(const OpenSwath::SpectrumAccessPtr& swath_map,
+                                                                   int closest_idx, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
+  {
+    OpenSwath::SpectrumPtr added_spec(new OpenSwath::Spectrum);
+    added_spec->getDataArrays().push_back( OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray) );
+    added_spec->getDataArrays().back()->description = "Ion Mobility";
+
+    if (closest_idx < 0)
+    {
+      return added_spec;
+    }
 
     if (nr_spectra_to_add == 1)
     {
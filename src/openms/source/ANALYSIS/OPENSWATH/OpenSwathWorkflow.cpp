@@ -890,7 +890,8 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
-    std::vector<String> to_tsv_output, to_osw_output;
+    std::vector<String> to_tsv_output;
+    OpenSwathOSWWriter::OSWRows to_osw_output;
     ///////////////////////////////////
     // Start of main function
     // Iterating over all the assays
@@ -984,9 +985,11 @@ namespace OpenMS
       {
         const OpenSwath::LightCompound pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
         const TransitionType* transition = assay_it->second[detection_assay_it];
-        to_osw_output.push_back(osw_writer.prepareLine(pep, transition, output, id));
+        osw_writer.prepareRows(pep, transition, output, id, to_osw_output);
       }
     }
+    OPENMS_LOG_DEBUG << "Spectrum cache: " << featureFinder.getSpectrumCacheStatistics().hits << " hits, "
+                     << featureFinder.getSpectrumCacheStatistics().misses << " misses" << std::endl;
 
     // Only write at the very end since this is a step that needs a barrier
     if (tsv_writer.isActive())
@@ -1006,7 +1009,7 @@ namespace OpenMS
 #pragma omp critical (osw_write_tsv)
 #endif
       {
-        osw_writer.writeLines(to_osw_output);
+        osw_writer.writeRows(to_osw_output);
       }
     }
   }
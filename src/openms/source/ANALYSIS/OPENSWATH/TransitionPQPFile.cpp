@@ -37,6 +37,8 @@
 #include <sqlite3.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
 
+#include <unordered_set>
+
 namespace OpenMS
 {
 
@@ -62,13 +64,9 @@ namespace OpenMS
     return 0;
   }
 
-  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  String TransitionPQPFile::getTransitionSelectSQL_(SqliteConnector& conn, bool legacy_traml_id, bool minimal, Size nr_windows,
+                                                    bool& drift_time_exists, bool& gene_exists) const
   {
-    sqlite3 *db;
-    sqlite3_stmt * cntstmt;
-    sqlite3_stmt * stmt;
-    std::string select_sql;
-
     // Use legacy TraML identifiers for precursors (transition_group_id) and transitions (transition_name)?
     std::string traml_id = "ID";
     if (legacy_traml_id)
@@ -76,18 +74,8 @@ namespace OpenMS
       traml_id = "TRAML_ID";
     }
 
-    // Open database
-    SqliteConnector conn(filename);
-    db = conn.getDB();
-
-    // Count transitions
-    SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
-    sqlite3_step( cntstmt );
-    int num_transitions = sqlite3_column_int(cntstmt, 0);
-    sqlite3_finalize(cntstmt);
-
     String select_drift_time = "";
-    bool drift_time_exists = SqliteConnector::columnExists(db, "PRECURSOR", "LIBRARY_DRIFT_TIME");
+    drift_time_exists = conn.columnExists("PRECURSOR", "LIBRARY_DRIFT_TIME");
     if (drift_time_exists)
     {
       select_drift_time = ", PRECURSOR.LIBRARY_DRIFT_TIME AS drift_time ";
@@ -96,7 +84,7 @@ namespace OpenMS
     String select_gene = "";
     String select_gene_null = "";
     String join_gene = "";
-    bool gene_exists = SqliteConnector::tableExists(db, "GENE");
+    gene_exists = conn.tableExists("GENE");
     if (gene_exists)
     {
       select_gene = ", GENE.GENE_NAME AS gene_name ";
@@ -106,15 +94,38 @@ namespace OpenMS
     }
 
     String select_annotation = "'' AS Annotation, ";
-    bool annotation_exists = SqliteConnector::columnExists(db, "TRANSITION", "ANNOTATION");
+    bool annotation_exists = !minimal && conn.columnExists("TRANSITION", "ANNOTATION");
     if (annotation_exists) select_annotation = "TRANSITION.ANNOTATION AS Annotation, ";
 
     String select_adducts = "'' AS Adducts, ";
-    bool adducts_exists = SqliteConnector::columnExists(db, "COMPOUND", "ADDUCTS");
+    bool adducts_exists = conn.columnExists("COMPOUND", "ADDUCTS");
     if (adducts_exists) select_adducts = "COMPOUND.ADDUCTS AS Adducts, ";
 
+    // Peptidoforms are aggregated per transition, which is only needed for the full TraML representation
+    String select_peptidoforms = "NULL AS peptidoforms ";
+    String join_peptidoforms = "";
+    if (!minimal)
+    {
+      select_peptidoforms = "PEPTIDE_AGGREGATED.PEPTIDOFORMS AS peptidoforms ";
+      join_peptidoforms = "LEFT OUTER JOIN " \
+                            "(SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
+                            "FROM TRANSITION_PEPTIDE_MAPPING "\
+                            "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
+                            "GROUP BY TRANSITION_ID) "\
+                            "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+    }
+
+    // Restrict precursor m/z to the requested ranges (parameters are shared by both parts of the UNION)
+    String where_precursor_mz = "";
+    for (Size i = 0; i < nr_windows; ++i)
+    {
+      where_precursor_mz += (i == 0 ? "WHERE " : "OR ");
+      where_precursor_mz += "(PRECURSOR.PRECURSOR_MZ >= ?" + String(2 * i + 1) +
+                            " AND PRECURSOR.PRECURSOR_MZ <= ?" + String(2 * i + 2) + ") ";
+    }
+
     // Get peptides
-    select_sql = "SELECT " \
+    String select_sql = "SELECT " \
                   "PRECURSOR.PRECURSOR_MZ AS precursor, " \
                   "TRANSITION.PRODUCT_MZ AS product, " \
                   "PRECURSOR.LIBRARY_RT AS rt_calibrated, " \
@@ -143,7 +154,7 @@ namespace OpenMS
                   "TRANSITION.DETECTING AS detecting_transition, " \
                   "TRANSITION.IDENTIFYING AS identifying_transition, " \
                   "TRANSITION.QUANTIFYING AS quantifying_transition, " \
-                  "PEPTIDE_AGGREGATED.PEPTIDOFORMS AS peptidoforms " + \
+                  + select_peptidoforms + \
                   select_drift_time + \
                   select_gene + \
                   "FROM PRECURSOR " + \
@@ -157,13 +168,9 @@ namespace OpenMS
                     "FROM PROTEIN " \
                     "INNER JOIN PEPTIDE_PROTEIN_MAPPING ON PROTEIN.ID = PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID "\
                     "GROUP BY PEPTIDE_ID) " \
-                    "AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " \
-                  "LEFT OUTER JOIN " \
-                    "(SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
-                    "FROM TRANSITION_PEPTIDE_MAPPING "\
-                    "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
-                    "GROUP BY TRANSITION_ID) "\
-                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+                    "AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " + \
+                  join_peptidoforms + \
+                  where_precursor_mz;
 
     // Get compounds
     select_sql += "UNION SELECT " \
@@ -202,8 +209,30 @@ namespace OpenMS
                   "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN TRANSITION ON TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID = TRANSITION.ID " \
                   "INNER JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
-                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID; ";
+                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID " + \
+                  where_precursor_mz + "; ";
+
+    return select_sql;
+  }
+
+  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  {
+    sqlite3 *db;
+    sqlite3_stmt * cntstmt;
+    sqlite3_stmt * stmt;
 
+    // Open database
+    SqliteConnector conn(filename);
+    db = conn.getDB();
+
+    // Count transitions
+    SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    sqlite3_step( cntstmt );
+    int num_transitions = sqlite3_column_int(cntstmt, 0);
+    sqlite3_finalize(cntstmt);
+
+    bool drift_time_exists, gene_exists;
+    String select_sql = getTransitionSelectSQL_(conn, legacy_traml_id, false, 0, drift_time_exists, gene_exists);
 
     // Execute SQL select statement
     SqliteConnector::prepareStatement(db, &stmt, select_sql);
@@ -696,11 +725,135 @@ namespace OpenMS
 
   void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename,
                                                          OpenSwath::LightTargetedExperiment& targeted_exp,
-                                                         bool legacy_traml_id)
+                                                         bool legacy_traml_id,
+                                                         const std::vector<std::pair<double, double> >& swath_windows)
   {
-    std::vector<TSVTransition> transition_list;
-    readPQPInput_(filename, transition_list, legacy_traml_id);
-    TSVToTargetedExperiment_(transition_list, targeted_exp);
+    sqlite3 *db;
+    sqlite3_stmt * cntstmt;
+    sqlite3_stmt * stmt;
+
+    // Merge overlapping windows to keep the number of bound parameters small
+    std::vector<std::pair<double, double> > mz_ranges(swath_windows);
+    std::sort(mz_ranges.begin(), mz_ranges.end());
+    Size nr_ranges = 0;
+    for (Size i = 0; i < mz_ranges.size(); ++i)
+    {
+      if (nr_ranges > 0 && mz_ranges[i].first <= mz_ranges[nr_ranges - 1].second)
+      {
+        mz_ranges[nr_ranges - 1].second = std::max(mz_ranges[nr_ranges - 1].second, mz_ranges[i].second);
+      }
+      else
+      {
+        mz_ranges[nr_ranges++] = mz_ranges[i];
+      }
+    }
+    mz_ranges.resize(nr_ranges);
+
+    // Open database
+    SqliteConnector conn(filename);
+    db = conn.getDB();
+
+    // Count transitions
+    SqliteConnector::prepareStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    sqlite3_step( cntstmt );
+    int num_transitions = sqlite3_column_int(cntstmt, 0);
+    sqlite3_finalize(cntstmt);
+
+    bool drift_time_exists, gene_exists;
+    String select_sql = getTransitionSelectSQL_(conn, legacy_traml_id, true, mz_ranges.size(), drift_time_exists, gene_exists);
+
+    SqliteConnector::prepareStatement(db, &stmt, select_sql);
+    for (Size i = 0; i < mz_ranges.size(); ++i)
+    {
+      if (sqlite3_bind_double(stmt, (int)(2 * i + 1), mz_ranges[i].first) != SQLITE_OK ||
+          sqlite3_bind_double(stmt, (int)(2 * i + 2), mz_ranges[i].second) != SQLITE_OK)
+      {
+        String error(sqlite3_errmsg(db));
+        sqlite3_finalize(stmt);
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error);
+      }
+    }
+    sqlite3_step(stmt);
+
+    targeted_exp.transitions.reserve(targeted_exp.transitions.size() + (mz_ranges.empty() ? num_transitions : 0));
+
+    // Compounds and proteins are created once at their first occurrence, all
+    // other rows only contribute a LightTransition. A single scratch
+    // TSVTransition holds the compound-level columns of the current row.
+    std::unordered_set<std::string> compound_ids;
+    std::unordered_set<std::string> protein_ids;
+    std::map<String, String> label_sequence_map;
+    std::vector<TSVTransition> scratch(1);
+    TSVTransition& row = scratch[0];
+
+    Size progress = 0;
+    startProgress(0, num_transitions, "reading PQP file");
+    while (sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+    {
+      setProgress(progress++);
+
+      OpenSwath::LightTransition transition;
+      transition.precursor_mz = sqlite3_column_double(stmt, 0);
+      transition.product_mz = -1;
+      Sql::extractValue<double>(&transition.product_mz, stmt, 1);
+      Sql::extractValue<std::string>(&transition.transition_name, stmt, 3);
+      transition.library_intensity = -1;
+      Sql::extractValue<double>(&transition.library_intensity, stmt, 5);
+      Sql::extractValue<std::string>(&transition.peptide_ref, stmt, 6);
+      // flags are INT columns, NULL falls back to the TSVTransition defaults
+      transition.decoy = sqlite3_column_type(stmt, 7) != SQLITE_NULL && sqlite3_column_int(stmt, 7) != 0;
+      if (sqlite3_column_type(stmt, 19) != SQLITE_NULL) transition.fragment_charge = sqlite3_column_int(stmt, 19);
+      transition.detecting_transition = sqlite3_column_type(stmt, 25) == SQLITE_NULL || sqlite3_column_int(stmt, 25) != 0;
+      transition.identifying_transition = sqlite3_column_type(stmt, 26) != SQLITE_NULL && sqlite3_column_int(stmt, 26) != 0;
+      transition.quantifying_transition = sqlite3_column_type(stmt, 27) == SQLITE_NULL || sqlite3_column_int(stmt, 27) != 0;
+
+      if (compound_ids.insert(transition.peptide_ref).second)
+      {
+        row = TSVTransition();
+        row.group_id = transition.peptide_ref;
+        Sql::extractValue<double>(&row.rt_calibrated, stmt, 2);
+        Sql::extractValue<std::string>(&row.PeptideSequence, stmt, 8);
+        String tmp_field;
+        if (Sql::extractValue<std::string>(&tmp_field, stmt, 9)) tmp_field.split(';', row.ProteinName);
+        Sql::extractValue<std::string>(&row.FullPeptideName, stmt, 11);
+        Sql::extractValue<std::string>(&row.CompoundName, stmt, 12);
+        Sql::extractValue<std::string>(&row.SMILES, stmt, 13);
+        Sql::extractValue<std::string>(&row.SumFormula, stmt, 14);
+        Sql::extractValue<std::string>(&row.Adducts, stmt, 15);
+        Sql::extractValueIntStr(&row.precursor_charge, stmt, 16);
+        Sql::extractValue<std::string>(&row.peptide_group_label, stmt, 17);
+        Sql::extractValue<std::string>(&row.label_type, stmt, 18);
+        // optional attributes only present in newer file versions
+        if (drift_time_exists) Sql::extractValue<double>(&row.drift_time, stmt, 29);
+        if (gene_exists) Sql::extractValue<std::string>(&row.GeneName, stmt, 30);
+        if (row.GeneName == "NA") row.GeneName = "";
+
+        resolveMixedSequenceGroup_(row, label_sequence_map);
+
+        OpenSwath::LightCompound compound;
+        createLightCompound_(scratch.cbegin(), compound);
+        targeted_exp.compounds.push_back(compound);
+
+        if (row.isPeptide())
+        {
+          for (Size i = 0; i < row.ProteinName.size(); ++i)
+          {
+            if (protein_ids.insert(row.ProteinName[i]).second)
+            {
+              OpenSwath::LightProtein protein;
+              protein.id = row.ProteinName[i];
+              targeted_exp.proteins.push_back(protein);
+            }
+          }
+        }
+      }
+
+      targeted_exp.transitions.push_back(transition);
+      sqlite3_step( stmt );
+    }
+    endProgress();
+
+    sqlite3_finalize(stmt);
   }
 
 }
@@ -704,18 +704,7 @@ namespace OpenMS
       if (compound_map.find(tr_it->group_id) == compound_map.end())
       {
         OpenSwath::LightCompound compound;
-        if (tr_it->isPeptide())
-        {
-          OpenMS::TargetedExperiment::Peptide tramlpeptide;
-          createPeptide_(tr_it, tramlpeptide);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
-        }
-        else
-        {
-          OpenMS::TargetedExperiment::Compound tramlcompound;
-          createCompound_(tr_it, tramlcompound);
-          OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
-        }
+        createLightCompound_(tr_it, compound);
         exp.compounds.push_back(compound);
         compound_map[compound.id] = 0;
       }
@@ -740,6 +729,52 @@ namespace OpenMS
     OPENMS_POSTCONDITION(exp.transitions.size() == transition_list.size(), "Input and output list need to have equal size.")
   }
 
+  void TransitionTSVFile::createLightCompound_(std::vector<TSVTransition>::const_iterator tr_it, OpenSwath::LightCompound& compound)
+  {
+    if (tr_it->isPeptide())
+    {
+      OpenMS::TargetedExperiment::Peptide tramlpeptide;
+      createPeptide_(tr_it, tramlpeptide);
+      OpenSwathDataAccessHelper::convertTargetedCompound(tramlpeptide, compound);
+    }
+    else
+    {
+      OpenMS::TargetedExperiment::Compound tramlcompound;
+      createCompound_(tr_it, tramlcompound);
+      OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
+    }
+  }
+
+  void TransitionTSVFile::resolveMixedSequenceGroup_(TSVTransition& transition, std::map<String, String>& label_sequence_map) const
+  {
+    if (transition.peptide_group_label.empty()) return;
+
+    // the first transition of each label group defines the reference sequence
+    std::map<String, String>::const_iterator it = label_sequence_map.find(transition.peptide_group_label);
+    if (it == label_sequence_map.end())
+    {
+      label_sequence_map[transition.peptide_group_label] = transition.PeptideSequence;
+      return;
+    }
+
+    const String& curr_sequence = it->second;
+    if (!curr_sequence.empty() && transition.PeptideSequence != curr_sequence)
+    {
+      if (override_group_label_check_)
+      {
+        OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << transition.peptide_group_label <<
+          ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
+      }
+      else
+      {
+        OPENMS_LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << transition.peptide_group_label <<
+          ". This is most likely an error and to fix this, a new peptide label group will be inferred - " <<
+          "to override this decision, please use the override_group_label_check parameter." << std::endl;
+        transition.peptide_group_label = transition.group_id;
+      }
+    }
+  }
+
   void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<TransitionTSVFile::TSVTransition>& transition_list) const
   {
     // Create temporary map by group label
@@ -42,6 +42,11 @@
 #include <OpenMS/KERNEL/ConsensusFeature.h>
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+
+#include <cmath>
+#include <limits>
 
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
@@ -54,6 +59,9 @@ namespace OpenMS
   // Also used for TMT_11PLEX
   double TMT_10AND11PLEX_CHANNEL_TOLERANCE = 0.003;
 
+  // Window around each reporter ion searched for the calibration statistics (and hence the only region of MSn spectra that is needed)
+  const double REPORTER_QC_DIST_MZ = 0.5;
+
   /// small quality control class, holding temporary data for reporting
   struct ChannelQC
   {
@@ -68,6 +76,115 @@ namespace OpenMS
   };
 
 
+  namespace
+  {
+    /// m/z window [first, second]
+    typedef std::pair<double, double> MZWindow;
+
+    /**
+      @brief Collects the spectra of a file while it is read, keeping only the peaks needed for the channel extraction
+
+      MSn spectra are reduced to the reporter ion region. MS1 spectra are reduced to the (fuzzy) isolation windows of
+      the MSn spectra for which they can be the precursor or follow-up scan, i.e. all MSn spectra between the previous
+      and the next MS1 spectrum. Thus, each MS1 spectrum is reduced only once the next MS1 spectrum was read. Two
+      neighbouring peaks are kept on either side of each window, since the purity computation may look at them.
+    */
+    class ReducedExperimentCollector
+    {
+    public:
+      ReducedExperimentCollector(PeakMap& exp, const MZWindow& reporter_window, double isotope_deviation_ppm) :
+        exp_(exp),
+        reporter_window_(1, reporter_window),
+        isotope_deviation_ppm_(isotope_deviation_ppm),
+        has_ms1_(false),
+        last_ms1_(0)
+      {
+      }
+
+      void addSpectrum(PeakMap::SpectrumType& spec)
+      {
+        if (spec.getMSLevel() == 1)
+        {
+          // all MSn spectra around the previous MS1 spectrum are known now
+          reduceLastMS1_();
+          windows_before_.swap(windows_after_);
+          windows_after_.clear();
+          has_ms1_ = true;
+          last_ms1_ = exp_.size();
+        }
+        else
+        {
+          if (!spec.getPrecursors().empty())
+          {
+            // same fuzzy isolation window as in the purity computation
+            const Precursor& precursor = spec.getPrecursors()[0];
+            const double strict_lower_mz = precursor.getMZ() - precursor.getIsolationWindowLowerOffset();
+            const double strict_upper_mz = precursor.getMZ() + precursor.getIsolationWindowUpperOffset();
+            windows_after_.push_back(MZWindow(strict_lower_mz - (strict_lower_mz * isotope_deviation_ppm_ / 1000000),
+                                              strict_upper_mz + (strict_upper_mz * isotope_deviation_ppm_ / 1000000)));
+          }
+          // only spectra with peaks are quantified, so keep at least one (outside of the reporter region, it is never used)
+          if (!spec.empty())
+          {
+            Peak1D first = spec[0];
+            keepWindows_(spec, reporter_window_, 0);
+            if (spec.empty()) spec.push_back(first);
+          }
+        }
+        exp_.addSpectrum(spec);
+      }
+
+      /// reduces the last MS1 spectrum (call after all spectra were added)
+      void finish()
+      {
+        reduceLastMS1_();
+        windows_before_.clear();
+        windows_after_.clear();
+        has_ms1_ = false;
+      }
+
+    private:
+      void reduceLastMS1_()
+      {
+        if (!has_ms1_) return;
+        std::vector<MZWindow> windows(windows_before_);
+        windows.insert(windows.end(), windows_after_.begin(), windows_after_.end());
+        keepWindows_(exp_[last_ms1_], windows, 2);
+      }
+
+      /// keeps the peaks within any of the @p windows and @p neighbours peaks to either side of each window
+      static void keepWindows_(PeakMap::SpectrumType& spec, const std::vector<MZWindow>& windows, Size neighbours)
+      {
+        if (!spec.isSorted()) spec.sortByPosition();
+        std::vector<bool> keep(spec.size(), false);
+        for (std::vector<MZWindow>::const_iterator w = windows.begin(); w != windows.end(); ++w)
+        {
+          Size first = spec.MZBegin(w->first) - spec.begin();
+          Size last = spec.MZEnd(w->second) - spec.begin(); // past the end
+          first = first > neighbours ? first - neighbours : 0;
+          last = std::min(last + neighbours, spec.size());
+          std::fill(keep.begin() + first, keep.begin() + last, true);
+        }
+        std::vector<Size> indices;
+        for (Size i = 0; i < keep.size(); ++i)
+        {
+          if (keep[i]) indices.push_back(i);
+        }
+        if (indices.size() != spec.size()) spec.select(indices);
+      }
+
+      PeakMap& exp_;
+      std::vector<MZWindow> reporter_window_;
+      double isotope_deviation_ppm_;
+      /// isolation windows of MSn spectra before the last MS1 spectrum
+      std::vector<MZWindow> windows_before_;
+      /// isolation windows of MSn spectra after the last MS1 spectrum
+      std::vector<MZWindow> windows_after_;
+      bool has_ms1_;
+      Size last_ms1_;
+    };
+  }
+
   IsobaricChannelExtractor::PuritySate_::PuritySate_(const PeakMap& targetExp) :
     baseExperiment(targetExp)
   {
@@ -508,19 +625,35 @@ namespace OpenMS
 
     // now we have picked data
     // --> assign peaks to channels
-    UInt64 element_index(0);
 
     // remember the current precursor spectrum
     PuritySate_ pState(ms_exp_data);
 
     typedef std::map<String, ChannelQC > ChannelQCSet;
     ChannelQCSet channel_mz_delta;
-    const double qc_dist_mz = 0.5; // fixed! Do not change!
+    const double qc_dist_mz = REPORTER_QC_DIST_MZ; // fixed! Do not change!
 
     Size number_of_channels = quant_method_->getNumberOfChannels();
 
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
-
+    // spectrum to quantify, together with the state of the precursor purity search at its position
+    struct QuantTask
+    {
+      PeakMap::ConstIterator spec;
+      PuritySate_ purity_state;
+      // set by the parallel computation
+      double precursor_purity;
+      bool failed;
+      std::vector<Peak2D::IntensityType> intensities;
+      std::vector<double> mz_deltas;
+      std::vector<bool> not_unique;
+
+      QuantTask(const PeakMap::ConstIterator& s, const PuritySate_& state) :
+        spec(s), purity_state(state), precursor_purity(-1.0), failed(false)
+      {}
+    };
+    std::vector<QuantTask> tasks;
+
+    // first pass (sequential, cheap): select spectra and track the surrounding MS1 scans
     for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
     {
       // remember the last MS1 spectra as we assume it to be the precursor spectrum
@@ -528,8 +661,6 @@ namespace OpenMS
       {
         // remember potential precursor and continue
         pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
         continue;
       }
 
@@ -551,11 +682,54 @@ namespace OpenMS
         continue;
       }
 
+      tasks.push_back(QuantTask(it, pState));
+    }
+
+    // second pass (parallel): precursor purity and reporter ions of each spectrum
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)tasks.size(); ++i)
+    {
+      QuantTask& task = tasks[i];
+      try
+      {
+        if (task.purity_state.precursorScan != ms_exp_data.end())
+        {
+          task.precursor_purity = computePrecursorPurity_(task.spec, task.purity_state);
+          // no need to search reporters, the spectrum will be skipped
+          if (task.precursor_purity < min_precursor_purity_) continue;
+        }
+        extractReporterIons_(*task.spec, task.intensities, task.mz_deltas, task.not_unique);
+      }
+      catch (...)
+      {
+        // exceptions must not leave the parallel region; re-done sequentially below to raise them in order
+        task.failed = true;
+      }
+    }
+
+    // third pass (sequential): assemble the features in the order of the spectra
+    UInt64 element_index(0);
+
+    for (std::vector<QuantTask>::iterator task = tasks.begin(); task != tasks.end(); ++task)
+    {
+      PeakMap::ConstIterator it = task->spec;
+
+      if (task->failed)
+      {
+        // throws the same exception as in the parallel computation
+        if (task->purity_state.precursorScan != ms_exp_data.end())
+        {
+          task->precursor_purity = computePrecursorPurity_(it, task->purity_state);
+        }
+        extractReporterIons_(*it, task->intensities, task->mz_deltas, task->not_unique);
+      }
+
       // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
+      const double precursor_purity = task->precursor_purity;
+      if (task->purity_state.precursorScan != ms_exp_data.end())
       {
-        precursor_purity = computePrecursorPurity_(it, pState);
         // check if purity is high enough
         if (precursor_purity < min_precursor_purity_)
         {
@@ -568,6 +742,7 @@ namespace OpenMS
         OPENMS_LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
       }
 
+      PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
       if (it->getMSLevel() == 3)
       {
         // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
@@ -607,46 +782,13 @@ namespace OpenMS
       {
         // set mz-position of channel
         channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
-        {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
-          {
-            idx_nearest = mz_it;
-          }
-        }
-        if (idx_nearest != mz_end)
-        {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
-          {
-            channel_value.setIntensity(idx_nearest->getIntensity());
-          }
-        }
+        channel_value.setIntensity(task->intensities[map_index]);
 
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
+        if (!std::isnan(task->mz_deltas[map_index]))
         {
-          channel_value.setIntensity(0);
+          // stats: we don't care what shift the user specified
+          channel_mz_delta[cl_it->name].mz_deltas.push_back(task->mz_deltas[map_index]);
+          if (task->not_unique[map_index]) ++channel_mz_delta[cl_it->name].signal_not_unique;
         }
 
         overall_intensity += channel_value.getIntensity();
@@ -728,6 +870,84 @@ namespace OpenMS
     registerChannelsInOutputMap_(consensus_map);
   }
 
+  void IsobaricChannelExtractor::extractChannels(const String& mzml_file, ConsensusMap& consensus_map)
+  {
+    // reporter ion region (including the window used for the calibration statistics)
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    MZWindow reporter_window(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = channels.begin(); cl_it != channels.end(); ++cl_it)
+    {
+      reporter_window.first = std::min(reporter_window.first, cl_it->center - REPORTER_QC_DIST_MZ);
+      reporter_window.second = std::max(reporter_window.second, cl_it->center + REPORTER_QC_DIST_MZ);
+    }
+
+    PeakMap exp;
+    ReducedExperimentCollector collector(exp, reporter_window, max_precursor_isotope_deviation_);
+
+    MSDataTransformingConsumer consumer;
+    consumer.setSpectraProcessingFunc([&collector](PeakMap::SpectrumType& s) { collector.addSpectrum(s); });
+    consumer.setExperimentalSettingsFunc([&exp](const ExperimentalSettings& settings) { static_cast<ExperimentalSettings&>(exp) = settings; });
+
+    MzMLFile mzml;
+    mzml.transform(mzml_file, &consumer, true);
+    collector.finish();
+
+    exp.updateRanges();
+    extractChannels(exp, consensus_map);
+  }
+
+  void IsobaricChannelExtractor::extractReporterIons_(const PeakMap::SpectrumType& spec, std::vector<Peak2D::IntensityType>& intensities, std::vector<double>& mz_deltas, std::vector<bool>& not_unique) const
+  {
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    intensities.assign(channels.size(), 0);
+    mz_deltas.assign(channels.size(), std::numeric_limits<double>::quiet_NaN());
+    not_unique.assign(channels.size(), false);
+
+    Size channel_index = 0;
+    for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = channels.begin();
+          cl_it != channels.end();
+          ++cl_it, ++channel_index)
+    {
+      // as every evaluation requires time, we cache the MZEnd iterator
+      const PeakMap::SpectrumType::ConstIterator mz_end = spec.MZEnd(cl_it->center + REPORTER_QC_DIST_MZ);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
+      PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
+      for (PeakMap::SpectrumType::ConstIterator mz_it = spec.MZBegin(cl_it->center - REPORTER_QC_DIST_MZ);
+            mz_it != mz_end;
+            ++mz_it)
+      {
+        if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
+        double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
+        if (dist_mz < reporter_mass_shift_) ++peak_count;
+        if (idx_nearest == mz_end // first peak
+            || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
+        {
+          idx_nearest = mz_it;
+        }
+      }
+      if (idx_nearest != mz_end)
+      {
+        double mz_delta = cl_it->center - idx_nearest->getMZ();
+        mz_deltas[channel_index] = mz_delta;
+        not_unique[channel_index] = peak_count > 1;
+        // pass user threshold
+        if (std::fabs(mz_delta) < reporter_mass_shift_)
+        {
+          intensities[channel_index] = idx_nearest->getIntensity();
+        }
+      }
+
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (intensities[channel_index] < min_reporter_intensity_)
+      {
+        intensities[channel_index] = 0;
+      }
+    }
+  }
+
   void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map)
   {
     // register the individual channels in the output consensus map
@@ -40,14 +40,15 @@ using namespace std;
 namespace OpenMS
 {
 
+/// Ranges of the 2D tree with at most this many features are not split (but searched linearly)
+const Size KDTREE_LEAF_SIZE = 8;
+
 void KDTreeFeatureMaps::addFeature(Size mt_map_index, const BaseFeature* feature)
 {
   map_index_.push_back(mt_map_index);
   features_.push_back(feature);
   rt_.push_back(feature->getRT());
-
-  KDTreeFeatureNode mt_node(this, size() - 1);
-  kd_tree_.insert(mt_node);
+  mz_.push_back(feature->getMZ());
 }
 
 const BaseFeature* KDTreeFeatureMaps::feature(Size i) const
@@ -62,7 +63,7 @@ double KDTreeFeatureMaps::rt(Size i) const
 
 double KDTreeFeatureMaps::mz(Size i) const
 {
-  return features_[i]->getMZ();
+  return mz_[i];
 }
 
 float KDTreeFeatureMaps::intensity(Size i) const
@@ -87,7 +88,7 @@ Size KDTreeFeatureMaps::size() const
 
 Size KDTreeFeatureMaps::treeSize() const
 {
-  return kd_tree_.size();
+  return features_.size();
 }
 
 Size KDTreeFeatureMaps::numMaps() const
@@ -99,12 +100,69 @@ void KDTreeFeatureMaps::clear()
 {
   features_.clear();
   map_index_.clear();
-  kd_tree_.clear();
+  rt_.clear();
+  mz_.clear();
+  tree_.clear();
 }
 
 void KDTreeFeatureMaps::optimizeTree()
 {
-  kd_tree_.optimize();
+  if (tree_.size() == size())
+  {
+    return; // up to date
+  }
+  tree_.resize(size());
+  for (Size i = 0; i < size(); ++i)
+  {
+    tree_[i] = i;
+  }
+  buildTree_(0, tree_.size(), 0);
+}
+
+void KDTreeFeatureMaps::buildTree_(Size begin, Size end, Size dim)
+{
+  if (end - begin <= KDTREE_LEAF_SIZE)
+  {
+    return;
+  }
+  // put the median (in the current dimension) in the middle, smaller values before, larger values after it
+  Size mid = begin + (end - begin) / 2;
+  nth_element(tree_.begin() + begin, tree_.begin() + mid, tree_.begin() + end,
+              [this, dim](Size a, Size b) { return coordinate_(a, dim) < coordinate_(b, dim); });
+  buildTree_(begin, mid, 1 - dim);
+  buildTree_(mid + 1, end, 1 - dim);
+}
+
+void KDTreeFeatureMaps::queryTree_(Size begin, Size end, Size dim, const double (&low)[2], const double (&high)[2], vector<Size>& result_indices) const
+{
+  if (end - begin <= KDTREE_LEAF_SIZE)
+  {
+    for (Size k = begin; k < end; ++k)
+    {
+      Size i = tree_[k];
+      if (rt_[i] >= low[0] && rt_[i] <= high[0] && mz_[i] >= low[1] && mz_[i] <= high[1])
+      {
+        result_indices.push_back(i);
+      }
+    }
+    return;
+  }
+  Size mid = begin + (end - begin) / 2;
+  Size i = tree_[mid];
+  if (rt_[i] >= low[0] && rt_[i] <= high[0] && mz_[i] >= low[1] && mz_[i] <= high[1])
+  {
+    result_indices.push_back(i);
+  }
+  // descend into the halves that can overlap the region
+  double split = coordinate_(i, dim);
+  if (low[dim] <= split)
+  {
+    queryTree_(begin, mid, 1 - dim, low, high, result_indices);
+  }
+  if (high[dim] >= split)
+  {
+    queryTree_(mid + 1, end, 1 - dim, low, high, result_indices);
+  }
 }
 
 void KDTreeFeatureMaps::getNeighborhood(Size index, vector<Size>& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map, double max_pairwise_log_fc) const
@@ -144,21 +202,27 @@ void KDTreeFeatureMaps::getNeighborhood(Size index, vector<Size>& result_indices
 void KDTreeFeatureMaps::queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, vector<Size>& result_indices, Size ignored_map_index) const
 {
   // set up tolerance window as region for the 2D tree
-  FeatureKDTree::_Region_ region;
-  region._M_low_bounds[0] = rt_low;
-  region._M_high_bounds[0] = rt_high;
-  region._M_low_bounds[1] = mz_low;
-  region._M_high_bounds[1] = mz_high;
+  const double low[2] = {rt_low, mz_low};
+  const double high[2] = {rt_high, mz_high};
 
-  // range-query tolerance window
-  vector<KDTreeFeatureNode> tmp_result;
-  kd_tree_.find_within_range(region, back_insert_iterator<vector<KDTreeFeatureNode> >(tmp_result));
+  // range-query tolerance window (features not in the tree yet are checked one by one)
+  vector<Size> tmp_result;
+  queryTree_(0, tree_.size(), 0, low, high, tmp_result);
+  for (Size i = tree_.size(); i < size(); ++i)
+  {
+    if (rt_[i] >= rt_low && rt_[i] <= rt_high && mz_[i] >= mz_low && mz_[i] <= mz_high)
+    {
+      tmp_result.push_back(i);
+    }
+  }
+  // report results in a defined order (independent of the tree layout)
+  sort(tmp_result.begin(), tmp_result.end());
 
   // add indices to result
   result_indices.clear();
-  for (vector<KDTreeFeatureNode>::const_iterator it = tmp_result.begin(); it != tmp_result.end(); ++it)
+  for (vector<Size>::const_iterator it = tmp_result.begin(); it != tmp_result.end(); ++it)
   {
-    Size found_index = it->getIndex();
+    Size found_index = *it;
     if (ignored_map_index == numeric_limits<Size>::max() || map_index_[found_index] != ignored_map_index)
     {
       result_indices.push_back(found_index);
@@ -172,6 +236,9 @@ void KDTreeFeatureMaps::applyTransformations(const vector<TransformationModelLow
   {
     rt_[i] = trafos[map_index_[i]]->evaluate(features_[i]->getRT());
   }
+  // RTs changed, so the tree has to be rebuilt
+  tree_.clear();
+  optimizeTree();
 }
 
 void KDTreeFeatureMaps::updateMembers_()
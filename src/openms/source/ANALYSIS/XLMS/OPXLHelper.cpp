@@ -101,7 +101,6 @@ namespace OpenMS
       int first_index = first_loop - peptides.cbegin();
       int last_index = last_loop - peptides.cbegin();
 
-#pragma omp parallel for
       for (int p1 = first_index; p1 < last_index; ++p1)
       {
         const String& seq_first = peptides[p1].unmodified_seq;
@@ -140,13 +139,10 @@ namespace OpenMS
          precursor.alpha_seq = seq_first;
          precursor.beta_seq = "";
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+         mass_to_candidates.push_back(precursor);
+         precursor_correction_positions.push_back(pm);
         }
-      } // end of parallel loop over loop-link candidates
+      } // end of loop over loop-link candidates
 
       // ################################ Enumerate Mono-Links #################
       for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
@@ -164,7 +160,6 @@ namespace OpenMS
         first_index = first_mono - peptides.cbegin();
         last_index = last_mono - peptides.cbegin();
 
-#pragma omp parallel for
         for (int p1 = first_index; p1 < last_index; ++p1)
         {
           // Monoisotopic weight of the peptide + cross-linker
@@ -178,11 +173,8 @@ namespace OpenMS
           precursor.alpha_seq = peptides[p1].unmodified_seq;
           precursor.beta_seq = "";
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          mass_to_candidates.push_back(precursor);
+          precursor_correction_positions.push_back(pm);
         } // end of loop over candidates for a specific mono-link mass
       } // end of loop over mono-link masses
 
@@ -192,28 +184,36 @@ namespace OpenMS
       // maximal mass: difference between precursor mass and the smallest peptide + cross-linker
       max_peptide_mass = precursor_mass - cross_link_mass - peptides[0].peptide_mass + allowed_error;
       last_alpha = upper_bound(last_alpha, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      int last_alpha_index = last_alpha - peptides.cbegin();
+      Size last_alpha_index = last_alpha - peptides.cbegin();
 
-#pragma omp parallel for
-      for (int p1 = 0; p1 < last_alpha_index; ++p1)
+      // Two-pointer sweep over the alpha peptides: with increasing alpha mass the window of fitting beta masses
+      // moves towards lighter peptides, so both window bounds only ever move down (no binary search per alpha).
+      // The beta peptide is never lighter than the alpha peptide, so the sweep ends when the window drops below alpha.
+      Size first_beta_index = last_alpha_index;
+      Size last_beta_index = last_alpha_index;
+      for (Size p1 = 0; p1 < last_alpha_index; ++p1)
       {
         // Constrain search for beta
         double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
         double max_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
 
-        // the last_alpha upper bound is also a conservative upper bound here
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_beta = lower_bound(peptides.cbegin()+p1, last_alpha, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_beta = upper_bound(peptides.cbegin()+p1, last_alpha, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-
-        if (first_beta == last_beta)
+        // upper_bound of max_peptide_mass_beta
+        while (last_beta_index > 0 && peptides[last_beta_index - 1].peptide_mass > max_peptide_mass_beta)
         {
-          continue;
+          --last_beta_index;
+        }
+        // lower_bound of min_peptide_mass_beta
+        while (first_beta_index > 0 && peptides[first_beta_index - 1].peptide_mass >= min_peptide_mass_beta)
+        {
+          --first_beta_index;
         }
 
-        Size first_beta_index = first_beta - peptides.begin();
-        Size last_beta_index = last_beta - peptides.begin();
+        if (last_beta_index <= p1)
+        {
+          break;
+        }
 
-        for (Size p2 = first_beta_index; p2 < last_beta_index; ++p2)
+        for (Size p2 = std::max(first_beta_index, p1); p2 < last_beta_index; ++p2)
         {
           // Monoisotopic weight of the first peptide + the second peptide + cross-linker
           double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
@@ -226,13 +226,10 @@ namespace OpenMS
           precursor.alpha_seq = peptides[p1].unmodified_seq;
           precursor.beta_seq = peptides[p2].unmodified_seq;
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          mass_to_candidates.push_back(precursor);
+          precursor_correction_positions.push_back(pm);
         } // end of loop over betas
-      } // end of parallel loop over alphas
+      } // end of sweep over alphas
     } // end of loop over precursor masses
     return mass_to_candidates;
   }
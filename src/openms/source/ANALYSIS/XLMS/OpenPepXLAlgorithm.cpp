@@ -432,8 +432,38 @@ using namespace OpenMS;
     progresslogger.startProgress(0, 1, "Matching to theoretical spectra and scoring...");
     Size spectrum_counter = 0;
 
+    // Candidates are enumerated for a batch of spectrum pairs in parallel, then the pairs are scored one after the other
+    // (in parallel over the candidates). The batch size bounds the number of candidate lists held in memory.
+    SignedSize candidate_batch_size = 1;
+#ifdef _OPENMP
+    candidate_batch_size = 2 * omp_get_max_threads();
+#endif
+    vector< vector< OPXLDataStructs::ProteinProteinCrossLink > > batch_candidates;
+
     for (SignedSize pair_index = 0; pair_index < static_cast<SignedSize>(spectrum_pairs.size()); ++pair_index)
     {
+      if (pair_index % candidate_batch_size == 0)
+      {
+        const SignedSize batch_start = pair_index;
+        const SignedSize batch_end = std::min(batch_start + candidate_batch_size, static_cast<SignedSize>(spectrum_pairs.size()));
+        batch_candidates.clear();
+        batch_candidates.resize(batch_end - batch_start);
+
+#pragma omp parallel for schedule(dynamic)
+        for (SignedSize batch_index = batch_start; batch_index < batch_end; ++batch_index)
+        {
+          // pairs with less paired peaks than the minimal peptide size are skipped below
+          if (preprocessed_pair_spectra.spectra_all_peaks[batch_index].size() < peptide_min_size_)
+          {
+            continue;
+          }
+          const Precursor& batch_precursor = spectra[spectrum_pairs[batch_index].first].getPrecursors()[0];
+          const double batch_charge = batch_precursor.getCharge();
+          const double batch_precursor_mass = batch_precursor.getMZ() * batch_charge - batch_charge * Constants::PROTON_MASS_U;
+          batch_candidates[batch_index - batch_start] = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, batch_precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_);
+        }
+      }
+
       Size scan_index = spectrum_pairs[pair_index].first;
       Size scan_index_heavy = spectrum_pairs[pair_index].second;
 
@@ -457,7 +487,8 @@ using namespace OpenMS;
         continue;
       }
 
-      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_);
+      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates;
+      cross_link_candidates.swap(batch_candidates[pair_index % candidate_batch_size]);
 
       spectrum_counter++;
       cout << "Processing spectrum pair " << spectrum_counter << " / " << spectrum_pairs.size() << endl;
@@ -398,23 +398,52 @@ using namespace OpenMS;
 
     Size spectrum_counter(0);
 
+    // Candidates are enumerated for a batch of spectra in parallel, then the spectra are scored one after the other
+    // (in parallel over the candidates). The batch size bounds the number of candidate lists held in memory.
+    SignedSize candidate_batch_size = 1;
+#ifdef _OPENMP
+    candidate_batch_size = 2 * omp_get_max_threads();
+#endif
+    vector< vector< OPXLDataStructs::ProteinProteinCrossLink > > batch_candidates;
+
     for (SignedSize scan_index = 0; scan_index < static_cast<SignedSize>(spectra.size()); ++scan_index)
     {
+      if (scan_index % candidate_batch_size == 0)
+      {
+        const SignedSize batch_start = scan_index;
+        const SignedSize batch_end = std::min(batch_start + candidate_batch_size, static_cast<SignedSize>(spectra.size()));
+        batch_candidates.clear();
+        batch_candidates.resize(batch_end - batch_start);
+
+#pragma omp parallel for schedule(dynamic)
+        for (SignedSize batch_index = batch_start; batch_index < batch_end; ++batch_index)
+        {
+          const PeakSpectrum& batch_spectrum = spectra[batch_index];
+          const double batch_charge = batch_spectrum.getPrecursors()[0].getCharge();
+          const double batch_precursor_mass = (batch_spectrum.getPrecursors()[0].getMZ() * batch_charge) - (batch_charge * Constants::PROTON_MASS_U);
+
+          std::vector<std::string> tags;
+          if (use_sequence_tags_)
+          {
+            // the charge range of the tagger depends on the spectrum, so every spectrum needs its own copy
+            Tagger batch_tagger(tagger);
+            batch_tagger.setMaxCharge(batch_charge-1);
+            batch_tagger.getTag(batch_spectrum, tags);
+          }
+
+          batch_candidates[batch_index - batch_start] = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, batch_precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, use_sequence_tags_, tags);
+        }
+      }
+
       const PeakSpectrum& spectrum = spectra[scan_index];
 
       const double precursor_charge = spectrum.getPrecursors()[0].getCharge();
       const double precursor_mz = spectrum.getPrecursors()[0].getMZ();
       const double precursor_mass = (precursor_mz * static_cast<double>(precursor_charge)) - (static_cast<double>(precursor_charge) * Constants::PROTON_MASS_U);
 
-      std::vector<std::string> tags;
-      if (use_sequence_tags_)
-      {
-        tagger.setMaxCharge(precursor_charge-1);
-        tagger.getTag(spectrum, tags);
-      }
-
       vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
-      vector< OPXLDataStructs::ProteinProteinCrossLink > cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, use_sequence_tags_, tags);
+      vector< OPXLDataStructs::ProteinProteinCrossLink > cross_link_candidates;
+      cross_link_candidates.swap(batch_candidates[scan_index % candidate_batch_size]);
       all_candidates_count += cross_link_candidates.size();
 
 #ifdef DEBUG_OPENPEPXLLFALGO
@@ -39,18 +39,47 @@
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <include/OpenMS/CONCEPT/Constants.h>
 
+#include <Evergreen/evergreen.hpp>
+
 #include <cmath>
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
 #include <limits>
 #include <functional>
+#include <map>
 #include <numeric>
+#include <tuple>
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// minimal number of isotopes of both convolution operands for which the FFT is used instead of the direct sum
+    const Size FFT_MIN_ISOTOPES = 64;
+
+    /// maximal number of memoized element distributions; the table is cleared once it grows beyond that
+    const Size ELEMENT_POWER_CACHE_MAX_SIZE = 1 << 16;
+
+    /// memoized power of an element distribution (the element distribution is kept to detect stale Element pointers)
+    struct ElementPower
+    {
+      IsotopeDistribution::ContainerType element_distribution;
+      IsotopeDistribution::ContainerType power;
+    };
+
+    /// key: element, number of atoms, max isotope
+    typedef std::map<std::tuple<const Element*, Size, Size>, ElementPower> ElementPowerCache;
+
+    ElementPowerCache& elementPowerCache()
+    {
+      static ElementPowerCache cache;
+      return cache;
+    }
+  }
+
   CoarseIsotopePatternGenerator::CoarseIsotopePatternGenerator() : 
     IsotopePatternGenerator(),
     max_isotope_(0),
@@ -103,9 +132,8 @@ namespace OpenMS
     auto it = formula.begin();
     for (; it != formula.end(); ++it)
     {
-      IsotopeDistribution tmp = it->first->getIsotopeDistribution();
       result.set(convolve_(result.getContainer(),
-                           convolvePow_(tmp.getContainer(), it->second)));
+                           elementPow_(it->first, it->second)));
     }
 
     // replace atomic numbers with masses.
@@ -116,6 +144,59 @@ namespace OpenMS
     return result;
   }
 
+  void CoarseIsotopePatternGenerator::clearElementPowerCache()
+  {
+#pragma omp critical (CoarseIsotopePatternGenerator_elementPowerCache)
+    elementPowerCache().clear();
+  }
+
+  Size CoarseIsotopePatternGenerator::getElementPowerCacheSize()
+  {
+    Size size(0);
+#pragma omp critical (CoarseIsotopePatternGenerator_elementPowerCache)
+    size = elementPowerCache().size();
+    return size;
+  }
+
+  IsotopeDistribution::ContainerType CoarseIsotopePatternGenerator::elementPow_(const Element* element, Size count) const
+  {
+    const IsotopeDistribution::ContainerType& element_distribution = element->getIsotopeDistribution().getContainer();
+    const std::tuple<const Element*, Size, Size> key(element, count, max_isotope_);
+
+    bool found(false);
+    IsotopeDistribution::ContainerType result;
+#pragma omp critical (CoarseIsotopePatternGenerator_elementPowerCache)
+    {
+      ElementPowerCache::const_iterator it = elementPowerCache().find(key);
+      // the distribution is compared as well, since an Element could have been replaced at the same address
+      if (it != elementPowerCache().end() && it->second.element_distribution == element_distribution)
+      {
+        result = it->second.power;
+        found = true;
+      }
+    }
+    if (found)
+    {
+      return result;
+    }
+
+    // compute outside of the critical section; concurrent misses for the same key yield identical results
+    result = convolvePow_(element_distribution, count);
+
+#pragma omp critical (CoarseIsotopePatternGenerator_elementPowerCache)
+    {
+      ElementPowerCache& cache = elementPowerCache();
+      if (cache.size() >= ELEMENT_POWER_CACHE_MAX_SIZE)
+      {
+        cache.clear();
+      }
+      ElementPower& entry = cache[key];
+      entry.element_distribution = element_distribution;
+      entry.power = result;
+    }
+    return result;
+  }
+
   IsotopeDistribution CoarseIsotopePatternGenerator::estimateFromPeptideWeight(double average_weight)
   {
     // Element counts are from Senko's Averagine model
@@ -242,6 +323,12 @@ namespace OpenMS
       r_max = (IsotopeDistribution::ContainerType::size_type)max_isotope_;
     }
 
+    // the direct sum needs about min(left, r_max) * min(right, r_max) multiplications
+    if (min<Size>(left_l.size(), r_max) >= FFT_MIN_ISOTOPES && min<Size>(right_l.size(), r_max) >= FFT_MIN_ISOTOPES)
+    {
+      return convolveFFT_(left_l, right_l, r_max);
+    }
+
     // pre-fill result with masses
     result.resize(r_max);
     for (IsotopeDistribution::ContainerType::size_type i = 0; i != r_max; ++i)
@@ -266,7 +353,6 @@ namespace OpenMS
   IsotopeDistribution::ContainerType CoarseIsotopePatternGenerator::convolvePow_(const IsotopeDistribution::ContainerType & input, Size n) const
   {
     IsotopeDistribution::ContainerType result;
-    // TODO: use FFT convolve?
     if (n == 1)
     {
       result = input; // Not needed copy
@@ -331,6 +417,11 @@ namespace OpenMS
       r_max = (IsotopeDistribution::ContainerType::size_type)(max_isotope_ + 1);
     }
 
+    if (min<Size>(input.size(), r_max) >= FFT_MIN_ISOTOPES)
+    {
+      return convolveFFT_(input, input, r_max);
+    }
+
     result.resize(r_max);
     for (IsotopeDistribution::ContainerType::size_type i = 0; i != r_max; ++i)
     {
@@ -350,6 +441,37 @@ namespace OpenMS
     return result;
   }
 
+  IsotopeDistribution::ContainerType CoarseIsotopePatternGenerator::convolveFFT_(const IsotopeDistribution::ContainerType & left, const IsotopeDistribution::ContainerType & right, Size r_max) const
+  {
+    IsotopeDistribution::ContainerType result;
+    if (left.empty() || right.empty())
+    {
+      return result;
+    }
+
+    evergreen::Tensor<double> left_t(evergreen::Vector<unsigned long>({(unsigned long)left.size()}));
+    for (Size i = 0; i < left.size(); ++i)
+    {
+      left_t.flat()[i] = left[i].getIntensity();
+    }
+    evergreen::Tensor<double> right_t(evergreen::Vector<unsigned long>({(unsigned long)right.size()}));
+    for (Size i = 0; i < right.size(); ++i)
+    {
+      right_t.flat()[i] = right[i].getIntensity();
+    }
+
+    const evergreen::Tensor<double> conv = evergreen::fft_convolve(left_t, right_t);
+
+    r_max = min<Size>(r_max, conv.flat().size());
+    result.resize(r_max);
+    for (Size i = 0; i != r_max; ++i)
+    {
+      // round-off of the transform can produce tiny negative values for (almost) impossible isotopes
+      result[i] = Peak1D(left[0].getMZ() + right[0].getMZ() + i, max(0.0, conv.flat()[i]));
+    }
+    return result;
+  }
+
   IsotopeDistribution CoarseIsotopePatternGenerator::calcFragmentIsotopeDist_(const IsotopeDistribution::ContainerType& fragment_isotope_dist, const IsotopeDistribution::ContainerType& comp_fragment_isotope_dist, const std::set<UInt>& precursor_isotopes) const
   {
     
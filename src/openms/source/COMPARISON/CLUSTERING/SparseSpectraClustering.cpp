@@ -0,0 +1,402 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/COMPARISON/CLUSTERING/SparseSpectraClustering.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    // 64 bit mixing function (splitmix64 finalizer) used to derive the random hyperplanes
+    inline UInt64 mix64(UInt64 z)
+    {
+      z += 0x9e3779b97f4a7c15ULL;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    }
+
+    // distance statistics of all scored element pairs between two clusters
+    struct LinkStats
+    {
+      double sum;
+      float min;
+      float max;
+      Size count;
+    };
+
+    // entry of the merge queue; outdated if the version of a cluster changed
+    struct QueueEntry
+    {
+      float distance;
+      Size a;
+      Size b;
+      UInt version_a;
+      UInt version_b;
+
+      bool operator>(const QueueEntry& rhs) const
+      {
+        if (distance != rhs.distance) return distance > rhs.distance;
+        if (a != rhs.a) return a > rhs.a;
+        return b > rhs.b;
+      }
+    };
+  }
+
+  SparseSpectraClustering::SparseSpectraClustering() :
+    DefaultParamHandler("SparseSpectraClustering"),
+    ProgressLogger()
+  {
+    defaults_.setValue("precursor_mz_tolerance", 0.02, "Maximal precursor m/z difference of spectra in the same cluster.");
+    defaults_.setMinFloat("precursor_mz_tolerance", 0.0);
+    defaults_.setValue("precursor_mz_tolerance_unit", "Da", "Unit of 'precursor_mz_tolerance'.");
+    defaults_.setValidStrings("precursor_mz_tolerance_unit", ListUtils::create<String>("Da,ppm"));
+
+    defaults_.setValue("bin_size", BinnedSpectrum::DEFAULT_BIN_WIDTH_HIRES, "Bin size (in Th) of the binned spectra.");
+    defaults_.setMinFloat("bin_size", 1e-5);
+    defaults_.setValue("bin_spread", 0, "Number of neighboring bins a peak is added to.");
+    defaults_.setMinInt("bin_spread", 0);
+    defaults_.setValue("bin_offset", BinnedSpectrum::DEFAULT_BIN_OFFSET_HIRES, "Offset of the bins.");
+
+    defaults_.setValue("similarity", BinnedSpectrumMatrix::NamesOfSimilarityMeasure[BinnedSpectrumMatrix::CONTRAST_ANGLE], "Similarity measure of the binned spectra.");
+    defaults_.setValidStrings("similarity", vector<String>(BinnedSpectrumMatrix::NamesOfSimilarityMeasure, BinnedSpectrumMatrix::NamesOfSimilarityMeasure + BinnedSpectrumMatrix::SIZE_OF_SIMILARITYMEASURE));
+
+    defaults_.setValue("linkage", "single", "Linkage of the agglomerative clustering. Unscored pairs count with distance 1.");
+    defaults_.setValidStrings("linkage", ListUtils::create<String>("single,average,complete"));
+    defaults_.setValue("distance_threshold", 0.3, "Clusters are only merged if their distance (1 - similarity) is below this value.");
+    defaults_.setMinFloat("distance_threshold", 0.0);
+    defaults_.setMaxFloat("distance_threshold", 1.0);
+
+    defaults_.setValue("lsh:bands", 16, "Number of hash bands. More bands find more candidate pairs.");
+    defaults_.setMinInt("lsh:bands", 1);
+    defaults_.setValue("lsh:bits_per_band", 8, "Number of hyperplane bits per band. More bits make candidate pairs more specific.");
+    defaults_.setMinInt("lsh:bits_per_band", 1);
+    defaults_.setMaxInt("lsh:bits_per_band", 64);
+    defaults_.setSectionDescription("lsh", "Locality-sensitive hashing used to find candidate pairs");
+
+    defaultsToParam_();
+  }
+
+  SparseSpectraClustering::~SparseSpectraClustering()
+  {
+  }
+
+  void SparseSpectraClustering::updateMembers_()
+  {
+    precursor_tolerance_ = param_.getValue("precursor_mz_tolerance");
+    precursor_tolerance_ppm_ = param_.getValue("precursor_mz_tolerance_unit") == "ppm";
+    bin_size_ = (double)param_.getValue("bin_size");
+    bin_spread_ = (UInt)param_.getValue("bin_spread");
+    bin_offset_ = (double)param_.getValue("bin_offset");
+    String similarity = param_.getValue("similarity");
+    measure_ = BinnedSpectrumMatrix::SimilarityMeasure(find(BinnedSpectrumMatrix::NamesOfSimilarityMeasure, BinnedSpectrumMatrix::NamesOfSimilarityMeasure + BinnedSpectrumMatrix::SIZE_OF_SIMILARITYMEASURE, similarity) - BinnedSpectrumMatrix::NamesOfSimilarityMeasure);
+    linkage_ = param_.getValue("linkage");
+    distance_threshold_ = param_.getValue("distance_threshold");
+    bands_ = (UInt)param_.getValue("lsh:bands");
+    bits_per_band_ = (UInt)param_.getValue("lsh:bits_per_band");
+  }
+
+  double SparseSpectraClustering::precursorMZ_(const PeakSpectrum& spec)
+  {
+    return spec.getPrecursors().empty() ? 0.0 : spec.getPrecursors()[0].getMZ();
+  }
+
+  void SparseSpectraClustering::computeBandKeys_(const BinnedSpectrumMatrix& matrix, vector<UInt64>& keys) const
+  {
+    const Size n_bits = bands_ * bits_per_band_;
+    const Size n_words = (n_bits + 63) / 64;
+    const vector<Size>& offsets = matrix.getRowOffsets();
+    const vector<UInt>& indices = matrix.getBinIndices();
+    const vector<float>& values = matrix.getBinValues();
+
+    keys.assign(matrix.size() * bands_, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      vector<double> projection(n_bits);
+      vector<UInt64> words(n_words);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1000)
+#endif
+      for (SignedSize row = 0; row < (SignedSize)matrix.size(); ++row)
+      {
+        // project the spectrum onto n_bits random hyperplanes; the hyperplane
+        // component of a bin is +1 or -1, derived from a hash of the bin index
+        fill(projection.begin(), projection.end(), 0.0);
+        for (Size k = offsets[row]; k < offsets[row + 1]; ++k)
+        {
+          for (Size w = 0; w < n_words; ++w)
+          {
+            words[w] = mix64((UInt64(indices[k]) << 8) ^ w);
+          }
+          for (Size bit = 0; bit < n_bits; ++bit)
+          {
+            const bool positive = (words[bit / 64] >> (bit % 64)) & 1;
+            projection[bit] += positive ? values[k] : -values[k];
+          }
+        }
+
+        for (Size band = 0; band < bands_; ++band)
+        {
+          UInt64 key = 0;
+          for (Size bit = 0; bit < bits_per_band_; ++bit)
+          {
+            key = (key << 1) | UInt64(projection[band * bits_per_band_ + bit] > 0.0);
+          }
+          keys[row * bands_ + band] = key;
+        }
+      }
+    }
+  }
+
+  void SparseSpectraClustering::computeCandidatePairs(const vector<PeakSpectrum>& data, vector<CandidatePair>& pairs)
+  {
+    pairs.clear();
+    const Size n = data.size();
+
+    // 1. binning (the matrix is filled sequentially, the bins are computed in parallel chunks)
+    BinnedSpectrumMatrix matrix;
+    const Size chunk_size = 10000;
+    for (Size chunk_start = 0; chunk_start < n; chunk_start += chunk_size)
+    {
+      const Size chunk_end = min(n, chunk_start + chunk_size);
+      vector<BinnedSpectrum> binned(chunk_end - chunk_start);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = (SignedSize)chunk_start; i < (SignedSize)chunk_end; ++i)
+      {
+        binned[i - chunk_start] = BinnedSpectrum(data[i], bin_size_, false, bin_spread_, bin_offset_);
+      }
+      for (const BinnedSpectrum& bs : binned)
+      {
+        matrix.addSpectrum(bs);
+      }
+    }
+
+    // 2. candidate pairs: same band key and precursor m/z within tolerance
+    vector<UInt64> keys;
+    computeBandKeys_(matrix, keys);
+
+    vector<double> precursor_mz(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      precursor_mz[i] = precursorMZ_(data[i]);
+    }
+
+    vector<vector<pair<Size, Size> > > band_pairs(bands_);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize band = 0; band < (SignedSize)bands_; ++band)
+    {
+      // sort by (key, precursor m/z) and sweep over each bucket with a precursor window
+      vector<Size> order(n);
+      for (Size i = 0; i < n; ++i) order[i] = i;
+      sort(order.begin(), order.end(), [&](Size a, Size b)
+      {
+        const UInt64 key_a = keys[a * bands_ + band], key_b = keys[b * bands_ + band];
+        if (key_a != key_b) return key_a < key_b;
+        if (precursor_mz[a] != precursor_mz[b]) return precursor_mz[a] < precursor_mz[b];
+        return a < b;
+      });
+
+      vector<pair<Size, Size> >& current = band_pairs[band];
+      for (Size i = 0; i < n; ++i)
+      {
+        const Size a = order[i];
+        const UInt64 key_a = keys[a * bands_ + band];
+        const double max_mz = precursor_mz[a] + (precursor_tolerance_ppm_ ? precursor_mz[a] * precursor_tolerance_ * 1e-6 : precursor_tolerance_);
+        for (Size j = i + 1; j < n; ++j)
+        {
+          const Size b = order[j];
+          if (keys[b * bands_ + band] != key_a || precursor_mz[b] > max_mz) break;
+          current.push_back(make_pair(min(a, b), max(a, b)));
+        }
+      }
+      sort(current.begin(), current.end());
+    }
+
+    vector<pair<Size, Size> > candidates;
+    for (vector<pair<Size, Size> >& current : band_pairs)
+    {
+      candidates.insert(candidates.end(), current.begin(), current.end());
+      vector<pair<Size, Size> >().swap(current);
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // 3. scoring
+    pairs.resize(candidates.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize k = 0; k < (SignedSize)candidates.size(); ++k)
+    {
+      CandidatePair& p = pairs[k];
+      p.first = candidates[k].first;
+      p.second = candidates[k].second;
+      p.distance = static_cast<float>(1.0 - matrix.compare(p.first, p.second, measure_));
+    }
+    pairs.erase(remove_if(pairs.begin(), pairs.end(), [&](const CandidatePair& p)
+    {
+      return p.distance >= distance_threshold_;
+    }), pairs.end());
+
+    OPENMS_LOG_DEBUG << "SparseSpectraClustering: " << candidates.size() << " candidate pairs, " << pairs.size() << " below the distance threshold" << endl;
+  }
+
+  void SparseSpectraClustering::clusterSparse(Size size, const vector<CandidatePair>& pairs, vector<BinaryTreeNode>& cluster_tree) const
+  {
+    cluster_tree.clear();
+    cluster_tree.reserve(size > 0 ? size - 1 : 0);
+
+    // clusters are identified by their smallest element
+    vector<unordered_map<Size, LinkStats> > neighbors(size);
+    vector<Size> cluster_size(size, 1);
+    vector<UInt> version(size, 0);
+    vector<bool> alive(size, true);
+
+    auto linkDistance = [&](Size a, Size b, const LinkStats& s)
+    {
+      if (linkage_ == "single") return s.min;
+      const double all_pairs = double(cluster_size[a]) * cluster_size[b];
+      if (linkage_ == "complete") return s.count == all_pairs ? s.max : 1.0f;
+      return float((s.sum + (all_pairs - s.count)) / all_pairs); // average
+    };
+
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queue;
+    for (const CandidatePair& p : pairs)
+    {
+      if (p.first == p.second) continue;
+      const Size a = min(p.first, p.second), b = max(p.first, p.second);
+      LinkStats s = {p.distance, p.distance, p.distance, 1};
+      neighbors[a][b] = s;
+      neighbors[b][a] = s;
+      QueueEntry e = {p.distance, a, b, 0, 0};
+      queue.push(e);
+    }
+
+    startProgress(0, size, "clustering data");
+    while (!queue.empty())
+    {
+      const QueueEntry e = queue.top();
+      queue.pop();
+      if (!alive[e.a] || !alive[e.b] || version[e.a] != e.version_a || version[e.b] != e.version_b) continue;
+      if (e.distance >= distance_threshold_) break;
+
+      // merge b into a (a < b, so a stays the smallest element)
+      const Size a = e.a, b = e.b;
+      cluster_tree.push_back(BinaryTreeNode(a, b, e.distance));
+
+      neighbors[a].erase(b);
+      for (const auto& nb : neighbors[b])
+      {
+        const Size c = nb.first;
+        if (c == a) continue;
+        unordered_map<Size, LinkStats>::iterator it = neighbors[a].find(c);
+        if (it == neighbors[a].end())
+        {
+          neighbors[a][c] = nb.second;
+        }
+        else
+        {
+          LinkStats& s = it->second;
+          s.sum += nb.second.sum;
+          s.min = min(s.min, nb.second.min);
+          s.max = max(s.max, nb.second.max);
+          s.count += nb.second.count;
+        }
+        neighbors[c].erase(b);
+      }
+      unordered_map<Size, LinkStats>().swap(neighbors[b]);
+      alive[b] = false;
+      cluster_size[a] += cluster_size[b];
+      ++version[a];
+
+      for (const auto& nb : neighbors[a])
+      {
+        const Size c = nb.first;
+        neighbors[c][a] = nb.second;
+        QueueEntry updated = {linkDistance(a, c, nb.second), min(a, c), max(a, c), 0, 0};
+        updated.version_a = version[updated.a];
+        updated.version_b = version[updated.b];
+        queue.push(updated);
+      }
+      setProgress(cluster_tree.size());
+    }
+    endProgress();
+
+    // join the remaining clusters with dummy nodes
+    Size first_alive = size;
+    for (Size i = 0; i < size; ++i)
+    {
+      if (!alive[i]) continue;
+      if (first_alive == size)
+      {
+        first_alive = i;
+      }
+      else
+      {
+        cluster_tree.push_back(BinaryTreeNode(first_alive, i, -1.0));
+      }
+    }
+  }
+
+  void SparseSpectraClustering::cluster(const vector<PeakSpectrum>& data, vector<BinaryTreeNode>& cluster_tree)
+  {
+    // input MUST have >= 2 elements!
+    if (data.size() < 2)
+    {
+      throw ClusterFunctor::InsufficientInput(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Clustering requires at least two spectra");
+    }
+
+    vector<CandidatePair> pairs;
+    computeCandidatePairs(data, pairs);
+    clusterSparse(data.size(), pairs, cluster_tree);
+  }
+
+}
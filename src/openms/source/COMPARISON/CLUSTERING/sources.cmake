@@ -13,6 +13,7 @@ EuclideanSimilarity.cpp
 GridBasedCluster.cpp
 GridBasedClustering.cpp
 SingleLinkage.cpp
+SparseSpectraClustering.cpp
 )
 
 ### add path to the filenames
@@ -0,0 +1,311 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumMatrix.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const std::string BinnedSpectrumMatrix::NamesOfSimilarityMeasure[] = {"BinnedSpectralContrastAngle", "BinnedSharedPeakCount", "BinnedSumAgreeingIntensities"};
+
+  namespace
+  {
+    // sort by decreasing similarity, ties by increasing index
+    bool betterHit(const BinnedSpectrumMatrix::Hit& a, const BinnedSpectrumMatrix::Hit& b)
+    {
+      return a.second > b.second || (a.second == b.second && a.first < b.first);
+    }
+  }
+
+  BinnedSpectrumMatrix::BinnedSpectrumMatrix() :
+    row_offsets_(1, 0),
+    bin_indices_(),
+    bin_values_(),
+    row_sums_(),
+    row_sqsums_(),
+    layout_(),
+    has_layout_(false)
+  {
+  }
+
+  BinnedSpectrumMatrix::BinnedSpectrumMatrix(const vector<BinnedSpectrum>& spectra) :
+    BinnedSpectrumMatrix()
+  {
+    Size nnz = 0;
+    for (const BinnedSpectrum& spec : spectra)
+    {
+      nnz += spec.getBins().nonZeros();
+    }
+    bin_indices_.reserve(nnz);
+    bin_values_.reserve(nnz);
+    row_offsets_.reserve(spectra.size() + 1);
+    row_sums_.reserve(spectra.size());
+    row_sqsums_.reserve(spectra.size());
+
+    for (const BinnedSpectrum& spec : spectra)
+    {
+      addSpectrum(spec);
+    }
+  }
+
+  BinnedSpectrumMatrix::~BinnedSpectrumMatrix()
+  {
+  }
+
+  void BinnedSpectrumMatrix::checkCompatible_(const BinnedSpectrum& spec) const
+  {
+    if (has_layout_ && !BinnedSpectrum::isCompatible(layout_, spec))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Binned spectra have different bin size or offset");
+    }
+  }
+
+  void BinnedSpectrumMatrix::addSpectrum(const BinnedSpectrum& spec)
+  {
+    checkCompatible_(spec);
+    if (!has_layout_)
+    {
+      layout_ = spec;
+      layout_.getBins() = BinnedSpectrum::SparseVectorType();
+      layout_.getPrecursors().clear();
+      has_layout_ = true;
+    }
+
+    // Eigen stores the bins of a sparse vector sorted by index
+    double sum = 0.0, sqsum = 0.0;
+    for (BinnedSpectrum::SparseVectorIteratorType it(spec.getBins()); it; ++it)
+    {
+      bin_indices_.push_back(static_cast<UInt>(it.index()));
+      bin_values_.push_back(it.value());
+      sum += it.value();
+      sqsum += double(it.value()) * it.value();
+    }
+    row_offsets_.push_back(bin_indices_.size());
+    row_sums_.push_back(sum);
+    row_sqsums_.push_back(sqsum);
+  }
+
+  void BinnedSpectrumMatrix::clear()
+  {
+    row_offsets_.assign(1, 0);
+    bin_indices_.clear();
+    bin_values_.clear();
+    row_sums_.clear();
+    row_sqsums_.clear();
+    has_layout_ = false;
+  }
+
+  Size BinnedSpectrumMatrix::size() const
+  {
+    return row_sums_.size();
+  }
+
+  Size BinnedSpectrumMatrix::nonZeros() const
+  {
+    return bin_indices_.size();
+  }
+
+  const vector<Size>& BinnedSpectrumMatrix::getRowOffsets() const
+  {
+    return row_offsets_;
+  }
+
+  const vector<UInt>& BinnedSpectrumMatrix::getBinIndices() const
+  {
+    return bin_indices_;
+  }
+
+  const vector<float>& BinnedSpectrumMatrix::getBinValues() const
+  {
+    return bin_values_;
+  }
+
+  BinnedSpectrumMatrix::MergeResult_ BinnedSpectrumMatrix::merge_(const UInt* idx_a, const float* val_a, Size size_a,
+                                                                  const UInt* idx_b, const float* val_b, Size size_b)
+  {
+    MergeResult_ m = {0.0, 0.0, 0};
+    Size i = 0, j = 0;
+    while (i < size_a && j < size_b)
+    {
+      const UInt ia = idx_a[i], ib = idx_b[j];
+      if (ia == ib)
+      {
+        const double a = val_a[i], b = val_b[j];
+        m.dot += a * b;
+        // bins filled in only one spectrum never contribute a positive value
+        m.agreeing += max(0.0, 0.5 * (a + b) - fabs(a - b));
+        ++m.shared;
+        ++i;
+        ++j;
+      }
+      else
+      {
+        // branch-free advance of the smaller index
+        i += (ia < ib);
+        j += (ib < ia);
+      }
+    }
+    return m;
+  }
+
+  double BinnedSpectrumMatrix::score_(const MergeResult_& m, SimilarityMeasure measure,
+                                      Size nnz_a, double sum_a, double sqsum_a,
+                                      Size nnz_b, double sum_b, double sqsum_b)
+  {
+    switch (measure)
+    {
+      case CONTRAST_ANGLE:
+      {
+        const double denominator = sqrt(sqsum_a * sqsum_b);
+        return denominator > 0.0 ? m.dot / denominator : 0.0;
+      }
+      case SHARED_PEAK_COUNT:
+      {
+        const Size denominator = max(nnz_a, nnz_b);
+        return denominator > 0 ? static_cast<double>(m.shared) / denominator : 0.0;
+      }
+      case SUM_AGREEING_INTENSITIES:
+      {
+        const double denominator = (sum_a + sum_b) / 2.0;
+        return denominator > 0.0 ? min(m.agreeing / denominator, 1.0) : 0.0;
+      }
+      default:
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown similarity measure", String(measure));
+    }
+  }
+
+  double BinnedSpectrumMatrix::compare(Size i, Size j, SimilarityMeasure measure) const
+  {
+    if (i >= size() || j >= size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, max(i, j), size());
+    }
+    const Size begin_i = row_offsets_[i], nnz_i = row_offsets_[i + 1] - begin_i;
+    const Size begin_j = row_offsets_[j], nnz_j = row_offsets_[j + 1] - begin_j;
+    MergeResult_ m = merge_(bin_indices_.data() + begin_i, bin_values_.data() + begin_i, nnz_i,
+                            bin_indices_.data() + begin_j, bin_values_.data() + begin_j, nnz_j);
+    return score_(m, measure, nnz_i, row_sums_[i], row_sqsums_[i], nnz_j, row_sums_[j], row_sqsums_[j]);
+  }
+
+  void BinnedSpectrumMatrix::compareOneVsMany(const BinnedSpectrum& query, SimilarityMeasure measure, vector<double>& scores) const
+  {
+    checkCompatible_(query);
+
+    // pack the query in the same layout as the rows
+    BinnedSpectrumMatrix q;
+    q.addSpectrum(query);
+    const Size nnz_q = q.nonZeros();
+
+    scores.assign(size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000)
+#endif
+    for (SignedSize r = 0; r < (SignedSize)size(); ++r)
+    {
+      const Size begin = row_offsets_[r], nnz = row_offsets_[r + 1] - begin;
+      MergeResult_ m = merge_(q.bin_indices_.data(), q.bin_values_.data(), nnz_q,
+                              bin_indices_.data() + begin, bin_values_.data() + begin, nnz);
+      scores[r] = score_(m, measure, nnz_q, q.row_sums_[0], q.row_sqsums_[0], nnz, row_sums_[r], row_sqsums_[r]);
+    }
+  }
+
+  void BinnedSpectrumMatrix::selectTopK_(vector<Hit>& hits, Size top_k)
+  {
+    if (hits.size() > top_k)
+    {
+      nth_element(hits.begin(), hits.begin() + top_k, hits.end(), betterHit);
+      hits.resize(top_k);
+    }
+    sort(hits.begin(), hits.end(), betterHit);
+  }
+
+  void BinnedSpectrumMatrix::compareOneVsMany(const BinnedSpectrum& query, SimilarityMeasure measure, Size top_k, vector<Hit>& hits) const
+  {
+    vector<double> scores;
+    compareOneVsMany(query, measure, scores);
+
+    hits.clear();
+    for (Size r = 0; r < scores.size(); ++r)
+    {
+      if (scores[r] > 0.0) hits.push_back(Hit(r, scores[r]));
+    }
+    selectTopK_(hits, top_k);
+  }
+
+  void BinnedSpectrumMatrix::compareAllVsAll(SimilarityMeasure measure, DistanceMatrix<float>& similarities) const
+  {
+    similarities.resize(size(), 1.0f);
+
+    // rows are handed out in reverse, as the work per row grows with its index
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize r = (SignedSize)size() - 1; r >= 0; --r)
+    {
+      for (Size c = 0; c < (Size)r; ++c)
+      {
+        similarities.setValueQuick(r, c, static_cast<float>(compare(r, c, measure)));
+      }
+    }
+    similarities.updateMinElement();
+  }
+
+  void BinnedSpectrumMatrix::compareAllVsAll(SimilarityMeasure measure, Size top_k, vector<vector<Hit> >& hits) const
+  {
+    hits.assign(size(), vector<Hit>());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize r = 0; r < (SignedSize)size(); ++r)
+    {
+      // every pair is scored twice, but rows are independent and need no locking
+      vector<Hit>& row_hits = hits[r];
+      for (Size c = 0; c < size(); ++c)
+      {
+        if (c == (Size)r) continue;
+        double score = compare(r, c, measure);
+        if (score > 0.0) row_hits.push_back(Hit(c, score));
+      }
+      selectTopK_(row_hits, top_k);
+      row_hits.shrink_to_fit();
+    }
+  }
+
+}
@@ -7,6 +7,7 @@ BinnedSharedPeakCount.cpp
 BinnedSpectralContrastAngle.cpp
 BinnedSpectrum.cpp
 BinnedSpectrumCompareFunctor.cpp
+BinnedSpectrumMatrix.cpp
 BinnedSumAgreeingIntensities.cpp
 PeakAlignment.cpp
 PeakSpectrumCompareFunctor.cpp
@@ -32,6 +32,23 @@
 // $Authors: Marc Sturm, Clemens Groepl $
 // --------------------------------------------------------------------------
 
+#include <OpenMS/CONCEPT/PrecisionWrapper.h>
+#include <OpenMS/DATASTRUCTURES/StringUtils.h>
+
 namespace OpenMS
 {
+  std::ostream & operator<<(std::ostream & os, const PrecisionWrapper<double> & rhs)
+  {
+    char buffer[32];
+    const char* end = StringConversions::formatShortest(rhs.ref_, buffer);
+    if (os.width() == 0)
+    {
+      os.write(buffer, end - buffer);
+    }
+    else
+    {
+      os << std::string(buffer, end - buffer); // respect std::setw()
+    }
+    return os;
+  }
 }
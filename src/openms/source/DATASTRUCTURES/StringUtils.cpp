@@ -34,9 +34,460 @@
 
 #include <OpenMS/DATASTRUCTURES/StringUtils.h>
 
+#include <cmath>
+#include <cstring>
+
 namespace OpenMS
 {
 
+  namespace
+  {
+    // Grisu2 (F. Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010):
+    // the boundaries of the rounding interval of a double are scaled by a cached power of ten, such that
+    // the digits can be generated using 64-bit integer arithmetic only. The generated digits are the
+    // shortest ones within the (slightly narrowed) rounding interval, so they always read back to the same double.
+
+    /// A floating point number f * 2^e with 64-bit significand
+    struct DiyFp
+    {
+      UInt64 f;
+      int e;
+
+      DiyFp(UInt64 f_, int e_) :
+        f(f_), e(e_)
+      {
+      }
+
+      /// x - y (same exponent, x.f >= y.f)
+      static DiyFp sub(const DiyFp& x, const DiyFp& y)
+      {
+        return DiyFp(x.f - y.f, x.e);
+      }
+
+      /// x * y, rounded to the upper 64 bits of the product
+      static DiyFp mul(const DiyFp& x, const DiyFp& y)
+      {
+        const UInt64 a = x.f >> 32, b = x.f & 0xFFFFFFFFu;
+        const UInt64 c = y.f >> 32, d = y.f & 0xFFFFFFFFu;
+        const UInt64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+        UInt64 tmp = (bd >> 32) + (ad & 0xFFFFFFFFu) + (bc & 0xFFFFFFFFu);
+        tmp += UInt64(1) << 31; // round
+        return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+      }
+
+      /// shifts the significand until its highest bit is set
+      static DiyFp normalize(DiyFp x)
+      {
+        while ((x.f >> 63) == 0)
+        {
+          x.f <<= 1;
+          --x.e;
+        }
+        return x;
+      }
+
+      /// shifts the significand to the (smaller) exponent @p target_exponent
+      static DiyFp normalizeTo(const DiyFp& x, int target_exponent)
+      {
+        return DiyFp(x.f << (x.e - target_exponent), target_exponent);
+      }
+    };
+
+    /// 10^k ~= f * 2^e
+    struct CachedPower
+    {
+      UInt64 f;
+      int e;
+      int k;
+    };
+
+    /// normalized powers of ten 10^-300, 10^-292, ..., 10^324 (significands rounded to nearest)
+    const CachedPower cached_powers[] =
+    {
+        { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+        { 0xBE5691EF416BD60CULL, -1007, -284 },
+        { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+        { 0xD3515C2831559A83ULL,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+        { 0xEA9C227723EE8BCBULL,  -901, -252 },
+        { 0xAECC49914078536DULL,  -874, -244 },
+        { 0x823C12795DB6CE57ULL,  -847, -236 },
+        { 0xC21094364DFB5637ULL,  -821, -228 },
+        { 0x9096EA6F3848984FULL,  -794, -220 },
+        { 0xD77485CB25823AC7ULL,  -768, -212 },
+        { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+        { 0xEF340A98172AACE5ULL,  -715, -196 },
+        { 0xB23867FB2A35B28EULL,  -688, -188 },
+        { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+        { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+        { 0x936B9FCEBB25C996ULL,  -608, -164 },
+        { 0xDBAC6C247D62A584ULL,  -582, -156 },
+        { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+        { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+        { 0x87625F056C7C4A8BULL,  -475, -124 },
+        { 0xC9BCFF6034C13053ULL,  -449, -116 },
+        { 0x964E858C91BA2655ULL,  -422, -108 },
+        { 0xDFF9772470297EBDULL,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+        { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+        { 0xB94470938FA89BCFULL,  -316,  -76 },
+        { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+        { 0xCDB02555653131B6ULL,  -263,  -60 },
+        { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+        { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+        { 0xAA242499697392D3ULL,  -183,  -36 },
+        { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+        { 0xBCE5086492111AEBULL,  -130,  -20 },
+        { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+        { 0xD1B71758E219652CULL,   -77,   -4 },
+        { 0x9C40000000000000ULL,   -50,    4 },
+        { 0xE8D4A51000000000ULL,   -24,   12 },
+        { 0xAD78EBC5AC620000ULL,     3,   20 },
+        { 0x813F3978F8940984ULL,    30,   28 },
+        { 0xC097CE7BC90715B3ULL,    56,   36 },
+        { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+        { 0xD5D238A4ABE98068ULL,   109,   52 },
+        { 0x9F4F2726179A2245ULL,   136,   60 },
+        { 0xED63A231D4C4FB27ULL,   162,   68 },
+        { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+        { 0x83C7088E1AAB65DBULL,   216,   84 },
+        { 0xC45D1DF942711D9AULL,   242,   92 },
+        { 0x924D692CA61BE758ULL,   269,  100 },
+        { 0xDA01EE641A708DEAULL,   295,  108 },
+        { 0xA26DA3999AEF774AULL,   322,  116 },
+        { 0xF209787BB47D6B85ULL,   348,  124 },
+        { 0xB454E4A179DD1877ULL,   375,  132 },
+        { 0x865B86925B9BC5C2ULL,   402,  140 },
+        { 0xC83553C5C8965D3DULL,   428,  148 },
+        { 0x952AB45CFA97A0B3ULL,   455,  156 },
+        { 0xDE469FBD99A05FE3ULL,   481,  164 },
+        { 0xA59BC234DB398C25ULL,   508,  172 },
+        { 0xF6C69A72A3989F5CULL,   534,  180 },
+        { 0xB7DCBF5354E9BECEULL,   561,  188 },
+        { 0x88FCF317F22241E2ULL,   588,  196 },
+        { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+        { 0x98165AF37B2153DFULL,   641,  212 },
+        { 0xE2A0B5DC971F303AULL,   667,  220 },
+        { 0xA8D9D1535CE3B396ULL,   694,  228 },
+        { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+        { 0xBB764C4CA7A44410ULL,   747,  244 },
+        { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+        { 0xD01FEF10A657842CULL,   800,  260 },
+        { 0x9B10A4E5E9913129ULL,   827,  268 },
+        { 0xE7109BFBA19C0C9DULL,   853,  276 },
+        { 0xAC2820D9623BF429ULL,   880,  284 },
+        { 0x80444B5E7AA7CF85ULL,   907,  292 },
+        { 0xBF21E44003ACDD2DULL,   933,  300 },
+        { 0x8E679C2F5E44FF8FULL,   960,  308 },
+        { 0xD433179D9C8CB841ULL,   986,  316 },
+        { 0x9E19DB92B4E31BA9ULL,  1013,  324 }
+    };
+
+    /// returns a cached power c = f * 2^e with -60 <= e + @p e + 64 <= -32
+    const CachedPower& cachedPowerForBinaryExponent(int e)
+    {
+      // k = ceil((alpha - e - 1) * log10(2)), with 78913 / 2^18 ~= log10(2)
+      const int f = -60 - e - 1;
+      const int k = (f * 78913) / (1 << 18) + (f > 0);
+      const int index = (300 + k + 7) / 8;
+      return cached_powers[index];
+    }
+
+    /// number of decimal digits of @p n (n > 0) and the largest power of ten <= @p n
+    int largestPow10(UInt32 n, UInt32& pow10)
+    {
+      static const UInt32 pow10s[] = { 1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u };
+      int digits = 10;
+      while (digits > 1 && n < pow10s[digits - 1])
+      {
+        --digits;
+      }
+      pow10 = pow10s[digits - 1];
+      return digits;
+    }
+
+    /// moves the last digit towards the exact value (w), while staying inside the rounding interval
+    void grisuRound(char* buffer, int length, UInt64 dist, UInt64 delta, UInt64 rest, UInt64 ten_k)
+    {
+      while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+      {
+        --buffer[length - 1];
+        rest += ten_k;
+      }
+    }
+
+    /// generates the digits of @p w (scaled), within the interval [@p m_minus, @p m_plus]
+    void grisuDigitGen(char* buffer, int& length, int& decimal_exponent, const DiyFp& m_minus, const DiyFp& w, const DiyFp& m_plus)
+    {
+      UInt64 delta = DiyFp::sub(m_plus, m_minus).f;
+      UInt64 dist = DiyFp::sub(m_plus, w).f;
+
+      // split m_plus into integral (p1) and fractional (p2) part
+      const DiyFp one(UInt64(1) << -m_plus.e, m_plus.e);
+      UInt32 p1 = UInt32(m_plus.f >> -one.e);
+      UInt64 p2 = m_plus.f & (one.f - 1);
+
+      UInt32 pow10;
+      int n = largestPow10(p1, pow10);
+      while (n > 0)
+      {
+        const UInt32 digit = p1 / pow10;
+        p1 %= pow10;
+        buffer[length++] = char('0' + digit);
+        --n;
+        const UInt64 rest = (UInt64(p1) << -one.e) + p2;
+        if (rest <= delta)
+        {
+          decimal_exponent += n;
+          grisuRound(buffer, length, dist, delta, rest, UInt64(pow10) << -one.e);
+          return;
+        }
+        pow10 /= 10;
+      }
+
+      int m = 0;
+      while (true)
+      {
+        p2 *= 10;
+        const UInt64 digit = p2 >> -one.e;
+        p2 &= one.f - 1;
+        buffer[length++] = char('0' + digit);
+        ++m;
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta)
+        {
+          break;
+        }
+      }
+      decimal_exponent -= m;
+      grisuRound(buffer, length, dist, delta, p2, one.f);
+    }
+
+    /// generates the digits of @p value > 0, such that value ~= digits * 10^decimal_exponent
+    void grisu2(double value, char* buffer, int& length, int& decimal_exponent)
+    {
+      UInt64 bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      const UInt64 hidden_bit = UInt64(1) << 52;
+      const UInt64 fraction = bits & (hidden_bit - 1);
+      const int biased_exponent = int(bits >> 52);
+
+      // the double and the boundaries of its rounding interval
+      const DiyFp v = (biased_exponent == 0) ? DiyFp(fraction, 1 - 1075) : DiyFp(fraction + hidden_bit, biased_exponent - 1075);
+      const bool lower_boundary_is_closer = (fraction == 0 && biased_exponent > 1);
+      const DiyFp m_plus(2 * v.f + 1, v.e - 1);
+      const DiyFp m_minus = lower_boundary_is_closer ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1);
+
+      const DiyFp w_plus = DiyFp::normalize(m_plus);
+      const DiyFp w_minus = DiyFp::normalizeTo(m_minus, w_plus.e);
+      const DiyFp w = DiyFp::normalize(v);
+
+      const CachedPower& cached = cachedPowerForBinaryExponent(w_plus.e);
+      const DiyFp c_minus_k(cached.f, cached.e);
+      const DiyFp scaled_w = DiyFp::mul(w, c_minus_k);
+      const DiyFp scaled_minus = DiyFp::mul(w_minus, c_minus_k);
+      const DiyFp scaled_plus = DiyFp::mul(w_plus, c_minus_k);
+
+      // narrow the interval by one unit, to account for the rounding errors of the multiplication
+      const DiyFp m_minus_narrow(scaled_minus.f + 1, scaled_minus.e);
+      const DiyFp m_plus_narrow(scaled_plus.f - 1, scaled_plus.e);
+
+      length = 0;
+      decimal_exponent = -cached.k;
+      grisuDigitGen(buffer, length, decimal_exponent, m_minus_narrow, scaled_w, m_plus_narrow);
+    }
+
+    /// writes the exponent @p e (|e| < 1000) with at least two digits, as append(double) does (e.g. "-07", "04", "308")
+    char* appendExponent(int e, char* out)
+    {
+      if (e < 0)
+      {
+        *out++ = '-';
+        e = -e;
+      }
+      if (e >= 100)
+      {
+        *out++ = char('0' + e / 100);
+        e %= 100;
+      }
+      *out++ = char('0' + e / 10);
+      *out++ = char('0' + e % 10);
+      return out;
+    }
+
+    /// exact powers of ten that are representable as double
+    const double exact_powers_of_ten[] =
+    {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+  }
+
+  namespace StringConversions
+  {
+    char* formatShortest(double d, char* buffer)
+    {
+      char* out = buffer;
+      if (std::isnan(d))
+      {
+        std::memcpy(out, "nan", 3);
+        return out + 3;
+      }
+      if (std::signbit(d))
+      {
+        *out++ = '-';
+        d = -d;
+      }
+      if (std::isinf(d))
+      {
+        std::memcpy(out, "inf", 3);
+        return out + 3;
+      }
+      if (d == 0.0)
+      {
+        std::memcpy(out, "0.0", 3);
+        return out + 3;
+      }
+
+      char digits[24];
+      int length, decimal_exponent;
+      grisu2(d, digits, length, decimal_exponent);
+
+      // value = 0.digits * 10^point
+      const int point = length + decimal_exponent;
+      const int scientific_exponent = point - 1;
+
+      // same notation as append(double): scientific for >= 1e4 and < 1e-2
+      if (scientific_exponent >= 4 || scientific_exponent < -2)
+      {
+        *out++ = digits[0];
+        *out++ = '.';
+        if (length > 1)
+        {
+          std::memcpy(out, digits + 1, length - 1);
+          out += length - 1;
+        }
+        else
+        {
+          *out++ = '0';
+        }
+        *out++ = 'e';
+        return appendExponent(scientific_exponent, out);
+      }
+
+      if (point <= 0)
+      {
+        // 0.00ddd
+        *out++ = '0';
+        *out++ = '.';
+        std::memset(out, '0', -point);
+        out += -point;
+        std::memcpy(out, digits, length);
+        return out + length;
+      }
+      if (point < length)
+      {
+        // dd.ddd
+        std::memcpy(out, digits, point);
+        out += point;
+        *out++ = '.';
+        std::memcpy(out, digits + point, length - point);
+        return out + (length - point);
+      }
+      // ddd00.0
+      std::memcpy(out, digits, length);
+      out += length;
+      std::memset(out, '0', point - length);
+      out += point - length;
+      *out++ = '.';
+      *out++ = '0';
+      return out;
+    }
+  }
+
+  bool StringUtils::parseDoubleFast(const char*& begin, const char* end, double& target)
+  {
+    const char* it = begin;
+    bool negative = false;
+    if (it != end && (*it == '-' || *it == '+'))
+    {
+      negative = (*it == '-');
+      ++it;
+    }
+
+    // mantissa (up to 19 significant digits fit into 64 bits)
+    UInt64 mantissa = 0;
+    int significant_digits = 0, exponent = 0;
+    bool has_digits = false;
+    for (; it != end && *it >= '0' && *it <= '9'; ++it)
+    {
+      has_digits = true;
+      if (mantissa == 0 && *it == '0') continue; // leading zero
+      if (++significant_digits > 19) return false;
+      mantissa = mantissa * 10 + UInt64(*it - '0');
+    }
+    if (it != end && *it == '.')
+    {
+      ++it;
+      for (; it != end && *it >= '0' && *it <= '9'; ++it)
+      {
+        has_digits = true;
+        --exponent;
+        if (mantissa == 0 && *it == '0') continue; // leading zero
+        if (++significant_digits > 19) return false;
+        mantissa = mantissa * 10 + UInt64(*it - '0');
+      }
+    }
+    if (!has_digits)
+    {
+      return false; // e.g. "nan", "inf" or no number at all
+    }
+
+    if (it != end && (*it == 'e' || *it == 'E'))
+    {
+      ++it;
+      bool negative_exponent = false;
+      if (it != end && (*it == '-' || *it == '+'))
+      {
+        negative_exponent = (*it == '-');
+        ++it;
+      }
+      if (it == end || *it < '0' || *it > '9')
+      {
+        return false; // leave incomplete exponents to the general parser
+      }
+      int exp_value = 0;
+      for (; it != end && *it >= '0' && *it <= '9'; ++it)
+      {
+        if (exp_value > 10000) return false;
+        exp_value = exp_value * 10 + (*it - '0');
+      }
+      exponent += negative_exponent ? -exp_value : exp_value;
+    }
+
+    // the conversion is exact (correctly rounded) if mantissa and power of ten are exactly representable
+    double value;
+    if (mantissa == 0)
+    {
+      value = 0.0;
+    }
+    else if (mantissa <= (UInt64(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+      value = double(mantissa);
+      value = (exponent < 0) ? value / exact_powers_of_ten[-exponent] : value * exact_powers_of_ten[exponent];
+    }
+    else
+    {
+      return false;
+    }
+    target = negative ? -value : value;
+    begin = it;
+    return true;
+  }
+
     boost::spirit::qi::real_parser<double, StringUtils::real_policies_NANfixed_<double> > StringUtils::parse_double_ = boost::spirit::qi::real_parser<double, real_policies_NANfixed_<double> >();
     boost::spirit::qi::real_parser<float, StringUtils::real_policies_NANfixed_<float> > StringUtils::parse_float_ = boost::spirit::qi::real_parser<float, real_policies_NANfixed_<float> >();
  
@@ -35,13 +35,16 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/IsotopeDistributionCache.h>
 
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 namespace OpenMS
 {
 
   IsotopeDistributionCache::IsotopeDistributionCache(double max_mass, double mass_window_width, double intensity_percentage, double intensity_percentage_optional) :
-    mass_window_width_(mass_window_width)
+    mass_window_width_(mass_window_width),
+    intensity_percentage_(intensity_percentage),
+    intensity_percentage_optional_(intensity_percentage_optional)
   {
     Size num_isotopes = std::ceil(max_mass / mass_window_width) + 1;
 
@@ -54,59 +57,63 @@ namespace OpenMS
       //log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
       CoarseIsotopePatternGenerator solver(20);
       auto d = solver.estimateFromPeptideWeight(0.5 * mass_window_width + index * mass_window_width);
+      fillPattern_(d, isotope_distributions_[index]);
+    }
+  }
 
-      //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
-      Size size_before = d.size();
-      d.trimLeft(intensity_percentage_optional);
-      isotope_distributions_[index].trimmed_left = size_before - d.size();
-      d.trimRight(intensity_percentage_optional);
+  void IsotopeDistributionCache::fillPattern_(IsotopeDistribution& d, TheoreticalIsotopePattern& pattern) const
+  {
+    //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
+    Size size_before = d.size();
+    d.trimLeft(intensity_percentage_optional_);
+    pattern.trimmed_left = size_before - d.size();
+    d.trimRight(intensity_percentage_optional_);
 
-      for (IsotopeDistribution::Iterator it = d.begin(); it != d.end(); ++it)
+    for (IsotopeDistribution::Iterator it = d.begin(); it != d.end(); ++it)
+    {
+      pattern.intensity.push_back(it->getIntensity());
+      //log_ << " - " << it->second << std::endl;
+    }
+
+    //determine the number of optional peaks at the beginning/end
+    Size begin = 0;
+    Size end = 0;
+    bool is_begin = true;
+    bool is_end = false;
+    for (Size i = 0; i < pattern.intensity.size(); ++i)
+    {
+      if (pattern.intensity[i] < intensity_percentage_)
       {
-        isotope_distributions_[index].intensity.push_back(it->getIntensity());
-        //log_ << " - " << it->second << std::endl;
+        if (!is_end && !is_begin)
+          is_end = true;
+        if (is_begin)
+          ++begin;
+        else if (is_end)
+          ++end;
       }
-
-      //determine the number of optional peaks at the beginning/end
-      Size begin = 0;
-      Size end = 0;
-      bool is_begin = true;
-      bool is_end = false;
-      for (Size i = 0; i < isotope_distributions_[index].intensity.size(); ++i)
+      else if (is_begin)
       {
-        if (isotope_distributions_[index].intensity[i] < intensity_percentage)
-        {
-          if (!is_end && !is_begin)
-            is_end = true;
-          if (is_begin)
-            ++begin;
-          else if (is_end)
-            ++end;
-        }
-        else if (is_begin)
-        {
-          is_begin = false;
-        }
+        is_begin = false;
       }
-      isotope_distributions_[index].optional_begin = begin;
-      isotope_distributions_[index].optional_end = end;
+    }
+    pattern.optional_begin = begin;
+    pattern.optional_end = end;
 
-      //scale the distribution to a maximum of 1
-      double max = 0.0;
-      for (Size i = 0; i < isotope_distributions_[index].intensity.size(); ++i)
+    //scale the distribution to a maximum of 1
+    double max = 0.0;
+    for (Size i = 0; i < pattern.intensity.size(); ++i)
+    {
+      if (pattern.intensity[i] > max)
       {
-        if (isotope_distributions_[index].intensity[i] > max)
-        {
-          max = isotope_distributions_[index].intensity[i];
-        }
+        max = pattern.intensity[i];
       }
+    }
 
-      isotope_distributions_[index].max = max;
+    pattern.max = max;
 
-      for (Size i = 0; i < isotope_distributions_[index].intensity.size(); ++i)
-      {
-        isotope_distributions_[index].intensity[i] /= max;
-      }
+    for (Size i = 0; i < pattern.intensity.size(); ++i)
+    {
+      pattern.intensity[i] /= max;
     }
   }
 
@@ -125,4 +132,49 @@ namespace OpenMS
     return isotope_distributions_[index];
   }
 
+  const IsotopeDistributionCache::TheoreticalIsotopePattern& IsotopeDistributionCache::getIsotopeDistribution(const EmpiricalFormula& formula) const
+  {
+    const String key = formula.toString();
+
+    const TheoreticalIsotopePattern* result = nullptr;
+#pragma omp critical (IsotopeDistributionCache_formula)
+    {
+      std::map<String, TheoreticalIsotopePattern>::const_iterator it = formula_distributions_.find(key);
+      if (it != formula_distributions_.end())
+      {
+        result = &(it->second);
+      }
+    }
+    if (result != nullptr)
+    {
+      return *result;
+    }
+
+    // same number of isotopes as the averagine distributions
+    CoarseIsotopePatternGenerator solver(20);
+    IsotopeDistribution d = formula.getIsotopeDistribution(solver);
+    TheoreticalIsotopePattern pattern;
+    fillPattern_(d, pattern);
+
+    // map nodes are never moved, so the reference stays valid; if another thread was faster, its pattern is kept
+#pragma omp critical (IsotopeDistributionCache_formula)
+    result = &(formula_distributions_.insert(std::make_pair(key, pattern)).first->second);
+
+    return *result;
+  }
+
+  Size IsotopeDistributionCache::getFormulaCacheSize() const
+  {
+    Size size(0);
+#pragma omp critical (IsotopeDistributionCache_formula)
+    size = formula_distributions_.size();
+    return size;
+  }
+
+  void IsotopeDistributionCache::clearFormulaCache()
+  {
+#pragma omp critical (IsotopeDistributionCache_formula)
+    formula_distributions_.clear();
+  }
+
 }
@@ -39,6 +39,11 @@
 #include <OpenMS/METADATA/DataProcessing.h>
 #include <OpenMS/CHEMISTRY/ProteaseDB.h>
 #include <fstream>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -850,49 +855,51 @@ namespace OpenMS
     }
     os << "\t</mapList>\n";
 
-    // write all consensus elements
+    // write all consensus elements (formatted in parallel chunks and written in order)
     os << "\t<consensusElementList>\n";
-    for (Size i = 0; i < consensus_map.size(); ++i)
-    {
-      setProgress(++progress_);
-      // write a consensusElement
-      const ConsensusFeature& elem = consensus_map[i];
-      os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
-      if (elem.getCharge() != 0)
-      {
-        os << " charge=\"" << elem.getCharge() << "\"";
-      }
-      os << ">\n";
-      // write centroid
-      os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
-        elem.getIntensity()) << "\"/>\n";
-      // write groupedElementList
-      os << "\t\t\t<groupedElementList>\n";
-      for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
+    writeElementsChunked_(os, consensus_map.size(),
+      [&](std::ostream& chunk_os, Size i)
       {
-        os << "\t\t\t\t<element"
-              " map=\"" << it->getMapIndex() << "\""
-                                                " id=\"" << it->getUniqueId() << "\""
-                                                                                 " rt=\"" << precisionWrapper(it->getRT()) << "\""
-                                                                                                                              " mz=\"" << precisionWrapper(it->getMZ()) << "\""
-                                                                                                                                                                           " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
-        if (it->getCharge() != 0)
+        // write a consensusElement
+        const ConsensusFeature& elem = consensus_map[i];
+        chunk_os << "\t\t<consensusElement id=\"e_" << elem.getUniqueId() << "\" quality=\"" << precisionWrapper(elem.getQuality()) << "\"";
+        if (elem.getCharge() != 0)
         {
-          os << " charge=\"" << it->getCharge() << "\"";
+          chunk_os << " charge=\"" << elem.getCharge() << "\"";
         }
-        os << "/>\n";
-      }
-      os << "\t\t\t</groupedElementList>\n";
+        chunk_os << ">\n";
+        // write centroid
+        chunk_os << "\t\t\t<centroid rt=\"" << precisionWrapper(elem.getRT()) << "\" mz=\"" << precisionWrapper(elem.getMZ()) << "\" it=\"" << precisionWrapper(
+          elem.getIntensity()) << "\"/>\n";
+        // write groupedElementList
+        chunk_os << "\t\t\t<groupedElementList>\n";
+        for (ConsensusFeature::HandleSetType::const_iterator it = elem.begin(); it != elem.end(); ++it)
+        {
+          chunk_os << "\t\t\t\t<element"
+                      " map=\"" << it->getMapIndex() << "\""
+                      " id=\"" << it->getUniqueId() << "\""
+                      " rt=\"" << precisionWrapper(it->getRT()) << "\""
+                      " mz=\"" << precisionWrapper(it->getMZ()) << "\""
+                      " it=\"" << precisionWrapper(it->getIntensity()) << "\"";
+          if (it->getCharge() != 0)
+          {
+            chunk_os << " charge=\"" << it->getCharge() << "\"";
+          }
+          chunk_os << "/>\n";
+        }
+        chunk_os << "\t\t\t</groupedElementList>\n";
 
-      // write PeptideIdentification
-      for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
-      {
-        writePeptideIdentification_(filename, os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
-      }
+        // write PeptideIdentification
+        for (UInt j = 0; j < elem.getPeptideIdentifications().size(); ++j)
+        {
+          writePeptideIdentification_(filename, chunk_os, elem.getPeptideIdentifications()[j], "PeptideIdentification", 3);
+        }
 
-      writeUserParam_("UserParam", os, elem, 3);
-      os << "\t\t</consensusElement>\n";
-    }
+        writeUserParam_("UserParam", chunk_os, elem, 3);
+        chunk_os << "\t\t</consensusElement>\n";
+      },
+      [&](Size written) { setProgress(progress_ + written); });
+    progress_ += consensus_map.size();
     os << "\t</consensusElementList>\n";
 
     os << "</consensusXML>\n";
@@ -916,7 +923,41 @@ namespace OpenMS
     consensus_map_->setLoadedFileType(file_);
     consensus_map_->setLoadedFilePath(file_);
 
-    parse_(filename, this);
+    // consensus elements of large files are parsed in parallel chunks, each into a separate map
+    bool parsed = false;
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1)
+    {
+      std::vector<std::unique_ptr<ConsensusXMLFile> > workers;
+      std::vector<std::unique_ptr<ConsensusMap> > chunk_maps;
+      parsed = parseChunked_(filename, this, "consensusElementList", "consensusElement", "consensusElementList", 1000,
+        [&](Size /*chunk*/) -> Internal::XMLHandler*
+        {
+          chunk_maps.emplace_back(new ConsensusMap());
+          workers.emplace_back(new ConsensusXMLFile());
+          ConsensusXMLFile& worker = *workers.back();
+          worker.file_ = file_;
+          worker.options_ = options_;
+          worker.consensus_map_ = chunk_maps.back().get();
+          worker.id_identifier_ = id_identifier_;
+          worker.proteinid_to_accession_ = proteinid_to_accession_;
+          return &worker;
+        },
+        [&](Size chunk)
+        {
+          ConsensusMap& chunk_map = *chunk_maps[chunk];
+          const Size offset = consensus_map_->size();
+          consensus_map_->resize(offset + chunk_map.size());
+          std::move(chunk_map.begin(), chunk_map.end(), consensus_map_->begin() + offset);
+          chunk_maps[chunk].reset();
+          workers[chunk].reset();
+        });
+    }
+#endif
+    if (!parsed)
+    {
+      parse_(filename, this);
+    }
 
     if (!map.isMapConsistent(&OpenMS_Log_warn)) // a warning is printed to LOG_WARN during isMapConsistent()
     {
@@ -950,14 +991,19 @@ namespace OpenMS
   {
     String indent = String(indentation_level, '\t');
 
-    if (!identifier_id_.has(id.getIdentifier()))
+    // consensus elements may be written concurrently, so the maps are only read here
+    Map<String, String>::const_iterator run_id = identifier_id_.find(id.getIdentifier());
+    if (run_id == identifier_id_.end())
     {
+#ifdef _OPENMP
+#pragma omp critical (XMLHandler_warning)
+#endif
       warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier()
               + "' while writing '" + filename + "'!");
       return;
     }
     os << indent << "<" << tag_name << " ";
-    os << "identification_run_ref=\"" << identifier_id_[id.getIdentifier()] << "\" ";
+    os << "identification_run_ref=\"" << run_id->second << "\" ";
     os << "score_type=\"" << writeXMLEscape(id.getScoreType()) << "\" ";
     os << "higher_score_better=\"" << (id.isHigherScoreBetter() ? "true" : "false") << "\" ";
     os << "significance_threshold=\"" << id.getSignificanceThreshold() << "\" ";
@@ -1005,7 +1051,8 @@ namespace OpenMS
         if (!protein_accession.empty())
         {
           accs += "PH_";
-          accs += String(accession_to_id_[id.getIdentifier() + "_" + protein_accession]);
+          std::unordered_map<std::string, UInt>::const_iterator acc_id = accession_to_id_.find(id.getIdentifier() + "_" + protein_accession);
+          accs += String(acc_id != accession_to_id_.end() ? acc_id->second : 0);
         }
       }
 
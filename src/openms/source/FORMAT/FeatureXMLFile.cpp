@@ -41,6 +41,11 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 
 #include <fstream>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -112,7 +117,41 @@ namespace OpenMS
     map_->setLoadedFileType(file_);
     map_->setLoadedFilePath(file_);
 
-    parse_(filename, this);
+    // features of large files are parsed in parallel chunks, each into a separate map
+    bool parsed = false;
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1 && !options_.getMetadataOnly())
+    {
+      std::vector<std::unique_ptr<FeatureXMLFile> > workers;
+      std::vector<std::unique_ptr<FeatureMap> > chunk_maps;
+      parsed = parseChunked_(filename, this, "featureList", "feature", "featureMap", 1000,
+        [&](Size /*chunk*/) -> Internal::XMLHandler*
+        {
+          chunk_maps.emplace_back(new FeatureMap());
+          workers.emplace_back(new FeatureXMLFile());
+          FeatureXMLFile& worker = *workers.back();
+          worker.file_ = file_;
+          worker.options_ = options_;
+          worker.map_ = chunk_maps.back().get();
+          worker.id_identifier_ = id_identifier_;
+          worker.proteinid_to_accession_ = proteinid_to_accession_;
+          return &worker;
+        },
+        [&](Size chunk)
+        {
+          FeatureMap& chunk_map = *chunk_maps[chunk];
+          const Size offset = map_->size();
+          map_->resize(offset + chunk_map.size());
+          std::move(chunk_map.begin(), chunk_map.end(), map_->begin() + offset);
+          chunk_maps[chunk].reset();
+          workers[chunk].reset();
+        });
+    }
+#endif
+    if (!parsed)
+    {
+      parse_(filename, this);
+    }
 
     // !!! Hack: set feature FWHM from meta info entries as
     // long as featureXML doesn't support a width entry.
@@ -307,12 +346,13 @@ namespace OpenMS
     // write features with their corresponding attributes
     os << "\t<featureList count=\"" << feature_map.size() << "\">\n";
     startProgress(0, feature_map.size(), "Storing featureXML file");
-    for (Size s = 0; s < feature_map.size(); s++)
-    {
-      writeFeature_(filename, os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
-      setProgress(s);
-      // writeFeature_(filename, os, feature_map[s], "f_", s, 0);
-    }
+    // features are formatted in parallel chunks and written in order
+    writeElementsChunked_(os, feature_map.size(),
+      [&](std::ostream& chunk_os, Size s)
+      {
+        writeFeature_(filename, chunk_os, feature_map[s], "f_", feature_map[s].getUniqueId(), 0);
+      },
+      [&](Size written) { setProgress(written); });
     endProgress();
 
     os << "\t</featureList>\n";
@@ -1039,13 +1079,18 @@ namespace OpenMS
   {
     String indent = String(indentation_level, '\t');
 
-    if (!identifier_id_.has(id.getIdentifier()))
+    // features may be written concurrently, so the maps are only read here
+    Map<String, String>::const_iterator run_id = identifier_id_.find(id.getIdentifier());
+    if (run_id == identifier_id_.end())
     {
+#ifdef _OPENMP
+#pragma omp critical (XMLHandler_warning)
+#endif
       warning(STORE, String("Omitting peptide identification because of missing ProteinIdentification with identifier '") + id.getIdentifier() + "' while writing '" + filename + "'!");
       return;
     }
     os << indent << "<" << tag_name << " ";
-    os << "identification_run_ref=\"" << identifier_id_[id.getIdentifier()] << "\" ";
+    os << "identification_run_ref=\"" << run_id->second << "\" ";
     os << "score_type=\"" << writeXMLEscape(id.getScoreType()) << "\" ";
     os << "higher_score_better=\"" << (id.isHigherScoreBetter() ? "true" : "false") << "\" ";
     os << "significance_threshold=\"" << id.getSignificanceThreshold() << "\" ";
@@ -1094,7 +1139,8 @@ namespace OpenMS
         if (!protein_accession.empty())
         {
           accs += "PH_";
-          accs += String(accession_to_id_[id.getIdentifier() + "_" + protein_accession]);
+          Map<String, Size>::const_iterator acc_id = accession_to_id_.find(id.getIdentifier() + "_" + protein_accession);
+          accs += String(acc_id != accession_to_id_.end() ? acc_id->second : 0);
         }
       }
 
@@ -39,6 +39,9 @@
 #include <OpenMS/FORMAT/MzXMLFile.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/FORMAT/MzIdentMLFile.h>
 #include <OpenMS/FORMAT/MzDataFile.h>
 #include <OpenMS/FORMAT/MascotGenericFile.h>
 #include <OpenMS/FORMAT/MS2File.h>
@@ -163,6 +166,12 @@ namespace OpenMS
     // so far, compression is only supported for XML files
     vector<String> complete_file;
 
+    // binary formats are recognized by their magic number
+    if (IdBinaryFile::isIdBinaryFile(filename))
+    {
+      return FileTypes::IDBIN;
+    }
+
     // test whether the file is compressed (bzip2 or gzip)
     ifstream compressed_file(filename.c_str());
     char bz[2];
@@ -561,6 +570,65 @@ if (first_line.hasSubstring("File	First Scan	Last Scan	Num of Scans	Charge	Monoi
     return true;
   }
 
+  bool FileHandler::loadIdentifications(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type)
+  {
+    //determine file type
+    FileTypes::Type type;
+    if (force_type != FileTypes::UNKNOWN)
+    {
+      type = force_type;
+    }
+    else
+    {
+      try
+      {
+        type = getType(filename);
+      }
+      catch ( Exception::FileNotFound& )
+      {
+        return false;
+      }
+    }
+
+    //load right file
+    if (type == FileTypes::IDXML)
+    {
+      IdXMLFile().load(filename, protein_ids, peptide_ids);
+    }
+    else if (type == FileTypes::MZIDENTML)
+    {
+      MzIdentMLFile().load(filename, protein_ids, peptide_ids);
+    }
+    else if (type == FileTypes::IDBIN)
+    {
+      IdBinaryFile().load(filename, protein_ids, peptide_ids);
+    }
+    else
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  void FileHandler::storeIdentifications(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids)
+  {
+    switch (getTypeByFileName(filename))
+    {
+    case FileTypes::MZIDENTML:
+      MzIdentMLFile().store(filename, protein_ids, peptide_ids);
+      break;
+
+    case FileTypes::IDBIN:
+      IdBinaryFile().store(filename, protein_ids, peptide_ids);
+      break;
+
+    default:
+      IdXMLFile().store(filename, protein_ids, peptide_ids);
+      break;
+    }
+  }
+
   bool FileHandler::loadExperiment(const String& filename, PeakMap& exp, FileTypes::Type force_type, ProgressLogger::LogType log, const bool rewrite_source_file, const bool compute_hash)
   {
     // setting the flag for hash recomputation only works if source file entries are rewritten
@@ -39,7 +39,13 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/METADATA/ProteinIdentification.h>
 
+#include <exception>
 #include <set>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 using namespace xercesc;
@@ -198,6 +204,64 @@ namespace OpenMS
       }
     }
 
+    void XMLHandler::writeElementsChunked_(std::ostream& os, Size count, const std::function<void(std::ostream&, Size)>& write_element,
+                                           const std::function<void(Size)>& written, Size chunk_size)
+    {
+      chunk_size = std::max(chunk_size, Size(1));
+      const Size chunk_count = (count + chunk_size - 1) / chunk_size;
+
+      // buffer a few chunks per thread at a time, to limit the memory used by the buffers
+      Size chunks_per_round = 1;
+#ifdef _OPENMP
+      chunks_per_round = 2 * Size(omp_get_max_threads());
+#endif
+      vector<string> buffers(std::min(chunks_per_round, chunk_count));
+
+      for (Size round_begin = 0; round_begin < chunk_count; round_begin += chunks_per_round)
+      {
+        const SignedSize round_size = SignedSize(std::min(chunks_per_round, chunk_count - round_begin));
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (SignedSize c = 0; c < round_size; ++c)
+        {
+          try
+          {
+            ostringstream buffer;
+            buffer.precision(os.precision());
+            buffer.flags(os.flags());
+            const Size begin = (round_begin + c) * chunk_size;
+            const Size end = std::min(begin + chunk_size, count);
+            for (Size i = begin; i < end; ++i)
+            {
+              write_element(buffer, i);
+            }
+            buffers[c] = buffer.str();
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (XMLHandler_writeElementsChunked)
+#endif
+            if (!error) error = std::current_exception();
+          }
+        }
+        if (error)
+        {
+          std::rethrow_exception(error);
+        }
+
+        // write in element order
+        for (SignedSize c = 0; c < round_size; ++c)
+        {
+          os.write(buffers[c].data(), buffers[c].size());
+          string().swap(buffers[c]);
+        }
+        written(std::min((round_begin + Size(round_size)) * chunk_size, count));
+      }
+    }
+
     void XMLHandler::writeUserParam_(const String& tag_name, std::ostream& os, const MetaInfoInterface& meta, UInt indent) const
     {
       std::vector<String> keys;
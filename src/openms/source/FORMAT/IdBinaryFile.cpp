@@ -0,0 +1,1193 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/FORMAT/ZlibCompression.h>
+#include <OpenMS/METADATA/MetaInfoRegistry.h>
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    // file layout:
+    //   header:    magic (8 bytes), version (UInt32), byte order mark (UInt32)
+    //   blocks:    one zlib-compressed block per column
+    //   directory: number of columns (UInt32), then per column: name, offset, compressed size, raw size (UInt64 each)
+    //   footer:    offset of the directory (UInt64), magic (8 bytes)
+    //
+    // raw column block:
+    //   kind (UInt8), number of rows (UInt64), dictionary size (UInt32), dictionary strings,
+    //   [KIND_VARIABLE only: byte length of each row (UInt32)], row data
+    const char IDBIN_MAGIC[8] = {'O', 'M', 'S', 'I', 'D', 'B', 'I', 'N'};
+    const UInt32 IDBIN_VERSION = 1;
+    const UInt32 IDBIN_BYTE_ORDER = 0x01020304;
+    const Size IDBIN_HEADER_SIZE = sizeof(IDBIN_MAGIC) + 2 * sizeof(UInt32);
+    const Size IDBIN_FOOTER_SIZE = sizeof(UInt64) + sizeof(IDBIN_MAGIC);
+
+    const char* const COLUMN_HIT_COUNT = "peptide_id.hit_count";
+    const char* const COLUMN_PROTEINS = "proteins";
+    const char* const PEPTIDE_META_PREFIX = "peptide_id.meta:";
+    const char* const HIT_META_PREFIX = "hit.meta:";
+
+    enum ColumnKind
+    {
+      KIND_DOUBLE,   ///< one double per row
+      KIND_INT,      ///< one Int32 per row
+      KIND_FLAG,     ///< one byte per row
+      KIND_STRING,   ///< one dictionary index (UInt32) per row
+      KIND_VARIABLE  ///< a variable number of bytes per row (zero bytes: no value)
+    };
+
+    Size fixedWidth(ColumnKind kind)
+    {
+      switch (kind)
+      {
+        case KIND_DOUBLE: return sizeof(double);
+        case KIND_INT: return sizeof(Int32);
+        case KIND_FLAG: return sizeof(std::uint8_t);
+        case KIND_STRING: return sizeof(UInt32);
+        default: return 0;
+      }
+    }
+
+    /// Collects the rows of one column and serializes them to a raw block
+    class ColumnWriter
+    {
+    public:
+      explicit ColumnWriter(ColumnKind kind) :
+        kind_(kind),
+        rows_(0),
+        row_start_(0)
+      {
+      }
+
+      template <typename T>
+      void put(T value)
+      {
+        payload_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+      }
+
+      void putString(const String& s)
+      {
+        auto it = dict_index_.find(s);
+        if (it == dict_index_.end())
+        {
+          it = dict_index_.emplace(s, UInt32(dict_.size())).first;
+          dict_.push_back(s);
+        }
+        put<UInt32>(it->second);
+      }
+
+      void putStrings(const vector<String>& strings)
+      {
+        put<UInt32>(UInt32(strings.size()));
+        for (const String& s : strings)
+        {
+          putString(s);
+        }
+      }
+
+      void putValue(const DataValue& value)
+      {
+        put<std::uint8_t>(std::uint8_t(value.valueType()));
+        switch (value.valueType())
+        {
+          case DataValue::STRING_VALUE:
+            putString(value.toString());
+            break;
+          case DataValue::INT_VALUE:
+            put<Int64>(Int64(value));
+            break;
+          case DataValue::DOUBLE_VALUE:
+            put<double>(double(value));
+            break;
+          case DataValue::STRING_LIST:
+            putStrings(value.toStringList());
+            break;
+          case DataValue::INT_LIST:
+          {
+            IntList list = value.toIntList();
+            put<UInt32>(UInt32(list.size()));
+            for (Int i : list) put<Int32>(i);
+            break;
+          }
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList list = value.toDoubleList();
+            put<UInt32>(UInt32(list.size()));
+            for (double d : list) put<double>(d);
+            break;
+          }
+          default: // EMPTY_VALUE
+            break;
+        }
+      }
+
+      void putMetaValues(const MetaInfoInterface& meta)
+      {
+        vector<String> keys;
+        meta.getKeys(keys);
+        put<UInt32>(UInt32(keys.size()));
+        for (const String& key : keys)
+        {
+          putString(key);
+          putValue(meta.getMetaValue(key));
+        }
+      }
+
+      /// Finishes the current row (for fixed-width columns: after exactly one put())
+      void endRow()
+      {
+        if (kind_ == KIND_VARIABLE)
+        {
+          lengths_.push_back(UInt32(payload_.size() - row_start_));
+          row_start_ = payload_.size();
+        }
+        ++rows_;
+      }
+
+      /// Returns the raw block
+      std::string finish() const
+      {
+        std::string raw;
+        raw.push_back(char(kind_));
+        raw.append(reinterpret_cast<const char*>(&rows_), sizeof(rows_));
+        UInt32 dict_size(dict_.size());
+        raw.append(reinterpret_cast<const char*>(&dict_size), sizeof(dict_size));
+        for (const String& s : dict_)
+        {
+          UInt32 length(s.size());
+          raw.append(reinterpret_cast<const char*>(&length), sizeof(length));
+          raw.append(s);
+        }
+        if (!lengths_.empty())
+        {
+          raw.append(reinterpret_cast<const char*>(lengths_.data()), lengths_.size() * sizeof(UInt32));
+        }
+        raw.append(payload_);
+        return raw;
+      }
+
+    private:
+      ColumnKind kind_;
+      UInt64 rows_;
+      Size row_start_;
+      vector<String> dict_;
+      unordered_map<std::string, UInt32> dict_index_;
+      vector<UInt32> lengths_;
+      std::string payload_;
+    };
+
+    /// Reads values of one row of a decoded column
+    class RowCursor
+    {
+    public:
+      RowCursor(const char* begin, const char* end, const vector<String>& dict) :
+        pos_(begin),
+        end_(end),
+        dict_(dict)
+      {
+      }
+
+      bool atEnd() const
+      {
+        return pos_ == end_;
+      }
+
+      template <typename T>
+      T get()
+      {
+        if (Size(end_ - pos_) < sizeof(T))
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Column data is truncated.");
+        }
+        T value;
+        memcpy(&value, pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+      }
+
+      const String& getString()
+      {
+        UInt32 index = get<UInt32>();
+        if (index >= dict_.size())
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(index), "Invalid dictionary index in column data.");
+        }
+        return dict_[index];
+      }
+
+      vector<String> getStrings()
+      {
+        vector<String> strings(get<UInt32>());
+        for (String& s : strings)
+        {
+          s = getString();
+        }
+        return strings;
+      }
+
+      DataValue getValue()
+      {
+        switch (DataValue::DataType(get<std::uint8_t>()))
+        {
+          case DataValue::STRING_VALUE:
+            return DataValue(getString());
+          case DataValue::INT_VALUE:
+            return DataValue(get<Int64>());
+          case DataValue::DOUBLE_VALUE:
+            return DataValue(get<double>());
+          case DataValue::STRING_LIST:
+            return DataValue(StringList(getStrings()));
+          case DataValue::INT_LIST:
+          {
+            IntList list(get<UInt32>());
+            for (Int& i : list) i = get<Int32>();
+            return DataValue(list);
+          }
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList list(get<UInt32>());
+            for (double& d : list) d = get<double>();
+            return DataValue(list);
+          }
+          default:
+            return DataValue::EMPTY;
+        }
+      }
+
+      void getMetaValues(MetaInfoInterface& meta)
+      {
+        UInt32 count = get<UInt32>();
+        for (UInt32 i = 0; i < count; ++i)
+        {
+          const String& key = getString();
+          meta.setMetaValue(key, getValue());
+        }
+      }
+
+    private:
+      const char* pos_;
+      const char* end_;
+      const vector<String>& dict_;
+    };
+
+    /// A decompressed column block
+    class ColumnReader
+    {
+    public:
+      ColumnReader() :
+        kind(KIND_DOUBLE),
+        rows(0),
+        data_start_(0)
+      {
+      }
+
+      /// Decodes the block header and dictionary (and the row offsets of variable-length columns)
+      void parse(std::string&& raw)
+      {
+        raw_ = std::move(raw);
+        RowCursor header(raw_.data(), raw_.data() + raw_.size(), dict);
+        std::uint8_t kind_value = header.get<std::uint8_t>();
+        if (kind_value > KIND_VARIABLE)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(kind_value), "Unknown column type.");
+        }
+        kind = ColumnKind(kind_value);
+        rows = header.get<UInt64>();
+        UInt32 dict_size = header.get<UInt32>();
+        if (dict_size > raw_.size())
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Column dictionary is truncated.");
+        }
+        dict.resize(dict_size);
+        Size pos = sizeof(std::uint8_t) + sizeof(UInt64) + sizeof(UInt32);
+        for (String& s : dict)
+        {
+          UInt32 length = RowCursor(raw_.data() + pos, raw_.data() + raw_.size(), dict).get<UInt32>();
+          pos += sizeof(UInt32);
+          if (raw_.size() - pos < length)
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Column dictionary is truncated.");
+          }
+          s.assign(raw_.data() + pos, length);
+          pos += length;
+        }
+
+        Size data_size;
+        if (kind == KIND_VARIABLE)
+        {
+          if ((raw_.size() - pos) / sizeof(UInt32) < rows)
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Column data is truncated.");
+          }
+          offsets_.resize(rows + 1);
+          offsets_[0] = pos + rows * sizeof(UInt32);
+          for (Size i = 0; i < rows; ++i)
+          {
+            UInt32 length;
+            memcpy(&length, raw_.data() + pos + i * sizeof(UInt32), sizeof(UInt32));
+            offsets_[i + 1] = offsets_[i] + length;
+          }
+          data_size = offsets_[rows] - offsets_[0];
+          pos = offsets_[0];
+        }
+        else
+        {
+          data_size = rows * fixedWidth(kind);
+        }
+        if (raw_.size() < pos || raw_.size() - pos != data_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "Column data has unexpected size.");
+        }
+        data_start_ = pos;
+      }
+
+      RowCursor row(Size index) const
+      {
+        const char* data = raw_.data();
+        if (kind == KIND_VARIABLE)
+        {
+          return RowCursor(data + offsets_[index], data + offsets_[index + 1], dict);
+        }
+        Size width = fixedWidth(kind);
+        return RowCursor(data + data_start_ + index * width, data + data_start_ + (index + 1) * width, dict);
+      }
+
+      ColumnKind kind;
+      UInt64 rows;
+      vector<String> dict;
+
+    private:
+      std::string raw_;
+      Size data_start_;
+      vector<Size> offsets_;
+    };
+
+    struct DirectoryEntry
+    {
+      String name;
+      UInt64 offset;
+      UInt64 compressed_size;
+      UInt64 raw_size;
+    };
+
+    template <typename T>
+    void writeValue(ostream& os, T value)
+    {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T readValue(istream& is, const String& filename)
+    {
+      T value;
+      if (!is.read(reinterpret_cast<char*>(&value), sizeof(T)))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "idBin file is truncated.");
+      }
+      return value;
+    }
+
+    /// Checks header and footer and reads the column directory
+    vector<DirectoryEntry> readDirectory(istream& is, const String& filename)
+    {
+      is.seekg(0, ios::end);
+      UInt64 file_size = is.tellg();
+      if (file_size < IDBIN_HEADER_SIZE + IDBIN_FOOTER_SIZE)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "File is too small to be an idBin file.");
+      }
+
+      is.seekg(0);
+      char magic[sizeof(IDBIN_MAGIC)];
+      is.read(magic, sizeof(magic));
+      if (memcmp(magic, IDBIN_MAGIC, sizeof(magic)) != 0)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Not an idBin file.");
+      }
+      UInt32 version = readValue<UInt32>(is, filename);
+      if (readValue<UInt32>(is, filename) != IDBIN_BYTE_ORDER)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "idBin file was created on a platform with different endianness.");
+      }
+      if (version != IDBIN_VERSION)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Unsupported idBin version " + String(version) + " (expected " + String(IDBIN_VERSION) + ").");
+      }
+
+      is.seekg(file_size - IDBIN_FOOTER_SIZE);
+      UInt64 directory_offset = readValue<UInt64>(is, filename);
+      is.read(magic, sizeof(magic));
+      if (!is || memcmp(magic, IDBIN_MAGIC, sizeof(magic)) != 0 ||
+          directory_offset < IDBIN_HEADER_SIZE || directory_offset > file_size - IDBIN_FOOTER_SIZE)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "idBin file is truncated or corrupt.");
+      }
+
+      is.seekg(directory_offset);
+      vector<DirectoryEntry> directory(readValue<UInt32>(is, filename));
+      for (DirectoryEntry& entry : directory)
+      {
+        UInt32 length = readValue<UInt32>(is, filename);
+        if (length > file_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "idBin column directory is corrupt.");
+        }
+        std::string name(length, '\0');
+        is.read(&name[0], length);
+        entry.name = name;
+        entry.offset = readValue<UInt64>(is, filename);
+        entry.compressed_size = readValue<UInt64>(is, filename);
+        entry.raw_size = readValue<UInt64>(is, filename);
+        if (entry.offset < IDBIN_HEADER_SIZE || entry.offset + entry.compressed_size > directory_offset)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "idBin column directory is corrupt.");
+        }
+      }
+      return directory;
+    }
+
+    void writeProteinIdentification(ColumnWriter& col, const ProteinIdentification& prot_id)
+    {
+      col.putString(prot_id.getIdentifier());
+      col.putString(prot_id.getSearchEngine());
+      col.putString(prot_id.getSearchEngineVersion());
+      col.putString(prot_id.getDateTime().get());
+      col.putString(prot_id.getScoreType());
+      col.put<std::uint8_t>(prot_id.isHigherScoreBetter());
+      col.put<double>(prot_id.getSignificanceThreshold());
+
+      const ProteinIdentification::SearchParameters& params = prot_id.getSearchParameters();
+      col.putString(params.db);
+      col.putString(params.db_version);
+      col.putString(params.taxonomy);
+      col.putString(params.charges);
+      col.put<std::uint8_t>(params.mass_type);
+      col.putStrings(params.fixed_modifications);
+      col.putStrings(params.variable_modifications);
+      col.put<UInt32>(params.missed_cleavages);
+      col.put<double>(params.fragment_mass_tolerance);
+      col.put<std::uint8_t>(params.fragment_mass_tolerance_ppm);
+      col.put<double>(params.precursor_mass_tolerance);
+      col.put<std::uint8_t>(params.precursor_mass_tolerance_ppm);
+      col.putString(params.digestion_enzyme.getName());
+      col.putMetaValues(params);
+
+      col.put<UInt32>(UInt32(prot_id.getHits().size()));
+      for (const ProteinHit& hit : prot_id.getHits())
+      {
+        col.put<double>(hit.getScore());
+        col.put<UInt32>(hit.getRank());
+        col.putString(hit.getAccession());
+        col.putString(hit.getSequence());
+        col.put<double>(hit.getCoverage());
+        col.putMetaValues(hit);
+      }
+
+      for (const vector<ProteinIdentification::ProteinGroup>* groups : {&prot_id.getProteinGroups(), &prot_id.getIndistinguishableProteins()})
+      {
+        col.put<UInt32>(UInt32(groups->size()));
+        for (const ProteinIdentification::ProteinGroup& group : *groups)
+        {
+          col.put<double>(group.probability);
+          col.putStrings(group.accessions);
+        }
+      }
+
+      col.putMetaValues(prot_id);
+    }
+
+    void readProteinIdentification(RowCursor row, ProteinIdentification& prot_id)
+    {
+      prot_id.setIdentifier(row.getString());
+      prot_id.setSearchEngine(row.getString());
+      prot_id.setSearchEngineVersion(row.getString());
+      const String& date = row.getString();
+      if (date != DateTime().get()) // not an invalid (unset) date
+      {
+        DateTime date_time;
+        date_time.set(date);
+        prot_id.setDateTime(date_time);
+      }
+      prot_id.setScoreType(row.getString());
+      prot_id.setHigherScoreBetter(row.get<std::uint8_t>() != 0);
+      prot_id.setSignificanceThreshold(row.get<double>());
+
+      ProteinIdentification::SearchParameters params;
+      params.db = row.getString();
+      params.db_version = row.getString();
+      params.taxonomy = row.getString();
+      params.charges = row.getString();
+      params.mass_type = ProteinIdentification::PeakMassType(row.get<std::uint8_t>());
+      params.fixed_modifications = row.getStrings();
+      params.variable_modifications = row.getStrings();
+      params.missed_cleavages = row.get<UInt32>();
+      params.fragment_mass_tolerance = row.get<double>();
+      params.fragment_mass_tolerance_ppm = row.get<std::uint8_t>() != 0;
+      params.precursor_mass_tolerance = row.get<double>();
+      params.precursor_mass_tolerance_ppm = row.get<std::uint8_t>() != 0;
+      const String& enzyme = row.getString();
+      if (ProteaseDB::getInstance()->hasEnzyme(enzyme))
+      {
+        params.digestion_enzyme = *(ProteaseDB::getInstance()->getEnzyme(enzyme));
+      }
+      row.getMetaValues(params);
+      prot_id.setSearchParameters(std::move(params));
+
+      vector<ProteinHit>& hits = prot_id.getHits();
+      hits.resize(row.get<UInt32>());
+      for (ProteinHit& hit : hits)
+      {
+        hit.setScore(row.get<double>());
+        hit.setRank(row.get<UInt32>());
+        hit.setAccession(row.getString());
+        hit.setSequence(row.getString());
+        hit.setCoverage(row.get<double>());
+        row.getMetaValues(hit);
+      }
+
+      for (vector<ProteinIdentification::ProteinGroup>* groups : {&prot_id.getProteinGroups(), &prot_id.getIndistinguishableProteins()})
+      {
+        groups->resize(row.get<UInt32>());
+        for (ProteinIdentification::ProteinGroup& group : *groups)
+        {
+          group.probability = row.get<double>();
+          group.accessions = row.getStrings();
+        }
+      }
+
+      row.getMetaValues(prot_id);
+    }
+
+    /// Calls @p func for all peptide hits, in order
+    void forEachHit(const vector<PeptideIdentification>& peptide_ids, const std::function<void(const PeptideHit&)>& func)
+    {
+      for (const PeptideIdentification& pep_id : peptide_ids)
+      {
+        for (const PeptideHit& hit : pep_id.getHits())
+        {
+          func(hit);
+        }
+      }
+    }
+
+    /// Sets one attribute of a peptide identification (or hit) from the given row of a decoded column
+    typedef std::function<void(PeptideIdentification&, Size)> PeptideSetter;
+    typedef std::function<void(PeptideHit&, Size)> HitSetter;
+  }
+
+  IdBinaryFile::IdBinaryFile() :
+    ProgressLogger()
+  {
+  }
+
+  void IdBinaryFile::setColumnFilter(const StringList& columns)
+  {
+    column_filter_ = columns;
+  }
+
+  const StringList& IdBinaryFile::getColumnFilter() const
+  {
+    return column_filter_;
+  }
+
+  bool IdBinaryFile::isSelected_(const String& name) const
+  {
+    if (column_filter_.empty() || name == COLUMN_HIT_COUNT)
+    {
+      return true;
+    }
+    for (const String& filter : column_filter_)
+    {
+      if (filter.hasSuffix("*") ? name.hasPrefix(filter.prefix(filter.size() - 1)) : name == filter)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool IdBinaryFile::isIdBinaryFile(const String& filename)
+  {
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    char magic[sizeof(IDBIN_MAGIC)];
+    return is.read(magic, sizeof(magic)) && memcmp(magic, IDBIN_MAGIC, sizeof(magic)) == 0;
+  }
+
+  StringList IdBinaryFile::getColumnNames(const String& filename)
+  {
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    if (!is)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    StringList names;
+    for (const DirectoryEntry& entry : readDirectory(is, filename))
+    {
+      names.push_back(entry.name);
+    }
+    return names;
+  }
+
+  void IdBinaryFile::store(const String& filename, const vector<ProteinIdentification>& protein_ids, const vector<PeptideIdentification>& peptide_ids)
+  {
+    std::ofstream os(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // collect meta value keys, each key becomes a column
+    set<UInt> pep_meta_keys, hit_meta_keys;
+    vector<UInt> keys;
+    for (const PeptideIdentification& pep_id : peptide_ids)
+    {
+      keys.clear();
+      pep_id.getKeys(keys);
+      pep_meta_keys.insert(keys.begin(), keys.end());
+      for (const PeptideHit& hit : pep_id.getHits())
+      {
+        keys.clear();
+        hit.getKeys(keys);
+        hit_meta_keys.insert(keys.begin(), keys.end());
+      }
+    }
+    const MetaInfoRegistry& registry = MetaInfoInterface::metaRegistry();
+
+    // define the columns; they are filled independently of each other
+    typedef std::function<void(ColumnWriter&)> ColumnBuilder;
+    vector<pair<String, pair<ColumnKind, ColumnBuilder> > > columns;
+    auto addPeptideColumn = [&](const String& name, ColumnKind kind, const std::function<void(ColumnWriter&, const PeptideIdentification&)>& func)
+    {
+      columns.emplace_back(name, make_pair(kind, [&peptide_ids, func](ColumnWriter& col)
+      {
+        for (const PeptideIdentification& pep_id : peptide_ids)
+        {
+          func(col, pep_id);
+          col.endRow();
+        }
+      }));
+    };
+    auto addHitColumn = [&](const String& name, ColumnKind kind, const std::function<void(ColumnWriter&, const PeptideHit&)>& func)
+    {
+      columns.emplace_back(name, make_pair(kind, [&peptide_ids, func](ColumnWriter& col)
+      {
+        forEachHit(peptide_ids, [&](const PeptideHit& hit)
+        {
+          func(col, hit);
+          col.endRow();
+        });
+      }));
+    };
+
+    columns.emplace_back(COLUMN_PROTEINS, make_pair(KIND_VARIABLE, [&protein_ids](ColumnWriter& col)
+    {
+      for (const ProteinIdentification& prot_id : protein_ids)
+      {
+        writeProteinIdentification(col, prot_id);
+        col.endRow();
+      }
+    }));
+
+    addPeptideColumn(COLUMN_HIT_COUNT, KIND_INT, [](ColumnWriter& col, const PeptideIdentification& p) { col.put<Int32>(Int32(p.getHits().size())); });
+    addPeptideColumn("peptide_id.identifier", KIND_STRING, [](ColumnWriter& col, const PeptideIdentification& p) { col.putString(p.getIdentifier()); });
+    addPeptideColumn("peptide_id.score_type", KIND_STRING, [](ColumnWriter& col, const PeptideIdentification& p) { col.putString(p.getScoreType()); });
+    addPeptideColumn("peptide_id.higher_score_better", KIND_FLAG, [](ColumnWriter& col, const PeptideIdentification& p) { col.put<std::uint8_t>(p.isHigherScoreBetter()); });
+    addPeptideColumn("peptide_id.significance_threshold", KIND_DOUBLE, [](ColumnWriter& col, const PeptideIdentification& p) { col.put<double>(p.getSignificanceThreshold()); });
+    addPeptideColumn("peptide_id.rt", KIND_DOUBLE, [](ColumnWriter& col, const PeptideIdentification& p) { col.put<double>(p.getRT()); });
+    addPeptideColumn("peptide_id.mz", KIND_DOUBLE, [](ColumnWriter& col, const PeptideIdentification& p) { col.put<double>(p.getMZ()); });
+    addPeptideColumn("peptide_id.base_name", KIND_STRING, [](ColumnWriter& col, const PeptideIdentification& p) { col.putString(p.getBaseName()); });
+    for (UInt key : pep_meta_keys)
+    {
+      addPeptideColumn(PEPTIDE_META_PREFIX + registry.getName(key), KIND_VARIABLE, [key](ColumnWriter& col, const PeptideIdentification& p)
+      {
+        if (p.metaValueExists(key)) col.putValue(p.getMetaValue(key));
+      });
+    }
+
+    addHitColumn("hit.sequence", KIND_STRING, [](ColumnWriter& col, const PeptideHit& h) { col.putString(h.getSequence().toString()); });
+    addHitColumn("hit.score", KIND_DOUBLE, [](ColumnWriter& col, const PeptideHit& h) { col.put<double>(h.getScore()); });
+    addHitColumn("hit.rank", KIND_INT, [](ColumnWriter& col, const PeptideHit& h) { col.put<Int32>(Int32(h.getRank())); });
+    addHitColumn("hit.charge", KIND_INT, [](ColumnWriter& col, const PeptideHit& h) { col.put<Int32>(h.getCharge()); });
+    addHitColumn("hit.evidences", KIND_VARIABLE, [](ColumnWriter& col, const PeptideHit& h)
+    {
+      if (h.getPeptideEvidences().empty()) return;
+      col.put<UInt32>(UInt32(h.getPeptideEvidences().size()));
+      for (const PeptideEvidence& pe : h.getPeptideEvidences())
+      {
+        col.putString(pe.getProteinAccession());
+        col.put<Int32>(pe.getStart());
+        col.put<Int32>(pe.getEnd());
+        col.put<char>(pe.getAABefore());
+        col.put<char>(pe.getAAAfter());
+      }
+    });
+    addHitColumn("hit.analysis_results", KIND_VARIABLE, [](ColumnWriter& col, const PeptideHit& h)
+    {
+      if (h.getAnalysisResults().empty()) return;
+      col.put<UInt32>(UInt32(h.getAnalysisResults().size()));
+      for (const PeptideHit::PepXMLAnalysisResult& ar : h.getAnalysisResults())
+      {
+        col.putString(ar.score_type);
+        col.put<std::uint8_t>(ar.higher_is_better);
+        col.put<double>(ar.main_score);
+        col.put<UInt32>(UInt32(ar.sub_scores.size()));
+        for (const auto& sub_score : ar.sub_scores)
+        {
+          col.putString(sub_score.first);
+          col.put<double>(sub_score.second);
+        }
+      }
+    });
+    addHitColumn("hit.annotations", KIND_VARIABLE, [](ColumnWriter& col, const PeptideHit& h)
+    {
+      if (h.getPeakAnnotations().empty()) return;
+      col.put<UInt32>(UInt32(h.getPeakAnnotations().size()));
+      for (const PeptideHit::PeakAnnotation& pa : h.getPeakAnnotations())
+      {
+        col.putString(pa.annotation);
+        col.put<Int32>(pa.charge);
+        col.put<double>(pa.mz);
+        col.put<double>(pa.intensity);
+      }
+    });
+    for (UInt key : hit_meta_keys)
+    {
+      addHitColumn(HIT_META_PREFIX + registry.getName(key), KIND_VARIABLE, [key](ColumnWriter& col, const PeptideHit& h)
+      {
+        if (h.metaValueExists(key)) col.putValue(h.getMetaValue(key));
+      });
+    }
+
+    // build and compress all columns
+    vector<std::string> compressed(columns.size());
+    vector<UInt64> raw_sizes(columns.size());
+    Size progress = 0;
+    startProgress(0, columns.size(), "storing idBin file");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(columns.size()); ++i)
+    {
+      ColumnWriter col(columns[i].second.first);
+      columns[i].second.second(col);
+      std::string raw = col.finish();
+      raw_sizes[i] = raw.size();
+      ZlibCompression::compressString(raw, compressed[i]);
+#ifdef _OPENMP
+#pragma omp critical (IdBinaryFile_progress)
+#endif
+      setProgress(++progress);
+    }
+    endProgress();
+
+    // write header, blocks, directory and footer
+    os.write(IDBIN_MAGIC, sizeof(IDBIN_MAGIC));
+    writeValue<UInt32>(os, IDBIN_VERSION);
+    writeValue<UInt32>(os, IDBIN_BYTE_ORDER);
+    vector<UInt64> offsets(columns.size());
+    UInt64 offset = IDBIN_HEADER_SIZE;
+    for (Size i = 0; i < columns.size(); ++i)
+    {
+      offsets[i] = offset;
+      os.write(compressed[i].data(), compressed[i].size());
+      offset += compressed[i].size();
+    }
+    writeValue<UInt32>(os, UInt32(columns.size()));
+    for (Size i = 0; i < columns.size(); ++i)
+    {
+      writeValue<UInt32>(os, UInt32(columns[i].first.size()));
+      os.write(columns[i].first.data(), columns[i].first.size());
+      writeValue<UInt64>(os, offsets[i]);
+      writeValue<UInt64>(os, compressed[i].size());
+      writeValue<UInt64>(os, raw_sizes[i]);
+    }
+    writeValue<UInt64>(os, offset);
+    os.write(IDBIN_MAGIC, sizeof(IDBIN_MAGIC));
+
+    if (!os)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Error while writing the file.");
+    }
+  }
+
+  void IdBinaryFile::load(const String& filename, vector<ProteinIdentification>& protein_ids, vector<PeptideIdentification>& peptide_ids)
+  {
+    std::ifstream is(filename.c_str(), std::ios::binary);
+    if (!is)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // read the selected blocks (sequentially, to keep disk access linear)
+    vector<DirectoryEntry> directory = readDirectory(is, filename);
+    vector<DirectoryEntry> selected;
+    for (const DirectoryEntry& entry : directory)
+    {
+      if (isSelected_(entry.name))
+      {
+        selected.push_back(entry);
+      }
+    }
+    vector<std::string> compressed(selected.size());
+    for (Size i = 0; i < selected.size(); ++i)
+    {
+      compressed[i].resize(selected[i].compressed_size);
+      is.seekg(selected[i].offset);
+      if (!is.read(&compressed[i][0], selected[i].compressed_size))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "idBin file is truncated.");
+      }
+    }
+
+    // decompress and decode the blocks in parallel
+    startProgress(0, 3, "loading idBin file");
+    vector<ColumnReader> readers(selected.size());
+    String error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < SignedSize(selected.size()); ++i)
+    {
+      try
+      {
+        std::string raw(selected[i].raw_size, '\0');
+        uLongf raw_size = uLongf(selected[i].raw_size);
+        if (uncompress(reinterpret_cast<Bytef*>(&raw[0]), &raw_size, reinterpret_cast<const Bytef*>(compressed[i].data()), uLong(compressed[i].size())) != Z_OK ||
+            raw_size != selected[i].raw_size)
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, selected[i].name, "Column block could not be decompressed.");
+        }
+        std::string().swap(compressed[i]);
+        readers[i].parse(std::move(raw));
+      }
+      catch (Exception::BaseException& e)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IdBinaryFile_error)
+#endif
+        error = "Column '" + selected[i].name + "': " + e.what();
+      }
+    }
+    if (!error.empty())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, error);
+    }
+    setProgress(1);
+
+    // the structure: number of hits per peptide identification
+    map<String, const ColumnReader*> by_name;
+    for (Size i = 0; i < selected.size(); ++i)
+    {
+      by_name[selected[i].name] = &readers[i];
+    }
+    if (by_name.count(COLUMN_HIT_COUNT) == 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, String("Column '") + COLUMN_HIT_COUNT + "' is missing.");
+    }
+    const ColumnReader& hit_count = *by_name[COLUMN_HIT_COUNT];
+    Size n_peptide_ids = hit_count.rows;
+    vector<Size> hit_offsets(n_peptide_ids + 1, 0);
+    for (Size i = 0; i < n_peptide_ids; ++i)
+    {
+      Int32 count = hit_count.row(i).get<Int32>();
+      if (count < 0)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Negative number of peptide hits.");
+      }
+      hit_offsets[i + 1] = hit_offsets[i] + count;
+    }
+    Size n_hits = hit_offsets.back();
+
+    // peptide sequences are parsed once per distinct sequence
+    vector<AASequence> sequences;
+    if (by_name.count("hit.sequence"))
+    {
+      const vector<String>& dict = by_name["hit.sequence"]->dict;
+      sequences.resize(dict.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (SignedSize i = 0; i < SignedSize(dict.size()); ++i)
+      {
+        try
+        {
+          sequences[i] = AASequence::fromString(dict[i]);
+        }
+        catch (Exception::BaseException& e)
+        {
+#ifdef _OPENMP
+#pragma omp critical (IdBinaryFile_error)
+#endif
+          error = "Invalid peptide sequence '" + dict[i] + "': " + e.what();
+        }
+      }
+      if (!error.empty())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, error);
+      }
+    }
+    setProgress(2);
+
+    // set up one setter per selected column
+    vector<PeptideSetter> pep_setters;
+    vector<HitSetter> hit_setters;
+    for (const auto& column : by_name)
+    {
+      const String& name = column.first;
+      const ColumnReader& col = *column.second;
+      bool peptide_level = name.hasPrefix("peptide_id.");
+      bool hit_level = name.hasPrefix("hit.");
+      if (!peptide_level && !hit_level)
+      {
+        continue;
+      }
+      if (col.rows != (peptide_level ? n_peptide_ids : n_hits))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Column '" + name + "' has an unexpected number of rows.");
+      }
+
+      if (name.hasPrefix(PEPTIDE_META_PREFIX) || name.hasPrefix(HIT_META_PREFIX))
+      {
+        // register the key up front, so threads only look up the index
+        String key = name.suffix(name.size() - (peptide_level ? strlen(PEPTIDE_META_PREFIX) : strlen(HIT_META_PREFIX)));
+        UInt index = MetaInfoInterface::metaRegistry().registerName(key);
+        auto setMeta = [&col, index](MetaInfoInterface& meta, Size row)
+        {
+          RowCursor cursor = col.row(row);
+          if (!cursor.atEnd())
+          {
+            meta.setMetaValue(index, cursor.getValue());
+          }
+        };
+        if (peptide_level)
+        {
+          pep_setters.push_back(setMeta);
+        }
+        else
+        {
+          hit_setters.push_back(setMeta);
+        }
+      }
+      else if (name == "peptide_id.identifier")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setIdentifier(col.row(row).getString()); });
+      }
+      else if (name == "peptide_id.score_type")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setScoreType(col.row(row).getString()); });
+      }
+      else if (name == "peptide_id.higher_score_better")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setHigherScoreBetter(col.row(row).get<std::uint8_t>() != 0); });
+      }
+      else if (name == "peptide_id.significance_threshold")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setSignificanceThreshold(col.row(row).get<double>()); });
+      }
+      else if (name == "peptide_id.rt")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setRT(col.row(row).get<double>()); });
+      }
+      else if (name == "peptide_id.mz")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setMZ(col.row(row).get<double>()); });
+      }
+      else if (name == "peptide_id.base_name")
+      {
+        pep_setters.push_back([&col](PeptideIdentification& p, Size row) { p.setBaseName(col.row(row).getString()); });
+      }
+      else if (name == "hit.sequence")
+      {
+        hit_setters.push_back([&col, &sequences](PeptideHit& h, Size row)
+        {
+          UInt32 index = col.row(row).get<UInt32>();
+          if (index >= sequences.size())
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(index), "Invalid dictionary index in column data.");
+          }
+          h.setSequence(sequences[index]);
+        });
+      }
+      else if (name == "hit.score")
+      {
+        hit_setters.push_back([&col](PeptideHit& h, Size row) { h.setScore(col.row(row).get<double>()); });
+      }
+      else if (name == "hit.rank")
+      {
+        hit_setters.push_back([&col](PeptideHit& h, Size row) { h.setRank(UInt(col.row(row).get<Int32>())); });
+      }
+      else if (name == "hit.charge")
+      {
+        hit_setters.push_back([&col](PeptideHit& h, Size row) { h.setCharge(col.row(row).get<Int32>()); });
+      }
+      else if (name == "hit.evidences")
+      {
+        hit_setters.push_back([&col](PeptideHit& h, Size row)
+        {
+          RowCursor cursor = col.row(row);
+          if (cursor.atEnd()) return;
+          vector<PeptideEvidence> evidences(cursor.get<UInt32>());
+          for (PeptideEvidence& pe : evidences)
+          {
+            pe.setProteinAccession(cursor.getString());
+            pe.setStart(cursor.get<Int32>());
+            pe.setEnd(cursor.get<Int32>());
+            pe.setAABefore(cursor.get<char>());
+            pe.setAAAfter(cursor.get<char>());
+          }
+          h.setPeptideEvidences(std::move(evidences));
+        });
+      }
+      else if (name == "hit.analysis_results")
+      {
+        hit_setters.push_back([&col](PeptideHit& h, Size row)
+        {
+          RowCursor cursor = col.row(row);
+          if (cursor.atEnd()) return;
+          vector<PeptideHit::PepXMLAnalysisResult> results(cursor.get<UInt32>());
+          for (PeptideHit::PepXMLAnalysisResult& ar : results)
+          {
+            ar.score_type = cursor.getString();
+            ar.higher_is_better = cursor.get<std::uint8_t>() != 0;
+            ar.main_score = cursor.get<double>();
+            UInt32 n_sub_scores = cursor.get<UInt32>();
+            for (UInt32 k = 0; k < n_sub_scores; ++k)
+            {
+              const String& key = cursor.getString();
+              ar.sub_scores[key] = cursor.get<double>();
+            }
+          }
+          h.setAnalysisResults(results);
+        });
+      }
+      else if (name == "hit.annotations")
+      {
+        hit_setters.push_back([&col](PeptideHit& h, Size row)
+        {
+          RowCursor cursor = col.row(row);
+          if (cursor.atEnd()) return;
+          vector<PeptideHit::PeakAnnotation> annotations(cursor.get<UInt32>());
+          for (PeptideHit::PeakAnnotation& pa : annotations)
+          {
+            pa.annotation = cursor.getString();
+            pa.charge = cursor.get<Int32>();
+            pa.mz = cursor.get<double>();
+            pa.intensity = cursor.get<double>();
+          }
+          h.setPeakAnnotations(annotations);
+        });
+      }
+      // unknown columns (written by a newer version) are ignored
+    }
+
+    // assemble the peptide identifications in parallel
+    peptide_ids.clear();
+    peptide_ids.resize(n_peptide_ids);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for (SignedSize i = 0; i < SignedSize(n_peptide_ids); ++i)
+    {
+      try
+      {
+        PeptideIdentification& pep_id = peptide_ids[i];
+        for (const PeptideSetter& setter : pep_setters)
+        {
+          setter(pep_id, i);
+        }
+        vector<PeptideHit>& hits = pep_id.getHits();
+        hits.resize(hit_offsets[i + 1] - hit_offsets[i]);
+        for (Size j = 0; j < hits.size(); ++j)
+        {
+          for (const HitSetter& setter : hit_setters)
+          {
+            setter(hits[j], hit_offsets[i] + j);
+          }
+        }
+      }
+      catch (Exception::BaseException& e)
+      {
+#ifdef _OPENMP
+#pragma omp critical (IdBinaryFile_error)
+#endif
+        error = e.what();
+      }
+    }
+    if (!error.empty())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, error);
+    }
+
+    protein_ids.clear();
+    if (by_name.count(COLUMN_PROTEINS))
+    {
+      const ColumnReader& proteins = *by_name[COLUMN_PROTEINS];
+      protein_ids.resize(proteins.rows);
+      try
+      {
+        for (Size i = 0; i < proteins.rows; ++i)
+        {
+          readProteinIdentification(proteins.row(i), protein_ids[i]);
+        }
+      }
+      catch (Exception::BaseException& e)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, String("Column '") + COLUMN_PROTEINS + "': " + e.what());
+      }
+    }
+    endProgress();
+  }
+
+} // namespace OpenMS
@@ -35,6 +35,7 @@
 #include <OpenMS/FORMAT/MzTab.h>
 
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/DATASTRUCTURES/StringUtils.h>
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/METADATA/MetaInfoInterfaceUtils.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
@@ -1295,7 +1296,7 @@ namespace OpenMS
 
     case MZTAB_CELLSTATE_DEFAULT:
     default:
-      return String(value_);
+      return StringConversions::toStringShortest(value_);
     }
   }
 
@@ -39,6 +39,8 @@
 
 #include <boost/regex.hpp>
 
+#include <exception>
+
 using namespace std;
 
 // TODO fix all the shadowed "String s"
@@ -2887,7 +2889,69 @@ namespace OpenMS
       }
     }
   }
-    // stream IDs to file
+  template <typename SectionRow>
+  Size MzTabFile::writeMzTabSectionStreamed_(std::ostream& os,
+                                             const std::function<bool(SectionRow&)>& next_row,
+                                             const std::function<void(const SectionRow&)>& write_header,
+                                             const std::vector<String>& optional_columns,
+                                             const MzTabMetaData& meta) const
+  {
+    // rows per batch: large enough to keep all threads busy, small enough to keep the memory low
+    const Size batch_size = 10000;
+    vector<SectionRow> rows(batch_size);
+    vector<String> lines(batch_size);
+    Size n_rows(0);
+    while (true)
+    {
+      // pulling rows is sequential (the row streams are stateful)
+      Size n_batch(0);
+      while (n_batch < batch_size && next_row(rows[n_batch]))
+      {
+        ++n_batch;
+      }
+      if (n_batch == 0) break;
+
+      if (n_rows == 0)
+      {
+        write_header(rows[0]);
+      }
+
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+      for (SignedSize i = 0; i < SignedSize(n_batch); ++i)
+      {
+        try
+        {
+          lines[i] = generateMzTabSectionRow_(rows[i], optional_columns, meta);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MzTabFile_writeMzTabSectionStreamed)
+#endif
+          if (!error) error = std::current_exception();
+        }
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+
+      // write in row order
+      for (Size i = 0; i < n_batch; ++i)
+      {
+        os.write(lines[i].c_str(), lines[i].size());
+        os.put('\n');
+      }
+      n_rows += n_batch;
+      if (n_batch < batch_size) break; // stream exhausted
+    }
+    return n_rows;
+  }
+
+  // stream IDs to file
   void MzTabFile::store(
         const String& filename,
         const std::vector<ProteinIdentification>& protein_identifications,
@@ -2930,23 +2994,17 @@ namespace OpenMS
    
     Size n_best_search_engine_score = meta_data.protein_search_engine_score.size();
 
-    {
-      MzTabProteinSectionRow row;
-      bool first = true;
-      while (s.nextPRTRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabProteinHeader_(
-            row,
-            n_best_search_engine_score,
-            s.getProteinOptionalColumnNames(),
-            meta_data) + "\n";
-          first = false;
-        }
-        tab_file << generateMzTabSectionRow_(row, s.getProteinOptionalColumnNames(), meta_data) + "\n";
-      }
-    }
+    writeMzTabSectionStreamed_<MzTabProteinSectionRow>(tab_file,
+      [&s](MzTabProteinSectionRow& row) { return s.nextPRTRow(row); },
+      [&](const MzTabProteinSectionRow& row)
+      { // add header
+        tab_file << "\n" << generateMzTabProteinHeader_(
+          row,
+          n_best_search_engine_score,
+          s.getProteinOptionalColumnNames(),
+          meta_data) + "\n";
+      },
+      s.getProteinOptionalColumnNames(), meta_data);
 
     Size n_search_engine_scores = meta_data.psm_search_engine_score.size();
 
@@ -2955,26 +3013,20 @@ namespace OpenMS
       OPENMS_LOG_WARN << "No search engine scores given. Please check your input data." << endl;
     }
 
-    {
-      MzTabPSMSectionRow row;
-      bool first = true;
-      while (s.nextPSMRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames()) + "\n";
-          first = false;
-        }
-        tab_file << generateMzTabSectionRow_(row, s.getPSMOptionalColumnNames(), meta_data) + "\n";
-      }
-    }
+    writeMzTabSectionStreamed_<MzTabPSMSectionRow>(tab_file,
+      [&s](MzTabPSMSectionRow& row) { return s.nextPSMRow(row); },
+      [&](const MzTabPSMSectionRow&)
+      { // add header
+        tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames()) + "\n";
+      },
+      s.getPSMOptionalColumnNames(), meta_data);
 
     tab_file.close();
     
   }
 
   void MzTabFile::store(
-      const String& filename, 
+      const String& filename,
       const ConsensusMap& cmap,
       const bool first_run_inference_only,
       const bool export_unidentified_features,
@@ -3012,44 +3064,31 @@ namespace OpenMS
    
     Size n_best_search_engine_score = meta_data.protein_search_engine_score.size();
 
-    {
-      MzTabProteinSectionRow row;
-      bool first = true;
-      while (s.nextPRTRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabProteinHeader_(
-            row,
-            n_best_search_engine_score,
-            s.getProteinOptionalColumnNames(),
-            meta_data) + "\n";
-          first = false;
-        }
-        tab_file << generateMzTabSectionRow_(row, s.getProteinOptionalColumnNames(), meta_data) + "\n";
-      }
-    }
-
-    Size assays(0);
-    Size study_variables(0);
-    Size search_ms_runs = 0;
-    {
-      MzTabPeptideSectionRow row;
-      bool first = true;
-      while (s.nextPEPRow(row))
-      {
-        if (first)
-        {
-          assays = row.peptide_abundance_assay.size();
-          study_variables = row.peptide_abundance_study_variable.size();
-          Size n_search_engine_score = row.search_engine_score_ms_run.size();
-          Size n_best_search_engine_score = row.best_search_engine_score.size();
-          tab_file << "\n" << generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, s.getPeptideOptionalColumnNames()) + "\n";
-          first = false;
-        }
-        tab_file << generateMzTabSectionRow_(row, s.getPeptideOptionalColumnNames(), meta_data) + "\n";
-      }
-    } 
+    writeMzTabSectionStreamed_<MzTabProteinSectionRow>(tab_file,
+      [&s](MzTabProteinSectionRow& row) { return s.nextPRTRow(row); },
+      [&](const MzTabProteinSectionRow& row)
+      { // add header
+        tab_file << "\n" << generateMzTabProteinHeader_(
+          row,
+          n_best_search_engine_score,
+          s.getProteinOptionalColumnNames(),
+          meta_data) + "\n";
+      },
+      s.getProteinOptionalColumnNames(), meta_data);
+
+    writeMzTabSectionStreamed_<MzTabPeptideSectionRow>(tab_file,
+      [&s](MzTabPeptideSectionRow& row) { return s.nextPEPRow(row); },
+      [&](const MzTabPeptideSectionRow& row)
+      { // add header
+        Size assays = row.peptide_abundance_assay.size();
+        Size study_variables = row.peptide_abundance_study_variable.size();
+        Size n_search_engine_score = row.search_engine_score_ms_run.size();
+        Size n_best_search_engine_score = row.best_search_engine_score.size();
+        // as in store(filename, MzTab): report the ms_run-level scores (of all runs) if present ("Summary" mode)
+        Size search_ms_runs = row.search_engine_score_ms_run.empty() ? 0 : meta_data.ms_run.size();
+        tab_file << "\n" << generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, s.getPeptideOptionalColumnNames()) + "\n";
+      },
+      s.getPeptideOptionalColumnNames(), meta_data);
 
     Size n_search_engine_scores = meta_data.psm_search_engine_score.size();
 
@@ -3058,19 +3097,13 @@ namespace OpenMS
       OPENMS_LOG_WARN << "No search engine scores given. Please check your input data." << endl;
     }
 
-    {
-      MzTabPSMSectionRow row;
-      bool first = true;
-      while (s.nextPSMRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames()) + "\n";
-          first = false;
-        }
-        tab_file << generateMzTabSectionRow_(row, s.getPSMOptionalColumnNames(), meta_data) + "\n";
-      }
-    }
+    writeMzTabSectionStreamed_<MzTabPSMSectionRow>(tab_file,
+      [&s](MzTabPSMSectionRow& row) { return s.nextPSMRow(row); },
+      [&](const MzTabPSMSectionRow&)
+      { // add header
+        tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames()) + "\n";
+      },
+      s.getPSMOptionalColumnNames(), meta_data);
 
     tab_file.close();
   }
@@ -34,6 +34,7 @@
 
 #include <OpenMS/FORMAT/SVOutStream.h>
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/StringUtils.h>
 
 using namespace std;
 
@@ -129,6 +130,22 @@ namespace OpenMS
     return operator<<((String&)str);
   }
 
+  SVOutStream& SVOutStream::operator<<(double value)
+  {
+    if (!newline_)
+    {
+      (ostream&) *this << sep_;
+    }
+    else
+    {
+      newline_ = false;
+    }
+    char buffer[32];
+    const char* end = StringConversions::formatShortest(value, buffer);
+    ostream::write(buffer, end - buffer);
+    return *this;
+  }
+
   SVOutStream& SVOutStream::operator<<(ostream& (*fp)(ostream&))
   {
     // check for "std::endl":
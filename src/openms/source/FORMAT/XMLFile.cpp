@@ -47,11 +47,17 @@
 #include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/sax2/XMLReaderFactory.hpp>
 
+#include <exception>
 #include <fstream>
 #include <iomanip> // setprecision etc.
+#include <iterator>
 
 #include <boost/shared_ptr.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -79,6 +85,149 @@ private:
       XMLHandler * p_;
     };
 
+    namespace
+    {
+      /// Initializes Xerces. The initialization is reference counted, but not thread-safe.
+      void initializeXerces()
+      {
+        String error;
+#ifdef _OPENMP
+#pragma omp critical (XMLFile_initialize)
+#endif
+        {
+          try
+          {
+            xercesc::XMLPlatformUtils::Initialize();
+          }
+          catch (const xercesc::XMLException & toCatch)
+          {
+            error = StringManager().convert(toCatch.getMessage());
+          }
+        }
+        if (!error.empty())
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "", String("Error during initialization: ") + error);
+        }
+      }
+
+      /// Returns whether @p tag starts at position @p pos of @p document and is followed by a character that ends a tag name
+      bool tagStartsAt(const std::string & document, Size pos, const String & tag)
+      {
+        if (document.compare(pos, tag.size(), tag) != 0 || pos + tag.size() >= document.size())
+        {
+          return false;
+        }
+        const char next = document[pos + tag.size()];
+        return next == '>' || next == '/' || next == ' ' || next == '\t' || next == '\n' || next == '\r';
+      }
+
+      /**
+        @brief Locates the content of the first @p list_tag element in @p document and the ends of its top-level @p element_tag children
+
+        Comments and CDATA sections are skipped. Every @p elements_per_chunk elements, the position after the closing
+        tag is appended to @p chunk_ends. The last chunk always ends at @p content_end.
+
+        @return false if the list element (or its end) was not found
+      */
+      bool splitElementList(const std::string & document, const String & list_tag, const String & element_tag, Size elements_per_chunk,
+                            Size & content_begin, Size & content_end, std::vector<Size> & chunk_ends)
+      {
+        chunk_ends.clear();
+        const String list_open = "<" + list_tag;
+        const String list_close = "</" + list_tag;
+        const String element_open = "<" + element_tag;
+        const String element_close = "</" + element_tag;
+
+        // find the start tag of the list
+        Size pos = 0;
+        while (true)
+        {
+          pos = document.find(list_open, pos);
+          if (pos == std::string::npos)
+          {
+            return false;
+          }
+          if (tagStartsAt(document, pos + 1, list_tag))
+          {
+            break;
+          }
+          ++pos;
+        }
+        pos = document.find('>', pos);
+        if (pos == std::string::npos || document[pos - 1] == '/')
+        {
+          return false; // empty list
+        }
+        content_begin = pos + 1;
+
+        Size depth = 0, elements_in_chunk = 0;
+        pos = content_begin;
+        while (true)
+        {
+          pos = document.find('<', pos);
+          if (pos == std::string::npos)
+          {
+            return false;
+          }
+          if (document.compare(pos, 4, "<!--") == 0)
+          {
+            pos = document.find("-->", pos);
+            if (pos == std::string::npos) return false;
+            continue;
+          }
+          if (document.compare(pos, 9, "<![CDATA[") == 0)
+          {
+            pos = document.find("]]>", pos);
+            if (pos == std::string::npos) return false;
+            continue;
+          }
+          const Size tag_end = document.find('>', pos);
+          if (tag_end == std::string::npos)
+          {
+            return false;
+          }
+          if (depth == 0 && tagStartsAt(document, pos + 2, list_tag) && document.compare(pos, list_close.size(), list_close) == 0)
+          {
+            content_end = pos;
+            break;
+          }
+          bool element_closed = false;
+          if (tagStartsAt(document, pos + 1, element_tag))
+          {
+            if (document[tag_end - 1] == '/')
+            {
+              element_closed = (depth == 0); // empty element
+            }
+            else
+            {
+              ++depth;
+            }
+          }
+          else if (depth > 0 && document.compare(pos, element_close.size(), element_close) == 0 && tagStartsAt(document, pos + 2, element_tag))
+          {
+            --depth;
+            element_closed = (depth == 0);
+          }
+          pos = tag_end + 1;
+          if (element_closed && ++elements_in_chunk == elements_per_chunk)
+          {
+            chunk_ends.push_back(pos);
+            elements_in_chunk = 0;
+          }
+        }
+        if (elements_in_chunk > 0)
+        {
+          chunk_ends.push_back(content_end);
+        }
+        else if (!chunk_ends.empty())
+        {
+          chunk_ends.back() = content_end; // include the whitespace after the last element
+        }
+        return true;
+      }
+    }
+
     XMLFile::XMLFile()
     {
     }
@@ -112,15 +261,7 @@ private:
       }
 
       // initialize parser
-      try
-      {
-        xercesc::XMLPlatformUtils::Initialize();
-      }
-      catch (const xercesc::XMLException & toCatch)
-      {
-        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "", String("Error during initialization: ") + StringManager().convert(toCatch.getMessage()));
-      }
+      initializeXerces();
 
       boost::shared_ptr< xercesc::SAX2XMLReader > parser(xercesc::XMLReaderFactory::createXMLReader());
       parser->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, false);
@@ -198,15 +339,7 @@ private:
       StringManager sm;
 
       // initialize parser
-      try
-      {
-        xercesc::XMLPlatformUtils::Initialize();
-      }
-      catch (const xercesc::XMLException & toCatch)
-      {
-        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "", String("Error during initialization: ") + StringManager().convert(toCatch.getMessage()));
-      }
+      initializeXerces();
 
       boost::shared_ptr< xercesc::SAX2XMLReader > parser(xercesc::XMLReaderFactory::createXMLReader());
       parser->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, false);
@@ -257,6 +390,87 @@ private:
       }
     }
 
+    bool XMLFile::parseChunked_(const String & filename, XMLHandler * handler, const String & list_tag, const String & element_tag,
+                                const String & chunk_root_tag, Size elements_per_chunk,
+                                const std::function<XMLHandler * (Size)> & chunk_handler, const std::function<void(Size)> & merge_chunk)
+    {
+      std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+      if (!is)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+      }
+      std::string document((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+      is.close();
+
+      // bzip2 or gzip compressed files are streamed by parse_()
+      if (document.size() >= 2 &&
+          ((document[0] == 'B' && document[1] == 'Z') || (document[0] == char(0x1f) && document[1] == char(0x8b))))
+      {
+        return false;
+      }
+
+      Size content_begin(0), content_end(0);
+      std::vector<Size> chunk_ends;
+      if (!splitElementList(document, list_tag, element_tag, elements_per_chunk, content_begin, content_end, chunk_ends) ||
+          chunk_ends.size() < 2)
+      {
+        // nothing to split
+        parseBuffer_(document, handler);
+        return true;
+      }
+
+      // parse the document without the list content
+      parseBuffer_(document.substr(0, content_begin) + document.substr(content_end), handler);
+
+      // documents of the chunks keep the XML declaration (encoding)
+      String prefix, suffix = "</" + chunk_root_tag + ">\n";
+      if (document.compare(0, 5, "<?xml") == 0)
+      {
+        prefix = document.substr(0, document.find("?>") + 2) + "\n";
+      }
+      prefix += "<" + chunk_root_tag + ">\n";
+
+      const SignedSize chunk_count = SignedSize(chunk_ends.size());
+      std::vector<XMLHandler*> handlers;
+      for (SignedSize c = 0; c < chunk_count; ++c)
+      {
+        handlers.push_back(chunk_handler(c));
+      }
+
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize c = 0; c < chunk_count; ++c)
+      {
+        try
+        {
+          const Size begin = (c == 0 ? content_begin : chunk_ends[c - 1]);
+          std::string chunk;
+          chunk.reserve(prefix.size() + chunk_ends[c] - begin + suffix.size());
+          chunk.append(prefix).append(document, begin, chunk_ends[c] - begin).append(suffix);
+          parseBuffer_(chunk, handlers[c]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (XMLFile_parseChunked)
+#endif
+          if (!error) error = std::current_exception();
+        }
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+
+      for (SignedSize c = 0; c < chunk_count; ++c)
+      {
+        merge_chunk(c);
+      }
+      return true;
+    }
+
     void XMLFile::save_(const String & filename, XMLHandler * handler) const
     {
       // open file in binary mode to avoid any line ending conversions
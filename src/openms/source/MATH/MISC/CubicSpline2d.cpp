@@ -105,6 +105,32 @@ namespace OpenMS
     return ((d_[i] * xx + c_[i]) * xx + b_[i]) * xx + a_[i];
   }
 
+  double CubicSpline2d::eval(double x, unsigned& index) const
+  {
+    if (x < x_.front() || x > x_.back())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Argument out of range of spline interpolation.");
+    }
+
+    const unsigned last = static_cast<unsigned>(x_.size()) - 2; // last knot interval
+    if (index > last || x_[index] > x)
+    {
+      // no usable start index (e.g. positions not sorted)
+      index = static_cast<unsigned>(std::upper_bound(x_.begin(), x_.end(), x) - x_.begin()) - 1;
+      index = std::min(index, last);
+    }
+    else
+    {
+      while (index < last && x_[index + 1] <= x)
+      {
+        ++index;
+      }
+    }
+
+    const double xx = x - x_[index];
+    return ((d_[index] * xx + c_[index]) * xx + b_[index]) * xx + a_[index];
+  }
+
   double CubicSpline2d::derivatives(double x, unsigned order) const
   {
     if (x < x_.front() || x > x_.back())
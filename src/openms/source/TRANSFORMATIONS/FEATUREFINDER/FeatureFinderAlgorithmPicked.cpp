@@ -56,7 +56,6 @@ namespace OpenMS
 {
   FeatureFinderAlgorithmPicked::FeatureFinderAlgorithmPicked() :
     FeatureFinderAlgorithm(),
-    map_(),
     log_()
   {
     //debugging
@@ -204,9 +203,6 @@ namespace OpenMS
     Param trace_fitter_params;
     trace_fitter_params.setValue("max_iteration", max_iterations);
 
-    //copy the input map
-    map_ = *(FeatureFinderAlgorithm::map_);
-
     //flag for user-specified seed mode
     bool user_seeds = (!seeds_.empty());
     if (user_seeds)
@@ -218,34 +214,17 @@ namespace OpenMS
     double user_seed_score = param_.getValue("user-seed:min_score");
 
     //reserve space for calculated scores
-    UInt charge_count = charge_high - charge_low + 1;
-    for (auto& s : map_)
-    {
-      Size scan_size = s.size();
-      s.getFloatDataArrays().resize(3 + 2 * charge_count);
-      s.getFloatDataArrays()[0].setName("trace_score");
-      s.getFloatDataArrays()[0].assign(scan_size, 0.0);
-      s.getFloatDataArrays()[1].setName("intensity_score");
-      s.getFloatDataArrays()[1].assign(scan_size, 0.0);
-      s.getFloatDataArrays()[2].setName("local_max");
-      s.getFloatDataArrays()[2].assign(scan_size, 0.0);
-      //create isotope pattern score arrays
-      UInt charge = charge_low;
-      for (Size i = 3; i < 3 + charge_count; ++i)
-      {
-        s.getFloatDataArrays()[i].setName(String("pattern_score_") + charge);
-        s.getFloatDataArrays()[i].assign(scan_size, 0.0);
-        ++charge;
-      }
-      //create overall score arrays
-      charge = charge_low;
-      for (Size i = 3 + charge_count; i < 3 + 2 * charge_count; ++i)
-      {
-        s.getFloatDataArrays()[i].setName(String("overall_score_") + charge);
-        s.getFloatDataArrays()[i].assign(scan_size, 0.0);
-        ++charge;
-      }
+    spectrum_offsets_.assign(map_->size() + 1, 0);
+    for (Size s = 0; s < map_->size(); ++s)
+    {
+      spectrum_offsets_[s + 1] = spectrum_offsets_[s] + (*map_)[s].size();
     }
+    Size peak_count = spectrum_offsets_.back();
+    trace_scores_.assign(peak_count, 0.0f);
+    intensity_scores_.assign(peak_count, 0.0f);
+    local_max_.assign(peak_count, 0);
+    pattern_scores_.assign(peak_count, 0.0f);
+    overall_scores_.assign(peak_count, 0.0f);
 
     debug_ = ((String)(param_.getValue("debug")) == "true");
     //clean up / create folders for debug information
@@ -255,6 +234,8 @@ namespace OpenMS
       dir.mkpath("debug/features");
       log_.open("debug/log.txt");
     }
+    //copy of the input map with the calculated scores (debug info)
+    MapType debug_map;
 
     //---------------------------------------------------------------------------
     //Step 1:
@@ -264,12 +245,16 @@ namespace OpenMS
     //new scope to make local variables disappear
     {
       ff_->startProgress(0, intensity_bins_ * intensity_bins_, "Precalculating intensity scores");
-      double rt_start = map_.getMinRT();
-      double mz_start = map_.getMinMZ();
-      intensity_rt_step_ = (map_.getMaxRT() - rt_start) / (double)intensity_bins_;
-      intensity_mz_step_ = (map_.getMaxMZ() - mz_start) / (double)intensity_bins_;
+      double rt_start = map_->getMinRT();
+      double mz_start = map_->getMinMZ();
+      intensity_rt_step_ = (map_->getMaxRT() - rt_start) / (double)intensity_bins_;
+      intensity_mz_step_ = (map_->getMaxMZ() - mz_start) / (double)intensity_bins_;
       intensity_thresholds_.resize(intensity_bins_);
-      for (Size rt = 0; rt < intensity_bins_; ++rt)
+      Size progress = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize rt = 0; rt < (SignedSize)intensity_bins_; ++rt)
       {
         intensity_thresholds_[rt].resize(intensity_bins_);
         double min_rt = rt_start + rt * intensity_rt_step_;
@@ -277,13 +262,16 @@ namespace OpenMS
         std::vector<double> tmp;
         for (Size mz = 0; mz < intensity_bins_; ++mz)
         {
-          ff_->setProgress(rt * intensity_bins_ + mz);
+          IF_MASTERTHREAD
+          {
+            ff_->setProgress(progress);
+          }
           double min_mz = mz_start + mz * intensity_mz_step_;
           double max_mz = mz_start + (mz + 1) * intensity_mz_step_;
           //std::cout << "rt range: " << min_rt << " - " << max_rt << std::endl;
           //std::cout << "mz range: " << min_mz << " - " << max_mz << std::endl;
           tmp.clear();
-          for (MapType::ConstAreaIterator it = map_.areaBeginConst(min_rt, max_rt, min_mz, max_mz); it != map_.areaEndConst(); ++it)
+          for (MapType::ConstAreaIterator it = map_->areaBeginConst(min_rt, max_rt, min_mz, max_mz); it != map_->areaEndConst(); ++it)
           {
             tmp.push_back(it->getIntensity());
           }
@@ -299,15 +287,22 @@ namespace OpenMS
               intensity_thresholds_[rt][mz][i] = tmp[index];
             }
           }
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++progress;
         }
       }
 
-      //store intensity score in PeakInfo
-      for (Size s = 0; s < map_.size(); ++s)
+      //store intensity score of each peak
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize s = 0; s < (SignedSize)map_->size(); ++s)
       {
-        for (Size p = 0; p < map_[s].size(); ++p)
+        for (Size p = 0; p < (*map_)[s].size(); ++p)
         {
-          map_[s].getFloatDataArrays()[1][p] = intensityScore_(s, p);
+          intensity_scores_[peakIndex_(s, p)] = intensityScore_(s, p);
         }
       }
       ff_->endProgress();
@@ -319,13 +314,19 @@ namespace OpenMS
     //---------------------------------------------------------------------------
     //new scope to make local variables disappear
     {
-      Size end_iteration = map_.size() - std::min((Size) min_spectra_, map_.size());
+      Size end_iteration = map_->size() - std::min((Size) min_spectra_, map_->size());
       ff_->startProgress(min_spectra_, end_iteration, "Precalculating mass trace scores");
       // skip first and last scans since we cannot extend the mass traces there
-      for (Size s = min_spectra_; s < end_iteration; ++s)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize s = min_spectra_; s < (SignedSize)end_iteration; ++s)
       {
-        ff_->setProgress(s);
-        SpectrumType& spectrum = map_[s];
+        IF_MASTERTHREAD
+        {
+          ff_->setProgress(s);
+        }
+        const SpectrumType& spectrum = (*map_)[s];
         //iterate over all peaks of the scan
         for (Size p = 0; p < spectrum.size(); ++p)
         {
@@ -338,7 +339,7 @@ namespace OpenMS
           bool is_max_peak = true; //checking the maximum intensity peaks -> use them later as feature seeds.
           for (Size i = 1; i <= min_spectra_; ++i)
           {
-            SpectrumType& next_spectrum = map_[s + i];
+            const SpectrumType& next_spectrum = (*map_)[s + i];
             if (!next_spectrum.empty()) // There are peaks in the spectrum
             {
               Size spec_index = next_spectrum.findNearest(pos);
@@ -349,7 +350,7 @@ namespace OpenMS
           }
           for (Size i = 1; i <= min_spectra_; ++i)
           {
-            SpectrumType& next_spectrum = map_[s - i];
+            const SpectrumType& next_spectrum = (*map_)[s - i];
             if (!next_spectrum.empty()) // There are peaks in the spectrum
             {
               Size spec_index = next_spectrum.findNearest(pos);
@@ -362,20 +363,27 @@ namespace OpenMS
           trace_score /= 2 * min_spectra_;
 
           //store final score for later use
-          spectrum.getFloatDataArrays()[0][p] = trace_score;
-          spectrum.getFloatDataArrays()[2][p] = is_max_peak;
+          trace_scores_[peakIndex_(s, p)] = trace_score;
+          local_max_[peakIndex_(s, p)] = is_max_peak;
         }
       }
       ff_->endProgress();
     }
 
+    if (debug_)
+    {
+      debug_map = *map_;
+      addScoreArray_(debug_map, "trace_score", trace_scores_);
+      addScoreArray_(debug_map, "intensity_score", intensity_scores_);
+    }
+
     //---------------------------------------------------------------------------
     //Step 2.5:
     //Precalculate isotope distributions for interesting mass ranges
     //---------------------------------------------------------------------------
     //new scope to make local variables disappear
     {
-      double max_mass = map_.getMaxMZ() * charge_high;
+      double max_mass = map_->getMaxMZ() * charge_high;
       Size num_isotopes = std::ceil(max_mass / mass_window_width_) + 1;
       ff_->startProgress(0, num_isotopes, "Precalculating isotope distributions");
 
@@ -451,51 +459,68 @@ namespace OpenMS
     Int feature_nr_global = 0; //counter for the number of features (debug info)
     for (SignedSize c = charge_low; c <= charge_high; ++c)
     {
-      UInt meta_index_isotope = 3 + c - charge_low;
-      UInt meta_index_overall = 3 + charge_count + c - charge_low;
-
       Size feature_candidates = 0;
       std::vector<Seed> seeds;
 
       //-----------------------------------------------------------
       //Step 3.1: Precalculate IsotopePattern score
       //-----------------------------------------------------------
-      ff_->startProgress(0, map_.size(), String("Calculating isotope pattern scores for charge ") + String(c));
-      for (Size s = 0; s < map_.size(); ++s)
+      ff_->startProgress(0, map_->size(), String("Calculating isotope pattern scores for charge ") + String(c));
+      std::fill(pattern_scores_.begin(), pattern_scores_.end(), 0.0f);
+      // The peaks of a pattern lie in the spectrum of its center peak or in one of the two adjacent spectra.
+      // Spectra are thus processed in three interleaved passes, so that no two threads update the score of
+      // the same peak. Debug output of findIsotope_ is written to a single log, so debug mode runs serially.
+      Size progress = 0;
+      for (Size offset = 0; offset < 3; ++offset)
       {
-        ff_->setProgress(s);
-        const SpectrumType& spectrum = map_[s];
-        for (Size p = 0; p < spectrum.size(); ++p)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (!debug_)
+#endif
+        for (SignedSize s = offset; s < (SignedSize)map_->size(); s += 3)
         {
-          double mz = spectrum[p].getMZ();
-
-          //get isotope distribution for this mass
-          const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(mz * c);
-          //determine highest peak in isotope distribution
-          Size max_isotope = std::max_element(isotopes.intensity.begin(), isotopes.intensity.end()) - isotopes.intensity.begin();
-          //Look up expected isotopic peaks (in the current spectrum or adjacent spectra)
-          Size peak_index = spectrum.findNearest(mz - ((double)(isotopes.size() + 1) / c));
-          IsotopePattern pattern(isotopes.size());
-
-          for (Size i = 0; i < isotopes.size(); ++i)
+          IF_MASTERTHREAD
           {
-            double isotope_pos = mz + ((double)i - max_isotope) / c;
-            findIsotope_(isotope_pos, s, pattern, i, peak_index);
+            ff_->setProgress(progress);
           }
+          const SpectrumType& spectrum = (*map_)[s];
+          for (Size p = 0; p < spectrum.size(); ++p)
+          {
+            double mz = spectrum[p].getMZ();
 
-          double pattern_score = isotopeScore_(isotopes, pattern, true);
+            //get isotope distribution for this mass
+            const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(mz * c);
+            //determine highest peak in isotope distribution
+            Size max_isotope = std::max_element(isotopes.intensity.begin(), isotopes.intensity.end()) - isotopes.intensity.begin();
+            //Look up expected isotopic peaks (in the current spectrum or adjacent spectra)
+            Size peak_index = spectrum.findNearest(mz - ((double)(isotopes.size() + 1) / c));
+            IsotopePattern pattern(isotopes.size());
 
-          //update pattern scores of all contained peaks (if necessary)
-          if (pattern_score > 0.0)
-          {
-            for (Size i = 0; i < pattern.peak.size(); ++i)
+            for (Size i = 0; i < isotopes.size(); ++i)
+            {
+              double isotope_pos = mz + ((double)i - max_isotope) / c;
+              findIsotope_(isotope_pos, s, pattern, i, peak_index);
+            }
+
+            double pattern_score = isotopeScore_(isotopes, pattern, true);
+
+            //update pattern scores of all contained peaks (if necessary)
+            if (pattern_score > 0.0)
             {
-              if (pattern.peak[i] >= 0 && pattern_score > map_[pattern.spectrum[i]].getFloatDataArrays()[meta_index_isotope][pattern.peak[i]])
+              for (Size i = 0; i < pattern.peak.size(); ++i)
               {
-                map_[pattern.spectrum[i]].getFloatDataArrays()[meta_index_isotope][pattern.peak[i]] = pattern_score;
+                if (pattern.peak[i] < 0) continue;
+                float& score = pattern_scores_[peakIndex_(pattern.spectrum[i], pattern.peak[i])];
+                if (pattern_score > score)
+                {
+                  score = pattern_score;
+                }
               }
             }
           }
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++progress;
         }
       }
       ff_->endProgress();
@@ -503,24 +528,25 @@ namespace OpenMS
       //Step 3.2:
       //Find seeds for this charge
       //-----------------------------------------------------------
-      Size end_of_iteration = map_.size() - std::min((Size) min_spectra_, map_.size());
+      Size end_of_iteration = map_->size() - std::min((Size) min_spectra_, map_->size());
       ff_->startProgress(min_spectra_, end_of_iteration, String("Finding seeds for charge ") + String(c));
 
       double min_seed_score = param_.getValue("seed:min_score");
+      std::fill(overall_scores_.begin(), overall_scores_.end(), 0.0f);
       //do nothing for the first few and last few spectra as the scans required to search for traces are missing
       for (Size s = min_spectra_; s < end_of_iteration; ++s)
       {
         ff_->setProgress(s);
 
         //iterate over peaks
-        for (Size p = 0; p < map_[s].size(); ++p)
+        for (Size p = 0; p < (*map_)[s].size(); ++p)
         {
-          FloatDataArrays& meta = map_[s].getFloatDataArrays();
-          double overall_score = std::pow(meta[0][p] * meta[1][p] * meta[meta_index_isotope][p], 1.0f / 3.0f);
-          meta[meta_index_overall][p] = overall_score;
+          Size index = peakIndex_(s, p);
+          double overall_score = std::pow(trace_scores_[index] * intensity_scores_[index] * pattern_scores_[index], 1.0f / 3.0f);
+          overall_scores_[index] = overall_score;
 
           //add seed to vector if certain conditions are fulfilled
-          if (meta[2][p] != 0.0) // local maximum of mass trace is prerequisite for all features
+          if (local_max_[index] != 0) // local maximum of mass trace is prerequisite for all features
           {
             //automatic seeds: overall score greater than the min seed score
             if (!user_seeds && overall_score >= min_seed_score)
@@ -528,7 +554,7 @@ namespace OpenMS
               Seed seed;
               seed.spectrum = s;
               seed.peak = p;
-              seed.intensity = map_[s][p].getIntensity();
+              seed.intensity = (*map_)[s][p].getIntensity();
               seeds.push_back(seed);
             }
             //user-specified seeds: overall score greater than USER min seed score
@@ -536,20 +562,20 @@ namespace OpenMS
             {
               //only consider seeds, if they are near a user-specified seed
               Feature tmp;
-              tmp.setMZ(map_[s][p].getMZ() - user_mz_tol);
+              tmp.setMZ((*map_)[s][p].getMZ() - user_mz_tol);
               for (FeatureMap::const_iterator it = std::lower_bound(seeds_.begin(), seeds_.end(), tmp, Feature::MZLess()); it < seeds_.end(); ++it)
               {
-                if (it->getMZ() > map_[s][p].getMZ() + user_mz_tol)
+                if (it->getMZ() > (*map_)[s][p].getMZ() + user_mz_tol)
                 {
                   break;
                 }
-                if (fabs(it->getMZ() - map_[s][p].getMZ()) < user_mz_tol &&
-                    fabs(it->getRT() - map_[s].getRT()) < user_rt_tol)
+                if (fabs(it->getMZ() - (*map_)[s][p].getMZ()) < user_mz_tol &&
+                    fabs(it->getRT() - (*map_)[s].getRT()) < user_rt_tol)
                 {
                   Seed seed;
                   seed.spectrum = s;
                   seed.peak = p;
-                  seed.intensity = map_[s][p].getIntensity();
+                  seed.intensity = (*map_)[s][p].getIntensity();
                   seeds.push_back(seed);
                   break;
                 }
@@ -570,18 +596,22 @@ namespace OpenMS
         {
           Size spectrum = seed.spectrum;
           Size peak = seed.peak;
-          const FloatDataArrays& meta = map_[spectrum].getFloatDataArrays();
+          Size index = peakIndex_(spectrum, peak);
           Feature tmp;
           tmp.setIntensity(seed.intensity);
-          tmp.setOverallQuality(meta[meta_index_overall][peak]);
-          tmp.setRT(map_[spectrum].getRT());
-          tmp.setMZ(map_[spectrum][peak].getMZ());
-          tmp.setMetaValue("intensity_score", meta[1][peak]);
-          tmp.setMetaValue("pattern_score", meta[meta_index_isotope][peak]);
-          tmp.setMetaValue("trace_score", meta[0][peak]);
+          tmp.setOverallQuality(overall_scores_[index]);
+          tmp.setRT((*map_)[spectrum].getRT());
+          tmp.setMZ((*map_)[spectrum][peak].getMZ());
+          tmp.setMetaValue("intensity_score", intensity_scores_[index]);
+          tmp.setMetaValue("pattern_score", pattern_scores_[index]);
+          tmp.setMetaValue("trace_score", trace_scores_[index]);
           seed_map.push_back(tmp);
         }
         FeatureXMLFile().store(String("debug/seeds_") + String(c) + ".featureXML", seed_map);
+
+        //pattern and overall scores of this charge
+        addScoreArray_(debug_map, String("pattern_score_") + c, pattern_scores_);
+        addScoreArray_(debug_map, String("overall_score_") + c, overall_scores_);
       }
 
       ff_->endProgress();
@@ -614,7 +644,7 @@ namespace OpenMS
         //Extend all mass traces
         //------------------------------------------------------------------
 
-        const SpectrumType& spectrum = map_[seeds[i].spectrum];
+        const SpectrumType& spectrum = (*map_)[seeds[i].spectrum];
         const PeakType& peak = spectrum[seeds[i].peak];
 
         IF_MASTERTHREAD
@@ -644,10 +674,10 @@ namespace OpenMS
         //extend the convex hull in RT dimension (starting from the trace peaks)
         MassTraces traces;
         traces.reserve(best_pattern.peak.size());
-        extendMassTraces_(best_pattern, traces, meta_index_overall);
+        extendMassTraces_(best_pattern, traces);
 
         //check if the traces are still valid
-        double seed_mz = map_[seeds[i].spectrum][seeds[i].peak].getMZ();
+        double seed_mz = (*map_)[seeds[i].spectrum][seeds[i].peak].getMZ();
 
         if (!traces.isValid(seed_mz, trace_tolerance_))
         {
@@ -813,8 +843,8 @@ namespace OpenMS
         DBoundingBox<2> bb = f.getConvexHull().getBoundingBox();
         for (Size j = i + 1; j < seeds.size(); ++j)
         {
-          double rt = map_[seeds[j].spectrum].getRT();
-          double mz = map_[seeds[j].spectrum][seeds[j].peak].getMZ();
+          double rt = (*map_)[seeds[j].spectrum].getRT();
+          double mz = (*map_)[seeds[j].spectrum][seeds[j].peak].getMZ();
           if (bb.encloses(rt, mz) && f.encloses(rt, mz))
           {
 #pragma omp critical (FeatureFinderAlgorithmPicked_SEEDSINFEATURES)
@@ -984,9 +1014,9 @@ namespace OpenMS
       for (std::map<Seed, String>::iterator it2 = abort_reasons_.begin(); it2 != abort_reasons_.end(); ++it2, ++counter)
       {
         Feature f;
-        f.setRT(map_[it2->first.spectrum].getRT());
-        f.setMZ(map_[it2->first.spectrum][it2->first.peak].getMZ());
-        f.setIntensity(map_[it2->first.spectrum][it2->first.peak].getIntensity());
+        f.setRT((*map_)[it2->first.spectrum].getRT());
+        f.setMZ((*map_)[it2->first.spectrum][it2->first.peak].getMZ());
+        f.setIntensity((*map_)[it2->first.spectrum][it2->first.peak].getIntensity());
         f.setMetaValue("label", it2->second);
         f.setUniqueId(counter); // ID = index
         abort_map.push_back(f);
@@ -994,16 +1024,23 @@ namespace OpenMS
       abort_map.setUniqueId();
       FeatureXMLFile().store("debug/abort_reasons.featureXML", abort_map);
 
-      //store input map with calculated scores (without overall score)
-      for (auto& s : map_)
-      {
-        s.getFloatDataArrays().erase(s.getFloatDataArrays().begin() + 2);
-      }
-      MzMLFile().store("debug/input.mzML", map_);
+      //store input map with calculated scores
+      MzMLFile().store("debug/input.mzML", debug_map);
     }
 
   }
 
+  void FeatureFinderAlgorithmPicked::addScoreArray_(MapType& map, const String& name, const std::vector<float>& scores) const
+  {
+    for (Size s = 0; s < map.size(); ++s)
+    {
+      SpectrumType::FloatDataArray array;
+      array.setName(name);
+      array.assign(scores.begin() + spectrum_offsets_[s], scores.begin() + spectrum_offsets_[s + 1]);
+      map[s].getFloatDataArrays().push_back(array);
+    }
+  }
+
   FeatureFinderAlgorithm* FeatureFinderAlgorithmPicked::create()
   {
     return new FeatureFinderAlgorithmPicked();
@@ -1114,7 +1151,7 @@ namespace OpenMS
   double FeatureFinderAlgorithmPicked::findBestIsotopeFit_(const Seed& center, UInt charge, IsotopePattern& best_pattern) const
   {
     if (debug_) log_ << "Testing isotope patterns for charge " << charge << ": " << std::endl;
-    const SpectrumType& spectrum = map_[center.spectrum];
+    const SpectrumType& spectrum = (*map_)[center.spectrum];
     const TheoreticalIsotopePattern& isotopes = getIsotopeDistribution_(spectrum[center.peak].getMZ() * charge);
     if (debug_) log_ << " - Seed: " << center.peak << " (mz:" << spectrum[center.peak].getMZ() << ")" << std::endl;
 
@@ -1201,7 +1238,7 @@ namespace OpenMS
     return max_score;
   }
 
-  void FeatureFinderAlgorithmPicked::extendMassTraces_(const IsotopePattern& pattern, MassTraces& traces, Size meta_index_overall) const
+  void FeatureFinderAlgorithmPicked::extendMassTraces_(const IsotopePattern& pattern, MassTraces& traces) const
   {
     //find index of the trace with the maximum intensity
     double max_int =  0.0;
@@ -1209,25 +1246,25 @@ namespace OpenMS
     for (Size p = 0; p < pattern.peak.size(); ++p)
     {
       if (pattern.peak[p] < 0) continue; //skip missing and removed traces
-      if (map_[pattern.spectrum[p]][pattern.peak[p]].getIntensity() > max_int)
+      if ((*map_)[pattern.spectrum[p]][pattern.peak[p]].getIntensity() > max_int)
       {
-        max_int = map_[pattern.spectrum[p]][pattern.peak[p]].getIntensity();
+        max_int = (*map_)[pattern.spectrum[p]][pattern.peak[p]].getIntensity();
         max_trace_index = p;
       }
     }
 
     //extend the maximum intensity trace to determine the boundaries in RT dimension
     Size start_index = pattern.spectrum[max_trace_index];
-    const PeakType* start_peak = &(map_[pattern.spectrum[max_trace_index]][pattern.peak[max_trace_index]]);
+    const PeakType* start_peak = &((*map_)[pattern.spectrum[max_trace_index]][pattern.peak[max_trace_index]]);
     double start_mz = start_peak->getMZ();
-    double start_rt = map_[start_index].getRT();
+    double start_rt = (*map_)[start_index].getRT();
     if (debug_) log_ << " - Trace " << max_trace_index << " (maximum intensity)" << std::endl;
-    if (debug_) log_ << "   - extending from: " << map_[start_index].getRT() << " / " << start_mz << " (int: " << start_peak->getIntensity() << ")" << std::endl;
+    if (debug_) log_ << "   - extending from: " << (*map_)[start_index].getRT() << " / " << start_mz << " (int: " << start_peak->getIntensity() << ")" << std::endl;
     //initialize the trace and extend
     MassTrace max_trace;
     max_trace.peaks.emplace_back(start_rt, start_peak);
-    extendMassTrace_(max_trace, start_index, start_mz, false, meta_index_overall);
-    extendMassTrace_(max_trace, start_index, start_mz, true, meta_index_overall);
+    extendMassTrace_(max_trace, start_index, start_mz, false);
+    extendMassTrace_(max_trace, start_index, start_mz, true);
 
     double rt_max = max_trace.peaks.back().first;
     double rt_min = max_trace.peaks.begin()->first;
@@ -1262,26 +1299,26 @@ namespace OpenMS
         if (debug_) log_ << "   - missing" << std::endl;
         continue;
       }
-      starting_peak.intensity = map_[starting_peak.spectrum][starting_peak.peak].getIntensity();
-      if (debug_) log_ << "   - trace seed: " << map_[starting_peak.spectrum].getRT() << " / " << map_[starting_peak.spectrum][starting_peak.peak].getMZ() << " (int: " << map_[starting_peak.spectrum][starting_peak.peak].getIntensity() << ")" << std::endl;
+      starting_peak.intensity = (*map_)[starting_peak.spectrum][starting_peak.peak].getIntensity();
+      if (debug_) log_ << "   - trace seed: " << (*map_)[starting_peak.spectrum].getRT() << " / " << (*map_)[starting_peak.spectrum][starting_peak.peak].getMZ() << " (int: " << (*map_)[starting_peak.spectrum][starting_peak.peak].getIntensity() << ")" << std::endl;
 
       //search for nearby maximum of the mass trace as the extension assumes that it starts at the maximum
       Size begin = std::max((Size)0, starting_peak.spectrum - min_spectra_);
-      Size end = std::min(starting_peak.spectrum + min_spectra_, (Size)map_.size());
-      double mz = map_[starting_peak.spectrum][starting_peak.peak].getMZ();
-      double inte = map_[starting_peak.spectrum][starting_peak.peak].getIntensity();
+      Size end = std::min(starting_peak.spectrum + min_spectra_, (Size)map_->size());
+      double mz = (*map_)[starting_peak.spectrum][starting_peak.peak].getMZ();
+      double inte = (*map_)[starting_peak.spectrum][starting_peak.peak].getIntensity();
       for (Size spectrum_index = begin; spectrum_index < end; ++spectrum_index)
       {
         //find better seeds (no-empty scan/low mz diff/higher intensity)
         SignedSize peak_index = -1;
-        if (!map_[spectrum_index].empty())
+        if (!(*map_)[spectrum_index].empty())
         {
-          peak_index = map_[spectrum_index].findNearest(map_[starting_peak.spectrum][starting_peak.peak].getMZ());
+          peak_index = (*map_)[spectrum_index].findNearest((*map_)[starting_peak.spectrum][starting_peak.peak].getMZ());
         }
 
         if (peak_index < 0 ||
-            map_[spectrum_index][peak_index].getIntensity() <= inte ||
-            std::fabs(mz - map_[spectrum_index][peak_index].getMZ()) >= pattern_tolerance_
+            (*map_)[spectrum_index][peak_index].getIntensity() <= inte ||
+            std::fabs(mz - (*map_)[spectrum_index][peak_index].getMZ()) >= pattern_tolerance_
             )
         {
           continue;
@@ -1289,18 +1326,18 @@ namespace OpenMS
 
         starting_peak.spectrum = spectrum_index;
         starting_peak.peak = peak_index;
-        inte = map_[spectrum_index][peak_index].getIntensity();
+        inte = (*map_)[spectrum_index][peak_index].getIntensity();
       }
-      if (debug_) log_ << "   - extending from: " << map_[starting_peak.spectrum].getRT() << " / " << map_[starting_peak.spectrum][starting_peak.peak].getMZ() << " (int: " << map_[starting_peak.spectrum][starting_peak.peak].getIntensity() << ")" << std::endl;
+      if (debug_) log_ << "   - extending from: " << (*map_)[starting_peak.spectrum].getRT() << " / " << (*map_)[starting_peak.spectrum][starting_peak.peak].getMZ() << " (int: " << (*map_)[starting_peak.spectrum][starting_peak.peak].getIntensity() << ")" << std::endl;
 
       //------------------------------------------------------------------
       //Extend seed to a mass trace
       MassTrace trace;
-      const PeakType* seed = &(map_[starting_peak.spectrum][starting_peak.peak]);
+      const PeakType* seed = &((*map_)[starting_peak.spectrum][starting_peak.peak]);
       //initialize trace with seed data and extend
-      trace.peaks.emplace_back(map_[starting_peak.spectrum].getRT(), seed);
-      extendMassTrace_(trace, starting_peak.spectrum, seed->getMZ(), false, meta_index_overall, rt_min, rt_max);
-      extendMassTrace_(trace, starting_peak.spectrum, seed->getMZ(), true, meta_index_overall, rt_min, rt_max);
+      trace.peaks.emplace_back((*map_)[starting_peak.spectrum].getRT(), seed);
+      extendMassTrace_(trace, starting_peak.spectrum, seed->getMZ(), false, rt_min, rt_max);
+      extendMassTrace_(trace, starting_peak.spectrum, seed->getMZ(), true, rt_min, rt_max);
 
       //check if enough peaks were found
       if (!trace.isValid())
@@ -1322,7 +1359,7 @@ namespace OpenMS
     }
   }
 
-  void FeatureFinderAlgorithmPicked::extendMassTrace_(MassTrace& trace, SignedSize spectrum_index, double mz, bool increase_rt, Size meta_index_overall, double min_rt, double max_rt) const
+  void FeatureFinderAlgorithmPicked::extendMassTrace_(MassTrace& trace, SignedSize spectrum_index, double mz, bool increase_rt, double min_rt, double max_rt) const
   {
     //Reverse peaks if we run the method for the second time (to keep them in chronological order)
     if (increase_rt)
@@ -1354,11 +1391,11 @@ namespace OpenMS
     Size peaks_before_extension = trace.peaks.size();
     String abort_reason = "";
 
-    while ((!increase_rt && spectrum_index >= 0) || (increase_rt && spectrum_index < (SignedSize)map_.size()))
+    while ((!increase_rt && spectrum_index >= 0) || (increase_rt && spectrum_index < (SignedSize)map_->size()))
     {
       if (boundaries &&
-          ((!increase_rt && map_[spectrum_index].getRT() < min_rt) ||
-           (increase_rt && map_[spectrum_index].getRT() > max_rt))
+          ((!increase_rt && (*map_)[spectrum_index].getRT() < min_rt) ||
+           (increase_rt && (*map_)[spectrum_index].getRT() > max_rt))
           )
       {
         abort_reason = "Hit upper/lower boundary";
@@ -1367,16 +1404,16 @@ namespace OpenMS
 
       SignedSize peak_index = -1;
 
-      if (!map_[spectrum_index].empty())
+      if (!(*map_)[spectrum_index].empty())
       {
-        peak_index = map_[spectrum_index].findNearest(mz);
+        peak_index = (*map_)[spectrum_index].findNearest(mz);
       }
 
       // check if the peak is "missing"
       if (
         peak_index < 0 // no peak found
-         || map_[spectrum_index].getFloatDataArrays()[meta_index_overall][peak_index] < 0.01 // overall score is to low
-         || positionScore_(mz, map_[spectrum_index][peak_index].getMZ(), trace_tolerance_) == 0.0 // deviation of mz is too big
+         || overall_scores_[peakIndex_(spectrum_index, peak_index)] < 0.01 // overall score is to low
+         || positionScore_(mz, (*map_)[spectrum_index][peak_index].getMZ(), trace_tolerance_) == 0.0 // deviation of mz is too big
         )
       {
         ++missing_peaks;
@@ -1392,11 +1429,11 @@ namespace OpenMS
         missing_peaks = 0;
 
         //add found peak to trace
-        trace.peaks.emplace_back(map_[spectrum_index].getRT(), &(map_[spectrum_index][peak_index]));
+        trace.peaks.emplace_back((*map_)[spectrum_index].getRT(), &((*map_)[spectrum_index][peak_index]));
 
         //update deltas and intensities
-        deltas.push_back((map_[spectrum_index][peak_index].getIntensity() - last_observed_intensity) / last_observed_intensity);
-        last_observed_intensity = map_[spectrum_index][peak_index].getIntensity();
+        deltas.push_back(((*map_)[spectrum_index][peak_index].getIntensity() - last_observed_intensity) / last_observed_intensity);
+        last_observed_intensity = (*map_)[spectrum_index][peak_index].getIntensity();
 
         //Abort if the average delta is too big (as intensity increases then)
         double average_delta = std::accumulate(deltas.end() - delta_count, deltas.end(), 0.0) / (double)delta_count;
@@ -1448,7 +1485,7 @@ namespace OpenMS
     UInt matches = 0;
 
     //search in the center spectrum
-    const SpectrumType& spectrum = map_[spectrum_index];
+    const SpectrumType& spectrum = (*map_)[spectrum_index];
     peak_index = nearest_(pos, spectrum, peak_index);
     double this_mz_score = positionScore_(pos, spectrum[peak_index].getMZ(), pattern_tolerance_);
     pattern.theoretical_mz[pattern_index] = pos;
@@ -1464,9 +1501,9 @@ namespace OpenMS
     }
 
     //previous spectrum
-    if (spectrum_index != 0 && !map_[spectrum_index - 1].empty())
+    if (spectrum_index != 0 && !(*map_)[spectrum_index - 1].empty())
     {
-      const SpectrumType& spectrum_before = map_[spectrum_index - 1];
+      const SpectrumType& spectrum_before = (*map_)[spectrum_index - 1];
       Size index_before = spectrum_before.findNearest(pos);
       double mz_score = positionScore_(pos, spectrum_before[index_before].getMZ(), pattern_tolerance_);
       if (mz_score != 0.0)
@@ -1485,9 +1522,9 @@ namespace OpenMS
     }
 
     //next spectrum
-    if (spectrum_index != map_.size() - 1 && !map_[spectrum_index + 1].empty())
+    if (spectrum_index != map_->size() - 1 && !(*map_)[spectrum_index + 1].empty())
     {
-      const SpectrumType& spectrum_after = map_[spectrum_index + 1];
+      const SpectrumType& spectrum_after = (*map_)[spectrum_index + 1];
       Size index_after = spectrum_after.findNearest(pos);
       double mz_score = positionScore_(pos, spectrum_after[index_after].getMZ(), pattern_tolerance_);
       if (mz_score != 0.0)
@@ -1631,11 +1668,11 @@ namespace OpenMS
   double FeatureFinderAlgorithmPicked::intensityScore_(Size spectrum, Size peak) const
   {
     // calculate (half) bin numbers
-    double intensity  = map_[spectrum][peak].getIntensity();
-    double rt = map_[spectrum].getRT();
-    double mz = map_[spectrum][peak].getMZ();
-    double rt_min = map_.getMinRT();
-    double mz_min = map_.getMinMZ();
+    double intensity  = (*map_)[spectrum][peak].getIntensity();
+    double rt = (*map_)[spectrum].getRT();
+    double mz = (*map_)[spectrum][peak].getMZ();
+    double rt_min = map_->getMinRT();
+    double mz_min = map_->getMinMZ();
     UInt rt_bin = std::min(2 * intensity_bins_ - 1, (UInt) std::floor((rt - rt_min) / intensity_rt_step_ * 2.0));
     UInt mz_bin = std::min(2 * intensity_bins_ - 1, (UInt) std::floor((mz - mz_min) / intensity_mz_step_ * 2.0));
     // determine mz bins
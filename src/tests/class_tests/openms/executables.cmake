@@ -51,6 +51,7 @@ set(datastructures_executables_list
   DefaultParamHandler_test
   DistanceMatrix_test
   FASTAContainer_test
+  FlatSet_test
   GridBasedCluster_test
   GridBasedClustering_test
   GridFeature_test
@@ -186,6 +187,7 @@ set(format_executables_list
   GzipIfstream_test
   GzipInputStream_test
   IBSpectraFile_test
+  IdBinaryFile_test
   IdXMLFile_test
   IndexedMzMLDecoder_test
   IndexedMzMLFile_test
@@ -362,6 +364,7 @@ set(comparison_executables_list
   BinnedSharedPeakCount_test
   BinnedSpectralContrastAngle_test
   BinnedSpectrumCompareFunctor_test
+  BinnedSpectrumMatrix_test
   BinnedSpectrum_test
   BinnedSumAgreeingIntensities_test
   ClusterAnalyzer_test
@@ -372,6 +375,7 @@ set(comparison_executables_list
   PeakAlignment_test
   PeakSpectrumCompareFunctor_test
   SingleLinkage_test
+  SparseSpectraClustering_test
   SpectraSTSimilarityScore_test
   SpectrumAlignmentScore_test
   SpectrumAlignment_test
@@ -523,6 +527,7 @@ set(analysis_executables_list
   ModifiedPeptideGenerator_test
   OfflinePrecursorIonSelection_test
   PeptideIndexing_test
+  ProteinDBIndex_test
   PeptideAndProteinQuant_test
   PeakIntensityPredictor_test
   PScore_test
@@ -656,6 +661,7 @@ if(NOT DISABLE_OPENSWATH)
     OpenSwathHelper_test
     OpenSwathScoring_test
     OpenSwathScores_test
+    OpenSwathOSWWriter_test
     PeakIntegrator_test
     PeakPickerMRM_test
     MRMTransitionGroupPicker_test
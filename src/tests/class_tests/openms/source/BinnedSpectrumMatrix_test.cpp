@@ -0,0 +1,212 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumMatrix.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSharedPeakCount.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSpectralContrastAngle.h>
+#include <OpenMS/COMPARISON/SPECTRA/BinnedSumAgreeingIntensities.h>
+#include <OpenMS/FORMAT/DTAFile.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(BinnedSpectrumMatrix, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+BinnedSpectrumMatrix* ptr = nullptr;
+BinnedSpectrumMatrix* nullPointer = nullptr;
+START_SECTION(BinnedSpectrumMatrix())
+{
+  ptr = new BinnedSpectrumMatrix();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->nonZeros(), 0)
+}
+END_SECTION
+
+START_SECTION(~BinnedSpectrumMatrix())
+{
+  delete ptr;
+}
+END_SECTION
+
+// three variants of the same spectrum
+PeakSpectrum s1, s2, s3;
+DTAFile().load(OPENMS_GET_TEST_DATA_PATH("PILISSequenceDB_DFPIANGER_1.dta"), s1);
+s2 = s1;
+s2.pop_back();
+s3 = s1;
+for (Size i = 0; i < s3.size(); i += 2)
+{
+  s3[i].setIntensity(s3[i].getIntensity() * 0.5);
+}
+s3.erase(s3.begin(), s3.begin() + s3.size() / 3);
+
+vector<BinnedSpectrum> binned;
+binned.push_back(BinnedSpectrum(s1, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+binned.push_back(BinnedSpectrum(s2, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+binned.push_back(BinnedSpectrum(s3, 1.5, false, 2, BinnedSpectrum::DEFAULT_BIN_OFFSET_LOWRES));
+
+BinnedSpectralContrastAngle contrast_angle;
+BinnedSharedPeakCount shared_peak_count;
+BinnedSumAgreeingIntensities sum_agreeing;
+
+START_SECTION((BinnedSpectrumMatrix(const std::vector<BinnedSpectrum>& spectra)))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  TEST_EQUAL(matrix.size(), 3)
+  TEST_EQUAL(matrix.nonZeros(), binned[0].getBins().nonZeros() + binned[1].getBins().nonZeros() + binned[2].getBins().nonZeros())
+
+  vector<BinnedSpectrum> incompatible(binned);
+  incompatible.push_back(BinnedSpectrum(s1, 0.02, false, 0, BinnedSpectrum::DEFAULT_BIN_OFFSET_HIRES));
+  TEST_EXCEPTION(Exception::IllegalArgument, BinnedSpectrumMatrix m(incompatible))
+}
+END_SECTION
+
+START_SECTION((void addSpectrum(const BinnedSpectrum& spec)))
+{
+  BinnedSpectrumMatrix matrix;
+  matrix.addSpectrum(binned[0]);
+  matrix.addSpectrum(binned[2]);
+  TEST_EQUAL(matrix.size(), 2)
+  TEST_EQUAL(matrix.nonZeros(), binned[0].getBins().nonZeros() + binned[2].getBins().nonZeros())
+  TEST_EXCEPTION(Exception::IllegalArgument, matrix.addSpectrum(BinnedSpectrum(s1, 10.0, true, 0, 0.0)))
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  matrix.clear();
+  TEST_EQUAL(matrix.size(), 0)
+  TEST_EQUAL(matrix.nonZeros(), 0)
+  // binning of the new spectra is accepted after clear()
+  matrix.addSpectrum(BinnedSpectrum(s1, 10.0, true, 0, 0.0));
+  TEST_EQUAL(matrix.size(), 1)
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((Size nonZeros() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((double compare(Size i, Size j, SimilarityMeasure measure) const))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  for (Size i = 0; i < binned.size(); ++i)
+  {
+    for (Size j = 0; j < binned.size(); ++j)
+    {
+      TEST_REAL_SIMILAR(matrix.compare(i, j, BinnedSpectrumMatrix::CONTRAST_ANGLE), contrast_angle(binned[i], binned[j]))
+      TEST_REAL_SIMILAR(matrix.compare(i, j, BinnedSpectrumMatrix::SHARED_PEAK_COUNT), shared_peak_count(binned[i], binned[j]))
+      TEST_REAL_SIMILAR(matrix.compare(i, j, BinnedSpectrumMatrix::SUM_AGREEING_INTENSITIES), sum_agreeing(binned[i], binned[j]))
+    }
+  }
+  TEST_REAL_SIMILAR(matrix.compare(0, 1, BinnedSpectrumMatrix::CONTRAST_ANGLE), 0.999985)
+  TEST_EXCEPTION(Exception::IndexOverflow, matrix.compare(0, 3, BinnedSpectrumMatrix::CONTRAST_ANGLE))
+}
+END_SECTION
+
+START_SECTION((void compareOneVsMany(const BinnedSpectrum& query, SimilarityMeasure measure, std::vector<double>& scores) const))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  vector<double> scores;
+  matrix.compareOneVsMany(binned[2], BinnedSpectrumMatrix::SUM_AGREEING_INTENSITIES, scores);
+  TEST_EQUAL(scores.size(), 3)
+  for (Size i = 0; i < binned.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(scores[i], sum_agreeing(binned[2], binned[i]))
+  }
+  TEST_EXCEPTION(Exception::IllegalArgument, matrix.compareOneVsMany(BinnedSpectrum(s1, 10.0, true, 0, 0.0), BinnedSpectrumMatrix::CONTRAST_ANGLE, scores))
+}
+END_SECTION
+
+START_SECTION((void compareOneVsMany(const BinnedSpectrum& query, SimilarityMeasure measure, Size top_k, std::vector<Hit>& hits) const))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  vector<BinnedSpectrumMatrix::Hit> hits;
+  matrix.compareOneVsMany(binned[0], BinnedSpectrumMatrix::CONTRAST_ANGLE, 2, hits);
+  TEST_EQUAL(hits.size(), 2)
+  TEST_EQUAL(hits[0].first, 0)
+  TEST_REAL_SIMILAR(hits[0].second, 1.0)
+  TEST_EQUAL(hits[1].first, 1)
+  TEST_REAL_SIMILAR(hits[1].second, 0.999985)
+}
+END_SECTION
+
+START_SECTION((void compareAllVsAll(SimilarityMeasure measure, DistanceMatrix<float>& similarities) const))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  DistanceMatrix<float> similarities;
+  matrix.compareAllVsAll(BinnedSpectrumMatrix::SHARED_PEAK_COUNT, similarities);
+  TEST_EQUAL(similarities.dimensionsize(), 3)
+  TEST_REAL_SIMILAR(similarities(1, 0), shared_peak_count(binned[1], binned[0]))
+  TEST_REAL_SIMILAR(similarities(2, 0), shared_peak_count(binned[2], binned[0]))
+  TEST_REAL_SIMILAR(similarities(2, 1), shared_peak_count(binned[2], binned[1]))
+}
+END_SECTION
+
+START_SECTION((void compareAllVsAll(SimilarityMeasure measure, Size top_k, std::vector<std::vector<Hit> >& hits) const))
+{
+  BinnedSpectrumMatrix matrix(binned);
+  vector<vector<BinnedSpectrumMatrix::Hit> > hits;
+  matrix.compareAllVsAll(BinnedSpectrumMatrix::CONTRAST_ANGLE, 1, hits);
+  TEST_EQUAL(hits.size(), 3)
+  TEST_EQUAL(hits[0].size(), 1)
+  TEST_EQUAL(hits[0][0].first, 1)
+  TEST_EQUAL(hits[1][0].first, 0)
+  TEST_REAL_SIMILAR(hits[1][0].second, 0.999985)
+  TEST_EQUAL(hits[2].size(), 1)
+  TEST_REAL_SIMILAR(hits[2][0].second, contrast_angle(binned[2], binned[hits[2][0].first]))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
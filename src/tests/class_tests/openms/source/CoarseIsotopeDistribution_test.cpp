@@ -247,6 +247,69 @@ START_SECTION(CoarseIsotopePatternGenerator& convolvePow_(Size factor))
 }
 END_SECTION
 
+START_SECTION(IsotopeDistribution::ContainerType convolveFFT_(const IsotopeDistribution::ContainerType& left, const IsotopeDistribution::ContainerType& right, Size r_max) const)
+{
+  // two uniform distributions of 100 isotopes: the convolution is a triangle
+  IsotopeDistribution::ContainerType uniform;
+  for (Size i = 0; i < 100; ++i)
+  {
+    uniform.push_back(IsotopeDistribution::MassAbundance(10 + i, 0.01));
+  }
+  CoarseIsotopePatternGenerator gen;
+  IsotopeDistribution::ContainerType result = gen.convolveFFT_(uniform, uniform, 199);
+  TEST_EQUAL(result.size(), 199)
+  TEST_EQUAL(result[0].getMZ(), 20)
+  TEST_EQUAL(result[198].getMZ(), 218)
+  TEST_REAL_SIMILAR(result[0].getIntensity(), 0.0001)
+  TEST_REAL_SIMILAR(result[49].getIntensity(), 0.005)
+  TEST_REAL_SIMILAR(result[99].getIntensity(), 0.01)
+  TEST_REAL_SIMILAR(result[198].getIntensity(), 0.0001)
+
+  // truncated result
+  result = gen.convolveFFT_(uniform, uniform, 50);
+  TEST_EQUAL(result.size(), 50)
+  TEST_REAL_SIMILAR(result[49].getIntensity(), 0.005)
+
+  // convolve_ uses the FFT for long distributions and has to give the same result
+  gen.setMaxIsotope(150);
+  IsotopeDistribution::ContainerType direct = gen.convolve_(uniform, uniform);
+  TEST_EQUAL(direct.size(), 150)
+  for (Size i = 0; i < direct.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(direct[i].getIntensity(), (i < 100 ? i + 1 : 199 - i) * 0.0001)
+  }
+}
+END_SECTION
+
+START_SECTION(static void clearElementPowerCache())
+{
+  CoarseIsotopePatternGenerator::clearElementPowerCache();
+  TEST_EQUAL(CoarseIsotopePatternGenerator::getElementPowerCacheSize(), 0)
+}
+END_SECTION
+
+START_SECTION(static Size getElementPowerCacheSize())
+{
+  CoarseIsotopePatternGenerator::clearElementPowerCache();
+  EmpiricalFormula ef("C6H12O6");
+  CoarseIsotopePatternGenerator gen(3);
+  IsotopeDistribution id1 = gen.run(ef);
+  TEST_EQUAL(CoarseIsotopePatternGenerator::getElementPowerCacheSize(), 3)
+  // cached result is identical
+  IsotopeDistribution id2 = gen.run(ef);
+  TEST_EQUAL(CoarseIsotopePatternGenerator::getElementPowerCacheSize(), 3)
+  TEST_EQUAL(id1 == id2, true)
+  // a different max isotope yields separate entries
+  CoarseIsotopePatternGenerator gen2(4);
+  IsotopeDistribution id3 = gen2.run(ef);
+  TEST_EQUAL(CoarseIsotopePatternGenerator::getElementPowerCacheSize(), 6)
+  TEST_EQUAL(id3.size(), 4)
+  TEST_REAL_SIMILAR(id3[2].getIntensity(), id1[2].getIntensity() * id3[0].getIntensity() / id1[0].getIntensity())
+  CoarseIsotopePatternGenerator::clearElementPowerCache();
+  TEST_EQUAL(CoarseIsotopePatternGenerator::getElementPowerCacheSize(), 0)
+}
+END_SECTION
+
 START_SECTION(IsotopeDistribution estimateFromWeightAndComp(double average_weight, double C, double H, double N, double O, double S, double P))
 {
     // We are testing that the parameterized version matches the hardcoded version.
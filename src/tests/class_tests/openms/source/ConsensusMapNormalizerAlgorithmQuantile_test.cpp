@@ -46,6 +46,32 @@ START_TEST(ConsensusMapNormalizerAlgorithmQuantile, "$Id$")
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
+// two maps: intensities 1, 3, 2 (map 0) and 10, 30 (map 1)
+ConsensusMap cmap;
+cmap.getColumnHeaders()[0].size = 3;
+cmap.getColumnHeaders()[1].size = 2;
+{
+  double ints_0[] = {1.0, 3.0, 2.0};
+  double ints_1[] = {10.0, 30.0};
+  for (Size i = 0; i < 3; ++i)
+  {
+    ConsensusFeature cf;
+    FeatureHandle fh;
+    fh.setMapIndex(0);
+    fh.setUniqueId(2 * i);
+    fh.setIntensity(ints_0[i]);
+    cf.insert(fh);
+    if (i < 2)
+    {
+      fh.setMapIndex(1);
+      fh.setUniqueId(2 * i + 1);
+      fh.setIntensity(ints_1[i]);
+      cf.insert(fh);
+    }
+    cmap.push_back(cf);
+  }
+}
+
 ConsensusMapNormalizerAlgorithmQuantile* ptr = nullptr;
 ConsensusMapNormalizerAlgorithmQuantile* null_ptr = nullptr;
 START_SECTION(ConsensusMapNormalizerAlgorithmQuantile())
@@ -69,25 +95,77 @@ END_SECTION
 
 START_SECTION((static void normalizeMaps(ConsensusMap &map)))
 {
-  // TODO
+  // reference distribution: mean of [1, 2, 3] and [10, 20, 30] (resampled) = [5.5, 11, 16.5]
+  ConsensusMap map = cmap;
+  ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(map);
+  vector<vector<double> > ints;
+  ConsensusMapNormalizerAlgorithmQuantile::extractIntensityVectors(map, ints);
+  TEST_EQUAL(ints.size(), 2)
+  TEST_EQUAL(ints[0].size(), 3)
+  TEST_REAL_SIMILAR(ints[0][0], 5.5)
+  TEST_REAL_SIMILAR(ints[0][1], 16.5)
+  TEST_REAL_SIMILAR(ints[0][2], 11.0)
+  TEST_EQUAL(ints[1].size(), 2)
+  TEST_REAL_SIMILAR(ints[1][0], 5.5)
+  TEST_REAL_SIMILAR(ints[1][1], 16.5)
+
+  // ties keep their order, normalizing again does not change anything
+  ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(map);
+  vector<vector<double> > ints_2;
+  ConsensusMapNormalizerAlgorithmQuantile::extractIntensityVectors(map, ints_2);
+  TEST_REAL_SIMILAR(ints_2[0][0], 5.5)
+  TEST_REAL_SIMILAR(ints_2[0][1], 16.5)
+  TEST_REAL_SIMILAR(ints_2[0][2], 11.0)
+  TEST_REAL_SIMILAR(ints_2[1][0], 5.5)
+  TEST_REAL_SIMILAR(ints_2[1][1], 16.5)
 }
 END_SECTION
 
 START_SECTION((static void resample(const std::vector< double > &data_in, std::vector< double > &data_out, UInt n_resampling_points)))
 {
-  // TODO
+  vector<double> data_in = {1.0, 2.0, 4.0};
+  vector<double> data_out;
+  ConsensusMapNormalizerAlgorithmQuantile::resample(data_in, data_out, 5);
+  TEST_EQUAL(data_out.size(), 5)
+  TEST_REAL_SIMILAR(data_out[0], 1.0)
+  TEST_REAL_SIMILAR(data_out[1], 1.5)
+  TEST_REAL_SIMILAR(data_out[2], 2.0)
+  TEST_REAL_SIMILAR(data_out[3], 3.0)
+  TEST_REAL_SIMILAR(data_out[4], 4.0)
+  ConsensusMapNormalizerAlgorithmQuantile::resample(data_in, data_out, 2);
+  TEST_EQUAL(data_out.size(), 2)
+  TEST_REAL_SIMILAR(data_out[0], 1.0)
+  TEST_REAL_SIMILAR(data_out[1], 4.0)
+  ConsensusMapNormalizerAlgorithmQuantile::resample(data_in, data_out, 0);
+  TEST_EQUAL(data_out.size(), 0)
 }
 END_SECTION
 
 START_SECTION((static void extractIntensityVectors(const ConsensusMap &map, std::vector< std::vector< double > > &out_intensities)))
 {
-  // TODO
+  vector<vector<double> > ints;
+  ConsensusMapNormalizerAlgorithmQuantile::extractIntensityVectors(cmap, ints);
+  TEST_EQUAL(ints.size(), 2)
+  TEST_EQUAL(ints[0].size(), 3)
+  TEST_REAL_SIMILAR(ints[0][0], 1.0)
+  TEST_REAL_SIMILAR(ints[0][1], 3.0)
+  TEST_REAL_SIMILAR(ints[0][2], 2.0)
+  TEST_EQUAL(ints[1].size(), 2)
+  TEST_REAL_SIMILAR(ints[1][0], 10.0)
+  TEST_REAL_SIMILAR(ints[1][1], 30.0)
 }
 END_SECTION
 
 START_SECTION((static void setNormalizedIntensityValues(const std::vector< std::vector< double > > &feature_ints, ConsensusMap &map)))
 {
-  // TODO
+  ConsensusMap map = cmap;
+  vector<vector<double> > ints = {{4.0, 5.0, 6.0}, {7.0, 8.0}};
+  ConsensusMapNormalizerAlgorithmQuantile::setNormalizedIntensityValues(ints, map);
+  TEST_REAL_SIMILAR(map[0].getFeatures().begin()->getIntensity(), 4.0)
+  TEST_REAL_SIMILAR(map[0].getFeatures().rbegin()->getIntensity(), 7.0)
+  TEST_REAL_SIMILAR(map[1].getFeatures().begin()->getIntensity(), 5.0)
+  TEST_REAL_SIMILAR(map[1].getFeatures().rbegin()->getIntensity(), 8.0)
+  TEST_REAL_SIMILAR(map[2].getFeatures().begin()->getIntensity(), 6.0)
 }
 END_SECTION
 
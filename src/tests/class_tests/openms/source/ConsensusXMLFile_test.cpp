@@ -245,6 +245,88 @@ START_SECTION([EXTRA](bool isValid(const String &filename)))
   TEST_EQUAL(f.isValid(tmp_filename, std::cerr), true);
 END_SECTION
 
+START_SECTION([EXTRA] store and load of large maps (written and parsed in chunks))
+{
+  // more consensus elements than fit into one chunk (1000), with peptide identifications
+  ConsensusMap map;
+  map.getColumnHeaders()[0].filename = "a.featureXML";
+  map.getColumnHeaders()[0].size = 2500;
+  map.getProteinIdentifications().resize(1);
+  map.getProteinIdentifications()[0].setIdentifier("run1");
+  ProteinHit protein;
+  protein.setAccession("P1");
+  map.getProteinIdentifications()[0].insertHit(protein);
+  for (Size i = 0; i < 2500; ++i)
+  {
+    ConsensusFeature element;
+    element.setRT(double(i));
+    element.setMZ(500.0 + double(i) / 1000.0);
+    element.setIntensity(1000.0 + double(i));
+    element.setUniqueId(i + 1);
+    FeatureHandle handle;
+    handle.setMapIndex(0);
+    handle.setUniqueId(i + 1);
+    handle.setRT(double(i));
+    element.insert(handle);
+    if (i % 5 == 0)
+    {
+      PeptideIdentification peptide_id;
+      peptide_id.setIdentifier("run1");
+      PeptideHit hit;
+      hit.setSequence(AASequence::fromString("PEPTIDE"));
+      PeptideEvidence evidence;
+      evidence.setProteinAccession("P1");
+      hit.addPeptideEvidence(evidence);
+      peptide_id.insertHit(hit);
+      element.getPeptideIdentifications().push_back(peptide_id);
+    }
+    map.push_back(element);
+  }
+
+  String filename;
+  NEW_TMP_FILE(filename);
+  ConsensusXMLFile f;
+  f.store(filename, map);
+
+  ConsensusMap map2;
+  f.load(filename, map2);
+  TEST_EQUAL(map2.size(), 2500)
+  TEST_EQUAL(map2.getProteinIdentifications().size(), 1)
+  bool all_equal = true;
+  for (Size i = 0; i < map2.size(); ++i)
+  {
+    const ConsensusFeature& element = map2[i];
+    if (element.getUniqueId() != i + 1 || element.getRT() != double(i) || element.size() != 1 ||
+        element.begin()->getUniqueId() != i + 1 || element.getPeptideIdentifications().size() != (i % 5 == 0 ? 1u : 0u))
+    {
+      all_equal = false;
+      break;
+    }
+    if (!element.getPeptideIdentifications().empty() &&
+        (element.getPeptideIdentifications()[0].getIdentifier() != map2.getProteinIdentifications()[0].getIdentifier() ||
+         element.getPeptideIdentifications()[0].getHits()[0].getPeptideEvidences()[0].getProteinAccession() != "P1"))
+    {
+      all_equal = false;
+      break;
+    }
+  }
+  TEST_EQUAL(all_equal, true)
+
+  // storing the loaded map again gives the same file
+  String filename2;
+  NEW_TMP_FILE(filename2);
+  f.store(filename2, map2);
+  TEST_FILE_EQUAL(filename.c_str(), filename2.c_str())
+
+  // range restrictions are applied in all chunks
+  f.getOptions().setRTRange(makeRange(1000.0, 1999.0));
+  f.load(filename, map2);
+  TEST_EQUAL(map2.size(), 1000)
+  TEST_EQUAL(map2[0].getRT(), 1000.0)
+  TEST_EQUAL(map2[999].getRT(), 1999.0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
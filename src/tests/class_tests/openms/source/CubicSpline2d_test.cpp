@@ -135,6 +135,29 @@ START_SECTION(double eval(double x))
   }
 END_SECTION
 
+START_SECTION(double eval(double x, unsigned& index))
+  // increasing positions (including the nodes), passing on the index
+  unsigned index = 0;
+  for (Size i = 0; i < 4 * n + 1; ++i)
+  {
+    double xx = x_min + (double)i / (4 * n) * (x_max - x_min);
+    TEST_REAL_SIMILAR(sp5.eval(xx, index), sp5.eval(xx));
+  }
+  TEST_EQUAL(index, n - 1);
+  // decreasing positions
+  for (Size i = 0; i < 4 * n + 1; ++i)
+  {
+    double xx = x_max - (double)i / (4 * n) * (x_max - x_min);
+    TEST_REAL_SIMILAR(sp5.eval(xx, index), sp5.eval(xx));
+  }
+  TEST_EQUAL(index, 0);
+  // invalid start index
+  index = 1000;
+  TEST_REAL_SIMILAR(sp1.eval(486.794, index), 2271426.93316241);
+  TEST_EQUAL(index, 3);
+  TEST_EXCEPTION(Exception::IllegalArgument, sp1.eval(486.7, index));
+END_SECTION
+
 START_SECTION(double derivatives(double x, unsigned order))
   // near border of spline range
   TEST_REAL_SIMILAR(sp1.derivatives(486.785,1), 39270152.2996247)
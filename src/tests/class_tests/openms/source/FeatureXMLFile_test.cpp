@@ -387,7 +387,88 @@ START_SECTION([EXTRA])
 }
 END_SECTION
 
+START_SECTION([EXTRA] store and load of large maps (written and parsed in chunks))
+{
+  // more features than fit into one chunk (1000), with subordinates and peptide identifications
+  FeatureMap map;
+  map.getProteinIdentifications().resize(1);
+  map.getProteinIdentifications()[0].setIdentifier("run1");
+  ProteinHit protein;
+  protein.setAccession("P1");
+  map.getProteinIdentifications()[0].insertHit(protein);
+  for (Size i = 0; i < 2500; ++i)
+  {
+    Feature feature;
+    feature.setRT(double(i));
+    feature.setMZ(500.0 + double(i) / 1000.0);
+    feature.setIntensity(1000.0 + double(i));
+    feature.setUniqueId(i + 1);
+    feature.setMetaValue("index", int(i));
+    if (i % 3 == 0)
+    {
+      Feature subordinate;
+      subordinate.setRT(double(i) + 0.5);
+      subordinate.setUniqueId(100000 + i);
+      feature.getSubordinates().push_back(subordinate);
+    }
+    if (i % 5 == 0)
+    {
+      PeptideIdentification peptide_id;
+      peptide_id.setIdentifier("run1");
+      PeptideHit hit;
+      hit.setSequence(AASequence::fromString("PEPTIDE"));
+      PeptideEvidence evidence;
+      evidence.setProteinAccession("P1");
+      hit.addPeptideEvidence(evidence);
+      peptide_id.insertHit(hit);
+      feature.getPeptideIdentifications().push_back(peptide_id);
+    }
+    map.push_back(feature);
+  }
+
+  String filename;
+  NEW_TMP_FILE(filename);
+  FeatureXMLFile f;
+  f.store(filename, map);
+
+  FeatureMap map2;
+  f.load(filename, map2);
+  TEST_EQUAL(map2.size(), 2500)
+  TEST_EQUAL(map2.getProteinIdentifications().size(), 1)
+  bool all_equal = true;
+  for (Size i = 0; i < map2.size(); ++i)
+  {
+    const Feature& feature = map2[i];
+    if (feature.getUniqueId() != i + 1 || feature.getRT() != double(i) || int(feature.getMetaValue("index")) != int(i) ||
+        feature.getSubordinates().size() != (i % 3 == 0 ? 1u : 0u) || feature.getPeptideIdentifications().size() != (i % 5 == 0 ? 1u : 0u))
+    {
+      all_equal = false;
+      break;
+    }
+    if (!feature.getPeptideIdentifications().empty() &&
+        (feature.getPeptideIdentifications()[0].getIdentifier() != map2.getProteinIdentifications()[0].getIdentifier() ||
+         feature.getPeptideIdentifications()[0].getHits()[0].getPeptideEvidences()[0].getProteinAccession() != "P1"))
+    {
+      all_equal = false;
+      break;
+    }
+  }
+  TEST_EQUAL(all_equal, true)
 
+  // storing the loaded map again gives the same file
+  String filename2;
+  NEW_TMP_FILE(filename2);
+  f.store(filename2, map2);
+  TEST_FILE_EQUAL(filename.c_str(), filename2.c_str())
+
+  // range restrictions are applied in all chunks
+  f.getOptions().setRTRange(makeRange(1000.0, 1999.0));
+  f.load(filename, map2);
+  TEST_EQUAL(map2.size(), 1000)
+  TEST_EQUAL(map2[0].getRT(), 1000.0)
+  TEST_EQUAL(map2[999].getRT(), 1999.0)
+}
+END_SECTION
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
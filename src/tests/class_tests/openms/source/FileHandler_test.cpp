@@ -40,6 +40,8 @@
 #include <OpenMS/FORMAT/FileTypes.h>
 ///////////////////////////
 
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+
 #include <OpenMS/KERNEL/FeatureMap.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
@@ -272,6 +274,43 @@ TEST_EQUAL(tmp.loadFeatures(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_2_options.
 TEST_EQUAL(map.size(), 7);
 END_SECTION
 
+START_SECTION((bool loadIdentifications(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids, FileTypes::Type force_type = FileTypes::UNKNOWN)))
+FileHandler tmp;
+vector<ProteinIdentification> protein_ids;
+vector<PeptideIdentification> peptide_ids;
+TEST_EQUAL(tmp.loadIdentifications("test.bla", protein_ids, peptide_ids), false)
+TEST_EQUAL(tmp.loadIdentifications(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids, peptide_ids), true)
+TEST_EQUAL(protein_ids.size(), 2)
+TEST_EQUAL(peptide_ids.size(), 3)
+TEST_EQUAL(tmp.loadIdentifications(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_2_options.featureXML"), protein_ids, peptide_ids), false)
+
+// idBin is recognized by content
+String filename;
+NEW_TMP_FILE(filename)
+IdBinaryFile().store(filename, protein_ids, peptide_ids);
+TEST_EQUAL(tmp.getTypeByContent(filename), FileTypes::IDBIN)
+vector<ProteinIdentification> protein_ids2;
+vector<PeptideIdentification> peptide_ids2;
+TEST_EQUAL(tmp.loadIdentifications(filename, protein_ids2, peptide_ids2), true)
+TEST_EQUAL(protein_ids2 == protein_ids, true)
+TEST_EQUAL(peptide_ids2 == peptide_ids, true)
+END_SECTION
+
+START_SECTION((void storeIdentifications(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids)))
+FileHandler tmp;
+vector<ProteinIdentification> protein_ids, protein_ids2;
+vector<PeptideIdentification> peptide_ids, peptide_ids2;
+tmp.loadIdentifications(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids, peptide_ids);
+
+// unknown extension: idXML is used
+String filename;
+NEW_TMP_FILE(filename)
+tmp.storeIdentifications(filename, protein_ids, peptide_ids);
+TEST_EQUAL(tmp.getTypeByContent(filename), FileTypes::IDXML)
+TEST_EQUAL(tmp.loadIdentifications(filename, protein_ids2, peptide_ids2), true)
+TEST_EQUAL(peptide_ids2.size(), 3)
+END_SECTION
+
 START_SECTION((void storeExperiment(const String &filename, const MSExperiment<>&exp, ProgressLogger::LogType log = ProgressLogger::NONE)))
 FileHandler fh;
 PeakMap exp;
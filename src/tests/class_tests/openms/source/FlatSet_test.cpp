@@ -0,0 +1,228 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+#include <OpenMS/DATASTRUCTURES/FlatSet.h>
+///////////////////////////
+
+#include <OpenMS/KERNEL/FeatureHandle.h>
+
+#include <functional>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FlatSet, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FlatSet<int>* ptr = nullptr;
+FlatSet<int>* null_ptr = nullptr;
+
+START_SECTION((FlatSet()))
+{
+  ptr = new FlatSet<int>();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION((~FlatSet()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((template <typename InputIterator> FlatSet(InputIterator first, InputIterator last, const Compare& comp = Compare())))
+{
+  vector<int> v = {5, 3, 9, 3, 1, 5};
+  FlatSet<int> s(v.begin(), v.end());
+  TEST_EQUAL(s.size(), 4)
+  vector<int> expected = {1, 3, 5, 9};
+  TEST_EQUAL(vector<int>(s.begin(), s.end()) == expected, true)
+
+  FlatSet<int, std::greater<int> > r(v.begin(), v.end());
+  vector<int> expected_r = {9, 5, 3, 1};
+  TEST_EQUAL(vector<int>(r.begin(), r.end()) == expected_r, true)
+}
+END_SECTION
+
+START_SECTION((std::pair<iterator, bool> insert(const value_type& value)))
+{
+  FlatSet<int> s;
+  // append (fast path)
+  TEST_EQUAL(s.insert(1).second, true)
+  TEST_EQUAL(s.insert(4).second, true)
+  // insertion in the middle and at the front
+  pair<FlatSet<int>::iterator, bool> res = s.insert(2);
+  TEST_EQUAL(res.second, true)
+  TEST_EQUAL(*res.first, 2)
+  TEST_EQUAL(s.insert(0).second, true)
+  // duplicate
+  res = s.insert(4);
+  TEST_EQUAL(res.second, false)
+  TEST_EQUAL(*res.first, 4)
+  TEST_EQUAL(s.size(), 4)
+  vector<int> expected = {0, 1, 2, 4};
+  TEST_EQUAL(vector<int>(s.begin(), s.end()) == expected, true)
+
+  // std::inserter uses the hinted insert
+  vector<int> v = {7, 2, 3, 8};
+  std::copy(v.begin(), v.end(), std::inserter(s, s.end()));
+  expected = {0, 1, 2, 3, 4, 7, 8};
+  TEST_EQUAL(vector<int>(s.begin(), s.end()) == expected, true)
+}
+END_SECTION
+
+START_SECTION((template <typename InputIterator> void insert(InputIterator first, InputIterator last)))
+{
+  // same semantics as std::set: already present elements win, then the first of the range
+  typedef pair<int, int> IntPair;
+  typedef vector<IntPair> IntPairVector;
+  typedef FlatSet<IntPair, std::function<bool(const IntPair&, const IntPair&)> > PairSet;
+  auto first_less = [](const IntPair& a, const IntPair& b) { return a.first < b.first; };
+  PairSet s(first_less);
+  s.insert(make_pair(2, 0));
+  s.insert(make_pair(4, 0));
+  IntPairVector v = { {3, 1}, {2, 1}, {1, 1}, {3, 2}, {5, 1} };
+  s.insert(v.begin(), v.end());
+  TEST_EQUAL(s.size(), 5)
+  IntPairVector expected = { {1, 1}, {2, 0}, {3, 1}, {4, 0}, {5, 1} };
+  TEST_EQUAL(IntPairVector(s.begin(), s.end()) == expected, true)
+
+  // compare to std::set
+  set<IntPair, std::function<bool(const IntPair&, const IntPair&)> > ref(first_less);
+  ref.insert(make_pair(2, 0));
+  ref.insert(make_pair(4, 0));
+  ref.insert(v.begin(), v.end());
+  TEST_EQUAL(IntPairVector(ref.begin(), ref.end()) == expected, true)
+
+  // empty range
+  s.insert(v.end(), v.end());
+  TEST_EQUAL(s.size(), 5)
+}
+END_SECTION
+
+START_SECTION((const_iterator find(const key_type& key) const))
+{
+  FlatSet<int> s = {10, 20, 30};
+  TEST_EQUAL(*s.find(20), 20)
+  TEST_EQUAL(s.find(25) == s.end(), true)
+  TEST_EQUAL(s.count(10), 1)
+  TEST_EQUAL(s.count(11), 0)
+  TEST_EQUAL(*s.lower_bound(15), 20)
+  TEST_EQUAL(*s.upper_bound(20), 30)
+  TEST_EQUAL(s.upper_bound(30) == s.end(), true)
+  typedef FlatSet<int>::const_iterator ConstIt;
+  pair<ConstIt, ConstIt> range = s.equal_range(20);
+  TEST_EQUAL(std::distance(range.first, range.second), 1)
+}
+END_SECTION
+
+START_SECTION((size_type erase(const key_type& key)))
+{
+  FlatSet<int> s = {1, 2, 3, 4, 5};
+  TEST_EQUAL(s.erase(3), 1)
+  TEST_EQUAL(s.erase(3), 0)
+  FlatSet<int>::iterator it = s.erase(s.begin());
+  TEST_EQUAL(*it, 2)
+  s.erase(s.begin(), s.find(5));
+  TEST_EQUAL(s.size(), 1)
+  TEST_EQUAL(*s.begin(), 5)
+  s.clear();
+  TEST_EQUAL(s.empty(), true)
+}
+END_SECTION
+
+START_SECTION((const_reverse_iterator rbegin() const))
+{
+  FlatSet<int> s = {3, 1, 2};
+  vector<int> expected = {3, 2, 1};
+  TEST_EQUAL(vector<int>(s.rbegin(), s.rend()) == expected, true)
+}
+END_SECTION
+
+START_SECTION((bool operator==(const FlatSet& rhs) const))
+{
+  FlatSet<int> a = {1, 2, 3};
+  FlatSet<int> b = {3, 2, 1};
+  FlatSet<int> c = {1, 2};
+  TEST_EQUAL(a == b, true)
+  TEST_EQUAL(a != c, true)
+  TEST_EQUAL(c < a, true)
+  TEST_EQUAL(a < c, false)
+  swap(a, c);
+  TEST_EQUAL(a.size(), 2)
+  TEST_EQUAL(c.size(), 3)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] FlatSet<FeatureHandle, FeatureHandle::IndexLess>))
+{
+  // same order and uniqueness as std::set for the consensus handles
+  FlatSet<FeatureHandle, FeatureHandle::IndexLess> flat;
+  set<FeatureHandle, FeatureHandle::IndexLess> ref;
+  for (UInt64 map = 0; map < 3; ++map)
+  {
+    for (UInt64 id = 5; id > 0; --id)
+    {
+      FeatureHandle fh;
+      fh.setMapIndex(2 - map);
+      fh.setUniqueId(id % 3);
+      fh.setRT(double(id));
+      TEST_EQUAL(flat.insert(fh).second, ref.insert(fh).second)
+    }
+  }
+  TEST_EQUAL(flat.size(), ref.size())
+  set<FeatureHandle, FeatureHandle::IndexLess>::const_iterator it_ref = ref.begin();
+  for (FlatSet<FeatureHandle, FeatureHandle::IndexLess>::const_iterator it = flat.begin(); it != flat.end(); ++it, ++it_ref)
+  {
+    TEST_EQUAL(it->getMapIndex(), it_ref->getMapIndex())
+    TEST_EQUAL(it->getUniqueId(), it_ref->getUniqueId())
+    TEST_REAL_SIMILAR(it->getRT(), it_ref->getRT())
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -38,11 +38,13 @@
 ///////////////////////////
 
 #include <iostream>
+#include <sstream>
 
 #include <OpenMS/ANALYSIS/ID/IDMapper.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 #include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/CONCEPT/LogStream.h>
 
 ///////////////////////////
 
@@ -401,6 +403,62 @@ START_SECTION((template < typename FeatureType > void annotate(FeatureMap< Featu
   TEST_EQUAL(fm_ppm.getUnassignedPeptideIdentifications()[0].getHits()[1].getSequence(), AASequence::fromString("DEADA"))
   TEST_EQUAL(fm_ppm.getUnassignedPeptideIdentifications()[1].getHits()[0].getSequence(), AASequence::fromString("DEADAA"))
   TEST_EQUAL(fm_ppm.getUnassignedPeptideIdentifications()[1].getHits()[1].getSequence(), AASequence::fromString("DEADAAA"))
+
+  // ******* unidentified precursors matched to centroids *******
+  {
+    FeatureMap fm_prec;
+    Feature feat;
+    feat.setCharge(2);
+    feat.setRT(100.0);
+    feat.setMZ(500.0);
+    fm_prec.push_back(feat);
+    feat.setRT(200.0);
+    feat.setMZ(600.0);
+    fm_prec.push_back(feat);
+
+    // two precursors match one feature each, the third one matches none
+    PeakMap experiment;
+    double prec_rts[3] = { 101.0, 199.0, 150.0 };
+    double prec_mzs[3] = { 500.005, 600.0, 550.0 };
+    for (Size i = 0; i != 3; ++i)
+    {
+      MSSpectrum spectrum;
+      spectrum.setRT(prec_rts[i]);
+      vector<Precursor> precursors(1);
+      precursors[0].setMZ(prec_mzs[i]);
+      spectrum.setPrecursors(precursors);
+      experiment.addSpectrum(spectrum);
+    }
+
+    IDMapper mapper_prec;
+    p = mapper_prec.getParameters();
+    p.setValue("rt_tolerance", 5.0);
+    p.setValue("mz_tolerance", 0.01);
+    p.setValue("mz_measure", "Da");
+    p.setValue("ignore_charge", "true");
+    mapper_prec.setParameters(p);
+
+    // capture the statistics
+    ostringstream log_stream;
+    OpenMS_Log_info.remove(cout);
+    OpenMS_Log_info.rdbuf()->clearCache();
+    OpenMS_Log_info.insert(log_stream);
+    mapper_prec.annotate(fm_prec, vector<PeptideIdentification>(), vector<ProteinIdentification>(), true, true, experiment);
+    OpenMS_Log_info.remove(log_stream);
+    OpenMS_Log_info.insert(cout);
+
+    TEST_EQUAL(fm_prec[0].getPeptideIdentifications().size(), 1)
+    TEST_EQUAL(fm_prec[0].getPeptideIdentifications()[0].getHits().empty(), true)
+    TEST_EQUAL(fm_prec[0].getPeptideIdentifications()[0].getMetaValue("spectrum_index"), 0)
+    TEST_EQUAL(fm_prec[1].getPeptideIdentifications().size(), 1)
+    TEST_EQUAL(fm_prec[1].getPeptideIdentifications()[0].getMetaValue("spectrum_index"), 1)
+    TEST_EQUAL(fm_prec.getUnassignedPeptideIdentifications().size(), 0)
+
+    String log = log_stream.str();
+    TEST_EQUAL(log.hasSubstring("Unassigned and unidentified precursors: 1"), true)
+    TEST_EQUAL(log.hasSubstring("Unidentified precursor assigned to exactly one feature: 2"), true)
+    TEST_EQUAL(log.hasSubstring("Unidentified precursor assigned to multiple features: 0"), true)
+  }
 }
 END_SECTION
 
@@ -587,6 +645,76 @@ START_SECTION((void annotate(ConsensusMap& map, const std::vector<PeptideIdentif
     WHITELIST("<?xml-stylesheet, date=");
     TEST_FILE_SIMILAR(tmp_filename, OPENMS_GET_TEST_DATA_PATH("IDMapper_6_out3.consensusXML"));
   }
+
+  // matches exactly at the tolerance edges and across m/z buckets (1 Th) of
+  // the feature index, in Da (500 +/- 0.5) and ppm mode (512 +/- 976.5625 ppm
+  // = 0.5 Th, all values exactly representable)
+  {
+    const char* measures[2] = { "Da", "ppm" };
+    double mz_tolerances[2] = { 0.5, 976.5625 };
+    double id_mzs[2] = { 500.0, 512.0 };
+
+    // the first four positions are within tolerance, the last two not
+    double rt_offsets[6] = { 0.0, 0.0, 2.0, -2.0, 0.0, 2.25 };
+    double mz_offsets[6] = { -0.5, 0.5, 0.0, 0.0, 0.625, 0.0 };
+
+    for (Size m = 0; m != 2; ++m)
+    {
+      IDMapper mapper_edge;
+      p = mapper_edge.getParameters();
+      p.setValue("rt_tolerance", 2.0);
+      p.setValue("mz_tolerance", mz_tolerances[m]);
+      p.setValue("mz_measure", measures[m]);
+      p.setValue("ignore_charge", "true");
+      mapper_edge.setParameters(p);
+
+      vector<PeptideIdentification> edge_ids(2);
+      edge_ids[0].setRT(100.0);
+      edge_ids[0].setMZ(id_mzs[m]);
+      edge_ids[0].insertHit(PeptideHit(1.0, 1, 2, AASequence::fromString("PEPTIDE")));
+      edge_ids[1] = edge_ids[0];
+      edge_ids[1].setRT(300.0);
+
+      // distance from the consensus centroids
+      ConsensusMap cm_centroid;
+      for (Size i = 0; i != 6; ++i)
+      {
+        ConsensusFeature cf;
+        cf.setRT(100.0 + rt_offsets[i]);
+        cf.setMZ(id_mzs[m] + mz_offsets[i]);
+        cf.setUniqueId(i + 1);
+        cm_centroid.push_back(cf);
+      }
+      mapper_edge.annotate(cm_centroid, edge_ids, vector<ProteinIdentification>());
+      for (Size i = 0; i != 6; ++i)
+      {
+        TEST_EQUAL(cm_centroid[i].getPeptideIdentifications().size(), i < 4 ? 1 : 0)
+      }
+      TEST_EQUAL(cm_centroid.getUnassignedPeptideIdentifications().size(), 1)
+      TEST_REAL_SIMILAR(cm_centroid.getUnassignedPeptideIdentifications()[0].getRT(), 300.0)
+
+      // distance from the sub-elements (centroids are far off)
+      ConsensusMap cm_sub;
+      for (Size i = 0; i != 6; ++i)
+      {
+        ConsensusFeature cf;
+        cf.setRT(1000.0);
+        cf.setMZ(1000.0);
+        cf.setUniqueId(i + 1);
+        Peak2D pos;
+        pos.setRT(100.0 + rt_offsets[i]);
+        pos.setMZ(id_mzs[m] + mz_offsets[i]);
+        cf.insert(FeatureHandle(0, pos, i));
+        cm_sub.push_back(cf);
+      }
+      mapper_edge.annotate(cm_sub, edge_ids, vector<ProteinIdentification>(), true);
+      for (Size i = 0; i != 6; ++i)
+      {
+        TEST_EQUAL(cm_sub[i].getPeptideIdentifications().size(), i < 4 ? 1 : 0)
+      }
+      TEST_EQUAL(cm_sub.getUnassignedPeptideIdentifications().size(), 1)
+    }
+  }
 }
 END_SECTION
 
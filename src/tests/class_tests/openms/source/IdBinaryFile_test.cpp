@@ -0,0 +1,208 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/IdBinaryFile.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+
+#include <fstream>
+
+///////////////////////////
+
+START_TEST(IdBinaryFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+IdBinaryFile* ptr = nullptr;
+IdBinaryFile* nullPointer = nullptr;
+START_SECTION((IdBinaryFile()))
+  ptr = new IdBinaryFile();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getColumnFilter().empty(), true)
+END_SECTION
+
+START_SECTION((~IdBinaryFile()))
+  delete ptr;
+END_SECTION
+
+// test data: the idXML example, plus a peptide identification using all attributes of a hit
+vector<ProteinIdentification> protein_ids;
+vector<PeptideIdentification> peptide_ids;
+IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids, peptide_ids);
+{
+  PeptideHit hit(12.5, 1, 3, AASequence::fromString("PEPM(Oxidation)TIDEK"));
+  PeptideEvidence pe("PROT1", 10, 20, 'K', 'A');
+  hit.addPeptideEvidence(pe);
+  PeptideHit::PeakAnnotation pa;
+  pa.annotation = "y3+";
+  pa.charge = 1;
+  pa.mz = 345.6;
+  pa.intensity = 1000.0;
+  hit.setPeakAnnotations(vector<PeptideHit::PeakAnnotation>(1, pa));
+  PeptideHit::PepXMLAnalysisResult ar;
+  ar.score_type = "peptideprophet";
+  ar.higher_is_better = true;
+  ar.main_score = 0.99;
+  ar.sub_scores["fval"] = 1.5;
+  hit.addAnalysisResults(ar);
+  hit.setMetaValue("string", "value");
+  hit.setMetaValue("int", 42);
+  hit.setMetaValue("double", 0.25);
+  hit.setMetaValue("string_list", ListUtils::create<String>("a,b,a"));
+  hit.setMetaValue("int_list", ListUtils::create<Int>("1,-2,3"));
+  hit.setMetaValue("double_list", ListUtils::create<double>("0.5,1.5"));
+
+  PeptideIdentification pep_id;
+  pep_id.setIdentifier(protein_ids[0].getIdentifier());
+  pep_id.setScoreType("XTandem");
+  pep_id.setRT(100.5);
+  pep_id.setMZ(500.25);
+  pep_id.setBaseName("run1");
+  pep_id.setMetaValue("spectrum_reference", "scan=42");
+  pep_id.insertHit(hit);
+  peptide_ids.push_back(pep_id);
+  peptide_ids.push_back(PeptideIdentification()); // no hits
+}
+
+START_SECTION((void store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(filename), true)
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename, std::vector<ProteinIdentification>& protein_ids, std::vector<PeptideIdentification>& peptide_ids)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+
+  vector<ProteinIdentification> protein_ids2;
+  vector<PeptideIdentification> peptide_ids2;
+  IdBinaryFile().load(filename, protein_ids2, peptide_ids2);
+  TEST_EQUAL(protein_ids2.size(), protein_ids.size())
+  TEST_EQUAL(peptide_ids2.size(), peptide_ids.size())
+  TEST_EQUAL(protein_ids2 == protein_ids, true)
+  TEST_EQUAL(peptide_ids2 == peptide_ids, true)
+
+  const PeptideHit& hit = peptide_ids2[3].getHits()[0];
+  TEST_EQUAL(hit.getSequence().toString(), "PEPM(Oxidation)TIDEK")
+  TEST_EQUAL(hit.getPeptideEvidences().size(), 1)
+  TEST_EQUAL(hit.getPeptideEvidences()[0].getProteinAccession(), "PROT1")
+  TEST_EQUAL(hit.getPeakAnnotations().size(), 1)
+  TEST_EQUAL(hit.getAnalysisResults().size(), 1)
+  TEST_EQUAL(hit.getMetaValue("int_list").toIntList()[1], -2)
+  TEST_EQUAL(peptide_ids2[3].getMetaValue("spectrum_reference"), "scan=42")
+  TEST_EQUAL(peptide_ids2[4].getHits().empty(), true)
+
+  // invalid files
+  TEST_EXCEPTION(Exception::FileNotFound, IdBinaryFile().load("this_file_does_not_exist.idBin", protein_ids2, peptide_ids2))
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids2, peptide_ids2))
+
+  String truncated;
+  NEW_TMP_FILE(truncated)
+  {
+    ifstream is(filename.c_str(), ios::binary);
+    std::string content((istreambuf_iterator<char>(is)), istreambuf_iterator<char>());
+    ofstream os(truncated.c_str(), ios::binary);
+    os.write(content.data(), content.size() / 2);
+  }
+  TEST_EXCEPTION(Exception::ParseError, IdBinaryFile().load(truncated, protein_ids2, peptide_ids2))
+}
+END_SECTION
+
+START_SECTION((static StringList getColumnNames(const String& filename)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+  StringList names = IdBinaryFile::getColumnNames(filename);
+  TEST_EQUAL(ListUtils::contains(names, "proteins"), true)
+  TEST_EQUAL(ListUtils::contains(names, "peptide_id.hit_count"), true)
+  TEST_EQUAL(ListUtils::contains(names, "peptide_id.meta:spectrum_reference"), true)
+  TEST_EQUAL(ListUtils::contains(names, "hit.sequence"), true)
+  TEST_EQUAL(ListUtils::contains(names, "hit.meta:double_list"), true)
+  TEST_EXCEPTION(Exception::FileNotFound, IdBinaryFile::getColumnNames("this_file_does_not_exist.idBin"))
+}
+END_SECTION
+
+START_SECTION((static bool isIdBinaryFile(const String& filename)))
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML")), false)
+  TEST_EQUAL(IdBinaryFile::isIdBinaryFile("this_file_does_not_exist.idBin"), false)
+END_SECTION
+
+START_SECTION((void setColumnFilter(const StringList& columns)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdBinaryFile().store(filename, protein_ids, peptide_ids);
+
+  IdBinaryFile file;
+  file.setColumnFilter(ListUtils::create<String>("hit.score,hit.meta:*"));
+  vector<ProteinIdentification> protein_ids2;
+  vector<PeptideIdentification> peptide_ids2;
+  file.load(filename, protein_ids2, peptide_ids2);
+  TEST_EQUAL(protein_ids2.empty(), true)
+  TEST_EQUAL(peptide_ids2.size(), peptide_ids.size())
+  const PeptideHit& hit = peptide_ids2[3].getHits()[0];
+  TEST_REAL_SIMILAR(hit.getScore(), 12.5)
+  TEST_EQUAL(hit.getMetaValue("int"), 42)
+  TEST_EQUAL(hit.getSequence().empty(), true)
+  TEST_EQUAL(hit.getPeptideEvidences().empty(), true)
+  TEST_EQUAL(peptide_ids2[3].hasRT(), false)
+  TEST_EQUAL(peptide_ids2[3].metaValueExists("spectrum_reference"), false)
+}
+END_SECTION
+
+START_SECTION((const StringList& getColumnFilter() const))
+  IdBinaryFile file;
+  file.setColumnFilter(ListUtils::create<String>("hit.*"));
+  TEST_EQUAL(file.getColumnFilter().size(), 1)
+  TEST_EQUAL(file.getColumnFilter()[0], "hit.*")
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
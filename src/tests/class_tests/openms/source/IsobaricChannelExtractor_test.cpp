@@ -515,6 +515,40 @@ START_SECTION((void extractChannels(const PeakMap&ms_exp_data, ConsensusMap & co
 }
 END_SECTION
 
+START_SECTION((void extractChannels(const String& mzml_file, ConsensusMap& consensus_map)))
+{
+  // streaming from disk has to give the same result as extracting from the loaded experiment
+  PeakMap exp_purity;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp_purity);
+
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  ConsensusMap cm_loaded, cm_streamed;
+  ice.extractChannels(exp_purity, cm_loaded);
+  ice.extractChannels(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), cm_streamed);
+
+  TEST_EQUAL(cm_streamed.size(), 5)
+  ABORT_IF(cm_streamed.size() != cm_loaded.size())
+  for (Size i = 0; i < cm_streamed.size(); ++i)
+  {
+    TEST_EQUAL(cm_streamed[i].getMetaValue("scan_id"), cm_loaded[i].getMetaValue("scan_id"))
+    TEST_REAL_SIMILAR(cm_streamed[i].getMetaValue("precursor_purity"), cm_loaded[i].getMetaValue("precursor_purity"))
+    TEST_REAL_SIMILAR(cm_streamed[i].getIntensity(), cm_loaded[i].getIntensity())
+    TEST_EQUAL(cm_streamed[i].size(), cm_loaded[i].size())
+    ConsensusFeature::const_iterator it_s = cm_streamed[i].begin(), it_l = cm_loaded[i].begin();
+    for (; it_s != cm_streamed[i].end() && it_l != cm_loaded[i].end(); ++it_s, ++it_l)
+    {
+      TEST_REAL_SIMILAR(it_s->getIntensity(), it_l->getIntensity())
+    }
+  }
+  TEST_REAL_SIMILAR(cm_streamed[1].getMetaValue("precursor_purity"), 0.692434)
+  TEST_EQUAL(cm_streamed.getColumnHeaders().size(), 4)
+}
+END_SECTION
+
 START_SECTION(([EXTRA] purity computation without interpolation))
 {
   // check precursor purity computation
@@ -36,6 +36,7 @@
 #include <OpenMS/test_config.h>
 
 #include <OpenMS/FILTERING/DATAREDUCTION/IsotopeDistributionCache.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
 
 using namespace OpenMS;
 
@@ -57,5 +58,32 @@ START_SECTION(const TheoreticalIsotopePattern& getIsotopeDistribution(double mas
   TEST_EQUAL(&p != &c.getIsotopeDistribution(499.9), true);
 END_SECTION
 
+START_SECTION(const TheoreticalIsotopePattern& getIsotopeDistribution(const EmpiricalFormula& formula) const)
+  IsotopeDistributionCache c(1000, 10);
+  TEST_EQUAL(c.getFormulaCacheSize(), 0)
+  const IsotopeDistributionCache::TheoreticalIsotopePattern &p(c.getIsotopeDistribution(EmpiricalFormula("C6H12O6")));
+  TEST_EQUAL(c.getFormulaCacheSize(), 1)
+  TEST_REAL_SIMILAR(p.intensity[0], 1);
+  TEST_REAL_SIMILAR(p.intensity[1], 0.0685601);
+  TEST_REAL_SIMILAR(p.max, 0.922633);
+  TEST_EQUAL(p.trimmed_left, 0);
+  // second request is served from the cache
+  TEST_EQUAL(&p == &c.getIsotopeDistribution(EmpiricalFormula("C6H12O6")), true);
+  TEST_EQUAL(&p != &c.getIsotopeDistribution(EmpiricalFormula("C6H12O5")), true);
+  TEST_EQUAL(c.getFormulaCacheSize(), 2)
+END_SECTION
+
+START_SECTION(Size getFormulaCacheSize() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(void clearFormulaCache())
+  IsotopeDistributionCache c(100, 1);
+  c.getIsotopeDistribution(EmpiricalFormula("C6H12O6"));
+  TEST_EQUAL(c.getFormulaCacheSize(), 1)
+  c.clearFormulaCache();
+  TEST_EQUAL(c.getFormulaCacheSize(), 0)
+END_SECTION
+
 END_TEST
 
@@ -41,6 +41,22 @@
 using namespace OpenMS;
 using namespace std;
 
+// brute-force version of queryRegion
+vector<Size> queryLinear(const KDTreeFeatureMaps& kd_data, double rt_low, double rt_high, double mz_low, double mz_high, Size ignored_map_index)
+{
+  vector<Size> result;
+  for (Size i = 0; i < kd_data.size(); ++i)
+  {
+    if (kd_data.rt(i) >= rt_low && kd_data.rt(i) <= rt_high &&
+        kd_data.mz(i) >= mz_low && kd_data.mz(i) <= mz_high &&
+        kd_data.mapIndex(i) != ignored_map_index)
+    {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
 START_TEST(KDTreeFeatureMaps, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -167,16 +183,70 @@ START_SECTION((void clear()))
   TEST_EQUAL(kd_data_3.treeSize(), 0)
 END_SECTION
 
+// features on a grid (with duplicate positions), distributed over three maps
+vector<FeatureMap> grid_maps(3);
+for (Size i = 0; i < 300; ++i)
+{
+  Feature f;
+  f.setRT(100.0 + 10.0 * (i % 17));
+  f.setMZ(400.0 + 0.5 * ((i * 7) % 23));
+  grid_maps[i % 3].push_back(f);
+}
+
+KDTreeFeatureMaps kd_grid(grid_maps, p);
+
 START_SECTION((void optimizeTree()))
-  NOT_TESTABLE;
+  // features added after building the tree are found (before and after rebuilding)
+  KDTreeFeatureMaps kd_data(fmaps, p);
+  Feature f3;
+  f3.setMZ(450);
+  f3.setRT(1500);
+  kd_data.addFeature(1, &f3);
+  vector<Size> result;
+  kd_data.queryRegion(1400, 1600, 440, 460, result);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 2)
+  kd_data.optimizeTree();
+  kd_data.queryRegion(1400, 1600, 440, 460, result);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 2)
+  kd_data.queryRegion(0, 3000, 0, 1000, result);
+  TEST_EQUAL(result.size(), 3)
 END_SECTION
 
-START_SECTION((void getNeighborhood(Size index, std::vector<Size>& result_indices, bool include_features_from_same_map = false) const))
-  NOT_TESTABLE;
+START_SECTION((void getNeighborhood(Size index, std::vector<Size>& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map = false, double max_pairwise_log_fc = -1.0) const))
+  vector<Size> result;
+  kd_grid.getNeighborhood(0, result, 10.0, 0.5, false, true);
+  TEST_EQUAL(result == queryLinear(kd_grid, kd_grid.rt(0) - 10.0, kd_grid.rt(0) + 10.0, kd_grid.mz(0) - 0.5, kd_grid.mz(0) + 0.5, numeric_limits<Size>::max()), true)
+  result.clear(); // results are appended
+  kd_grid.getNeighborhood(0, result, 10.0, 0.5, false, false);
+  TEST_EQUAL(result == queryLinear(kd_grid, kd_grid.rt(0) - 10.0, kd_grid.rt(0) + 10.0, kd_grid.mz(0) - 0.5, kd_grid.mz(0) + 0.5, kd_grid.mapIndex(0)), true)
+  TEST_EQUAL(result.empty(), false)
 END_SECTION
 
 START_SECTION((void queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, std::vector<Size>& result_indices, Size ignored_map_index = std::numeric_limits<Size>::max()) const))
-  NOT_TESTABLE;
+  // compare against a linear scan (results are sorted by index)
+  vector<Size> result;
+  bool all_equal = true;
+  Size total = 0;
+  for (Size i = 0; i < 40; ++i)
+  {
+    double rt_low = 95.0 + 5.0 * i, mz_low = 399.0 + 0.3 * i;
+    double rt_high = rt_low + 7.0 * (i % 5), mz_high = mz_low + 0.8 * (i % 7);
+    Size ignored = (i % 4 == 3) ? numeric_limits<Size>::max() : i % 4;
+    kd_grid.queryRegion(rt_low, rt_high, mz_low, mz_high, result, ignored);
+    all_equal &= (result == queryLinear(kd_grid, rt_low, rt_high, mz_low, mz_high, ignored));
+    total += result.size();
+  }
+  TEST_EQUAL(all_equal, true)
+  TEST_NOT_EQUAL(total, 0)
+
+  // empty region, empty data
+  kd_grid.queryRegion(0, 50, 0, 1000, result);
+  TEST_EQUAL(result.size(), 0)
+  KDTreeFeatureMaps kd_empty;
+  kd_empty.queryRegion(0, 5000, 0, 5000, result);
+  TEST_EQUAL(result.size(), 0)
 END_SECTION
 
 START_SECTION((void applyTransformations(const std::vector<TransformationModelLowess*>& trafos)))
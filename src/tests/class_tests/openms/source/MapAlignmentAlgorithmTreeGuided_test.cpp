@@ -40,6 +40,10 @@
 
 #include <iostream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace OpenMS;
 
@@ -171,6 +175,84 @@ START_SECTION((static void computeTransformedFeatureMaps(std::vector<FeatureMap>
 }
 END_SECTION
 
+START_SECTION(([EXTRA] independent merges give the same result with any number of threads))
+{
+  // four maps: in1 and a linearly shifted copy of it are nearly identical, as are in0 and in2,
+  // so the tree first merges (1, 3) and (0, 2) independently of each other, then both clusters
+  vector<FeatureMap> input(4);
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmTreeGuided_test_in0.featureXML"), input[0]);
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmTreeGuided_test_in1.featureXML"), input[1]);
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmTreeGuided_test_in2.featureXML"), input[2]);
+  input[3] = input[1];
+  for (Feature& feature : input[3])
+  {
+    feature.setRT(feature.getRT() * 1.02 + 10.0);
+    feature.setUniqueId(feature.getUniqueId() + 100);
+    for (PeptideIdentification& pep : feature.getPeptideIdentifications())
+    {
+      pep.setRT(pep.getRT() * 1.02 + 10.0);
+    }
+  }
+
+  vector<BinaryTreeNode> tree;
+  vector<FeatureMap> run_maps[2];
+  FeatureMap run_transformed[2];
+  vector<Size> run_order[2];
+
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+#endif
+  for (Size run = 0; run < 2; ++run)
+  {
+#ifdef _OPENMP
+    omp_set_num_threads(run == 0 ? 4 : 1);
+#endif
+    vector<FeatureMap> to_align = input;
+    vector<vector<double>> ranges(4);
+    tree.clear();
+    MapAlignmentAlgorithmTreeGuided::buildTree(to_align, tree, ranges);
+
+    MapAlignmentAlgorithmTreeGuided tree_aligner;
+    tree_aligner.treeGuidedAlignment(tree, to_align, ranges, run_transformed[run], run_order[run]);
+
+    run_maps[run] = input;
+    vector<TransformationDescription> run_trafos(4);
+    tree_aligner.computeTrafosByOriginalRT(run_maps[run], run_transformed[run], run_trafos, run_order[run]);
+    MapAlignmentAlgorithmTreeGuided::computeTransformedFeatureMaps(run_maps[run], run_trafos);
+  }
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  // the first two merges do not share a map
+  TEST_EQUAL(tree.size(), 3)
+  set<Size> first_merges;
+  first_merges.insert(tree[0].left_child);
+  first_merges.insert(tree[0].right_child);
+  first_merges.insert(tree[1].left_child);
+  first_merges.insert(tree[1].right_child);
+  TEST_EQUAL(first_merges.size(), 4)
+
+  TEST_EQUAL(run_order[0].size(), 4)
+  TEST_EQUAL(run_order[0] == run_order[1], true)
+  TEST_EQUAL(run_transformed[0].size(), 20)
+  TEST_EQUAL(run_transformed[0].size(), run_transformed[1].size())
+  for (Size i = 0; i < run_transformed[0].size(); ++i)
+  {
+    TEST_EQUAL(run_transformed[0][i].getUniqueId(), run_transformed[1][i].getUniqueId())
+    TEST_REAL_SIMILAR(run_transformed[0][i].getRT(), run_transformed[1][i].getRT())
+  }
+  for (Size m = 0; m < 4; ++m)
+  {
+    TEST_EQUAL(run_maps[0][m].size(), run_maps[1][m].size())
+    for (Size i = 0; i < run_maps[0][m].size(); ++i)
+    {
+      TEST_REAL_SIMILAR(run_maps[0][m][i].getRT(), run_maps[1][m][i].getRT())
+    }
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -134,6 +134,40 @@ START_SECTION((static void transformRetentionTimes(PeakMap& msexp, const Transfo
 }
 END_SECTION
 
+START_SECTION((static void transformRetentionTimes(MSSpectrum& spectrum, const TransformationDescription& trafo, bool store_original_rt = false)))
+{
+  MSSpectrum spec;
+  spec.setRT(11.1);
+  MapAlignmentTransformer::transformRetentionTimes(spec, td);
+  TEST_REAL_SIMILAR(spec.getRT(), 23.2)
+  TEST_EQUAL(spec.metaValueExists("original_RT"), false)
+
+  MapAlignmentTransformer::transformRetentionTimes(spec, td, true);
+  TEST_REAL_SIMILAR(spec.getRT(), 47.4)
+  TEST_REAL_SIMILAR(spec.getMetaValue("original_RT"), 23.2)
+}
+END_SECTION
+
+START_SECTION((static void transformRetentionTimes(MSChromatogram& chromatogram, const TransformationDescription& trafo, bool store_original_rt = false)))
+{
+  MSChromatogram chrom;
+  chrom.push_back(ChromatogramPeak(1.0, 10.0));
+  chrom.push_back(ChromatogramPeak(2.5, 20.0));
+  MapAlignmentTransformer::transformRetentionTimes(chrom, td);
+  TEST_REAL_SIMILAR(chrom[0].getRT(), 3.0)
+  TEST_REAL_SIMILAR(chrom[1].getRT(), 6.0)
+  TEST_REAL_SIMILAR(chrom[1].getIntensity(), 20.0)
+  TEST_EQUAL(chrom.metaValueExists("original_rt"), false)
+
+  MapAlignmentTransformer::transformRetentionTimes(chrom, td, true);
+  TEST_REAL_SIMILAR(chrom[0].getRT(), 7.0)
+  vector<double> original_rts = chrom.getMetaValue("original_rt");
+  TEST_EQUAL(original_rts.size(), 2)
+  TEST_REAL_SIMILAR(original_rts[0], 3.0)
+  TEST_REAL_SIMILAR(original_rts[1], 6.0)
+}
+END_SECTION
+
 START_SECTION((static void transformRetentionTimes(FeatureMap& fmap, const TransformationDescription& trafo, bool store_original_rt = false)))
 {
   Feature f;
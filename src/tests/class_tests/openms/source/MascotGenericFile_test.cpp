@@ -96,7 +96,7 @@ START_SECTION((void store(std::ostream &os, const String &filename, const PeakMa
   strings.push_back("BEGIN IONS\n"
                     "TITLE=Testtitle_index=0\n" // different from input!
                     "PEPMASS=1998.0\n"
-                    "RTINSECONDS=25.379000000000001\n"
+                    "RTINSECONDS=25.379\n"
                     "SCANS=0");
   strings.push_back("1.0 1.0\n"
                     "2.0 4.0\n"
@@ -125,9 +125,9 @@ START_SECTION((void store(std::ostream &os, const String &filename, const PeakMa
   ptr->store(ss2, "test", exp);
   vector<String> strings2;
   strings2.push_back("BEGIN IONS\n"
-                    "TITLE=1998.0_25.379000000000001_index=0_test\n" // different from input!
+                    "TITLE=1998.0_25.379_index=0_test\n" // different from input!
                     "PEPMASS=1998.0\n"
-                    "RTINSECONDS=25.379000000000001\n"
+                    "RTINSECONDS=25.379\n"
                     "SCANS=0");
   strings2.push_back("1.0 1.0\n"
                     "2.0 4.0\n"
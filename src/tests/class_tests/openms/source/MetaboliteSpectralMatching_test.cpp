@@ -73,9 +73,66 @@ START_SECTION((double computeHyperScore(MSSpectrum, MSSpectrum, const double &,
 }
 END_SECTION
 
-START_SECTION((void run(PeakMap &, MzTab &)))
+START_SECTION((void run(PeakMap &, PeakMap &, MzTab &)))
 {
-  // TODO
+  // library: exact match (A), weaker match (B) and a spectrum outside of the precursor window (C)
+  PeakMap spec_db;
+  const double lib_prec[] = {200.0, 200.001, 300.0};
+  const char* lib_ids[] = {"A", "B", "C"};
+  for (Size i = 0; i < 3; ++i)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(2);
+    Precursor prec;
+    prec.setMZ(lib_prec[i]);
+    prec.setCharge(1);
+    spec.getPrecursors().push_back(prec);
+    for (Size j = 0; j < (i == 1 ? 3 : 4); ++j)
+    {
+      Peak1D p;
+      p.setMZ(50.0 + 30.0 * j);
+      p.setIntensity(i == 1 ? 1.0 : 100.0 * (j + 1));
+      spec.push_back(p);
+    }
+    spec.setMetaValue("Massbank_Accession_ID", String(lib_ids[i]));
+    spec.setMetaValue("HMDB_ID", String("HMDB") + String(i));
+    spec.setMetaValue("Sum_Formula", "C6H12O6");
+    spec.setMetaValue("Metabolite_Name", String("metabolite ") + String(lib_ids[i]));
+    spec.setMetaValue("Inchi_String", "");
+    spec.setMetaValue("SMILES_String", "");
+    spec.setMetaValue("Precursor_Ion", "[M+H]+");
+    spec_db.addSpectrum(spec);
+  }
+
+  PeakMap query;
+  MSSpectrum spec(spec_db[0]);
+  spec.setRT(10.0);
+  query.addSpectrum(spec);
+  spec.getPrecursors()[0].setMZ(500.0);
+  spec.setRT(100.0);
+  query.addSpectrum(spec);
+
+  MetaboliteSpectralMatching msm;
+  MzTab mztab;
+  PeakMap query_copy(query), spec_db_copy(spec_db);
+  msm.run(query_copy, spec_db_copy, mztab);
+  MzTabSmallMoleculeSectionRows rows = mztab.getSmallMoleculeSectionRows();
+  TEST_EQUAL(rows.size(), 2)
+  ABORT_IF(rows.size() != 2)
+  TEST_EQUAL(rows[0].identifier.get()[0].get(), "A")
+  TEST_EQUAL(rows[1].identifier.get()[0].get(), "B")
+
+  // only the candidate with the best binned cosine is scored
+  Param p = msm.getParameters();
+  p.setValue("prefilter_top_n", 1);
+  msm.setParameters(p);
+  query_copy = query;
+  spec_db_copy = spec_db;
+  msm.run(query_copy, spec_db_copy, mztab);
+  rows = mztab.getSmallMoleculeSectionRows();
+  TEST_EQUAL(rows.size(), 1)
+  ABORT_IF(rows.size() != 1)
+  TEST_EQUAL(rows[0].identifier.get()[0].get(), "A")
 }
 END_SECTION
 
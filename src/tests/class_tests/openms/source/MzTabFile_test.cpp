@@ -39,6 +39,8 @@
 #include <OpenMS/FORMAT/MzTabFile.h>
 #include <OpenMS/FORMAT/MzTab.h>
 #include <OpenMS/FORMAT/TextFile.h>
+#include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
 ///////////////////////////
 
 using namespace OpenMS;
@@ -121,6 +123,36 @@ START_SECTION(void store(const String& filename, MzTab& mzTab) )
 }
 END_SECTION
 
+START_SECTION(void store(const String& filename, const ConsensusMap& cmap, const bool first_run_inference_only, const bool export_unidentified_features, const bool export_unassigned_ids, const bool export_subfeatures, const bool export_empty_pep_ids = false) const)
+{
+  ConsensusMap cmap;
+  ConsensusXMLFile().load(OPENMS_GET_TEST_DATA_PATH("BSA.consensusXML"), cmap);
+
+  // streamed export must be identical to the export of the full MzTab object
+  String streamed, materialized;
+  NEW_TMP_FILE(streamed)
+  NEW_TMP_FILE(materialized)
+  MzTabFile().store(streamed, cmap, true, true, true, true);
+  MzTab mztab = MzTab::exportConsensusMapToMzTab(cmap, streamed, true, true, true, true);
+  MzTabFile().store(materialized, mztab);
+  TEST_FILE_SIMILAR(streamed.c_str(), materialized.c_str())
+
+  // header and rows of the peptide section have the same number of columns
+  TextFile file(streamed);
+  Size peh_columns(0), pep_rows(0);
+  for (const String& line : file)
+  {
+    if (line.hasPrefix("PEH")) peh_columns = ListUtils::create<String>(line, '\t').size();
+    if (line.hasPrefix("PEP"))
+    {
+      TEST_EQUAL(ListUtils::create<String>(line, '\t').size(), peh_columns)
+      ++pep_rows;
+    }
+  }
+  TEST_EQUAL(pep_rows, mztab.getPeptideSectionRows().size())
+}
+END_SECTION
+
 START_SECTION(~MzTabFile())
 {
   delete ptr;
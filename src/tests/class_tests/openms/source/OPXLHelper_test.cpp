@@ -148,6 +148,23 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
     }
   }
 
+  // deterministic order: grouped by precursor, cross-linked pairs sorted by alpha and beta index
+  bool ordered = true;
+  for (Size i = 1; i < precursors.size(); ++i)
+  {
+    if (spectrum_precursor_correction_positions[i] < spectrum_precursor_correction_positions[i-1])
+    {
+      ordered = false;
+    }
+    else if (spectrum_precursor_correction_positions[i] == spectrum_precursor_correction_positions[i-1] &&
+             precursors[i].beta_index < peptides.size() && precursors[i-1].beta_index < peptides.size() &&
+             std::make_pair(precursors[i].alpha_index, precursors[i].beta_index) <= std::make_pair(precursors[i-1].alpha_index, precursors[i-1].beta_index))
+    {
+      ordered = false;
+    }
+  }
+  TEST_EQUAL(ordered, true)
+
 END_SECTION
 
 // building more data structures required in the following test
@@ -0,0 +1,186 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: George Rosenberger $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/SqliteConnector.h>
+#include <sqlite3.h>
+
+#include <limits>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  FeatureMap createFeatures()
+  {
+    FeatureMap output;
+    Feature feature;
+    feature.setUniqueId(17);
+    feature.setRT(1234.5678901);
+    feature.setIntensity(1000.0);
+    feature.setMetaValue("leftWidth", 1200.0);
+    feature.setMetaValue("rightWidth", 1260.0);
+    feature.setMetaValue("norm_RT", 42.0);
+    feature.setMetaValue("delta_rt", 1.5);
+    feature.setMetaValue("total_xic", 5000.0);
+    feature.setMetaValue("var_library_corr", 0.95);
+    feature.setMetaValue("var_xcorr_shape", std::numeric_limits<double>::quiet_NaN());
+
+    Feature transition;
+    transition.setMetaValue("FeatureLevel", "MS2");
+    transition.setMetaValue("native_id", "3");
+    transition.setIntensity(300.0);
+    transition.setMetaValue("total_xic", 600.0);
+    transition.setMetaValue("peak_apex_int", 30.0);
+    feature.getSubordinates().push_back(transition);
+    transition.setMetaValue("native_id", "4");
+    feature.getSubordinates().push_back(transition);
+
+    output.push_back(feature);
+    return output;
+  }
+
+  // returns the single value of a query as string ("NULL" for NULL)
+  String queryValue(const String& filename, const String& sql)
+  {
+    SqliteConnector conn(filename);
+    sqlite3_stmt* stmt;
+    SqliteConnector::prepareStatement(conn.getDB(), &stmt, sql);
+    sqlite3_step(stmt);
+    String result = "NULL";
+    if (sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+    {
+      result = String(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+    return result;
+  }
+}
+
+START_TEST(OpenSwathOSWWriter, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathOSWWriter* ptr = nullptr;
+OpenSwathOSWWriter* nullPointer = nullptr;
+
+START_SECTION(OpenSwathOSWWriter(const String& output_filename, const String& input_filename = "inputfile", bool ms1_scores = false, bool sonar = false, bool uis_scores = false))
+{
+  ptr = new OpenSwathOSWWriter("");
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isActive(), false)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(void prepareRows(const OpenSwath::LightCompound&, const OpenSwath::LightTransition*, FeatureMap& output, String id, OSWRows& rows) const)
+{
+  OpenSwathOSWWriter writer("dummy.osw");
+  FeatureMap output = createFeatures();
+  OpenSwathOSWWriter::OSWRows rows;
+  TEST_EQUAL(rows.empty(), true)
+  writer.prepareRows(OpenSwath::LightCompound(), nullptr, output, "5", rows);
+  TEST_EQUAL(rows.empty(), false)
+  TEST_EQUAL(rows.feature.size(), 9)
+  TEST_EQUAL(rows.feature_ms2.size(), 39)
+  TEST_EQUAL(rows.feature_ms1.size(), 0)
+  TEST_EQUAL(rows.feature_precursor.size(), 0)
+  TEST_EQUAL(rows.feature_transition.size(), 12)
+  TEST_EQUAL(rows.feature_transition_uis.size(), 0)
+  rows.clear();
+  TEST_EQUAL(rows.empty(), true)
+}
+END_SECTION
+
+START_SECTION(void writeRows(const OSWRows& rows))
+{
+  // the prepared statement writer has to produce the same tables as the textual one
+  String text_file, bound_file;
+  NEW_TMP_FILE(text_file)
+  NEW_TMP_FILE(bound_file)
+
+  FeatureMap output = createFeatures();
+
+  OpenSwathOSWWriter text_writer(text_file);
+  text_writer.writeHeader();
+  std::vector<String> lines;
+  lines.push_back(text_writer.prepareLine(OpenSwath::LightCompound(), nullptr, output, "5"));
+  text_writer.writeLines(lines);
+
+  OpenSwathOSWWriter bound_writer(bound_file);
+  bound_writer.writeHeader();
+  OpenSwathOSWWriter::OSWRows rows;
+  bound_writer.prepareRows(OpenSwath::LightCompound(), nullptr, output, "5", rows);
+  bound_writer.writeRows(rows);
+
+  const char* queries[] =
+  {
+    "SELECT COUNT(*) FROM FEATURE;",
+    "SELECT COUNT(*) FROM FEATURE_MS2;",
+    "SELECT COUNT(*) FROM FEATURE_TRANSITION;",
+    "SELECT ID FROM FEATURE;",
+    "SELECT PRECURSOR_ID FROM FEATURE;",
+    "SELECT typeof(PRECURSOR_ID) FROM FEATURE;",
+    "SELECT NORM_RT FROM FEATURE;",
+    "SELECT EXP_IM FROM FEATURE;",
+    "SELECT TOTAL_AREA_INTENSITY FROM FEATURE_MS2;",
+    "SELECT VAR_LIBRARY_CORR FROM FEATURE_MS2;",
+    "SELECT VAR_XCORR_SHAPE FROM FEATURE_MS2;",
+    "SELECT SUM(TRANSITION_ID) FROM FEATURE_TRANSITION;",
+    "SELECT typeof(TRANSITION_ID) FROM FEATURE_TRANSITION;",
+    "SELECT SUM(AREA_INTENSITY) FROM FEATURE_TRANSITION;"
+  };
+  for (const char* sql : queries)
+  {
+    TEST_EQUAL(queryValue(bound_file, sql), queryValue(text_file, sql))
+  }
+  TEST_EQUAL(queryValue(bound_file, "SELECT COUNT(*) FROM FEATURE_TRANSITION;"), "2")
+  TEST_EQUAL(queryValue(bound_file, "SELECT VAR_XCORR_SHAPE FROM FEATURE_MS2;"), "NULL")
+  // bound values keep full precision
+  TEST_REAL_SIMILAR(queryValue(bound_file, "SELECT EXP_RT FROM FEATURE;").toDouble(), 1234.5678901)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -273,6 +273,65 @@ START_SECTION((OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::
 }
 END_SECTION
 
+START_SECTION((void setSpectrumCacheSize(Size size)))
+{
+  PeakMap* eptr = new PeakMap;
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum s;
+    s.emplace_back(20.0 + i, 100.0 * (i + 1));
+    s.setRT(10.0 * (i + 1));
+    eptr->addSpectrum(s);
+  }
+  boost::shared_ptr<PeakMap > swath_map (eptr);
+  OpenSwath::SpectrumAccessPtr swath_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_map);
+
+  OpenSwathScoring sc;
+  OpenSwath_Scores_Usage su;
+  sc.initialize(1.0, 3, 0.005, 0.0, su, "simple");
+  TEST_EQUAL(sc.getSpectrumCacheSize(), 32)
+
+  OpenSwath::SpectrumPtr sp = sc.fetchSpectrumSwath(swath_ptr, 20.0, 3, 0, 0);
+  TEST_EQUAL(sp->getMZArray()->data.size(), 3)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().hits, 0)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().misses, 1)
+
+  // same closest spectrum -> same (cached) result
+  OpenSwath::SpectrumPtr sp2 = sc.fetchSpectrumSwath(swath_ptr, 21.0, 3, 0, 0);
+  TEST_EQUAL(sp2 == sp, true)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().hits, 1)
+
+  // different number of spectra, different RT: not cached
+  sp2 = sc.fetchSpectrumSwath(swath_ptr, 20.0, 1, 0, 0);
+  TEST_EQUAL(sp2->getMZArray()->data.size(), 1)
+  sp2 = sc.fetchSpectrumSwath(swath_ptr, 40.0, 3, 0, 0);
+  TEST_REAL_SIMILAR(sp2->getMZArray()->data[0], 22.0)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().hits, 1)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().misses, 3)
+
+  // changing the addition method invalidates the cache
+  sc.initialize(1.0, 3, 0.005, 0.0, su, "resample");
+  sp2 = sc.fetchSpectrumSwath(swath_ptr, 20.0, 3, 0, 0);
+  TEST_EQUAL(sp2 == sp, false)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().misses, 4)
+
+  // least recently used spectra are replaced
+  sc.setSpectrumCacheSize(1);
+  sp = sc.fetchSpectrumSwath(swath_ptr, 10.0, 1, 0, 0);
+  sc.fetchSpectrumSwath(swath_ptr, 50.0, 1, 0, 0);
+  sp2 = sc.fetchSpectrumSwath(swath_ptr, 10.0, 1, 0, 0);
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().misses, 7)
+  TEST_REAL_SIMILAR(sp2->getMZArray()->data[0], 20.0)
+
+  // disabled cache
+  sc.setSpectrumCacheSize(0);
+  sc.fetchSpectrumSwath(swath_ptr, 10.0, 1, 0, 0);
+  sc.fetchSpectrumSwath(swath_ptr, 10.0, 1, 0, 0);
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().hits, 1)
+  TEST_EQUAL(sc.getSpectrumCacheStatistics().misses, 9)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -278,6 +278,57 @@ START_SECTION((ExitCodes run(std::vector<FASTAFile::FASTAEntry>& proteins, std::
 }
 END_SECTION
 
+START_SECTION((ExitCodes run(const ProteinDBIndex& index, std::vector<ProteinIdentification>& prot_ids, std::vector<PeptideIdentification>& pep_ids)))
+{
+  // same results as searching the FASTA entries directly
+  std::vector<FASTAFile::FASTAEntry> proteins = toFASTAVec(QStringList() << "AAAKEEEKTTTK" << "*MLT*EAXK" << "MLTEAEKPEPTLDEK" << "KEEEKTTTKAAA",
+                                                          QStringList() << "P1" << "P2" << "P3" << "DECOY_P4");
+  ProteinDBIndex index;
+  index.build(proteins);
+  for (int il = 0; il < 2; ++il)
+  {
+    for (int i_aa = 0; i_aa < 2; ++i_aa)
+    {
+      PeptideIndexing pi;
+      Param p = pi.getParameters();
+      p.setValue("aaa_max", i_aa);
+      p.setValue("IL_equivalent", il ? "true" : "false");
+      p.setValue("missing_decoy_action", "silent");
+      p.setValue("allow_unmatched", "true");
+      p.setValue("write_protein_sequence", "true");
+      pi.setParameters(p);
+
+      std::vector<ProteinIdentification> prot_ids_fasta(1), prot_ids_index(1);
+      std::vector<PeptideIdentification> pep_ids_fasta = toPepVec(QStringList() << "EEEK" << "MLTEAEK" << "PEPTIDEK" << "TTTK" << "NOTTHERE");
+      std::vector<PeptideIdentification> pep_ids_index = pep_ids_fasta;
+      std::vector<FASTAFile::FASTAEntry> proteins_local = proteins;
+      TEST_EQUAL(pi.run(proteins_local, prot_ids_fasta, pep_ids_fasta), PeptideIndexing::EXECUTION_OK)
+      TEST_EQUAL(pi.run(index, prot_ids_index, pep_ids_index), PeptideIndexing::EXECUTION_OK)
+      for (Size i = 0; i < pep_ids_fasta.size(); ++i)
+      {
+        const PeptideHit& hit_fasta = pep_ids_fasta[i].getHits()[0];
+        const PeptideHit& hit_index = pep_ids_index[i].getHits()[0];
+        TEST_EQUAL(hit_index.getPeptideEvidences() == hit_fasta.getPeptideEvidences(), true)
+        TEST_EQUAL(hit_index.getMetaValue("protein_references"), hit_fasta.getMetaValue("protein_references"))
+      }
+      TEST_EQUAL(prot_ids_index[0].getHits().size(), prot_ids_fasta[0].getHits().size())
+      for (Size i = 0; i < prot_ids_fasta[0].getHits().size(); ++i)
+      {
+        TEST_EQUAL(prot_ids_index[0].getHits()[i].getAccession(), prot_ids_fasta[0].getHits()[i].getAccession())
+        TEST_EQUAL(prot_ids_index[0].getHits()[i].getMetaValue("target_decoy"), prot_ids_fasta[0].getHits()[i].getMetaValue("target_decoy"))
+      }
+    }
+  }
+
+  // empty index --> FAIL
+  PeptideIndexing pi;
+  ProteinDBIndex empty_index;
+  std::vector<ProteinIdentification> prot_ids;
+  std::vector<PeptideIdentification> pep_ids = toPepVec(QStringList() << "SOME" << "PEPTIDES");
+  TEST_EQUAL(pi.run(empty_index, prot_ids, pep_ids), PeptideIndexing::DATABASE_EMPTY);
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
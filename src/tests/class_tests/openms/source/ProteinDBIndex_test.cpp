@@ -0,0 +1,262 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Chris Bielow $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/ProteinDBIndex.h>
+///////////////////////////
+
+#include <fstream>
+
+using namespace OpenMS;
+using namespace std;
+
+typedef std::pair<Size, Size> Hit;
+typedef std::vector<Hit> Hits;
+
+Hits find(const ProteinDBIndex& index, const String& peptide, bool IL_equivalent)
+{
+  Hits hits;
+  index.findPeptide(peptide, IL_equivalent, hits);
+  std::sort(hits.begin(), hits.end());
+  return hits;
+}
+
+START_TEST(ProteinDBIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// a protein longer than the sort depth, with two almost identical halves
+String long_half(String(80, 'A') + "LK");
+std::vector<FASTAFile::FASTAEntry> proteins;
+proteins.push_back(FASTAFile::FASTAEntry("DECOY_P0", "first", "PEPTIDEKPEPTLDEK"));
+proteins.push_back(FASTAFile::FASTAEntry("P1", "second", "*MLT*EAXK"));
+proteins.push_back(FASTAFile::FASTAEntry("P2", "", "PEPJIDEK"));
+proteins.push_back(FASTAFile::FASTAEntry("P3", "modified", "PEP(Oxidation)TIDE"));
+proteins.push_back(FASTAFile::FASTAEntry("P4", "long", long_half + String(80, 'A') + "IK"));
+
+ProteinDBIndex* ptr = nullptr;
+ProteinDBIndex* null_ptr = nullptr;
+START_SECTION(ProteinDBIndex())
+{
+  ptr = new ProteinDBIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->isMemoryMapped(), false)
+}
+END_SECTION
+
+START_SECTION(~ProteinDBIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void build(const std::vector<FASTAFile::FASTAEntry>& proteins)))
+{
+  ProteinDBIndex index;
+  index.build(proteins);
+  TEST_EQUAL(index.size(), 5)
+  TEST_EQUAL(index.empty(), false)
+  TEST_EQUAL(index.residueCount(), 16 + 7 + 8 + 18 + 164)
+  TEST_EQUAL(index.getAccession(0), "DECOY_P0")
+  TEST_EQUAL(index.getAccession(4), "P4")
+  TEST_EQUAL(index.getDescription(1), "second")
+  TEST_EQUAL(index.getDescription(2), "")
+  TEST_EQUAL(index.getSequence(1), "MLTEAXK") // '*' removed
+  TEST_EQUAL(index.getSequence(0, true), "PEPTIDEKPEPTIDEK")
+  TEST_EQUAL(index.getSequence(2, true), "PEPIIDEK")
+  TEST_EQUAL(index.getSequenceLength(4), 164)
+}
+END_SECTION
+
+START_SECTION((template<typename T> void build(FASTAContainer<T>& proteins)))
+{
+  FASTAContainer<TFI_Vector> container(proteins);
+  ProteinDBIndex index;
+  index.build(container);
+  TEST_EQUAL(index.size(), 5)
+  TEST_EQUAL(index.getAccession(3), "P3")
+}
+END_SECTION
+
+START_SECTION((UInt getFlags(Size index) const))
+{
+  ProteinDBIndex index;
+  index.build(proteins);
+  TEST_EQUAL(index.getFlags(0), 0)
+  TEST_EQUAL(index.getFlags(1), ProteinDBIndex::HAS_AMBIGUOUS_AA)
+  TEST_EQUAL(index.getFlags(2), ProteinDBIndex::HAS_J)
+  TEST_EQUAL(index.getFlags(3), ProteinDBIndex::HAS_MODIFICATION)
+  TEST_EQUAL(index.getFlags(4), 0)
+}
+END_SECTION
+
+START_SECTION((void findPeptide(const String& peptide, bool IL_equivalent, std::vector<std::pair<Size, Size> >& hits) const))
+{
+  ProteinDBIndex index;
+  index.build(proteins);
+
+  // exact
+  Hits hits = find(index, "PEPTIDEK", false);
+  TEST_EQUAL(hits.size(), 1)
+  TEST_EQUAL(hits[0] == Hit(0, 0), true)
+  hits = find(index, "PEPTLDEK", false);
+  TEST_EQUAL(hits.size(), 1)
+  TEST_EQUAL(hits[0] == Hit(0, 8), true)
+  hits = find(index, "PEP", false);
+  TEST_EQUAL(hits.size(), 4)
+  TEST_EQUAL(find(index, "MLTEAXK", false).size(), 1) // '*' is not part of the sequence
+  TEST_EQUAL(find(index, "MLTEAEK", false).size(), 0) // ambiguous AAs are not resolved
+  TEST_EQUAL(find(index, "KPEPTIDE", false).size(), 0) // no matches across proteins
+  TEST_EQUAL(find(index, "DEKM", false).size(), 0)
+  TEST_EQUAL(find(index, "", false).size(), 0)
+
+  // I/L-equivalent
+  hits = find(index, "PEPTIDEK", true);
+  TEST_EQUAL(hits.size(), 2)
+  TEST_EQUAL(hits[0] == Hit(0, 0), true)
+  TEST_EQUAL(hits[1] == Hit(0, 8), true)
+  hits = find(index, "PEPLIDEK", true); // 'J' in the protein
+  TEST_EQUAL(hits.size(), 1)
+  TEST_EQUAL(hits[0] == Hit(2, 0), true)
+  TEST_EQUAL(find(index, "PEPLIDEK", false).size(), 0)
+
+  // longer than the sort depth
+  TEST_EQUAL(index.getSortDepth() < long_half.size(), true)
+  hits = find(index, long_half, false);
+  TEST_EQUAL(hits.size(), 1)
+  TEST_EQUAL(hits[0] == Hit(4, 0), true)
+  hits = find(index, long_half, true);
+  TEST_EQUAL(hits.size(), 2)
+  TEST_EQUAL(hits[1] == Hit(4, 82), true)
+  TEST_EQUAL(find(index, String(80, 'A') + "IK", false).size(), 1)
+  TEST_EQUAL(find(index, String(82, 'A'), false).size(), 0)
+}
+END_SECTION
+
+START_SECTION((const DecoyHelper::Result& getDecoyInfo() const))
+{
+  ProteinDBIndex index;
+  index.build(proteins);
+  TEST_EQUAL(index.getDecoyInfo().success, false) // too few decoys
+
+  std::vector<FASTAFile::FASTAEntry> td;
+  td.push_back(FASTAFile::FASTAEntry("P1", "", "PEPTIDE"));
+  td.push_back(FASTAFile::FASTAEntry("rev_P1", "", "EDITPEP"));
+  index.build(td);
+  TEST_EQUAL(index.getDecoyInfo().success, true)
+  TEST_EQUAL(index.getDecoyInfo().name, "rev_")
+  TEST_EQUAL(index.getDecoyInfo().is_prefix, true)
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  ProteinDBIndex index;
+  index.build(proteins);
+  index.setSourceInfo(12345, -42);
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  index.store(tmp_filename);
+  TEST_EQUAL(File::empty(tmp_filename), false)
+
+  TEST_EXCEPTION(Exception::UnableToCreateFile, index.store("/bla/bluff/blblb/sdfhsdjf/test.idx"))
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename)))
+{
+  ProteinDBIndex built;
+  built.build(proteins);
+  built.setSourceInfo(12345, -42);
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  built.store(tmp_filename);
+
+  ProteinDBIndex index;
+  index.load(tmp_filename);
+  TEST_EQUAL(index.isMemoryMapped(), true)
+  TEST_EQUAL(index.size(), built.size())
+  TEST_EQUAL(index.residueCount(), built.residueCount())
+  TEST_EQUAL(index.getSortDepth(), built.getSortDepth())
+  TEST_EQUAL(index.getSourceInfo() == std::make_pair(UInt64(12345), Int64(-42)), true)
+  TEST_EQUAL(index.getDecoyInfo().success, built.getDecoyInfo().success)
+  for (Size i = 0; i < index.size(); ++i)
+  {
+    TEST_EQUAL(index.getAccession(i), built.getAccession(i))
+    TEST_EQUAL(index.getDescription(i), built.getDescription(i))
+    TEST_EQUAL(index.getSequence(i), built.getSequence(i))
+    TEST_EQUAL(index.getFlags(i), built.getFlags(i))
+  }
+  TEST_EQUAL(find(index, "PEPTIDEK", true) == find(built, "PEPTIDEK", true), true)
+  TEST_EQUAL(find(index, long_half, true) == find(built, long_half, true), true)
+
+  // re-building drops the mapping
+  index.build(proteins);
+  TEST_EQUAL(index.isMemoryMapped(), false)
+  TEST_EQUAL(index.getSourceInfo() == std::make_pair(UInt64(0), Int64(0)), true)
+
+  // empty index
+  ProteinDBIndex empty;
+  NEW_TMP_FILE(tmp_filename);
+  empty.store(tmp_filename);
+  index.load(tmp_filename);
+  TEST_EQUAL(index.empty(), true)
+  TEST_EQUAL(find(index, "PEPTIDEK", false).size(), 0)
+
+  TEST_EXCEPTION(Exception::FileNotFound, index.load("ProteinDBIndex_test_this_file_does_not_exist"))
+  TEST_EXCEPTION(Exception::ParseError, index.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+  TEST_EQUAL(index.empty(), true)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  ProteinDBIndex index;
+  index.build(proteins);
+  index.clear();
+  TEST_EQUAL(index.empty(), true)
+  TEST_EQUAL(index.residueCount(), 0)
+  TEST_EQUAL(find(index, "PEPTIDEK", false).size(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
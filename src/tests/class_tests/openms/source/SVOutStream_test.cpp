@@ -90,6 +90,15 @@ START_SECTION((template <typename T> SVOutStream& operator<<(const T& value)))
 }
 END_SECTION
 
+START_SECTION((SVOutStream& operator<<(double value)))
+{
+  stringstream strstr;
+  SVOutStream out(strstr, ",");
+  out << 1.0 << 0.1 + 0.2 << 445.2345678 << 1.5e-7 << nl;
+  TEST_EQUAL(strstr.str(), "1.0,0.30000000000000004,445.2345678,1.5e-07\n");
+}
+END_SECTION
+
 START_SECTION((SVOutStream& operator<<(String str)))
 {
   stringstream strstr;
@@ -0,0 +1,216 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/COMPARISON/CLUSTERING/SparseSpectraClustering.h>
+#include <OpenMS/COMPARISON/CLUSTERING/ClusterAnalyzer.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SparseSpectraClustering, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SparseSpectraClustering* ptr = nullptr;
+SparseSpectraClustering* null_ptr = nullptr;
+START_SECTION(SparseSpectraClustering())
+{
+  ptr = new SparseSpectraClustering();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(~SparseSpectraClustering())
+{
+  delete ptr;
+}
+END_SECTION
+
+// distances: 0-1: 0.1, 1-2: 0.2, 0-2: 0.4, 2-3: 0.25 (all others 1)
+vector<SparseSpectraClustering::CandidatePair> pairs;
+SparseSpectraClustering::CandidatePair p01 = {0, 1, 0.1f}, p12 = {1, 2, 0.2f}, p02 = {0, 2, 0.4f}, p23 = {2, 3, 0.25f};
+pairs.push_back(p01);
+pairs.push_back(p12);
+pairs.push_back(p02);
+pairs.push_back(p23);
+
+START_SECTION((void clusterSparse(Size size, const std::vector<CandidatePair>& pairs, std::vector<BinaryTreeNode>& cluster_tree) const))
+{
+  SparseSpectraClustering ssc;
+  vector<BinaryTreeNode> tree;
+
+  // single linkage
+  ssc.clusterSparse(4, pairs, tree);
+  TEST_EQUAL(tree.size(), 3)
+  ABORT_IF(tree.size() != 3)
+  TEST_EQUAL(tree[0].left_child, 0)
+  TEST_EQUAL(tree[0].right_child, 1)
+  TEST_REAL_SIMILAR(tree[0].distance, 0.1)
+  TEST_EQUAL(tree[1].left_child, 0)
+  TEST_EQUAL(tree[1].right_child, 2)
+  TEST_REAL_SIMILAR(tree[1].distance, 0.2)
+  TEST_EQUAL(tree[2].left_child, 0)
+  TEST_EQUAL(tree[2].right_child, 3)
+  TEST_REAL_SIMILAR(tree[2].distance, 0.25)
+
+  // average linkage: {0,1} - 2 has distance 0.3, {0,1} - {2,3} has (0.4 + 0.2 + 1 + 1) / 4
+  Param p = ssc.getParameters();
+  p.setValue("linkage", "average");
+  ssc.setParameters(p);
+  ssc.clusterSparse(4, pairs, tree);
+  TEST_EQUAL(tree.size(), 3)
+  ABORT_IF(tree.size() != 3)
+  TEST_EQUAL(tree[0].left_child, 0)
+  TEST_EQUAL(tree[0].right_child, 1)
+  TEST_EQUAL(tree[1].left_child, 2)
+  TEST_EQUAL(tree[1].right_child, 3)
+  TEST_REAL_SIMILAR(tree[1].distance, 0.25)
+  TEST_EQUAL(tree[2].left_child, 0)
+  TEST_EQUAL(tree[2].right_child, 2)
+  TEST_REAL_SIMILAR(tree[2].distance, -1.0)
+
+  // complete linkage: {0,1} - 2 has distance 0.4
+  p.setValue("linkage", "complete");
+  ssc.setParameters(p);
+  ssc.clusterSparse(4, pairs, tree);
+  TEST_EQUAL(tree.size(), 3)
+  ABORT_IF(tree.size() != 3)
+  TEST_EQUAL(tree[1].left_child, 2)
+  TEST_EQUAL(tree[1].right_child, 3)
+  TEST_REAL_SIMILAR(tree[2].distance, -1.0)
+
+  // without pairs, only dummy nodes are created
+  ssc.clusterSparse(3, vector<SparseSpectraClustering::CandidatePair>(), tree);
+  TEST_EQUAL(tree.size(), 2)
+  TEST_REAL_SIMILAR(tree[0].distance, -1.0)
+  TEST_REAL_SIMILAR(tree[1].distance, -1.0)
+}
+END_SECTION
+
+// spectra 0-2 share their peaks (scaled intensities), 3-4 share other peaks,
+// spectrum 5 equals spectrum 0 but has a different precursor
+vector<PeakSpectrum> spectra;
+{
+  PeakSpectrum s, t;
+  for (Size i = 0; i < 10; ++i)
+  {
+    Peak1D peak;
+    peak.setMZ(100.0 + 37.3 * i);
+    peak.setIntensity(10.0 + i);
+    s.push_back(peak);
+    peak.setMZ(105.0 + 41.1 * i);
+    peak.setIntensity(100.0 - i);
+    t.push_back(peak);
+  }
+  const double factors[] = {1.0, 2.0, 0.5};
+  for (Size i = 0; i < 3; ++i)
+  {
+    PeakSpectrum spec(s);
+    for (Peak1D& peak : spec) peak.setIntensity(peak.getIntensity() * factors[i]);
+    spec.getPrecursors().resize(1);
+    spec.getPrecursors()[0].setMZ(500.0 + 0.001 * i);
+    spectra.push_back(spec);
+  }
+  for (Size i = 0; i < 2; ++i)
+  {
+    PeakSpectrum spec(t);
+    spec.getPrecursors().resize(1);
+    spec.getPrecursors()[0].setMZ(500.0 + 0.005 * i);
+    spectra.push_back(spec);
+  }
+  PeakSpectrum spec(s);
+  spec.getPrecursors().resize(1);
+  spec.getPrecursors()[0].setMZ(800.0);
+  spectra.push_back(spec);
+}
+
+START_SECTION((void computeCandidatePairs(const std::vector<PeakSpectrum>& data, std::vector<CandidatePair>& pairs)))
+{
+  SparseSpectraClustering ssc;
+  vector<SparseSpectraClustering::CandidatePair> result;
+  ssc.computeCandidatePairs(spectra, result);
+  TEST_EQUAL(result.size(), 4)
+  ABORT_IF(result.size() != 4)
+  TEST_EQUAL(result[0].first, 0)
+  TEST_EQUAL(result[0].second, 1)
+  TEST_EQUAL(result[1].first, 0)
+  TEST_EQUAL(result[1].second, 2)
+  TEST_EQUAL(result[2].first, 1)
+  TEST_EQUAL(result[2].second, 2)
+  TEST_EQUAL(result[3].first, 3)
+  TEST_EQUAL(result[3].second, 4)
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(result[i].distance + 1.0, 1.0)
+  }
+}
+END_SECTION
+
+START_SECTION((void cluster(const std::vector<PeakSpectrum>& data, std::vector<BinaryTreeNode>& cluster_tree)))
+{
+  SparseSpectraClustering ssc;
+  vector<BinaryTreeNode> tree;
+  ssc.cluster(spectra, tree);
+  TEST_EQUAL(tree.size(), spectra.size() - 1)
+
+  Size real_nodes = 0;
+  for (Size i = 0; i < tree.size(); ++i)
+  {
+    if (tree[i].distance != -1) ++real_nodes;
+  }
+  TEST_EQUAL(real_nodes, 3)
+
+  vector<vector<Size> > clusters;
+  ClusterAnalyzer().cut(spectra.size() - real_nodes, tree, clusters);
+  TEST_EQUAL(clusters.size(), 3)
+  ABORT_IF(clusters.size() != 3)
+  TEST_EQUAL(clusters[0].size(), 3)
+  TEST_EQUAL(clusters[1].size(), 2)
+  TEST_EQUAL(clusters[1][0], 3)
+  TEST_EQUAL(clusters[2].size(), 1)
+  TEST_EQUAL(clusters[2][0], 5)
+
+  TEST_EXCEPTION(ClusterFunctor::InsufficientInput, ssc.cluster(vector<PeakSpectrum>(1, spectra[0]), tree))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -38,6 +38,9 @@
 #include <OpenMS/DATASTRUCTURES/StringUtils.h>
 ///////////////////////////
 
+#include <cstring>
+#include <limits>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -336,6 +339,72 @@ START_SECTION((template <typename IteratorT> static bool extractDouble(IteratorT
 }
 END_SECTION
 
+START_SECTION((static bool parseDoubleFast(const char*& begin, const char* end, double& target)))
+{
+  double d = 0;
+  {
+    const char* s = "12345.45  ";
+    const char* it = s;
+    TEST_EQUAL(StringUtils::parseDoubleFast(it, s + strlen(s), d), true);
+    TEST_EQUAL(d, 12345.45)
+    TEST_EQUAL(it - s, 8) // was the pointer advanced?
+  }
+  {
+    const char* s = "-1.5E-7\t9.1";
+    const char* it = s;
+    TEST_EQUAL(StringUtils::parseDoubleFast(it, s + strlen(s), d), true);
+    TEST_EQUAL(d, -1.5e-7)
+    TEST_EQUAL(it - s, 7)
+  }
+  {
+    const char* s = ".5";
+    const char* it = s;
+    TEST_EQUAL(StringUtils::parseDoubleFast(it, s + strlen(s), d), true);
+    TEST_EQUAL(d, 0.5)
+  }
+  // not handled: pointer must not be advanced
+  const char* unhandled[] = {"nan", "inf", "1e", "abc", " 1", "12345678901234567890", "1.7976931348623157e308"};
+  for (const char* s : unhandled)
+  {
+    const char* it = s;
+    TEST_EQUAL(StringUtils::parseDoubleFast(it, s + strlen(s), d), false);
+    TEST_EQUAL(it - s, 0)
+  }
+}
+END_SECTION
+
+START_SECTION((char* StringConversions::formatShortest(double d, char* buffer)))
+{
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(0.0), "0.0")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(-0.0), "-0.0")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(1.0), "1.0")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(100.0), "100.0")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(0.1), "0.1")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(3.14), "3.14")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(0.1 + 0.2), "0.30000000000000004")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(0.01), "0.01")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(9999.5), "9999.5")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(1.0e4), "1.0e04")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(1.5e-7), "1.5e-07")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(-1.23e45), "-1.23e45")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(std::numeric_limits<double>::max()), "1.7976931348623157e308")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(std::numeric_limits<double>::denorm_min()), "5.0e-324")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(std::numeric_limits<double>::quiet_NaN()), "nan")
+  TEST_STRING_EQUAL(StringConversions::toStringShortest(-std::numeric_limits<double>::infinity()), "-inf")
+
+  // round trip (also through the fast parser)
+  double values[] = {1234.5678901234567, 445.2345678, 1.0 / 3.0, 2.2250738585072014e-308, 9007199254740993.0, 123456.0, 0.0099999};
+  for (double v : values)
+  {
+    String s = StringConversions::toStringShortest(v);
+    TEST_EQUAL(StringUtils::toDouble(s), v)
+  }
+  String target("x=");
+  StringConversions::appendShortest(2.5, target);
+  TEST_STRING_EQUAL(target, "x=2.5")
+}
+END_SECTION
+
 START_SECTION((static String& toUpper(String &this_s)))
 {
   // TODO
@@ -143,6 +143,25 @@ START_SECTION((double apply(double value) const))
 }
 END_SECTION
 
+START_SECTION((void apply(const double* in, double* out, Size n) const))
+{
+	TransformationDescription td;
+	std::vector<double> in = {-0.5, 1000}, out(2);
+	td.apply(in.data(), out.data(), in.size());
+	TEST_EQUAL(out[0], -0.5);
+	TEST_EQUAL(out[1], 1000);
+
+	TransformationDescription::DataPoints data;
+	data.push_back(make_pair(0.0, 1.0));
+	data.push_back(make_pair(1.0, 3.0));
+	td.setDataPoints(data);
+	td.fitModel("linear");
+	td.apply(in.data(), in.data(), in.size());
+	TEST_REAL_SIMILAR(in[0], 0.0);
+	TEST_REAL_SIMILAR(in[1], 2001.0);
+}
+END_SECTION
+
 START_SECTION((const String& getModelType() const))
 {
 	TransformationDescription td;
@@ -139,6 +139,47 @@ START_SECTION((double evaluate(double value) const))
 }
 END_SECTION
 
+START_SECTION((void evaluate(const double* in, double* out, Size n) const))
+{
+  TransformationModel::DataPoints data;
+  for (Size i = 0; i < 10; ++i)
+  {
+    data.push_back(make_pair(double(i), double(i * i) + (i % 2)));
+  }
+
+  // sorted values (including the data points and values beyond the borders)
+  std::vector<double> sorted;
+  for (double x = -2.0; x <= 11.0; x += 0.25)
+  {
+    sorted.push_back(x);
+  }
+  std::vector<double> reversed(sorted.rbegin(), sorted.rend());
+
+  const char* interpolation_types[] = {"linear", "cspline", "akima"};
+  for (const char* type : interpolation_types)
+  {
+    Param p;
+    TransformationModelInterpolated::getDefaultParameters(p);
+    p.setValue("interpolation_type", type);
+    p.setValue("extrapolation_type", "four-point-linear");
+    TransformationModelInterpolated tm(data, p);
+
+    std::vector<double> out(sorted.size());
+    tm.evaluate(sorted.data(), out.data(), sorted.size());
+    for (Size i = 0; i < sorted.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(out[i], tm.evaluate(sorted[i]));
+    }
+
+    tm.evaluate(reversed.data(), out.data(), reversed.size());
+    for (Size i = 0; i < reversed.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(out[i], tm.evaluate(reversed[i]));
+    }
+  }
+}
+END_SECTION
+
 START_SECTION(([EXTRA] TransformationModelInterpolated::evaluate() beyond the actual borders))
 {
   Param p;
@@ -93,6 +93,42 @@ START_SECTION((virtual double evaluate(double value) const))
 }
 END_SECTION
 
+START_SECTION((virtual void evaluate(const double* in, double* out, Size n) const))
+{
+  ptr = new TransformationModelLinear(data, Param());
+
+  std::vector<double> in = {-0.5, 0.0, 0.5, 1.0, 1.5}, out(in.size());
+  ptr->evaluate(in.data(), out.data(), in.size());
+  for (Size i = 0; i < in.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(out[i], ptr->evaluate(in[i]));
+  }
+  // in-place
+  ptr->evaluate(in.data(), in.data(), in.size());
+  TEST_REAL_SIMILAR(in[0], 0.0);
+  TEST_REAL_SIMILAR(in[4], 4.0);
+
+  // with weighting:
+  Param params;
+  TransformationModelLinear::getDefaultParameters(params);
+  params.setValue("x_weight", "ln(x)");
+  params.setValue("y_weight", "ln(y)");
+  TransformationModel::DataPoints data_weighted;
+  data_weighted.push_back(make_pair(1.2, 5.2));
+  data_weighted.push_back(make_pair(3.2, 7.3));
+  data_weighted.push_back(make_pair(2.2, 6.25));
+  TransformationModelLinear lm(data_weighted, params);
+  in = {1.0, 1.5, 2.0, 3.0};
+  lm.evaluate(in.data(), out.data(), in.size());
+  for (Size i = 0; i < in.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(out[i], lm.evaluate(in[i]));
+  }
+
+  delete ptr;
+}
+END_SECTION
+
 START_SECTION((void getParameters(Param & params) const))
 {  
 
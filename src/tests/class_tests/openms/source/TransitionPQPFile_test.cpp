@@ -35,6 +35,7 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/TraMLFile.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 
 #include <boost/assign/std/vector.hpp>
 
@@ -80,6 +81,136 @@ START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION( void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false, const std::vector<std::pair<double, double> >& swath_windows = std::vector<std::pair<double, double> >()))
+{
+  TransitionPQPFile pqp_file;
+  String filename = OPENMS_GET_TEST_DATA_PATH("../../../topp/TargetedFileConverter_10_input.pqp");
+
+  // the streaming Light reader has to agree with the full TraML representation
+  TargetedExperiment targeted_exp;
+  OpenSwath::LightTargetedExperiment reference;
+  pqp_file.convertPQPToTargetedExperiment(filename.c_str(), targeted_exp);
+  OpenSwathDataAccessHelper::convertTargetedExp(targeted_exp, reference);
+
+  OpenSwath::LightTargetedExperiment light_exp;
+  pqp_file.convertPQPToTargetedExperiment(filename.c_str(), light_exp);
+  TEST_EQUAL(light_exp.getTransitions().size(), 44)
+  TEST_EQUAL(light_exp.getCompounds().size(), 8)
+  TEST_EQUAL(light_exp.getProteins().size(), 0)
+  TEST_EQUAL(light_exp.getTransitions().size(), reference.getTransitions().size())
+  TEST_EQUAL(light_exp.getCompounds().size(), reference.getCompounds().size())
+  for (Size i = 0; i < light_exp.getTransitions().size(); ++i)
+  {
+    const OpenSwath::LightTransition& tr = light_exp.getTransitions()[i];
+    const OpenSwath::LightTransition& ref = reference.getTransitions()[i];
+    TEST_EQUAL(tr.transition_name, ref.transition_name)
+    TEST_EQUAL(tr.peptide_ref, ref.peptide_ref)
+    TEST_REAL_SIMILAR(tr.precursor_mz, ref.precursor_mz)
+    TEST_REAL_SIMILAR(tr.product_mz, ref.product_mz)
+    TEST_REAL_SIMILAR(tr.library_intensity, ref.library_intensity)
+    TEST_EQUAL(tr.decoy, ref.decoy)
+  }
+  for (Size i = 0; i < light_exp.getCompounds().size(); ++i)
+  {
+    const OpenSwath::LightCompound& c = light_exp.getCompounds()[i];
+    const OpenSwath::LightCompound& ref = reference.getCompounds()[i];
+    TEST_EQUAL(c.id, ref.id)
+    TEST_EQUAL(c.compound_name, ref.compound_name)
+    TEST_EQUAL(c.sum_formula, ref.sum_formula)
+    TEST_EQUAL(c.charge, ref.charge)
+    TEST_REAL_SIMILAR(c.rt, ref.rt)
+    TEST_EQUAL(c.isPeptide(), false)
+  }
+
+  // restrict to precursors within the provided windows (overlapping windows are merged)
+  std::vector<std::pair<double, double> > windows;
+  windows.push_back(std::make_pair(360.0, 400.0));
+  windows.push_back(std::make_pair(250.0, 270.0));
+  windows.push_back(std::make_pair(260.0, 280.0));
+  OpenSwath::LightTargetedExperiment filtered_exp;
+  pqp_file.convertPQPToTargetedExperiment(filename.c_str(), filtered_exp, false, windows);
+  TEST_EQUAL(filtered_exp.getTransitions().size(), 22)
+  TEST_EQUAL(filtered_exp.getCompounds().size(), 3)
+  for (Size i = 0; i < filtered_exp.getTransitions().size(); ++i)
+  {
+    double mz = filtered_exp.getTransitions()[i].precursor_mz;
+    TEST_EQUAL((mz >= 250.0 && mz <= 280.0) || (mz >= 360.0 && mz <= 400.0), true)
+  }
+
+  // windows without any precursor result in an empty experiment
+  windows.clear();
+  windows.push_back(std::make_pair(800.0, 825.0));
+  OpenSwath::LightTargetedExperiment empty_exp;
+  pqp_file.convertPQPToTargetedExperiment(filename.c_str(), empty_exp, false, windows);
+  TEST_EQUAL(empty_exp.getTransitions().size(), 0)
+  TEST_EQUAL(empty_exp.getCompounds().size(), 0)
+
+  // peptides: all four precursors share the group label "light" but have
+  // different sequences, so all but the first one get their own group
+  TargetedExperiment peptide_traml;
+  TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("../../../topp/MRMTransitionGroupPicker_1_input.TraML"), peptide_traml);
+  String peptide_filename;
+  NEW_TMP_FILE(peptide_filename)
+  pqp_file.convertTargetedExperimentToPQP(peptide_filename.c_str(), peptide_traml);
+
+  TargetedExperiment peptide_exp;
+  OpenSwath::LightTargetedExperiment peptide_reference;
+  pqp_file.convertPQPToTargetedExperiment(peptide_filename.c_str(), peptide_exp);
+  OpenSwathDataAccessHelper::convertTargetedExp(peptide_exp, peptide_reference);
+
+  OpenSwath::LightTargetedExperiment peptide_light;
+  pqp_file.convertPQPToTargetedExperiment(peptide_filename.c_str(), peptide_light);
+  TEST_EQUAL(peptide_light.getTransitions().size(), 24)
+  TEST_EQUAL(peptide_light.getCompounds().size(), 4)
+  TEST_EQUAL(peptide_light.getProteins().size(), 4)
+  TEST_EQUAL(peptide_light.getTransitions().size(), peptide_reference.getTransitions().size())
+  TEST_EQUAL(peptide_light.getCompounds().size(), peptide_reference.getCompounds().size())
+  TEST_EQUAL(peptide_light.getProteins().size(), peptide_reference.getProteins().size())
+  for (Size i = 0; i < peptide_light.getTransitions().size(); ++i)
+  {
+    const OpenSwath::LightTransition& tr = peptide_light.getTransitions()[i];
+    const OpenSwath::LightTransition& ref = peptide_reference.getTransitions()[i];
+    TEST_EQUAL(tr.transition_name, ref.transition_name)
+    TEST_EQUAL(tr.peptide_ref, ref.peptide_ref)
+    TEST_REAL_SIMILAR(tr.precursor_mz, ref.precursor_mz)
+    TEST_REAL_SIMILAR(tr.product_mz, ref.product_mz)
+    TEST_EQUAL(tr.fragment_charge, ref.fragment_charge)
+  }
+
+  Size light_groups = 0;
+  for (Size i = 0; i < peptide_light.getCompounds().size(); ++i)
+  {
+    const OpenSwath::LightCompound& c = peptide_light.getCompounds()[i];
+    const OpenSwath::LightCompound& ref = peptide_reference.getCompounds()[i];
+    TEST_EQUAL(c.isPeptide(), true)
+    TEST_EQUAL(c.id, ref.id)
+    TEST_EQUAL(c.sequence, ref.sequence)
+    TEST_EQUAL(c.charge, ref.charge)
+    TEST_REAL_SIMILAR(c.rt, ref.rt)
+    TEST_EQUAL(c.peptide_group_label, ref.peptide_group_label)
+    TEST_EQUAL(c.protein_refs.size(), 1)
+    TEST_EQUAL(c.protein_refs == ref.protein_refs, true)
+
+    TEST_EQUAL(peptide_traml.hasPeptide(c.id), true)
+
+    const TargetedExperiment::Peptide& pep = peptide_traml.getPeptideByRef(c.id);
+    TEST_EQUAL(c.sequence, pep.sequence)
+    TEST_EQUAL(c.charge, pep.getChargeState())
+    TEST_EQUAL(c.protein_refs.size(), pep.protein_refs.size())
+    TEST_EQUAL(c.protein_refs[0], pep.protein_refs[0])
+    if (c.peptide_group_label == "light") ++light_groups;
+    else TEST_EQUAL(c.peptide_group_label, c.id)
+  }
+  TEST_EQUAL(light_groups, 1)
+
+  for (Size i = 0; i < peptide_light.getProteins().size(); ++i)
+  {
+    TEST_EQUAL(peptide_light.getProteins()[i].id, peptide_reference.getProteins()[i].id)
+    TEST_EQUAL(peptide_traml.hasProtein(peptide_light.getProteins()[i].id), true)
+  }
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
@@ -38,6 +38,7 @@
 #include <OpenMS/CHEMISTRY/SpectrumAnnotator.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/FORMAT/FileTypes.h>
+#include <OpenMS/FORMAT/IdBinaryFile.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/FORMAT/MascotXMLFile.h>
 #include <OpenMS/FORMAT/MzIdentMLFile.h>
@@ -126,6 +127,7 @@ For Percolator tab-delimited output, information is extracted from the "PSMId" c
 Some information about the supported input types:
 @li @ref OpenMS::MzIdentMLFile "mzIdentML"
 @li @ref OpenMS::IdXMLFile "idXML"
+@li @ref OpenMS::IdBinaryFile "idBin"
 @li @ref OpenMS::PepXMLFile "pepXML"
 @li @ref OpenMS::ProtXMLFile "protXML"
 @li @ref OpenMS::MascotXMLFile "Mascot XML"
@@ -212,14 +214,14 @@ protected:
   {
     registerInputFile_("in", "<path/file>", "",
                        "Input file or directory containing the data to convert. This may be:\n"
-                       "- a single file in a multi-purpose XML format (.pepXML, .protXML, .idXML, .mzid),\n"
+                       "- a single file in a multi-purpose XML format (.pepXML, .protXML, .idXML, .mzid) or in the binary idBin format,\n"
                        "- a single file in a search engine-specific format (Mascot: .mascotXML, OMSSA: .omssaXML, X! Tandem: .xml, Percolator: .psms, xQuest: .xquest.xml),\n"
                        "- a single text file (tab separated) with one line for all peptide sequences matching a spectrum (top N hits),\n"
                        "- for Sequest results, a directory containing .out files.\n");
-    setValidFormats_("in", ListUtils::create<String>("pepXML,protXML,mascotXML,omssaXML,xml,psms,tsv,idXML,mzid,xquest.xml"));
+    setValidFormats_("in", ListUtils::create<String>("pepXML,protXML,mascotXML,omssaXML,xml,psms,tsv,idXML,idBin,mzid,xquest.xml"));
 
     registerOutputFile_("out", "<file>", "", "Output file", true);
-    String formats("idXML,mzid,pepXML,FASTA,xquest.xml");
+    String formats("idXML,idBin,mzid,pepXML,FASTA,xquest.xml");
     setValidFormats_("out", ListUtils::create<String>(formats));
     registerStringOption_("out_type", "<type>", "", "Output file type (default: determined from file extension)", false);
     setValidStrings_("out_type", ListUtils::create<String>(formats));
@@ -417,6 +419,13 @@ protected:
         }
       }
 
+      else if (in_type == FileTypes::IDBIN)
+      {
+        IdBinaryFile file;
+        file.setLogType(log_type_);
+        file.load(in, protein_identifications, peptide_identifications);
+      }
+
       else if (in_type == FileTypes::MZIDENTML)
       {
         OPENMS_LOG_WARN << "Converting from mzid: you might experience loss of information depending on the capabilities of the target format." << endl;
@@ -601,6 +610,13 @@ protected:
       IdXMLFile().store(out, protein_identifications, peptide_identifications);
     }
 
+    else if (out_type == FileTypes::IDBIN)
+    {
+      IdBinaryFile file;
+      file.setLogType(log_type_);
+      file.store(out, protein_identifications, peptide_identifications);
+    }
+
     else if (out_type == FileTypes::MZIDENTML)
     {
       MzIdentMLFile().store(out, protein_identifications,
@@ -221,6 +221,8 @@ protected:
     registerOutputFile_("out", "<file>", "", "output consensusXML file with quantitative information");
     setValidFormats_("out", ListUtils::create<String>("consensusXML"));
 
+    registerFlag_("low_memory", "Stream the input file and keep only the parts of the spectra needed for quantification (reporter ion region, precursor isolation windows) in memory.", true);
+
     registerSubsection_("extraction", "Parameters for the channel extraction.");
     registerSubsection_("quantification", "Parameters for the peptide quantification.");
     for (std::map<String, IsobaricQuantitationMethod*>::iterator it = quant_methods_.begin();
@@ -266,14 +268,19 @@ protected:
     String in = getStringOption_("in");
     String out = getStringOption_("out");
 
+    bool low_memory = getFlag_("low_memory");
+
     //-------------------------------------------------------------
     // loading input
     //-------------------------------------------------------------
 
-    MzMLFile mz_data_file;
     PeakMap exp;
-    mz_data_file.setLogType(log_type_);
-    mz_data_file.load(in, exp);
+    if (!low_memory)
+    {
+      MzMLFile mz_data_file;
+      mz_data_file.setLogType(log_type_);
+      mz_data_file.load(in, exp);
+    }
 
     //-------------------------------------------------------------
     // init quant method
@@ -293,7 +300,14 @@ protected:
     ConsensusMap consensus_map_raw, consensus_map_quant;
 
     // extract channel information
-    channel_extractor.extractChannels(exp, consensus_map_raw);
+    if (low_memory)
+    {
+      channel_extractor.extractChannels(in, consensus_map_raw);
+    }
+    else
+    {
+      channel_extractor.extractChannels(exp, consensus_map_raw);
+    }
 
     IsobaricQuantifier quantifier(quant_method);
     Param quant_param(getParam_().copy("quantification:", true));
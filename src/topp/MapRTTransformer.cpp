@@ -33,6 +33,9 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/APPLICATIONS/MapAlignerBase.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataChainingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -69,6 +72,8 @@ using namespace std;
 
     With this tool it is also possible to invert transformations, or to fit a different model than originally specified to the retention time data in the transformation files. To fit a new model, choose a value other than "none" for the model type (see below).
 
+    mzML files can be transformed with low memory usage (flag @p low_memory): spectra and chromatograms are then read, transformed and written one by one, instead of loading the whole file into memory first.
+
     Original retention time values can be kept as meta data. With the option @p store_original_rt, meta values with the name "original_RT" and the original retention time will be created for every major data element (spectrum, chromatogram, feature, consensus feature, peptide identification), unless they already exist - "original_RT" values from a previous invocation will not be overwritten.
 
     Since %OpenMS 1.8, the extraction of data for the alignment has been separate from the modeling of RT transformations based on that data. It is now possible to use different models independently of the chosen algorithm. The different available models are:
@@ -118,6 +123,7 @@ protected:
     setValidFormats_("trafo_out", ListUtils::create<String>("trafoXML"));
     registerFlag_("invert", "Invert transformation (approximatively) before applying it");
     registerFlag_("store_original_rt", "Store the original retention times (before transformation) as meta data in the output file");
+    registerFlag_("low_memory", "Stream mzML input through the transformation and write it to disk on the fly, instead of loading the whole file into memory first (only for mzML).", true);
     addEmptyLine_();
 
     registerSubsection_("model", "Options to control the modeling of retention time transformations from data");
@@ -141,6 +147,33 @@ protected:
     file.store(out, map);
   }
 
+  /// Transforms an mzML file spectrum by spectrum, without loading it completely into memory
+  void applyTransformationStreaming_(const String& in, const String& out,
+                                     const TransformationDescription& trafo)
+  {
+    bool store_original_rt = getFlag_("store_original_rt");
+    MSDataTransformingConsumer transformer;
+    transformer.setSpectraProcessingFunc([&trafo, store_original_rt](MSSpectrum& spectrum)
+    {
+      MapAlignmentTransformer::transformRetentionTimes(spectrum, trafo, store_original_rt);
+    });
+    transformer.setChromatogramProcessingFunc([&trafo, store_original_rt](MSChromatogram& chromatogram)
+    {
+      MapAlignmentTransformer::transformRetentionTimes(chromatogram, trafo, store_original_rt);
+    });
+
+    PlainMSDataWritingConsumer writer(out);
+    writer.addDataProcessing(getProcessingInfo_(DataProcessing::ALIGNMENT));
+
+    MSDataChainingConsumer consumer;
+    consumer.appendConsumer(&transformer);
+    consumer.appendConsumer(&writer);
+
+    MzMLFile file;
+    file.setLogType(log_type_);
+    file.transform(in, &consumer);
+  }
+
   ExitCodes main_(int, const char**) override
   {
     //-------------------------------------------------------------
@@ -192,7 +225,11 @@ protected:
     if (!in.empty()) // load input
     {
       FileTypes::Type in_type = FileHandler::getType(in);
-      if (in_type == FileTypes::MZML)
+      if (in_type == FileTypes::MZML && getFlag_("low_memory"))
+      {
+        applyTransformationStreaming_(in, out, trafo);
+      }
+      else if (in_type == FileTypes::MZML)
       {
         MzMLFile file;
         PeakMap map;
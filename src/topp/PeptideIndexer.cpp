@@ -41,6 +41,11 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <cstdio>
+
 using namespace OpenMS;
 
 //-------------------------------------------------------------
@@ -92,6 +97,11 @@ using namespace OpenMS;
   PeptideIndexer supports relative database filenames, which (when not found in the current working directory) are looked up in the directories specified
   by @p OpenMS.ini:id_db_dir (see @subpage TOPP_advanced).
 
+  If the same (large) database is used repeatedly, a persistent index of it can be used (@p fasta_index). It is created from the FASTA
+  file on first use (or whenever the FASTA file changed) and memory-mapped afterwards, which saves parsing the database on every run.
+  Exact and I/L-equivalent matches are then looked up in the index, and only proteins with ambiguous amino acids
+  (or all proteins, if mismatches are allowed) are searched with the (slower) tolerant search.
+
   Further details can be found in the underlying PeptideIndexing implementation.
   
   @note Currently mzIdentML (mzid) is not directly supported as an input/output format of this tool. Convert mzid files to/from idXML using @ref TOPP_IDFileConverter if necessary.
@@ -123,6 +133,7 @@ protected:
     setValidFormats_("in", ListUtils::create<String>("idXML"));
     registerInputFile_("fasta", "<file>", "", "Input sequence database in FASTA format. Non-existing relative filenames are looked up via 'OpenMS.ini:id_db_dir'", true, false, ListUtils::create<String>("skipexists"));
     setValidFormats_("fasta", ListUtils::create<String>("fasta"));
+    registerStringOption_("fasta_index", "<file>", "", "Persistent index of the sequence database (created or updated if missing or outdated). Speeds up repeated runs on the same database.", false, true);
     registerOutputFile_("out", "<file>", "", "Output idXML file.");
     setValidFormats_("out", ListUtils::create<String>("idXML"));
 
@@ -176,8 +187,58 @@ protected:
     // calculations
     //-------------------------------------------------------------
 
-    FASTAContainer<TFI_File> proteins(db_name);
-    PeptideIndexing::ExitCodes indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    PeptideIndexing::ExitCodes indexer_exit;
+    String index_name = getStringOption_("fasta_index");
+    if (index_name.empty())
+    {
+      FASTAContainer<TFI_File> proteins(db_name);
+      indexer_exit = indexer.run(proteins, prot_ids, pep_ids);
+    }
+    else
+    {
+      ProteinDBIndex index;
+      QFileInfo db_info(db_name.toQString());
+      const std::pair<UInt64, Int64> db_source(db_info.size(), db_info.lastModified().toMSecsSinceEpoch());
+      bool index_valid = false;
+      if (File::exists(index_name))
+      {
+        try
+        {
+          index.load(index_name);
+          index_valid = (index.getSourceInfo() == db_source);
+        }
+        catch (Exception::BaseException& e)
+        {
+          OPENMS_LOG_WARN << "Could not load database index '" << index_name << "': " << e.what() << std::endl;
+        }
+        if (!index_valid) OPENMS_LOG_INFO << "Database index '" << index_name << "' does not match '" << db_name << "'. Rebuilding it ..." << std::endl;
+      }
+      if (!index_valid)
+      {
+        FASTAContainer<TFI_File> proteins(db_name);
+        index.build(proteins);
+        index.setSourceInfo(db_source.first, db_source.second);
+        // other runs may have the old index memory-mapped: write to a temporary file in the
+        // same directory and replace the old index by renaming (atomic on POSIX systems)
+        String tmp_index_name = index_name + "." + File::getUniqueName(false) + ".tmp";
+        try
+        {
+          index.store(tmp_index_name);
+        }
+        catch (...)
+        {
+          File::remove(tmp_index_name);
+          throw;
+        }
+        if (std::rename(tmp_index_name.c_str(), index_name.c_str()) != 0 &&
+            !File::rename(tmp_index_name, index_name, true, false)) // std::rename does not replace existing files on Windows
+        {
+          File::remove(tmp_index_name);
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index_name);
+        }
+      }
+      indexer_exit = indexer.run(index, prot_ids, pep_ids);
+    }
   
     //-------------------------------------------------------------
     // calculate protein coverage
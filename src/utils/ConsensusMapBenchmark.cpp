@@ -0,0 +1,320 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmMedian.h>
+#include <OpenMS/ANALYSIS/MAPMATCHING/ConsensusMapNormalizerAlgorithmQuantile.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/ConsensusXMLFile.h>
+#include <OpenMS/KERNEL/ConsensusMap.h>
+#include <OpenMS/SYSTEM/File.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+#include <OpenMS/SYSTEM/SysInfo.h>
+
+#include <fstream>
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+    @page UTILS_ConsensusMapBenchmark ConsensusMapBenchmark
+
+    @brief Measures load time, memory footprint and normalization throughput of large consensus maps.
+
+    Either an existing consensusXML file is benchmarked (@p in) or a synthetic consensus map is generated
+    with @p maps input maps and @p features consensus features, of which every map contributes to a fraction
+    @p fill of the features. Synthetic maps are stored to a temporary consensusXML file and loaded again,
+    so the load time includes parsing and building the handle sets of every consensus feature.
+
+    The following numbers are reported (and optionally written as a two-column table to @p out):
+    - load time (wall clock) and the increase of the process memory during loading
+    - the memory used by the feature handles (their storage is contiguous per consensus feature)
+    - the throughput of iterating over all feature handles
+    - the throughput of median normalization (ConsensusMapNormalizerAlgorithmMedian), averaged over @p repeats runs
+    - the throughput of quantile normalization (ConsensusMapNormalizerAlgorithmQuantile), averaged over @p repeats runs
+
+    Both normalizations run multi-threaded; use @p threads to compare different numbers of threads.
+
+    <B>The command line parameters of this tool are:</B>
+    @verbinclude UTILS_ConsensusMapBenchmark.cli
+    <B>INI file documentation of this tool:</B>
+    @htmlinclude UTILS_ConsensusMapBenchmark.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPConsensusMapBenchmark :
+  public TOPPBase
+{
+public:
+  TOPPConsensusMapBenchmark() :
+    TOPPBase("ConsensusMapBenchmark", "Measures load time, memory footprint and normalization throughput of large consensus maps.", false)
+  {
+  }
+
+protected:
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Input consensusXML file. If empty, a synthetic consensus map is generated.", false);
+    setValidFormats_("in", ListUtils::create<String>("consensusXML"));
+    registerOutputFile_("out", "<file>", "", "Optional output file with the results (tab-separated).", false);
+    setValidFormats_("out", ListUtils::create<String>("tsv"));
+    registerIntOption_("maps", "<number>", 1000, "Number of input maps of the synthetic consensus map.", false);
+    setMinInt_("maps", 1);
+    registerIntOption_("features", "<number>", 10000, "Number of consensus features of the synthetic consensus map.", false);
+    setMinInt_("features", 1);
+    registerDoubleOption_("fill", "<fraction>", 0.8, "Fraction of consensus features every map contributes a feature to (synthetic consensus map).", false);
+    setMinFloat_("fill", 0.0);
+    setMaxFloat_("fill", 1.0);
+    registerIntOption_("repeats", "<number>", 3, "Number of normalization runs to average over.", false);
+    setMinInt_("repeats", 1);
+    registerIntOption_("seed", "<number>", 42, "Seed of the random number generator (synthetic consensus map).", false, true);
+  }
+
+  void createSyntheticMap_(Size n_maps, Size n_features, double fill, UInt seed, ConsensusMap& map) const
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> rt_dist(0.0, 7200.0);
+    std::uniform_real_distribution<double> mz_dist(200.0, 2000.0);
+    std::uniform_real_distribution<double> shift_dist(-0.01, 0.01);
+    std::uniform_real_distribution<double> presence(0.0, 1.0);
+    std::lognormal_distribution<double> int_dist(12.0, 2.0);
+
+    ConsensusMap::ColumnHeaders& headers = map.getColumnHeaders();
+    for (Size m = 0; m < n_maps; ++m)
+    {
+      headers[m].filename = "map_" + String(m) + ".featureXML";
+      headers[m].size = 0;
+    }
+
+    map.reserve(n_features);
+    UInt64 handle_id(1);
+    for (Size f = 0; f < n_features; ++f)
+    {
+      ConsensusFeature cf;
+      const double rt = rt_dist(rng);
+      const double mz = mz_dist(rng);
+      const double intensity = int_dist(rng);
+      for (Size m = 0; m < n_maps; ++m)
+      {
+        if (presence(rng) >= fill) continue;
+        FeatureHandle fh;
+        fh.setMapIndex(m);
+        fh.setUniqueId(handle_id++);
+        fh.setRT(rt + shift_dist(rng) * 1000.0);
+        fh.setMZ(mz + shift_dist(rng));
+        // map-specific scaling, so normalization has something to do
+        fh.setIntensity(intensity * (1.0 + 0.5 * double(m % 7) / 7.0));
+        fh.setCharge(2);
+        cf.insert(fh);
+        ++headers[m].size;
+      }
+      if (cf.empty()) continue;
+      cf.computeConsensus();
+      cf.setUniqueId();
+      map.push_back(cf);
+    }
+    map.setUniqueId();
+  }
+
+  static Size countHandles_(const ConsensusMap& map)
+  {
+    Size n(0);
+    for (const ConsensusFeature& cf : map)
+    {
+      n += cf.size();
+    }
+    return n;
+  }
+
+  ExitCodes main_(int, const char **) override
+  {
+    //-------------------------------------------------------------
+    // parsing parameters
+    //-------------------------------------------------------------
+    String in = getStringOption_("in");
+    String out = getStringOption_("out");
+    Size repeats = getIntOption_("repeats");
+
+    vector<pair<String, String> > results;
+    StopWatch sw;
+    size_t mem_before(0), mem_after(0);
+
+    //-------------------------------------------------------------
+    // load (or create, store and load) the consensus map
+    //-------------------------------------------------------------
+    ConsensusXMLFile cxml;
+    cxml.setLogType(ProgressLogger::NONE);
+    if (in.empty())
+    {
+      Size n_maps = getIntOption_("maps");
+      Size n_features = getIntOption_("features");
+      ConsensusMap synthetic;
+      sw.start();
+      createSyntheticMap_(n_maps, n_features, getDoubleOption_("fill"), getIntOption_("seed"), synthetic);
+      sw.stop();
+      results.push_back(make_pair("create_time_s", String(sw.getClockTime())));
+      sw.reset();
+
+      in = File::getTemporaryFile();
+      sw.start();
+      cxml.store(in, synthetic);
+      sw.stop();
+      results.push_back(make_pair("store_time_s", String(sw.getClockTime())));
+      sw.reset();
+    }
+
+    ConsensusMap map;
+    SysInfo::getProcessMemoryConsumption(mem_before);
+    sw.start();
+    cxml.load(in, map);
+    sw.stop();
+    SysInfo::getProcessMemoryConsumption(mem_after);
+    const double load_time = sw.getClockTime();
+    sw.reset();
+
+    const Size n_handles = countHandles_(map);
+    Size threads(1);
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    results.push_back(make_pair("threads", String(threads)));
+    results.push_back(make_pair("maps", String(map.getColumnHeaders().size())));
+    results.push_back(make_pair("consensus_features", String(map.size())));
+    results.push_back(make_pair("feature_handles", String(n_handles)));
+    results.push_back(make_pair("load_time_s", String(load_time)));
+    results.push_back(make_pair("load_memory_increase_KB", String(mem_after >= mem_before ? mem_after - mem_before : 0)));
+
+    //-------------------------------------------------------------
+    // memory footprint of the handles
+    //-------------------------------------------------------------
+    Size handle_bytes(0);
+    for (const ConsensusFeature& cf : map)
+    {
+      handle_bytes += cf.getFeatures().capacity() * sizeof(FeatureHandle);
+    }
+    results.push_back(make_pair("handle_size_bytes", String(sizeof(FeatureHandle))));
+    results.push_back(make_pair("handle_memory_KB", String(handle_bytes / 1024)));
+
+    //-------------------------------------------------------------
+    // iteration throughput
+    //-------------------------------------------------------------
+    double intensity_sum(0);
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      for (const ConsensusFeature& cf : map)
+      {
+        for (const FeatureHandle& fh : cf)
+        {
+          intensity_sum += fh.getIntensity();
+        }
+      }
+    }
+    sw.stop();
+    const double iteration_time = sw.getClockTime() / double(repeats);
+    sw.reset();
+    writeDebug_("Sum of intensities: " + String(intensity_sum / double(repeats)), 1);
+    results.push_back(make_pair("iteration_time_s", String(iteration_time)));
+    results.push_back(make_pair("iteration_handles_per_s", String(iteration_time > 0 ? double(n_handles) / iteration_time : 0.0)));
+
+    //-------------------------------------------------------------
+    // normalization throughput
+    //-------------------------------------------------------------
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      ConsensusMapNormalizerAlgorithmMedian::normalizeMaps(map, ConsensusMapNormalizerAlgorithmMedian::NM_SCALE, "", "");
+    }
+    sw.stop();
+    const double normalization_time = sw.getClockTime() / double(repeats);
+    results.push_back(make_pair("normalization_time_s", String(normalization_time)));
+    results.push_back(make_pair("normalization_handles_per_s", String(normalization_time > 0 ? double(n_handles) / normalization_time : 0.0)));
+    sw.reset();
+
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      ConsensusMapNormalizerAlgorithmQuantile::normalizeMaps(map);
+    }
+    sw.stop();
+    const double quantile_time = sw.getClockTime() / double(repeats);
+    results.push_back(make_pair("quantile_normalization_time_s", String(quantile_time)));
+    results.push_back(make_pair("quantile_normalization_handles_per_s", String(quantile_time > 0 ? double(n_handles) / quantile_time : 0.0)));
+
+    //-------------------------------------------------------------
+    // writing output
+    //-------------------------------------------------------------
+    for (const pair<String, String>& res : results)
+    {
+      OPENMS_LOG_INFO << res.first << ": " << res.second << endl;
+    }
+
+    if (!out.empty())
+    {
+      ofstream os(out.c_str());
+      if (!os)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, out);
+      }
+      os << "metric\tvalue\n";
+      for (const pair<String, String>& res : results)
+      {
+        os << res.first << "\t" << res.second << "\n";
+      }
+    }
+
+    return EXECUTION_OK;
+  }
+
+};
+
+
+int main(int argc, const char ** argv)
+{
+  TOPPConsensusMapBenchmark tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
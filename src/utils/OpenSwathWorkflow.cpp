@@ -741,6 +741,7 @@ protected:
     }
 
     // Check swath window input
+    std::vector<std::pair<double, double> > swath_windows;
     if (!swath_windows_file.empty())
     {
       OPENMS_LOG_INFO << "Validate provided Swath windows file:" << std::endl;
@@ -751,6 +752,7 @@ protected:
       for (Size i = 0; i < swath_prec_lower.size(); i++)
       {
         OPENMS_LOG_DEBUG << "Read lower swath window " << swath_prec_lower[i] << " and upper window " << swath_prec_upper[i] << std::endl;
+        swath_windows.push_back(std::make_pair(swath_prec_lower[i], swath_prec_upper[i]));
       }
     }
 
@@ -801,7 +803,9 @@ protected:
     ///////////////////////////////////
     // Load the transitions
     ///////////////////////////////////
-    OpenSwath::LightTargetedExperiment transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
+    // With known SWATH windows, transitions outside of all windows are not
+    // loaded from a PQP library since they can never be extracted.
+    OpenSwath::LightTargetedExperiment transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param, swath_windows);
     OPENMS_LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
       transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
 
@@ -1717,18 +1717,17 @@ protected:
       ConsensusXMLFile().store(getStringOption_("out_cxml"), consensus);
     }
 
-    // Fill MzTab with meta data and quants annotated in identification data structure
+    // Write mzTab with meta data and quants annotated in identification data structure.
+    // Rows are written while they are generated (without building the full MzTab object).
     const bool report_unmapped(true);
     const bool report_unidentified_features(false);
-
-    MzTab m = MzTab::exportConsensusMapToMzTab(
-      consensus, 
-      String("null"),
+    const bool report_subfeatures(true);
+    MzTabFile().store(out,
+      consensus,
       true,
-      report_unidentified_features, 
+      report_unidentified_features,
       report_unmapped,
-      "Export from ProteomicsLFQ workflow in OpenMS.");
-    MzTabFile().store(out, m);
+      report_subfeatures);
 
     if (!out_msstats.empty())
     {
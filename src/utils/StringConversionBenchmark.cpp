@@ -0,0 +1,274 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/PrecisionWrapper.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/DATASTRUCTURES/StringUtils.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+    @page UTILS_StringConversionBenchmark StringConversionBenchmark
+
+    @brief Measures the throughput of converting doubles to text and back.
+
+    A set of @p numbers random doubles is generated, resembling the values found in data files
+    (m/z values, retention times, intensities and scores with a limited number of decimals, as well as
+    arbitrary computed values). Each conversion is repeated @p repeats times and the average throughput
+    (in numbers per second) is reported:
+    - formatting: String(double, true), stream output with precisionWrapper() and StringConversions::formatShortest()
+    - parsing: StringUtils::toDouble() (fast path with fallback), StringUtils::extractDouble() (boost::spirit) and strtod()
+
+    Additionally, the tool checks that all numbers written by StringConversions::formatShortest() are read back to exactly
+    the same value by StringUtils::toDouble().
+
+    The results are optionally written as a two-column table to @p out.
+
+    <B>The command line parameters of this tool are:</B>
+    @verbinclude UTILS_StringConversionBenchmark.cli
+    <B>INI file documentation of this tool:</B>
+    @htmlinclude UTILS_StringConversionBenchmark.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPStringConversionBenchmark :
+  public TOPPBase
+{
+public:
+  TOPPStringConversionBenchmark() :
+    TOPPBase("StringConversionBenchmark", "Measures the throughput of converting doubles to text and back.", false)
+  {
+  }
+
+protected:
+  void registerOptionsAndFlags_() override
+  {
+    registerOutputFile_("out", "<file>", "", "Optional output file with the results (tab-separated).", false);
+    setValidFormats_("out", ListUtils::create<String>("tsv"));
+    registerIntOption_("numbers", "<number>", 1000000, "Number of random doubles to convert.", false);
+    setMinInt_("numbers", 1);
+    registerIntOption_("repeats", "<number>", 3, "Number of runs to average over.", false);
+    setMinInt_("repeats", 1);
+    registerIntOption_("seed", "<number>", 42, "Seed of the random number generator.", false, true);
+  }
+
+  static void createNumbers_(Size n, UInt seed, vector<double>& numbers)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> mz_dist(200.0, 2000.0);
+    std::uniform_real_distribution<double> rt_dist(0.0, 7200.0);
+    std::lognormal_distribution<double> int_dist(12.0, 2.0);
+    std::uniform_real_distribution<double> score_dist(0.0, 1.0);
+
+    numbers.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      switch (i % 4)
+      {
+        case 0: numbers[i] = mz_dist(rng); break; // computed values (full precision)
+        case 1: numbers[i] = std::round(rt_dist(rng) * 1000.0) / 1000.0; break; // values read from files (few decimals)
+        case 2: numbers[i] = std::round(int_dist(rng)); break;
+        default: numbers[i] = score_dist(rng) * 1e-3;
+      }
+    }
+  }
+
+  /// stores the throughput of @p n conversions in @p seconds (averaged over @p repeats)
+  static void addThroughput_(const String& name, Size n, Size repeats, double seconds, vector<pair<String, String> >& results)
+  {
+    seconds /= double(repeats);
+    results.push_back(make_pair(name + "_time_s", String(seconds)));
+    results.push_back(make_pair(name + "_numbers_per_s", String(seconds > 0 ? double(n) / seconds : 0.0)));
+  }
+
+  ExitCodes main_(int, const char **) override
+  {
+    //-------------------------------------------------------------
+    // parsing parameters
+    //-------------------------------------------------------------
+    String out = getStringOption_("out");
+    Size n = getIntOption_("numbers");
+    Size repeats = getIntOption_("repeats");
+
+    vector<pair<String, String> > results;
+    StopWatch sw;
+
+    vector<double> numbers;
+    createNumbers_(n, getIntOption_("seed"), numbers);
+    results.push_back(make_pair("numbers", String(n)));
+
+    //-------------------------------------------------------------
+    // formatting
+    //-------------------------------------------------------------
+    Size chars(0); // keeps the compiler from optimizing the conversions away
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      for (double d : numbers)
+      {
+        chars += String(d, true).size();
+      }
+    }
+    sw.stop();
+    addThroughput_("format_String", n, repeats, sw.getClockTime(), results);
+    sw.reset();
+
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      std::ostringstream os;
+      for (double d : numbers)
+      {
+        os << precisionWrapper(d) << '\n';
+      }
+      chars += os.str().size();
+    }
+    sw.stop();
+    addThroughput_("format_precisionWrapper", n, repeats, sw.getClockTime(), results);
+    sw.reset();
+
+    vector<String> texts(n);
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      for (Size i = 0; i < n; ++i)
+      {
+        texts[i].clear();
+        StringConversions::appendShortest(numbers[i], texts[i]);
+      }
+    }
+    sw.stop();
+    addThroughput_("format_shortest", n, repeats, sw.getClockTime(), results);
+    sw.reset();
+    writeDebug_("Characters written: " + String(chars), 1);
+
+    //-------------------------------------------------------------
+    // parsing
+    //-------------------------------------------------------------
+    double sum(0);
+    Size mismatches(0);
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      for (Size i = 0; i < n; ++i)
+      {
+        double d = StringUtils::toDouble(texts[i]);
+        if (d != numbers[i]) ++mismatches;
+        sum += d;
+      }
+    }
+    sw.stop();
+    addThroughput_("parse_toDouble", n, repeats, sw.getClockTime(), results);
+    sw.reset();
+
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      for (const String& s : texts)
+      {
+        double d(0);
+        String::ConstIterator it = s.begin();
+        StringUtils::extractDouble(it, s.end(), d);
+        sum += d;
+      }
+    }
+    sw.stop();
+    addThroughput_("parse_spirit", n, repeats, sw.getClockTime(), results);
+    sw.reset();
+
+    sw.start();
+    for (Size r = 0; r < repeats; ++r)
+    {
+      for (const String& s : texts)
+      {
+        sum += strtod(s.c_str(), nullptr);
+      }
+    }
+    sw.stop();
+    addThroughput_("parse_strtod", n, repeats, sw.getClockTime(), results);
+    writeDebug_("Sum of parsed numbers: " + String(sum), 1);
+
+    results.push_back(make_pair("round_trip_mismatches", String(mismatches / repeats)));
+
+    //-------------------------------------------------------------
+    // writing output
+    //-------------------------------------------------------------
+    for (const pair<String, String>& res : results)
+    {
+      OPENMS_LOG_INFO << res.first << ": " << res.second << endl;
+    }
+
+    if (!out.empty())
+    {
+      ofstream os(out.c_str());
+      if (!os)
+      {
+        throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, out);
+      }
+      os << "metric\tvalue\n";
+      for (const pair<String, String>& res : results)
+      {
+        os << res.first << "\t" << res.second << "\n";
+      }
+    }
+
+    return mismatches == 0 ? EXECUTION_OK : INTERNAL_ERROR;
+  }
+
+};
+
+
+int main(int argc, const char ** argv)
+{
+  TOPPStringConversionBenchmark tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
@@ -7,6 +7,7 @@ AccurateMassSearch
 AssayGeneratorMetabo
 ClusterMassTraces
 ClusterMassTracesByPrecursor
+ConsensusMapBenchmark
 CVInspector
 DatabaseFilter
 DecoyDatabase
@@ -59,6 +60,7 @@ SimpleSearchEngine
 SiriusAdapter
 SpecLibCreator
 SpectraSTSearchAdapter
+StringConversionBenchmark
 SvmTheoreticalSpectrumGeneratorTrainer
 TICCalculator
 TransformationEvaluation